@@ -0,0 +1,1241 @@
+/**
+ * ===============================================================================================
+ * @addtogroup string-vector
+ * @{
+ * ------------------------------------------------------------------------------------------------
+ * @file    bench.cpp
+ * @author  Pascal-Emmanuel Lachance
+ * @p       <a href="https://www.github.com/Raesangur">Raesangur</a>
+ *
+ * @brief   Benchmarks of the string vector utility class.
+ *
+ * ------------------------------------------------------------------------------------------------
+ * @copyright Copyright (c) 2023 Pascal-Emmanuel Lachance | Raesangur
+ *
+ * @par License: <a href="https://opensource.org/license/mit/"> MIT </a>
+ *               This project is released under the MIT License
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this software
+ * and associated documentation files (the "Software"), to deal in the Software without
+ * restriction, including without limitation the rights to use, copy, modify, merge, publish,
+ * distribute, sublicense, and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all copies or
+ * substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING
+ * BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NON INFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+ * DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ * ------------------------------------------------------------------------------------------------
+ * File History:
+ * @version 0.1
+ * 2026-10-14 - Raesangur
+ * - Creation of the benchmarks, comparing the `std::function` and template predicate overloads.
+ * @version 0.2
+ * 2026-10-14 - Raesangur
+ * - Operation suite over short and long, ASCII and UTF-8 corpora, for every reading, writing,
+ *   splitting, trimming, filtering, sorting and searching method.
+ * ===============================================================================================
+ */
+
+/** ===============================================================================================
+ *  INCLUDES
+ */
+#include "stringvec.h"
+
+#include <benchmark/benchmark.h>
+
+#include <cstdio>
+
+
+/** ===============================================================================================
+ *  DEFINES
+ */
+/* Largest corpus of the operation suite. Raise it, e.g. to 100000000, for full-size runs. */
+#ifndef STRINGVEC_BENCH_MAX_ELEMENTS
+#define STRINGVEC_BENCH_MAX_ELEMENTS (1 << 20)
+#endif
+
+/* Corpora of the operation suite larger than this many bytes are skipped. */
+#ifndef STRINGVEC_BENCH_MAX_BYTES
+#define STRINGVEC_BENCH_MAX_BYTES (std::int64_t{1} << 28)
+#endif
+
+
+/** ===============================================================================================
+ *  PRIVATE FUNCTION DECLARATIONS
+ */
+static stringvec make_corpus(std::size_t count, std::size_t length);
+static stringvec make_lines(const benchmark::State& state);
+static void      corpus_args(benchmark::internal::Benchmark* b);
+
+
+/** ===============================================================================================
+ *  BENCHMARKS
+ */
+
+static void BM_filter_keep_function(benchmark::State& state)
+{
+    const stringvec corpus = make_corpus(state.range(0), 32);
+    const std::function<bool(const std::string)> func = [](const std::string& s)
+                                                        {
+                                                            return s[0] < 'n';
+                                                        };
+
+    for(auto _ : state)
+    {
+        state.PauseTiming();
+        stringvec sv = corpus;
+        state.ResumeTiming();
+
+        sv.filter_keep(func);
+        benchmark::DoNotOptimize(sv.get().data());
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_filter_keep_function)->Range(1 << 10, 1 << 18);
+
+static void BM_filter_keep_template(benchmark::State& state)
+{
+    const stringvec corpus = make_corpus(state.range(0), 32);
+
+    for(auto _ : state)
+    {
+        state.PauseTiming();
+        stringvec sv = corpus;
+        state.ResumeTiming();
+
+        sv.filter_keep([](const std::string& s)
+                       {
+                           return s[0] < 'n';
+                       });
+        benchmark::DoNotOptimize(sv.get().data());
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_filter_keep_template)->Range(1 << 10, 1 << 18);
+
+static void BM_filter_keep_parallel(benchmark::State& state)
+{
+    const stringvec corpus = make_corpus(state.range(0), 32);
+
+    for(auto _ : state)
+    {
+        state.PauseTiming();
+        stringvec sv = corpus;
+        state.ResumeTiming();
+
+        sv.filter_keep(stringvec_execution::par, [](const std::string& s)
+                                                 {
+                                                     return s[0] < 'n';
+                                                 });
+        benchmark::DoNotOptimize(sv.get().data());
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_filter_keep_parallel)->Range(1 << 10, 1 << 18);
+
+static void BM_transform_function(benchmark::State& state)
+{
+    stringvec sv = make_corpus(state.range(0), 32);
+    const std::function<std::string(const std::string)> func = [](const std::string& s)
+                                                               {
+                                                                   return s;
+                                                               };
+
+    for(auto _ : state)
+    {
+        sv.transform(func);
+        benchmark::DoNotOptimize(sv.get().data());
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_transform_function)->Range(1 << 10, 1 << 18);
+
+static void BM_transform_template(benchmark::State& state)
+{
+    stringvec sv = make_corpus(state.range(0), 32);
+
+    for(auto _ : state)
+    {
+        sv.transform([](const std::string& s)
+                     {
+                         return s;
+                     });
+        benchmark::DoNotOptimize(sv.get().data());
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_transform_template)->Range(1 << 10, 1 << 18);
+
+/* Upper and lower case alternate between iterations, so every call converts every letter. */
+static void BM_to_upper_transform(benchmark::State& state)
+{
+    stringvec sv = make_corpus(state.range(0), 32);
+
+    for(auto _ : state)
+    {
+        sv.transform([](const std::string& s)
+                     {
+                         std::string upper = s;
+                         for (char& c : upper)
+                         {
+                             c = static_cast<char>(std::toupper(static_cast<unsigned char>(c)));
+                         }
+                         return upper;
+                     });
+        benchmark::DoNotOptimize(sv.get().data());
+        sv.to_lower();
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_to_upper_transform)->Range(1 << 10, 1 << 18);
+
+static void BM_to_upper(benchmark::State& state)
+{
+    stringvec sv = make_corpus(state.range(0), 32);
+
+    for(auto _ : state)
+    {
+        sv.to_upper();
+        benchmark::DoNotOptimize(sv.get().data());
+        sv.to_lower();
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_to_upper)->Range(1 << 10, 1 << 18);
+
+static void BM_casefold_utf8(benchmark::State& state)
+{
+    stringvec sv = make_corpus(state.range(0), 32);
+    for (std::string& s : sv.get())
+    {
+        s += "\xC3\x89t\xC3\xA9 \xD0\x9C\xD0\x9E\xD0\xA1\xD0\x9A\xD0\x92\xD0\x90";
+    }
+
+    for(auto _ : state)
+    {
+        stringvec folded = sv;
+        benchmark::DoNotOptimize(folded.casefold_utf8().get().data());
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_casefold_utf8)->Range(1 << 10, 1 << 18);
+
+/* Filtering CSV lines on their third field, re-splitting each line against a column table. */
+static stringvec make_csv(std::size_t count)
+{
+    const stringvec words = make_corpus(count, 12);
+    stringvec       csv;
+    csv.get().reserve(count);
+    for (std::size_t i = 0; i < count; i++)
+    {
+        csv.get().push_back(words[i] + "," + std::to_string(i) + ",code" + std::to_string(i % 97) + "," + words[(i * 7) % count]);
+    }
+
+    return csv;
+}
+
+static void BM_filter_column_resplit(benchmark::State& state)
+{
+    const stringvec    csv   = make_csv(state.range(0));
+    const regex_handle regex = regex_cache::global().get("code1[0-9]");
+
+    for(auto _ : state)
+    {
+        stringvec kept = csv;
+        kept.filter_keep([&regex](const std::string& line)
+                         {
+                             return regex->match(stringvec{line}.split(",")[2]);
+                         });
+        benchmark::DoNotOptimize(kept.get().data());
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_filter_column_resplit)->Range(1 << 10, 1 << 18);
+
+static void BM_filter_column_table(benchmark::State& state)
+{
+    const stringvec    csv   = make_csv(state.range(0));
+    const regex_handle regex = regex_cache::global().get("code1[0-9]");
+
+    for(auto _ : state)
+    {
+        column_table table = csv.split_columns(",").filter_keep(2, regex);
+        benchmark::DoNotOptimize(table.rows());
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_filter_column_table)->Range(1 << 10, 1 << 18);
+
+static void BM_filter_column_scan(benchmark::State& state)
+{
+    const column_table table = make_csv(state.range(0)).split_columns(",");
+    const regex_handle regex = regex_cache::global().get("code1[0-9]");
+
+    for(auto _ : state)
+    {
+        column_table kept = table;
+        benchmark::DoNotOptimize(kept.filter_keep(2, regex).rows());
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_filter_column_scan)->Range(1 << 10, 1 << 18);
+
+static void BM_find_function(benchmark::State& state)
+{
+    const stringvec corpus = make_corpus(state.range(0), 32);
+    const std::function<bool(const std::string&)> func = [](const std::string& s)
+                                                         {
+                                                             return s.empty();
+                                                         };
+
+    for(auto _ : state)
+    {
+        benchmark::DoNotOptimize(corpus.find(func));
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_find_function)->Range(1 << 10, 1 << 18);
+
+static void BM_find_template(benchmark::State& state)
+{
+    const stringvec corpus = make_corpus(state.range(0), 32);
+
+    for(auto _ : state)
+    {
+        benchmark::DoNotOptimize(corpus.find([](const std::string& s)
+                                             {
+                                                 return s.empty();
+                                             }));
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_find_template)->Range(1 << 10, 1 << 18);
+
+static void BM_find_string_linear(benchmark::State& state)
+{
+    const stringvec   corpus = make_corpus(state.range(0), 32);
+    const std::string last   = corpus[corpus.get().size() - 1];
+
+    for(auto _ : state)
+    {
+        benchmark::DoNotOptimize(corpus.find(last));
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_find_string_linear)->Range(1 << 10, 1 << 18);
+
+static void BM_find_string_indexed(benchmark::State& state)
+{
+    const stringvec   corpus = make_corpus(state.range(0), 32).build_index();
+    const std::string last   = corpus[corpus.get().size() - 1];
+
+    for(auto _ : state)
+    {
+        benchmark::DoNotOptimize(corpus.find(last));
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_find_string_indexed)->Range(1 << 10, 1 << 18);
+
+static void BM_find_all_containing_linear(benchmark::State& state)
+{
+    const stringvec   corpus = make_corpus(state.range(0), 32);
+    const std::string needle = corpus[corpus.get().size() / 2].substr(10, 6);
+
+    for(auto _ : state)
+    {
+        benchmark::DoNotOptimize(corpus.find_all_containing(needle));
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_find_all_containing_linear)->Range(1 << 10, 1 << 18);
+
+static void BM_find_all_containing_indexed(benchmark::State& state)
+{
+    const stringvec   corpus = make_corpus(state.range(0), 32).build_search_index();
+    const std::string needle = corpus[corpus.get().size() / 2].substr(10, 6);
+
+    for(auto _ : state)
+    {
+        benchmark::DoNotOptimize(corpus.find_all_containing(needle));
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_find_all_containing_indexed)->Range(1 << 10, 1 << 18);
+
+static void BM_build_search_index(benchmark::State& state)
+{
+    const stringvec corpus = make_corpus(state.range(0), 32);
+
+    for(auto _ : state)
+    {
+        stringvec sv = corpus;
+        benchmark::DoNotOptimize(sv.build_search_index().has_search_index());
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_build_search_index)->Range(1 << 10, 1 << 18);
+
+static void BM_find_all_reg_loop(benchmark::State& state)
+{
+    const stringvec    corpus = make_corpus(state.range(0), 32);
+    const regex_handle regex  = regex_cache::global().get("[a-m]+z.*");
+
+    for(auto _ : state)
+    {
+        std::vector<std::size_t> positions;
+        for (auto it = corpus.begin(); it != corpus.end(); ++it)
+        {
+            it = std::find_if(it, corpus.end(), [&regex](const std::string& s)
+                                                {
+                                                    return regex->match(s);
+                                                });
+            if (it == corpus.end())
+            {
+                break;
+            }
+            positions.push_back(static_cast<std::size_t>(it - corpus.begin()));
+        }
+        benchmark::DoNotOptimize(positions.data());
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_find_all_reg_loop)->Range(1 << 10, 1 << 18);
+
+static void BM_find_all_reg(benchmark::State& state)
+{
+    const stringvec    corpus = make_corpus(state.range(0), 32);
+    const regex_handle regex  = regex_cache::global().get("[a-m]+z.*");
+
+    for(auto _ : state)
+    {
+        benchmark::DoNotOptimize(corpus.find_all_reg(regex).data());
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_find_all_reg)->Range(1 << 10, 1 << 18);
+
+static void BM_find_all_reg_parallel(benchmark::State& state)
+{
+    const stringvec    corpus = make_corpus(state.range(0), 32);
+    const regex_handle regex  = regex_cache::global().get("[a-m]+z.*");
+
+    for(auto _ : state)
+    {
+        benchmark::DoNotOptimize(corpus.find_all_reg(stringvec_execution::par, regex).data());
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_find_all_reg_parallel)->Range(1 << 10, 1 << 18);
+
+static void BM_sort_std(benchmark::State& state)
+{
+    const stringvec corpus = make_corpus(state.range(0), 32);
+
+    for(auto _ : state)
+    {
+        state.PauseTiming();
+        stringvec sv = corpus;
+        state.ResumeTiming();
+
+        std::sort(sv.begin(), sv.end());
+        benchmark::DoNotOptimize(sv.get().data());
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_sort_std)->Range(1 << 10, 1 << 18);
+
+static void BM_sort_alphabetically(benchmark::State& state)
+{
+    const stringvec corpus = make_corpus(state.range(0), 32);
+
+    for(auto _ : state)
+    {
+        state.PauseTiming();
+        stringvec sv = corpus;
+        state.ResumeTiming();
+
+        sv.sort_alphabetically();
+        benchmark::DoNotOptimize(sv.get().data());
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_sort_alphabetically)->Range(1 << 10, 1 << 18);
+
+static void BM_sort_length(benchmark::State& state)
+{
+    const stringvec corpus = make_corpus(state.range(0), 32).transform([](const std::string& s)
+                                                                       {
+                                                                           return s.substr(0, s[0] - 'a' + 6);
+                                                                       });
+
+    for(auto _ : state)
+    {
+        state.PauseTiming();
+        stringvec sv = corpus;
+        state.ResumeTiming();
+
+        sv.sort_length();
+        benchmark::DoNotOptimize(sv.get().data());
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_sort_length)->Range(1 << 10, 1 << 18);
+
+static void BM_write_ofstream(benchmark::State& state)
+{
+    const stringvec corpus = make_corpus(state.range(0), 32);
+
+    for(auto _ : state)
+    {
+        std::ofstream output("bench_write.txt");
+        for(const std::string& s : corpus)
+        {
+            output << s << '\n';
+        }
+    }
+    std::remove("bench_write.txt");
+    state.SetBytesProcessed(state.iterations() * state.range(0) * 33);
+}
+BENCHMARK(BM_write_ofstream)->Range(1 << 14, 1 << 20);
+
+static void BM_write_file(benchmark::State& state)
+{
+    const stringvec corpus = make_corpus(state.range(0), 32);
+
+    for(auto _ : state)
+    {
+        corpus.write_file("bench_write.txt");
+    }
+    std::remove("bench_write.txt");
+    state.SetBytesProcessed(state.iterations() * state.range(0) * 33);
+}
+BENCHMARK(BM_write_file)->Range(1 << 14, 1 << 20);
+
+/* Picking up the lines appended to a log, by reading it again against following it. */
+static void follow_appends(benchmark::State& state, bool follow)
+{
+    const std::string path = "bench_follow.log";
+    make_corpus(state.range(0), 32).write_file(path);
+    const stringvec batch = make_corpus(64, 32);
+
+    stringvec     followed;
+    file_follower follower = followed.follow(path);
+    follower.poll();
+
+    for(auto _ : state)
+    {
+        state.PauseTiming();
+        {
+            std::ofstream output(path, std::ios::binary | std::ios::app);
+            output << '\n';
+            batch.print(output, "\n", false);
+        }
+        state.ResumeTiming();
+
+        if (follow)
+        {
+            benchmark::DoNotOptimize(follower.poll());
+        }
+        else
+        {
+            stringvec sv = stringvec{}.read_file(path);
+            benchmark::DoNotOptimize(sv.get().data());
+        }
+    }
+    std::remove(path.c_str());
+    state.SetItemsProcessed(state.iterations() * 64);
+}
+
+static void BM_follow_reread(benchmark::State& state)
+{
+    follow_appends(state, false);
+}
+BENCHMARK(BM_follow_reread)->Range(1 << 14, 1 << 18);
+
+static void BM_follow_poll(benchmark::State& state)
+{
+    follow_appends(state, true);
+}
+BENCHMARK(BM_follow_poll)->Range(1 << 14, 1 << 18);
+
+/* Reading a compressed file straight into lines, against decompressing it to disk first. */
+#if defined(STRINGVEC_USE_ZLIB) || defined(STRINGVEC_USE_ZSTD) || defined(STRINGVEC_USE_LZ4)
+static void read_compressed(benchmark::State& state, const std::string& path, compression codec)
+{
+    const stringvec corpus = make_corpus(state.range(0), 32);
+    corpus.write_file(path, "\n", write_options{.codec = codec});
+
+    for(auto _ : state)
+    {
+        stringvec sv = stringvec{}.read_file(path);
+        benchmark::DoNotOptimize(sv.get().data());
+    }
+    std::remove(path.c_str());
+    state.SetBytesProcessed(state.iterations() * state.range(0) * 33);
+}
+
+static void write_compressed(benchmark::State& state, const std::string& path, compression codec)
+{
+    const stringvec corpus = make_corpus(state.range(0), 32);
+
+    for(auto _ : state)
+    {
+        corpus.write_file(path, "\n", write_options{.codec = codec});
+    }
+    std::remove(path.c_str());
+    state.SetBytesProcessed(state.iterations() * state.range(0) * 33);
+}
+#endif
+
+#ifdef STRINGVEC_USE_ZLIB
+static void BM_read_file_gzip(benchmark::State& state)
+{
+    read_compressed(state, "bench_read.txt.gz", compression::gzip);
+}
+BENCHMARK(BM_read_file_gzip)->Range(1 << 14, 1 << 20);
+
+static void BM_read_file_gunzip_to_disk(benchmark::State& state)
+{
+    const stringvec corpus = make_corpus(state.range(0), 32);
+    corpus.write_file("bench_read.txt.gz");
+
+    for(auto _ : state)
+    {
+        stringvec{}.read_file("bench_read.txt.gz").write_file("bench_read.txt", "\n", write_options{.codec = compression::none});
+        stringvec sv = stringvec{}.read_file("bench_read.txt");
+        benchmark::DoNotOptimize(sv.get().data());
+    }
+    std::remove("bench_read.txt.gz");
+    std::remove("bench_read.txt");
+    state.SetBytesProcessed(state.iterations() * state.range(0) * 33);
+}
+BENCHMARK(BM_read_file_gunzip_to_disk)->Range(1 << 14, 1 << 20);
+
+static void BM_write_file_gzip(benchmark::State& state)
+{
+    write_compressed(state, "bench_write.txt.gz", compression::gzip);
+}
+BENCHMARK(BM_write_file_gzip)->Range(1 << 14, 1 << 20);
+#endif
+
+#ifdef STRINGVEC_USE_ZSTD
+static void BM_read_file_zstd(benchmark::State& state)
+{
+    read_compressed(state, "bench_read.txt.zst", compression::zstd);
+}
+BENCHMARK(BM_read_file_zstd)->Range(1 << 14, 1 << 20);
+
+static void BM_write_file_zstd(benchmark::State& state)
+{
+    write_compressed(state, "bench_write.txt.zst", compression::zstd);
+}
+BENCHMARK(BM_write_file_zstd)->Range(1 << 14, 1 << 20)->UseRealTime();
+#endif
+
+#ifdef STRINGVEC_USE_LZ4
+static void BM_read_file_lz4(benchmark::State& state)
+{
+    read_compressed(state, "bench_read.txt.lz4", compression::lz4);
+}
+BENCHMARK(BM_read_file_lz4)->Range(1 << 14, 1 << 20);
+
+static void BM_write_file_lz4(benchmark::State& state)
+{
+    write_compressed(state, "bench_write.txt.lz4", compression::lz4);
+}
+BENCHMARK(BM_write_file_lz4)->Range(1 << 14, 1 << 20);
+#endif
+
+static void BM_chain_eager(benchmark::State& state)
+{
+    const stringvec corpus = make_corpus(state.range(0), 32);
+
+    for(auto _ : state)
+    {
+        stringvec sv = stringvec{corpus}.split("e")
+                                        .filter_remove([](const std::string& s)
+                                                       {
+                                                           return s.size() < 3;
+                                                       })
+                                        .filter_keep([](const std::string& s)
+                                                     {
+                                                         return s[0] < 'n';
+                                                     });
+        benchmark::DoNotOptimize(sv.get().data());
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_chain_eager)->Range(1 << 10, 1 << 18);
+
+static void BM_chain_lazy(benchmark::State& state)
+{
+    const stringvec corpus = make_corpus(state.range(0), 32);
+
+    for(auto _ : state)
+    {
+        stringvec sv = corpus.pipeline()
+                             .split("e")
+                             .filter_remove([](std::string_view s)
+                                            {
+                                                return s.size() < 3;
+                                            })
+                             .filter_keep([](std::string_view s)
+                                          {
+                                              return s[0] < 'n';
+                                          })
+                             .collect();
+        benchmark::DoNotOptimize(sv.get().data());
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_chain_lazy)->Range(1 << 10, 1 << 18);
+
+static void BM_remove_first_loop(benchmark::State& state)
+{
+    const stringvec corpus = make_corpus(1 << 16, 32);
+
+    for(auto _ : state)
+    {
+        state.PauseTiming();
+        stringvec sv = corpus;
+        state.ResumeTiming();
+
+        for(std::int64_t i = 0; i < state.range(0); i++)
+        {
+            sv.remove_first();
+        }
+        benchmark::DoNotOptimize(sv.get().data());
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_remove_first_loop)->Range(1 << 4, 1 << 10);
+
+static void BM_remove_first_batch(benchmark::State& state)
+{
+    const stringvec corpus = make_corpus(1 << 16, 32);
+
+    for(auto _ : state)
+    {
+        state.PauseTiming();
+        stringvec sv = corpus;
+        state.ResumeTiming();
+
+        sv.remove_first(static_cast<std::size_t>(state.range(0)));
+        benchmark::DoNotOptimize(sv.get().data());
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_remove_first_batch)->Range(1 << 4, 1 << 10);
+
+static void BM_read_files_sequential(benchmark::State& state)
+{
+    std::vector<std::string> paths;
+    for(std::int64_t i = 0; i < state.range(0); i++)
+    {
+        paths.push_back("bench_small_" + std::to_string(i) + ".txt");
+        make_corpus(128, 32).write_file(paths.back());
+    }
+
+    for(auto _ : state)
+    {
+        for(const std::string& path : paths)
+        {
+            stringvec sv;
+            sv.read_file(path);
+            benchmark::DoNotOptimize(sv.get().data());
+        }
+    }
+    for(const std::string& path : paths)
+    {
+        std::remove(path.c_str());
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_read_files_sequential)->Range(16, 512);
+
+static void BM_read_files_async(benchmark::State& state)
+{
+    std::vector<std::string> paths;
+    for(std::int64_t i = 0; i < state.range(0); i++)
+    {
+        paths.push_back("bench_small_" + std::to_string(i) + ".txt");
+        make_corpus(128, 32).write_file(paths.back());
+    }
+
+    for(auto _ : state)
+    {
+        std::vector<stringvec> files = stringvec::read_files_async(paths).get();
+        benchmark::DoNotOptimize(files.data());
+    }
+    for(const std::string& path : paths)
+    {
+        std::remove(path.c_str());
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_read_files_async)->Range(16, 512);
+
+
+/** ===============================================================================================
+ *  OPERATION SUITE
+ *
+ *  Every benchmark below runs over the corpora of `corpus_args`: 1K to
+ *  `STRINGVEC_BENCH_MAX_ELEMENTS` lines of words, short or long, ASCII or UTF-8.
+ */
+
+static void BM_read_file(benchmark::State& state)
+{
+    make_lines(state).write_file("bench_read.txt");
+
+    for(auto _ : state)
+    {
+        stringvec sv;
+        sv.read_file("bench_read.txt");
+        benchmark::DoNotOptimize(sv.get().data());
+    }
+    std::remove("bench_read.txt");
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_read_file)->Apply(corpus_args);
+
+static void BM_read_file_parallel(benchmark::State& state)
+{
+    make_lines(state).write_file("bench_read.txt");
+
+    for(auto _ : state)
+    {
+        stringvec sv = stringvec{}.read_file(stringvec_execution::par, "bench_read.txt");
+        benchmark::DoNotOptimize(sv.get().data());
+    }
+    std::remove("bench_read.txt");
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_read_file_parallel)->Apply(corpus_args);
+
+static void BM_read_file_views(benchmark::State& state)
+{
+    make_lines(state).write_file("bench_read.txt");
+
+    for(auto _ : state)
+    {
+        stringview_vec sv = stringview_vec{}.read_file("bench_read.txt");
+        benchmark::DoNotOptimize(sv.get().data());
+    }
+    std::remove("bench_read.txt");
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_read_file_views)->Apply(corpus_args);
+
+static void BM_load_snapshot(benchmark::State& state)
+{
+    make_lines(state).save_snapshot("bench_snapshot.bin");
+
+    for(auto _ : state)
+    {
+        stringvec sv = stringvec{}.load_snapshot("bench_snapshot.bin");
+        benchmark::DoNotOptimize(sv.get().data());
+    }
+    std::remove("bench_snapshot.bin");
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_load_snapshot)->Apply(corpus_args);
+
+static void BM_load_snapshot_views(benchmark::State& state)
+{
+    make_lines(state).save_snapshot("bench_snapshot.bin");
+
+    for(auto _ : state)
+    {
+        stringview_vec sv = stringview_vec{}.load_snapshot("bench_snapshot.bin");
+        benchmark::DoNotOptimize(sv.get().data());
+    }
+    std::remove("bench_snapshot.bin");
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_load_snapshot_views)->Apply(corpus_args);
+
+static void BM_write_lines(benchmark::State& state)
+{
+    const stringvec corpus = make_lines(state);
+
+    for(auto _ : state)
+    {
+        corpus.write_file("bench_write.txt");
+    }
+    std::remove("bench_write.txt");
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_write_lines)->Apply(corpus_args);
+
+static void BM_split(benchmark::State& state)
+{
+    const stringvec corpus = make_lines(state);
+
+    for(auto _ : state)
+    {
+        state.PauseTiming();
+        stringvec sv = corpus;
+        state.ResumeTiming();
+
+        sv.split();
+        benchmark::DoNotOptimize(sv.get().data());
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_split)->Apply(corpus_args);
+
+static void BM_split_any(benchmark::State& state)
+{
+    const stringvec corpus = make_lines(state);
+
+    for(auto _ : state)
+    {
+        state.PauseTiming();
+        stringvec sv = corpus;
+        state.ResumeTiming();
+
+        sv.split_any(" ,;");
+        benchmark::DoNotOptimize(sv.get().data());
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_split_any)->Apply(corpus_args);
+
+static void BM_trim(benchmark::State& state)
+{
+    const stringvec corpus = make_lines(state);
+
+    for(auto _ : state)
+    {
+        state.PauseTiming();
+        stringvec sv = corpus;
+        state.ResumeTiming();
+
+        sv.trim();
+        benchmark::DoNotOptimize(sv.get().data());
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_trim)->Apply(corpus_args);
+
+static void BM_filter_remove(benchmark::State& state)
+{
+    const stringvec corpus = make_lines(state);
+
+    for(auto _ : state)
+    {
+        state.PauseTiming();
+        stringvec sv = corpus;
+        state.ResumeTiming();
+
+        sv.filter_remove([](const std::string& s)
+                         {
+                             return s.size() % 2 == 0;
+                         });
+        benchmark::DoNotOptimize(sv.get().data());
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_filter_remove)->Apply(corpus_args);
+
+static void BM_filter_remove_regex(benchmark::State& state)
+{
+    const stringvec corpus = make_lines(state);
+
+    for(auto _ : state)
+    {
+        state.PauseTiming();
+        stringvec sv = corpus;
+        state.ResumeTiming();
+
+        sv.filter_remove(".*ab.*");
+        benchmark::DoNotOptimize(sv.get().data());
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_filter_remove_regex)->Apply(corpus_args);
+
+static void BM_filter_keep_regex(benchmark::State& state)
+{
+    const stringvec corpus = make_lines(state);
+
+    for(auto _ : state)
+    {
+        state.PauseTiming();
+        stringvec sv = corpus;
+        state.ResumeTiming();
+
+        sv.filter_keep(".*ab.*");
+        benchmark::DoNotOptimize(sv.get().data());
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_filter_keep_regex)->Apply(corpus_args);
+
+/* Blocklists of `.*word.*` regexes: one pass per regex, against a single pass over a pattern set. */
+static std::vector<std::string> make_blocklist(std::size_t count)
+{
+    std::vector<std::string> patterns;
+    for (const std::string& word : make_corpus(count, 4))
+    {
+        patterns.push_back(".*" + word + ".*");
+    }
+    return patterns;
+}
+
+static void BM_filter_remove_each(benchmark::State& state)
+{
+    const stringvec                corpus   = make_corpus(1 << 14, 32);
+    const std::vector<std::string> patterns = make_blocklist(state.range(0));
+
+    for(auto _ : state)
+    {
+        stringvec sv = corpus;
+        for (const std::string& pattern : patterns)
+        {
+            sv.filter_remove(pattern);
+        }
+        benchmark::DoNotOptimize(sv.get().data());
+    }
+    state.SetItemsProcessed(state.iterations() * (1 << 14));
+}
+BENCHMARK(BM_filter_remove_each)->RangeMultiplier(4)->Range(16, 1024);
+
+static void BM_filter_remove_any(benchmark::State& state)
+{
+    const stringvec                corpus   = make_corpus(1 << 14, 32);
+    const std::vector<std::string> patterns = make_blocklist(state.range(0));
+
+    for(auto _ : state)
+    {
+        stringvec sv = stringvec{corpus}.filter_remove_any(patterns);
+        benchmark::DoNotOptimize(sv.get().data());
+    }
+    state.SetItemsProcessed(state.iterations() * (1 << 14));
+}
+BENCHMARK(BM_filter_remove_any)->RangeMultiplier(4)->Range(16, 1024);
+
+static void BM_filter_empty(benchmark::State& state)
+{
+    const stringvec corpus = make_lines(state);
+
+    for(auto _ : state)
+    {
+        state.PauseTiming();
+        stringvec sv = corpus;
+        state.ResumeTiming();
+
+        sv.filter_empty();
+        benchmark::DoNotOptimize(sv.get().data());
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_filter_empty)->Apply(corpus_args);
+
+static void BM_sort_lines(benchmark::State& state)
+{
+    const stringvec corpus = make_lines(state);
+
+    for(auto _ : state)
+    {
+        state.PauseTiming();
+        stringvec sv = corpus;
+        state.ResumeTiming();
+
+        sv.sort_alphabetically();
+        benchmark::DoNotOptimize(sv.get().data());
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_sort_lines)->Apply(corpus_args);
+
+static void BM_sort_length_lines(benchmark::State& state)
+{
+    const stringvec corpus = make_lines(state);
+
+    for(auto _ : state)
+    {
+        state.PauseTiming();
+        stringvec sv = corpus;
+        state.ResumeTiming();
+
+        sv.sort_length();
+        benchmark::DoNotOptimize(sv.get().data());
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_sort_length_lines)->Apply(corpus_args);
+
+static void BM_sort_comparator(benchmark::State& state)
+{
+    const stringvec corpus = make_lines(state);
+
+    for(auto _ : state)
+    {
+        state.PauseTiming();
+        stringvec sv = corpus;
+        state.ResumeTiming();
+
+        sv.sort([](const std::string_view a, const std::string_view b)
+                {
+                    return a > b;
+                });
+        benchmark::DoNotOptimize(sv.get().data());
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_sort_comparator)->Apply(corpus_args);
+
+static void BM_find_lines(benchmark::State& state)
+{
+    const stringvec   corpus = make_lines(state);
+    const std::string last   = corpus.get().back();
+
+    for(auto _ : state)
+    {
+        benchmark::DoNotOptimize(corpus.find(last));
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_find_lines)->Apply(corpus_args);
+
+static void BM_rfind_lines(benchmark::State& state)
+{
+    const stringvec   corpus = make_lines(state);
+    const std::string first  = corpus.get().front();
+
+    for(auto _ : state)
+    {
+        benchmark::DoNotOptimize(corpus.rfind(first));
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_rfind_lines)->Apply(corpus_args);
+
+static void BM_find_reg(benchmark::State& state)
+{
+    const stringvec corpus = make_lines(state);
+
+    for(auto _ : state)
+    {
+        benchmark::DoNotOptimize(corpus.find_reg(".*qqqq.*"));
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_find_reg)->Apply(corpus_args);
+
+
+/* ------------------------------------------- */
+BENCHMARK_MAIN();
+
+
+/** ===============================================================================================
+ *  PRIVATE FUNCTION DEFINITIONS
+ */
+
+/** -----------------------------------------------------------------------------------------------
+ * @brief Generate `count` pseudo-random lowercase strings of `length` characters.
+ */
+static stringvec make_corpus(std::size_t count, std::size_t length)
+{
+    std::vector<std::string> strings(count, std::string(length, ' '));
+    std::uint32_t            seed = 12345;
+    for(std::string& s : strings)
+    {
+        for(char& c : s)
+        {
+            seed = seed * 1664525 + 1013904223;
+            c    = static_cast<char>('a' + (seed >> 24) % 26);
+        }
+    }
+
+    return stringvec{strings};
+}
+
+/** -----------------------------------------------------------------------------------------------
+ * @brief Generate the corpus of an operation-suite benchmark from its arguments.
+ *
+ * @details Lines are made of words of 1 to 8 characters separated by spaces, with a leading
+ *          space on one line in eight. In UTF-8 corpora, one character in four is a multi-byte
+ *          sequence of 2 to 4 bytes.
+ */
+static stringvec make_lines(const benchmark::State& state)
+{
+    static constexpr std::string_view wide[] = {"\xC3\xA9", "\xC3\xBC", "\xC3\x9F", "\xE4\xB8\xAD", "\xE6\x96\x87",
+                                                "\xF0\x9F\x98\x80"};
+
+    const std::size_t count  = static_cast<std::size_t>(state.range(0));
+    const std::size_t length = static_cast<std::size_t>(state.range(1));
+    const bool        utf8   = state.range(2) != 0;
+
+    std::vector<std::string> lines(count);
+    std::uint32_t            seed = 12345;
+    auto                     next = [&seed]()
+                                    {
+                                        seed = seed * 1664525 + 1013904223;
+                                        return seed >> 16;
+                                    };
+
+    for(std::size_t i = 0; i < count; i++)
+    {
+        std::string& line = lines[i];
+        line.reserve(length + 4);
+        if(i % 8 == 0)
+        {
+            line.push_back(' ');
+        }
+
+        while(line.size() < length)
+        {
+            for(std::size_t word = next() % 8 + 1; word > 0 && line.size() < length; word--)
+            {
+                const std::uint32_t r = next();
+                if(utf8 && r % 4 == 0)
+                {
+                    line += wide[(r >> 2) % std::size(wide)];
+                }
+                else
+                {
+                    line.push_back(static_cast<char>('a' + (r >> 2) % 26));
+                }
+            }
+            line.push_back(' ');
+        }
+        line.pop_back();
+    }
+
+    return stringvec{std::move(lines)};
+}
+
+/** -----------------------------------------------------------------------------------------------
+ * @brief Register the corpora of the operation suite: element count, line length and encoding.
+ */
+static void corpus_args(benchmark::internal::Benchmark* b)
+{
+    b->ArgNames({"count", "length", "utf8"});
+    for(std::int64_t count = 1 << 10; count <= STRINGVEC_BENCH_MAX_ELEMENTS; count *= 32)
+    {
+        for(const std::int64_t length : {16, 256})
+        {
+            if(count * length > STRINGVEC_BENCH_MAX_BYTES)
+            {
+                continue;
+            }
+            b->Args({count, length, 0});
+            b->Args({count, length, 1});
+        }
+    }
+}
+
+
+
+/**
+ * ===============================================================================================
+ * @}
+ */
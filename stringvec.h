@@ -78,6 +78,165 @@
  *      - Added the `write_file` method
  *      - Added the == and != operators, as well as the <=> operator
  *
+ * @version 0.8
+ * 2026-10-14 - Raesangur
+ *      - Added the `mapped_file` class
+ *      - Added the `stringview_vec` class, reading files through a memory mapping without copies
+ *      - Fixed invalid return statements in the regex filters and in `rfind_reg`
+ *
+ * @version 0.9
+ * 2026-10-14 - Raesangur
+ *      - Added the `compiled_regex` and `regex_cache` classes
+ *      - Regex patterns are now compiled once and shared through `regex_cache::global()`
+ *      - Added overloads of the regex methods taking a precompiled `regex_handle`
+ *
+ * @version 0.10
+ * 2026-10-14 - Raesangur
+ *      - Added the `regex_engine` selection, with a linear-time DFA engine and an optional RE2
+ *        engine (`STRINGVEC_USE_RE2`)
+ *      - Literal and `.*`-glob patterns are now matched without running a regex engine
+ *
+ * @version 0.11
+ * 2026-10-14 - Raesangur
+ *      - Added template overloads of the filter, `transform`, `find` and `rfind` methods,
+ *        calling their function objects directly instead of through `std::function`
+ *
+ * @version 0.12
+ * 2026-10-14 - Raesangur
+ *      - Added the `transform_inplace` method
+ *      - `transform` moves strings into functions taking their argument by value
+ *      - `trim` now works in place, and no longer empties single-character strings
+ *
+ * @version 0.13
+ * 2026-10-14 - Raesangur
+ *      - Added move constructors and assignment operators, and a `std::vector` sink constructor
+ *      - Modifying methods now return the vector, as an rvalue when called on an rvalue, so that
+ *        they can be chained without copies
+ *
+ * @version 0.14
+ * 2026-10-14 - Raesangur
+ *      - Added `thread_pool` and the `stringvec_execution::seq` and `par` policies
+ *      - Added parallel overloads of the filtering, transforming, sorting and searching methods
+ *
+ * @version 0.15
+ * 2026-10-14 - Raesangur
+ *      - Added `read_file` overloads splitting the file into lines on several threads
+ *      - Lines are located with SSE2 when available
+ *
+ * @version 0.16
+ * 2026-10-14 - Raesangur
+ *      - Added `stream_pipeline`, applying `stringvec` operations to a stream chunk by chunk
+ *
+ * @version 0.17
+ * 2026-10-14 - Raesangur
+ *      - Added `string_arena`, now used as the owned storage of `stringview_vec`
+ *      - Added `stringview_vec::clear`
+ *
+ * @version 0.18
+ * 2026-10-14 - Raesangur
+ *      - `split` sizes its output up front and reuses the buffer of each string for its last token
+ *      - Added `split_any`, splitting on a set of single-character delimiters
+ *      - `split` no longer loops forever on an empty delimiter
+ *
+ * @version 0.19
+ * 2026-10-14 - Raesangur
+ *      - `trim` and `filter_empty` classify whitespace 16 or 32 bytes at a time with SSE2 or AVX2
+ *      - `filter_empty(false)` no longer goes through a regex, and now also removes empty strings
+ *      - `trim` now also removes form feeds, matching `std::isspace`
+ *
+ * @version 0.20
+ * 2026-10-14 - Raesangur
+ *      - Added an opt-in hash index (`build_index`), used by `find`, `rfind` and the new `contains`
+ *        on strings, and discarded by every modifying method
+ *
+ * @version 0.21
+ * 2026-10-14 - Raesangur
+ *      - Added `unique`, `merge_union`, `intersect` and `difference`, built on hash partitions
+ *        processed in parallel
+ *
+ * @version 0.22
+ * 2026-10-14 - Raesangur
+ *      - `sort_alphabetically` sorts through cached 8-byte prefixes, with an MSD radix pass when
+ *        parallel, and is now stable
+ *      - `sort_length` is now a stable counting sort, parallel when given a policy
+ *
+ * @version 0.23
+ * 2026-10-14 - Raesangur
+ *      - Tracked sort order, `sort_order`, with binary-search `find` and `rfind` while sorted
+ *      - Added `insert_sorted` and linear-time `merge`
+ *
+ * @version 0.24
+ * 2026-10-14 - Raesangur
+ *      - `write_file` gathers the strings into large blocks through `file_writer`, with `writev`
+ *        for large strings, and takes `write_options` for direct I/O and `fdatasync`
+ *      - `print` uses unformatted writes
+ *      - Fixed `write_file` with a `'\0'` separator writing no separator
+ *
+ * @version 0.25
+ * 2026-10-14 - Raesangur
+ *      - Added `lazy_pipeline`, created by `pipeline()`, fusing filter, transform, trim and split
+ *        stages into a single pass ending in `collect`, `write_to` or `for_each`
+ *
+ * @version 0.26
+ * 2026-10-14 - Raesangur
+ *      - `remove_first` and `remove_last` take a count, removed in a single shift
+ *      - Added `remove_range` and `remove_indices`, compacting in one pass
+ *      - Fixed `stringvec::remove_last` erasing at `end()`, and `remove_first` on empty vectors
+ *      - `remove_first` of the pipelines takes a count
+ *
+ * @version 0.27
+ * 2026-10-14 - Raesangur
+ *      - Added `stringvec_stats`, per-operation call, time, element, allocation and regex
+ *        compilation counters enabled by `STRINGVEC_STATS`, with JSON and Prometheus output
+ *
+ * @version 0.28
+ * 2026-10-14 - Raesangur
+ *      - Added `read_file_async`, `read_files_async` and `write_file_async`, returning futures,
+ *        double-buffered through `async_io`: io_uring on Linux, a thread per operation otherwise
+ *
+ * @version 0.29
+ * 2026-10-14 - Raesangur
+ *      - Added `save_snapshot` and `load_snapshot`, a binary format of offsets and one blob loaded
+ *        by mapping the file, keeping the sort order and hash index of `stringvec`
+ *
+ * @version 0.30
+ * 2026-10-14 - Raesangur
+ *      - `read_file` decompresses gzip, zstd and lz4 files, recognized by their magic bytes, block
+ *        by block into the line splitter; `write_file` compresses from the extension or
+ *        `write_options::codec`, zstd on several threads
+ *      - Codecs are enabled by `STRINGVEC_USE_ZLIB`, `STRINGVEC_USE_ZSTD` and `STRINGVEC_USE_LZ4`
+ *
+ * @version 0.31
+ * 2026-10-14 - Raesangur
+ *      - Added `pattern_set`, matching many substrings with one Aho-Corasick automaton and many
+ *        regexes merged into one DFA, with `filter_remove_any`, `filter_keep_any` and `find_any`
+ *
+ * @version 0.32
+ * 2026-10-14 - Raesangur
+ *      - Added `build_search_index`, a segmented suffix array answering `find_all_containing` and
+ *        `find_all_with_prefix`, kept up to date through `read_file` and the `remove_*` methods
+ *
+ * @version 0.33
+ * 2026-10-14 - Raesangur
+ *      - Added `find_all`, `find_all_reg`, `count_if`, `count_reg` and `partition_by`, returning
+ *        positions from a single pass, with parallel overloads on `stringvec`
+ *
+ * @version 0.34
+ * 2026-10-14 - Raesangur
+ *      - Added `to_lower`, `to_upper` and `casefold_utf8`, converting in place with SSE2 for ASCII,
+ *        `validate_utf8`, and `find_icase`, `filter_keep_icase` and `filter_remove_icase`
+ *
+ * @version 0.35
+ * 2026-10-14 - Raesangur
+ *      - Added `file_follower` and `stringvec::follow`, reading the lines appended to a file
+ *        through a `stream_pipeline`, across rotations and truncations, woken by inotify on Linux
+ *      - Added `append`, keeping the suffix array of the vector
+ *
+ * @version 0.36
+ * 2026-10-14 - Raesangur
+ *      - Added `column_table` and `split_columns`, splitting lines into one array of views per
+ *        field, with `filter_keep`, `filter_remove` and `sort_by` on a column, and `select`
+ *
  * ------------------------------------------------------------------------------------------------
  * @code
  * // Example usage:
@@ -120,615 +279,13826 @@
  *  INCLUDES
  */
 #include <algorithm>
+#include <array>
+#include <atomic>
+#include <bit>
+#include <bitset>
+#include <cctype>
+#include <chrono>
+#include <cerrno>
+#include <concepts>
+#include <condition_variable>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <deque>
+#include <exception>
 #include <fstream>
 #include <functional>
+#include <future>
 #include <iostream>
+#include <limits>
+#include <list>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <numeric>
+#include <optional>
 #include <regex>
+#include <span>
+#include <stdexcept>
 #include <string>
+#include <string_view>
+#include <system_error>
+#include <thread>
+#include <tuple>
 #include <type_traits>
+#include <unordered_map>
+#include <utility>
 #include <vector>
 
+#if __has_include(<sys/mman.h>) && __has_include(<unistd.h>)
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <sys/uio.h>
+#include <unistd.h>
+#define STRINGVEC_HAS_MMAP 1
+#else
+#define STRINGVEC_HAS_MMAP 0
+#endif
 
-/** ===============================================================================================
- *  CLASS DEFINITION
- *
- * @defgroup STRINGVEC_CLASS_DEF                 Class Definition
- * @{
- */
-
-/** -----------------------------------------------------------------------------------------------
- * @class   stringvec
- *
- * @brief   Vector of string utility class.
- */
-class stringvec
-{
-public:
-    using iter   = std::vector<std::string>::iterator;
-    using riter  = std::vector<std::string>::reverse_iterator;
-    using citer  = std::vector<std::string>::const_iterator;
-    using criter = std::vector<std::string>::const_reverse_iterator;
-
-    // Constructors / Destructors
-    ~stringvec()                 = default;
-    stringvec()                  = default;
-    stringvec(const stringvec&)  = default;
-    stringvec(const stringvec&&) = delete;
-    stringvec(const std::vector<std::string>& orig) : vec{orig} {};
-    stringvec(const std::initializer_list<std::string>&& orig) : vec{orig} {};
-
-    // Input / Output
-    inline void read_file (const std::string& path);
-    inline void write_file(const std::string& path, const std::string_view sep) const;
-    inline void write_file(const std::string& path, char sep = '\n') const;
-
-    inline void print(std::ostream& os = std::cout,
-                      const std::string_view sep = "\n",
-                      bool keep_last_sep = true) const;
-
-    // Filtering
-    inline void filter_remove(const std::function<bool(const std::string)> func);
-    inline void filter_remove(const std::string& regex);
-    inline void filter_keep  (const std::function<bool(const std::string)> func);
-    inline void filter_keep  (const std::string& regex);
-    inline void filter_empty (bool keep_whitespace = false);
-
-    inline void remove_first();
-    inline void remove_last();
-    inline void remove_nth(std::size_t pos);
-
-    // Transforming
-    inline void transform(const std::function<std::string(const std::string)> func);
-    inline void trim();
-    inline void split(const std::string_view delimiter = " ");
-
-    // Ordering
-    inline void reverse();
-    inline void sort(const std::function<bool(const std::string_view,
-                                              const std::string_view)> func);
-    inline void sort_alphabetically();
-    inline void sort_length();
+#ifndef STRINGVEC_HAS_IO_URING
+#if STRINGVEC_HAS_MMAP && defined(__linux__) && __has_include(<linux/io_uring.h>) && __has_include(<sys/syscall.h>)
+#include <linux/io_uring.h>
+#include <sys/syscall.h>
+#define STRINGVEC_HAS_IO_URING 1
+#else
+#define STRINGVEC_HAS_IO_URING 0
+#endif
+#endif
 
-    // Searching
-    inline  iter find     (const std::function<bool(const std::string&)> func);
-    inline citer find     (const std::function<bool(const std::string&)> func) const;
-    inline  iter rfind    (const std::function<bool(const std::string&)> func);
-    inline citer rfind    (const std::function<bool(const std::string&)> func) const;
-    inline  iter find     (const std::string_view s);
-    inline citer find     (const std::string_view s) const;
-    inline  iter rfind    (const std::string_view s);
-    inline citer rfind    (const std::string_view s) const;
-    inline  iter find_reg (const std::string& regex);
-    inline citer find_reg (const std::string& regex) const;
-    inline  iter rfind_reg(const std::string& regex);
-    inline citer rfind_reg(const std::string& regex) const;
- 
-    // Accessing
-    inline std::vector<std::string>&       get();
-    inline const std::vector<std::string>& get() const;
+#ifndef STRINGVEC_HAS_INOTIFY
+#if STRINGVEC_HAS_MMAP && defined(__linux__) && __has_include(<sys/inotify.h>) && __has_include(<poll.h>)
+#include <poll.h>
+#include <sys/inotify.h>
+#define STRINGVEC_HAS_INOTIFY 1
+#else
+#define STRINGVEC_HAS_INOTIFY 0
+#endif
+#endif
 
-    inline iter  begin();
-    inline citer begin() const;
-    inline citer cbegin() const;
-    inline iter  end();
-    inline citer end() const;
-    inline citer cend() const;
+#if defined(__SSE2__) || defined(_M_X64)
+#include <emmintrin.h>
+#define STRINGVEC_HAS_SSE2 1
+#else
+#define STRINGVEC_HAS_SSE2 0
+#endif
 
-    inline       std::string& operator[](std::size_t index);
-    inline const std::string& operator[](std::size_t index) const;
+#if defined(__AVX2__)
+#include <immintrin.h>
+#define STRINGVEC_HAS_AVX2 1
+#else
+#define STRINGVEC_HAS_AVX2 0
+#endif
 
-    // Comparison
-    inline bool operator== (const stringvec& other) const;
-    inline bool operator!= (const stringvec& other) const;
-    inline std::strong_ordering operator<=>(const stringvec& other) const;
+#ifdef STRINGVEC_USE_RE2
+#include <re2/re2.h>
+#endif
 
+#ifdef STRINGVEC_USE_ZLIB
+#include <zlib.h>
+#endif
 
-private:
-    std::vector<std::string> vec;
-};
+#ifdef STRINGVEC_USE_ZSTD
+#include <zstd.h>
+#endif
 
-/**
- * @}
- */
+#ifdef STRINGVEC_USE_LZ4
+#include <lz4frame.h>
+#endif
 
+#ifndef STRINGVEC_STATS
+#define STRINGVEC_STATS 0
+#endif
 
 
 /** ===============================================================================================
- *  METHOD DEFINITIONS
+ *  STATISTICS
  *
- * @defgroup STRINGVEC_METHOD_DEF                 Method Definitions
+ * @defgroup STRINGVEC_STATISTICS               Statistics
  * @{
  */
 
-
 /** -----------------------------------------------------------------------------------------------
- * @brief Read a file line by line, pushing each line into the vector of string.
- * @param path: File to read the lines from.
+ * @class   stringvec_stats
+ *
+ * @brief   Process-wide, thread-safe counters of the `stringvec` operations.
+ *
+ * @details The counters are only updated when compiling with `STRINGVEC_STATS` defined to a
+ *          non-zero value. Otherwise the instrumentation compiles to nothing, and every snapshot
+ *          is zero. When an operation calls another one, the whole call is counted once, for the
+ *          outermost operation. Measuring the allocated bytes walks the strings before and after
+ *          each call, outside of the timed region.
+ *
+ * @example
+ *      stringvec::stats().to_prometheus();   // Text exposition format
+ *      stringvec::stats().to_json();         // {"regex_compilations":1,"operations":{...}}
  */
-inline void stringvec::read_file(const std::string& path)
+class stringvec_stats
 {
-    /* Check if file is valid and open it. */
-    std::ifstream input(path);
-    if(!input)
+public:
+    enum class operation : std::size_t
     {
-        throw std::runtime_error("Couldn't open file: " + path);
-    }
+        read_file,
+        write_file,
+        filter_remove,
+        filter_keep,
+        filter_empty,
+        remove_first,
+        remove_last,
+        remove_nth,
+        remove_range,
+        remove_indices,
+        transform,
+        transform_inplace,
+        trim,
+        split,
+        split_any,
+        reverse,
+        sort,
+        sort_alphabetically,
+        sort_length,
+        insert_sorted,
+        merge,
+        append,
+        unique,
+        merge_union,
+        intersect,
+        difference,
+        find,
+        rfind,
+        find_reg,
+        rfind_reg,
+        build_index,
+        validate_utf8,
+        count,
+    };
 
-    /* Read all lines of file into the vector. */
-    std::string line;
-    while(std::getline(input, line))
+    static constexpr std::size_t operation_count = static_cast<std::size_t>(operation::count);
+
+    struct counters
     {
-        vec.push_back(line);
-    }
-}
+        std::uint64_t calls           = 0;
+        std::uint64_t nanoseconds     = 0;
+        std::uint64_t elements_in     = 0;
+        std::uint64_t elements_out    = 0;
+        std::uint64_t bytes_allocated = 0;
+    };
 
-/** -----------------------------------------------------------------------------------------------
- * @brief Write to a file every string from the vector, separated by a specified string.
- * @param path: File to write the strings to.
- * @param sep:  Separator string between the strings in the vector when writing back to file.
- */
-inline void stringvec::write_file(const std::string& path, const std::string_view sep) const
-{
-    /* Check if file is valid and open it. */
-    std::ofstream output(path);
-    if (!output)
+    struct snapshot
     {
-        throw std::runtime_error("Couldn't write to file: " + path);
-    }
+        std::array<counters, operation_count> operations{};
+        std::uint64_t                         regex_compilations = 0;
 
-    print(output, sep, false);
-}
+        inline const counters& operator[](operation op) const;
+        inline std::string     to_json() const;
+        inline std::string     to_prometheus() const;
+    };
 
-inline void stringvec::write_file(const std::string& path, char sep) const
+    inline static std::string_view name(operation op);
+    inline static snapshot         get();
+    inline static void             reset();
+    inline static void             record(operation op, const counters& c);
+    inline static void             record_regex_compilation();
+
+private:
+    struct atomic_counters
+    {
+        std::atomic<std::uint64_t> calls{0};
+        std::atomic<std::uint64_t> nanoseconds{0};
+        std::atomic<std::uint64_t> elements_in{0};
+        std::atomic<std::uint64_t> elements_out{0};
+        std::atomic<std::uint64_t> bytes_allocated{0};
+    };
+
+    struct table
+    {
+        std::array<atomic_counters, operation_count> operations;
+        std::atomic<std::uint64_t>                   regex_compilations{0};
+    };
+
+    inline static table& global();
+};
+
+/** -----------------------------------------------------------------------------------------------
+ * @brief Get the counters of an operation.
+ */
+inline const stringvec_stats::counters& stringvec_stats::snapshot::operator[](operation op) const
 {
-    char separator[2] = {sep, '\0'};
-    return write_file(path, separator);
+    return operations[static_cast<std::size_t>(op)];
 }
 
 /** -----------------------------------------------------------------------------------------------
- * @brief Print the vector of strings line by line, then flush the output buffer.
+ * @brief Format the counters as a JSON object, listing only the operations called at least once.
  */
-inline void stringvec::print(std::ostream& os,
-                             const std::string_view sep,
-                             bool keep_last_sep) const
+inline std::string stringvec_stats::snapshot::to_json() const
 {
-    /* Write all strings of vector into file. */
-    for(citer it = begin(); it < end(); it++)
+    std::string out = "{\"regex_compilations\":" + std::to_string(regex_compilations) + ",\"operations\":{";
+    bool        first = true;
+    for (std::size_t i = 0; i < operation_count; i++)
     {
-        os << *it;
-        if ((it != end() - 1) || keep_last_sep == true)
+        const counters& c = operations[i];
+        if (c.calls == 0)
         {
-            os << sep;
+            continue;
         }
-    }
-    os.flush();
-}
 
+        out += first ? "\"" : ",\"";
+        out += name(static_cast<operation>(i));
+        out += "\":{\"calls\":" + std::to_string(c.calls) +
+               ",\"nanoseconds\":" + std::to_string(c.nanoseconds) +
+               ",\"elements_in\":" + std::to_string(c.elements_in) +
+               ",\"elements_out\":" + std::to_string(c.elements_out) +
+               ",\"bytes_allocated\":" + std::to_string(c.bytes_allocated) + "}";
+        first = false;
+    }
+    out += "}}";
 
-/** -----------------------------------------------------------------------------------------------
- * @brief Check all strings against a provided func, remove all strings that match.
- * @param func: Function object to check against
- */
-inline void stringvec::filter_remove(const std::function<bool(const std::string)> func)
-{
-    vec.erase(std::remove_if(vec.begin(), vec.end(), func),
-              vec.end());
+    return out;
 }
 
 /** -----------------------------------------------------------------------------------------------
- * @brief Check all strings against a provided regex, remove all strings that match the regex.
- * @param regex: Regular Expression to check against.
+ * @brief Format the counters in the Prometheus text exposition format.
+ *
+ * @details Each counter is a `stringvec_*_total` metric labelled by operation. Only the operations
+ *          called at least once are listed.
  */
-inline void stringvec::filter_remove(const std::string& regex)
+inline std::string stringvec_stats::snapshot::to_prometheus() const
 {
-    try
+    struct metric
     {
-        std::regex reg{regex};
+        std::string_view name;
+        std::string_view help;
+        std::uint64_t counters::*field;
+    };
+    static constexpr metric metrics[] = {
+      {"stringvec_calls_total",           "Number of calls.",                      &counters::calls},
+      {"stringvec_nanoseconds_total",     "Wall time spent, in nanoseconds.",      &counters::nanoseconds},
+      {"stringvec_elements_in_total",     "Elements before the calls.",            &counters::elements_in},
+      {"stringvec_elements_out_total",    "Elements after the calls.",             &counters::elements_out},
+      {"stringvec_bytes_allocated_total", "Bytes of heap storage added by calls.", &counters::bytes_allocated},
+    };
 
-        filter_remove([&reg](const std::string& s)
-                    {
-                        return std::regex_match(s, reg);
-                    });
-    }
-    catch (const std::regex_error& e)
+    std::string out;
+    for (const metric& m : metrics)
     {
-        std::cerr << "Error: Invalid regex pattern '" << regex << "'. "
-                  << "Details: " << e.what() << std::endl;
-
-        return end();
+        out += "# HELP " + std::string{m.name} + " " + std::string{m.help} + "\n";
+        out += "# TYPE " + std::string{m.name} + " counter\n";
+        for (std::size_t i = 0; i < operation_count; i++)
+        {
+            if (operations[i].calls == 0)
+            {
+                continue;
+            }
+            out += std::string{m.name} + "{operation=\"" + std::string{name(static_cast<operation>(i))} + "\"} " +
+                   std::to_string(operations[i].*m.field) + "\n";
+        }
     }
+    out += "# HELP stringvec_regex_compilations_total Number of regexes compiled.\n";
+    out += "# TYPE stringvec_regex_compilations_total counter\n";
+    out += "stringvec_regex_compilations_total " + std::to_string(regex_compilations) + "\n";
+
+    return out;
 }
 
 /** -----------------------------------------------------------------------------------------------
- * @brief Check all strings against a provided func, keep only strings that match.
- * @param func: Function object to check against
+ * @brief Get the name of an operation, which is the name of the `stringvec` method.
  */
-inline void stringvec::filter_keep(const std::function<bool(const std::string)> func)
+inline std::string_view stringvec_stats::name(operation op)
 {
-    vec.erase(std::remove_if(vec.begin(), vec.end(), [func](const std::string& s)
-                                                     {
-                                                         return !func(s);
-                                                     }),
-              vec.end());
+    static constexpr std::string_view names[] = {
+      "read_file",
+      "write_file",
+      "filter_remove",
+      "filter_keep",
+      "filter_empty",
+      "remove_first",
+      "remove_last",
+      "remove_nth",
+      "remove_range",
+      "remove_indices",
+      "transform",
+      "transform_inplace",
+      "trim",
+      "split",
+      "split_any",
+      "reverse",
+      "sort",
+      "sort_alphabetically",
+      "sort_length",
+      "insert_sorted",
+      "merge",
+      "append",
+      "unique",
+      "merge_union",
+      "intersect",
+      "difference",
+      "find",
+      "rfind",
+      "find_reg",
+      "rfind_reg",
+      "build_index",
+      "validate_utf8",
+    };
+    static_assert(std::size(names) == operation_count);
+
+    return names[static_cast<std::size_t>(op)];
 }
 
 /** -----------------------------------------------------------------------------------------------
- * @brief Check all strings against a provided regex, keep only strings that match the regex.
- * @param regex: Regular Expression to check against.
+ * @brief Get a snapshot of every counter.
  */
-inline void stringvec::filter_keep(const std::string& regex)
+inline stringvec_stats::snapshot stringvec_stats::get()
 {
-    try
+    table&   t = global();
+    snapshot s;
+    for (std::size_t i = 0; i < operation_count; i++)
     {
-        std::regex reg{regex};
-
-        filter_keep([&reg](const std::string& s)
-                    {
-                        return std::regex_match(s, reg);
-                    });
+        s.operations[i].calls           = t.operations[i].calls.load(std::memory_order_relaxed);
+        s.operations[i].nanoseconds     = t.operations[i].nanoseconds.load(std::memory_order_relaxed);
+        s.operations[i].elements_in     = t.operations[i].elements_in.load(std::memory_order_relaxed);
+        s.operations[i].elements_out    = t.operations[i].elements_out.load(std::memory_order_relaxed);
+        s.operations[i].bytes_allocated = t.operations[i].bytes_allocated.load(std::memory_order_relaxed);
     }
-    catch (const std::regex_error& e)
-    {
-        std::cerr << "Error: Invalid regex pattern '" << regex << "'. "
-                  << "Details: " << e.what() << std::endl;
+    s.regex_compilations = t.regex_compilations.load(std::memory_order_relaxed);
 
-        return end();
-    }
+    return s;
 }
 
-/** -----------------------------------------------------------------------------------------------
- * @brief Remove all empty strings from the vector.
- * @param keep_whitespace: If true, keep strings containing only whitespace.
- */
-inline void stringvec::filter_empty(bool keep_whitespace)
+inline void stringvec_stats::reset()
 {
-    if (keep_whitespace)
-    {
-        filter_remove([](const std::string& s)
-                      {
-                          return s.empty();
-                      });
-    }
-    else
+    table& t = global();
+    for (atomic_counters& c : t.operations)
     {
-        filter_remove("^\\s+$");
+        c.calls.store(0, std::memory_order_relaxed);
+        c.nanoseconds.store(0, std::memory_order_relaxed);
+        c.elements_in.store(0, std::memory_order_relaxed);
+        c.elements_out.store(0, std::memory_order_relaxed);
+        c.bytes_allocated.store(0, std::memory_order_relaxed);
     }
+    t.regex_compilations.store(0, std::memory_order_relaxed);
 }
 
-
 /** -----------------------------------------------------------------------------------------------
- * @brief Remove first element from the vector.
+ * @brief Add the counters of a call to the totals of its operation.
  */
-inline void stringvec::remove_first()
+inline void stringvec_stats::record(operation op, const counters& c)
 {
-    vec.erase(begin());
+    atomic_counters& t = global().operations[static_cast<std::size_t>(op)];
+    t.calls.fetch_add(c.calls, std::memory_order_relaxed);
+    t.nanoseconds.fetch_add(c.nanoseconds, std::memory_order_relaxed);
+    t.elements_in.fetch_add(c.elements_in, std::memory_order_relaxed);
+    t.elements_out.fetch_add(c.elements_out, std::memory_order_relaxed);
+    t.bytes_allocated.fetch_add(c.bytes_allocated, std::memory_order_relaxed);
 }
 
-/** -----------------------------------------------------------------------------------------------
- * @brief Remove last element from the vector.
- */
-inline void stringvec::remove_last()
+inline void stringvec_stats::record_regex_compilation()
 {
-    vec.erase(end());
+    global().regex_compilations.fetch_add(1, std::memory_order_relaxed);
 }
 
-/** -----------------------------------------------------------------------------------------------
- * @brief Remove an element from the vector from its index.
- */
-inline void stringvec::remove_nth(std::size_t pos)
+inline stringvec_stats::table& stringvec_stats::global()
 {
-    if (begin() + pos >= end())
-        return;
-
-    vec.erase(begin() + pos);
+    static table t;
+    return t;
 }
 
+namespace stringvec_detail
+{
 
+#if STRINGVEC_STATS
 /** -----------------------------------------------------------------------------------------------
- * @brief Apply a function to all the elements of the vector
- * @param func: Function to apply
+ * @brief Scope recording one call of an operation on a vector of strings, unless it is nested in
+ *        another recorded call of the same thread.
  */
-inline void stringvec::transform(const std::function<std::string(const std::string)> func)
+class stat_scope
 {
-    std::for_each(begin(), end(), [func](std::string& s) {
-        s = func(s);
-    });
+public:
+    inline stat_scope(stringvec_stats::operation op, const std::vector<std::string>& v);
+    inline ~stat_scope();
+
+    stat_scope(const stat_scope&)            = delete;
+    stat_scope& operator=(const stat_scope&) = delete;
+
+private:
+    inline static std::size_t&  depth();
+    inline static std::uint64_t heap_bytes(const std::vector<std::string>& v);
+
+    stringvec_stats::operation                     op;
+    const std::vector<std::string>&                v;
+    bool                                           outermost;
+    std::uint64_t                                  elements_in = 0;
+    std::uint64_t                                  bytes_in    = 0;
+    std::chrono::steady_clock::time_point          start;
+};
+
+inline stat_scope::stat_scope(stringvec_stats::operation op, const std::vector<std::string>& v)
+    : op{op}, v{v}, outermost{depth()++ == 0}
+{
+    if (outermost)
+    {
+        elements_in = v.size();
+        bytes_in    = heap_bytes(v);
+        start       = std::chrono::steady_clock::now();
+    }
 }
 
-/** -----------------------------------------------------------------------------------------------
- * @brief Trim trailing and leading whitespace from all strings in the vector, including newlines.
- */
-inline void stringvec::trim()
+inline stat_scope::~stat_scope()
 {
-    transform([](const std::string s){
-        // https://cplusplus.com/forum/beginner/251052/
-        constexpr std::string_view whitespace = " \t\v\r\n";
+    depth()--;
+    if (!outermost)
+    {
+        return;
+    }
 
-        std::size_t start = s.find_first_not_of(whitespace);
-        std::size_t end = s.find_last_not_of(whitespace);
+    const auto                elapsed   = std::chrono::steady_clock::now() - start;
+    const std::uint64_t       bytes_out = heap_bytes(v);
+    stringvec_stats::counters c;
+    c.calls           = 1;
+    c.nanoseconds     = static_cast<std::uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(elapsed).count());
+    c.elements_in     = elements_in;
+    c.elements_out    = v.size();
+    c.bytes_allocated = bytes_out > bytes_in ? bytes_out - bytes_in : 0;
+    stringvec_stats::record(op, c);
+}
 
-        return start == end ? std::string() : s.substr(start, end - start + 1);
-    });
-    
+inline std::size_t& stat_scope::depth()
+{
+    thread_local std::size_t d = 0;
+    return d;
 }
 
 /** -----------------------------------------------------------------------------------------------
- * @brief Split all strings in-place with a specified delimiter string.
- *
- * @param delimiter: String to use as a separation point for the string.
- * 
- * @details The delimiter string is removed from each split.
+ * @brief Heap bytes held by a vector of strings, not counting the strings stored inline.
  */
-inline void stringvec::split(const std::string_view delimiter)
+inline std::uint64_t stat_scope::heap_bytes(const std::vector<std::string>& v)
 {
-    const std::size_t delimiterLength = delimiter.length();
-    std::vector<std::string> newStrings;
-    for (const std::string& s : *this)
+    std::uint64_t bytes = v.capacity() * sizeof(std::string);
+    for (const std::string& s : v)
     {
-        // https://stackoverflow.com/a/46931770
-        std::size_t start = 0;
-        std::size_t end;
-
-        while ((end = s.find(delimiter, start)) != std::string::npos)
+        const char* object = reinterpret_cast<const char*>(&s);
+        if (s.data() < object || s.data() >= object + sizeof(std::string))
         {
-            newStrings.emplace_back(s, start, end - start);
-            start = end + delimiterLength;
+            bytes += s.capacity() + 1;
         }
-        newStrings.emplace_back(s, start);
     }
-
-    vec = std::move(newStrings);
+    return bytes;
 }
 
+#define STRINGVEC_STAT(op) \
+    const stringvec_detail::stat_scope stringvec_stat_scope{stringvec_stats::operation::op, vec}
+#else
+#define STRINGVEC_STAT(op) static_cast<void>(0)
+#endif
 
-/** -----------------------------------------------------------------------------------------------
- * @brief Reverse the order of the vector's elements.
+}        // namespace stringvec_detail
+
+/**
+ * @}
  */
-inline void stringvec::reverse()
-{
-    std::reverse(begin(), end());
-}
 
-/** -----------------------------------------------------------------------------------------------
+
+
+/** ===============================================================================================
+ *  REGEX ENGINES
+ *
+ * @defgroup STRINGVEC_REGEX_ENGINES            Regex Engines
+ * @{
+ */
+
+/** -----------------------------------------------------------------------------------------------
+ * @enum    regex_engine
+ *
+ * @brief   Engine used by a `compiled_regex` to match strings.
+ */
+enum class regex_engine
+{
+    automatic,        ///< Literal fast paths, then the DFA, then `std::regex` for unsupported syntax
+    std_regex,        ///< Always use `std::regex`
+    dfa,              ///< Linear-time DFA, throws `std::regex_error` on unsupported syntax
+    re2,              ///< RE2, only available when compiled with `STRINGVEC_USE_RE2`
+};
+
+#ifndef STRINGVEC_DEFAULT_REGEX_ENGINE
+#define STRINGVEC_DEFAULT_REGEX_ENGINE regex_engine::automatic
+#endif
+
+
+namespace stringvec_detail
+{
+
+using byte_set = std::bitset<256>;
+
+/** -----------------------------------------------------------------------------------------------
+ * @brief   Node of the syntax tree built by `regex_parser`.
+ */
+struct regex_node
+{
+    enum kind_t : std::uint8_t
+    {
+        empty,
+        chars,
+        concat,
+        alternate,
+        repeat,
+    };
+
+    static constexpr std::size_t unbounded = std::numeric_limits<std::size_t>::max();
+
+    kind_t                  kind = empty;
+    byte_set                set;
+    std::vector<regex_node> children;
+    std::size_t             min  = 0;
+    std::size_t             max  = 0;
+};
+
+/** -----------------------------------------------------------------------------------------------
+ * @class   regex_parser
+ *
+ * @brief   Parser for the subset of the ECMAScript grammar that can be matched by a DFA.
+ *
+ * @details Anything outside of that subset (back-references, assertions, word boundaries, POSIX
+ *          classes, as well as every construct `std::regex` would reject) makes `parse` return
+ *          nothing, so that the caller can hand the pattern to `std::regex` instead.
+ *          The parsed tree has full-match semantics: `^` and `$` are only accepted at the very
+ *          start and end of the pattern, where they have no effect.
+ */
+class regex_parser
+{
+public:
+    inline regex_parser(const std::string_view pattern, bool icase);
+
+    inline std::optional<regex_node> parse();
+
+private:
+    struct unsupported
+    {
+    };
+
+    inline regex_node parse_alternate();
+    inline regex_node parse_concat();
+    inline regex_node parse_atom();
+    inline void       parse_quantifier(regex_node& atom);
+    inline byte_set   parse_class();
+    inline byte_set   parse_escape(bool in_class);
+    inline unsigned char escaped_char(bool in_class);
+    inline std::size_t parse_number();
+
+    inline byte_set   literal(unsigned char c) const;
+
+    std::string_view pat;
+    std::size_t      pos   = 0;
+    std::size_t      depth = 0;
+    bool             icase;
+};
+
+/** -----------------------------------------------------------------------------------------------
+ * @class   regex_dfa
+ *
+ * @brief   Automaton matching whole strings in linear time, built from a `regex_node` tree.
+ *
+ * @details The tree is first compiled to a Thompson NFA, which is then determinized eagerly over
+ *          byte equivalence classes. If the DFA would exceed `max_dfa_states`, matching falls back
+ *          to a simulation of the NFA, which is slower but still linear in the input length.
+ *          The automaton is immutable once built, and can be shared between threads.
+ */
+class regex_dfa
+{
+public:
+    static constexpr std::size_t max_nfa_states = 1 << 16;
+    static constexpr std::size_t max_dfa_states = 4096;
+
+    inline static std::unique_ptr<regex_dfa> compile(const regex_node& root);
+
+    inline bool match(const std::string_view s) const;
+
+private:
+    struct nfa_state
+    {
+        int set  = -1;        ///< Index in `sets`, -1 for an epsilon state
+        int out  = -1;
+        int out1 = -1;
+    };
+
+    inline int                 add_state(int set = -1);
+    inline std::pair<int, int> build(const regex_node& node);
+    inline void                closure(std::vector<int>& states, std::vector<std::uint32_t>& marks,
+                                       std::uint32_t generation) const;
+    inline bool                determinize();
+    inline bool                simulate(const std::string_view s) const;
+
+    std::vector<nfa_state> nfa;
+    std::vector<byte_set>  sets;
+    int                    start  = -1;
+    int                    accept = -1;
+
+    std::array<std::uint16_t, 256> classes{};
+    std::size_t                    class_count = 1;
+    std::vector<std::int32_t>      table;
+    std::vector<bool>              accepting;
+    std::int32_t                   dead = -1;
+};
+
+
+/** -----------------------------------------------------------------------------------------------
+ * @brief Prepare the parsing of a pattern.
+ * @param pattern: ECMAScript regex to parse.
+ * @param icase:   If true, ASCII letters match regardless of their case.
+ */
+inline regex_parser::regex_parser(const std::string_view pattern, bool icase)
+: pat{pattern}, icase{icase}
+{
+}
+
+/** -----------------------------------------------------------------------------------------------
+ * @brief Parse the whole pattern.
+ * @return The syntax tree, or nothing if the pattern is outside of the supported subset.
+ */
+inline std::optional<regex_node> regex_parser::parse()
+{
+    try
+    {
+        if (pat.starts_with('^'))
+        {
+            pos++;
+        }
+
+        regex_node root = parse_alternate();
+        if (pos != pat.size())
+        {
+            throw unsupported{};
+        }
+        return root;
+    }
+    catch (const unsupported&)
+    {
+        return std::nullopt;
+    }
+}
+
+inline regex_node regex_parser::parse_alternate()
+{
+    regex_node first = parse_concat();
+    if (pos == pat.size() || pat[pos] != '|')
+    {
+        return first;
+    }
+
+    regex_node alt;
+    alt.kind = regex_node::alternate;
+    alt.children.push_back(std::move(first));
+    while (pos < pat.size() && pat[pos] == '|')
+    {
+        pos++;
+        alt.children.push_back(parse_concat());
+    }
+    return alt;
+}
+
+inline regex_node regex_parser::parse_concat()
+{
+    regex_node cat;
+    cat.kind = regex_node::concat;
+
+    while (pos < pat.size() && pat[pos] != '|' && pat[pos] != ')')
+    {
+        if (pat[pos] == '$' && pos == pat.size() - 1 && depth == 0)
+        {
+            pos++;
+            break;
+        }
+
+        regex_node atom = parse_atom();
+        parse_quantifier(atom);
+        cat.children.push_back(std::move(atom));
+    }
+
+    if (cat.children.size() == 1)
+    {
+        return std::move(cat.children.front());
+    }
+    return cat;
+}
+
+inline regex_node regex_parser::parse_atom()
+{
+    regex_node atom;
+    atom.kind = regex_node::chars;
+
+    const char c = pat[pos++];
+    switch (c)
+    {
+        case '(':
+            if (pat.substr(pos).starts_with("?:"))
+            {
+                pos += 2;
+            }
+            else if (pos < pat.size() && pat[pos] == '?')
+            {
+                throw unsupported{};
+            }
+
+            depth++;
+            atom = parse_alternate();
+            depth--;
+            if (pos == pat.size() || pat[pos] != ')')
+            {
+                throw unsupported{};
+            }
+            pos++;
+            return atom;
+
+        case '[':
+            atom.set = parse_class();
+            return atom;
+
+        case '.':
+            atom.set.set();
+            atom.set.reset('\n');
+            atom.set.reset('\r');
+            return atom;
+
+        case '\\':
+            atom.set = parse_escape(false);
+            return atom;
+
+        case '^':
+        case '$':
+        case ')':
+        case ']':
+        case '{':
+        case '}':
+        case '*':
+        case '+':
+        case '?':
+            throw unsupported{};
+
+        default:
+            atom.set = literal(static_cast<unsigned char>(c));
+            return atom;
+    }
+}
+
+inline void regex_parser::parse_quantifier(regex_node& atom)
+{
+    if (pos == pat.size())
+    {
+        return;
+    }
+
+    std::size_t min = 0;
+    std::size_t max = regex_node::unbounded;
+    switch (pat[pos])
+    {
+        case '*':
+            pos++;
+            break;
+
+        case '+':
+            pos++;
+            min = 1;
+            break;
+
+        case '?':
+            pos++;
+            max = 1;
+            break;
+
+        case '{':
+            pos++;
+            min = parse_number();
+            max = min;
+            if (pos < pat.size() && pat[pos] == ',')
+            {
+                pos++;
+                max = (pos < pat.size() && pat[pos] == '}') ? regex_node::unbounded
+                                                            : parse_number();
+            }
+            if (pos == pat.size() || pat[pos] != '}' || max < min)
+            {
+                throw unsupported{};
+            }
+            pos++;
+            break;
+
+        default:
+            return;
+    }
+
+    /* Laziness does not change whether a whole string matches. */
+    if (pos < pat.size() && pat[pos] == '?')
+    {
+        pos++;
+    }
+
+    if (pos < pat.size() && std::string_view{"*+?{"}.find(pat[pos]) != std::string_view::npos)
+    {
+        throw unsupported{};
+    }
+
+    regex_node rep;
+    rep.kind = regex_node::repeat;
+    rep.min  = min;
+    rep.max  = max;
+    rep.children.push_back(std::move(atom));
+    atom = std::move(rep);
+}
+
+inline byte_set regex_parser::parse_class()
+{
+    byte_set set;
+    bool     negate = false;
+
+    if (pos < pat.size() && pat[pos] == '^')
+    {
+        negate = true;
+        pos++;
+    }
+
+    /* `[]` and `[^]` behave differently between implementations. */
+    if (pos == pat.size() || pat[pos] == ']' || (negate && icase))
+    {
+        throw unsupported{};
+    }
+
+    const auto is_range = [this]()
+                          {
+                              return pos + 1 < pat.size() && pat[pos] == '-' && pat[pos + 1] != ']';
+                          };
+
+    while (pos < pat.size() && pat[pos] != ']')
+    {
+        unsigned char low;
+        if (pat[pos] == '\\')
+        {
+            pos++;
+            if (pos < pat.size() && std::string_view{"dDwWsS"}.find(pat[pos]) != std::string_view::npos)
+            {
+                set |= parse_escape(true);
+                if (is_range())
+                {
+                    throw unsupported{};
+                }
+                continue;
+            }
+            low = escaped_char(true);
+        }
+        else if (pat[pos] == '[')
+        {
+            /* POSIX classes such as `[[:alpha:]]`. */
+            throw unsupported{};
+        }
+        else
+        {
+            low = static_cast<unsigned char>(pat[pos++]);
+        }
+
+        if (!is_range())
+        {
+            set |= literal(low);
+            continue;
+        }
+
+        pos++;
+        if (pat[pos] == '\\' || pat[pos] == '[')
+        {
+            throw unsupported{};
+        }
+
+        const unsigned char high = static_cast<unsigned char>(pat[pos++]);
+        if (high < low)
+        {
+            throw unsupported{};
+        }
+        for (unsigned b = low; b <= high; b++)
+        {
+            set |= literal(static_cast<unsigned char>(b));
+        }
+    }
+
+    if (pos == pat.size())
+    {
+        throw unsupported{};
+    }
+    pos++;
+
+    return negate ? ~set : set;
+}
+
+inline byte_set regex_parser::parse_escape(bool in_class)
+{
+    if (pos == pat.size())
+    {
+        throw unsupported{};
+    }
+
+    byte_set   set;
+    const char c     = pat[pos];
+    const auto range = [&set](unsigned char lo, unsigned char hi)
+                       {
+                           for (unsigned b = lo; b <= hi; b++)
+                           {
+                               set.set(b);
+                           }
+                       };
+    switch (c)
+    {
+        case 'd':
+        case 'D':
+            pos++;
+            range('0', '9');
+            return c == 'd' ? set : ~set;
+
+        case 'w':
+        case 'W':
+            pos++;
+            range('0', '9');
+            range('a', 'z');
+            range('A', 'Z');
+            set.set('_');
+            return c == 'w' ? set : ~set;
+
+        case 's':
+        case 'S':
+            pos++;
+            for (const char ws : std::string_view{" \t\n\v\f\r"})
+            {
+                set.set(static_cast<unsigned char>(ws));
+            }
+            return c == 's' ? set : ~set;
+
+        default:
+            return literal(escaped_char(in_class));
+    }
+}
+
+inline unsigned char regex_parser::escaped_char(bool in_class)
+{
+    if (pos == pat.size())
+    {
+        throw unsupported{};
+    }
+
+    const unsigned char c = static_cast<unsigned char>(pat[pos++]);
+    switch (c)
+    {
+        case 't': return '\t';
+        case 'n': return '\n';
+        case 'r': return '\r';
+        case 'f': return '\f';
+        case 'v': return '\v';
+
+        default:
+            /* Only escaped punctuation is unambiguous, `\b` even means backspace in a class. */
+            if (std::isalnum(c) || c >= 0x80 || (in_class && c == '-'))
+            {
+                throw unsupported{};
+            }
+            return c;
+    }
+}
+
+inline std::size_t regex_parser::parse_number()
+{
+    const std::size_t begin = pos;
+    std::size_t       value = 0;
+    while (pos < pat.size() && std::isdigit(static_cast<unsigned char>(pat[pos])) && value < 10000)
+    {
+        value = value * 10 + (pat[pos++] - '0');
+    }
+
+    if (pos == begin || value >= 10000)
+    {
+        throw unsupported{};
+    }
+    return value;
+}
+
+inline byte_set regex_parser::literal(unsigned char c) const
+{
+    byte_set set;
+    set.set(c);
+    if (icase && std::isalpha(c) && c < 0x80)
+    {
+        set.set(static_cast<unsigned char>(c ^ 0x20));
+    }
+    return set;
+}
+
+
+/** -----------------------------------------------------------------------------------------------
+ * @brief Build the automaton of a syntax tree.
+ * @return The automaton, or nullptr if the tree expands to too many NFA states.
+ */
+inline std::unique_ptr<regex_dfa> regex_dfa::compile(const regex_node& root)
+{
+    auto dfa = std::unique_ptr<regex_dfa>(new regex_dfa);
+
+    try
+    {
+        auto [first, last] = dfa->build(root);
+        dfa->accept        = dfa->add_state();
+        dfa->nfa[last].out = dfa->accept;
+        dfa->start         = first;
+    }
+    catch (const std::length_error&)
+    {
+        return nullptr;
+    }
+
+    if (!dfa->determinize())
+    {
+        dfa->table.clear();
+        dfa->accepting.clear();
+    }
+
+    return dfa;
+}
+
+/** -----------------------------------------------------------------------------------------------
+ * @brief Check if a whole string is accepted by the automaton.
+ */
+inline bool regex_dfa::match(const std::string_view s) const
+{
+    if (table.empty())
+    {
+        return simulate(s);
+    }
+
+    std::int32_t state = 0;
+    for (const char c : s)
+    {
+        state = table[state * class_count + classes[static_cast<unsigned char>(c)]];
+        if (state == dead)
+        {
+            return false;
+        }
+    }
+    return accepting[state];
+}
+
+inline int regex_dfa::add_state(int set)
+{
+    if (nfa.size() >= max_nfa_states)
+    {
+        throw std::length_error("regex_dfa: too many states");
+    }
+
+    nfa.push_back(nfa_state{set, -1, -1});
+    return static_cast<int>(nfa.size() - 1);
+}
+
+/** -----------------------------------------------------------------------------------------------
+ * @brief Thompson construction of a node.
+ * @return First and last states of the fragment. The last state is an epsilon state whose `out`
+ *         is still free.
+ */
+inline std::pair<int, int> regex_dfa::build(const regex_node& node)
+{
+    switch (node.kind)
+    {
+        case regex_node::chars:
+        {
+            sets.push_back(node.set);
+            const int first = add_state(static_cast<int>(sets.size() - 1));
+            const int last  = add_state();
+            nfa[first].out  = last;
+            return {first, last};
+        }
+
+        case regex_node::concat:
+        {
+            if (node.children.empty())
+            {
+                const int state = add_state();
+                return {state, state};
+            }
+
+            auto [first, last] = build(node.children.front());
+            for (std::size_t i = 1; i < node.children.size(); i++)
+            {
+                auto [f, l]    = build(node.children[i]);
+                nfa[last].out = f;
+                last           = l;
+            }
+            return {first, last};
+        }
+
+        case regex_node::alternate:
+        {
+            const int last  = add_state();
+            int       first = -1;
+            for (auto it = node.children.rbegin(); it != node.children.rend(); it++)
+            {
+                auto [f, l]    = build(*it);
+                nfa[l].out     = last;
+                if (first == -1)
+                {
+                    first = f;
+                    continue;
+                }
+
+                const int branch = add_state();
+                nfa[branch].out  = f;
+                nfa[branch].out1 = first;
+                first            = branch;
+            }
+            return {first, last};
+        }
+
+        case regex_node::repeat:
+        {
+            const regex_node& child = node.children.front();
+            const int         first = add_state();
+            int               last  = first;
+
+            for (std::size_t i = 0; i < node.min; i++)
+            {
+                auto [f, l]    = build(child);
+                nfa[last].out = f;
+                last           = l;
+            }
+
+            if (node.max == regex_node::unbounded)
+            {
+                auto [f, l]    = build(child);
+                const int loop = add_state();
+                const int end  = add_state();
+                nfa[last].out  = loop;
+                nfa[loop].out  = f;
+                nfa[loop].out1 = end;
+                nfa[l].out     = loop;
+                return {first, end};
+            }
+
+            const int end = add_state();
+            for (std::size_t i = node.min; i < node.max; i++)
+            {
+                auto [f, l]      = build(child);
+                const int branch = add_state();
+                nfa[last].out    = branch;
+                nfa[branch].out  = f;
+                nfa[branch].out1 = end;
+                last             = l;
+            }
+            nfa[last].out = end;
+            return {first, end};
+        }
+
+        case regex_node::empty:
+        default:
+        {
+            const int state = add_state();
+            return {state, state};
+        }
+    }
+}
+
+/** -----------------------------------------------------------------------------------------------
+ * @brief Replace a list of states by the sorted list of non-epsilon states reachable from them.
+ * @param states:     States to expand, replaced by their closure.
+ * @param marks:      Scratch buffer, one entry per NFA state.
+ * @param generation: Value marking the states visited by this call, must differ between calls.
+ */
+inline void regex_dfa::closure(std::vector<int>& states,
+                               std::vector<std::uint32_t>& marks,
+                               std::uint32_t generation) const
+{
+    std::vector<int> stack = std::move(states);
+    states.clear();
+
+    while (!stack.empty())
+    {
+        const int s = stack.back();
+        stack.pop_back();
+        if (s < 0 || marks[s] == generation)
+        {
+            continue;
+        }
+        marks[s] = generation;
+
+        if (nfa[s].set >= 0 || s == accept)
+        {
+            states.push_back(s);
+        }
+        else
+        {
+            stack.push_back(nfa[s].out1);
+            stack.push_back(nfa[s].out);
+        }
+    }
+
+    std::sort(states.begin(), states.end());
+}
+
+/** -----------------------------------------------------------------------------------------------
+ * @brief Subset construction of the DFA.
+ * @return False if the DFA would have more than `max_dfa_states` states.
+ */
+inline bool regex_dfa::determinize()
+{
+    /* Split the bytes into classes that no set of the NFA can tell apart. */
+    for (const byte_set& set : sets)
+    {
+        std::array<std::uint16_t, 256> refined;
+        std::vector<int>               remap(class_count * 2, -1);
+        std::size_t                    count = 0;
+        for (unsigned b = 0; b < 256; b++)
+        {
+            const std::size_t key = classes[b] * 2 + set[b];
+            if (remap[key] < 0)
+            {
+                remap[key] = static_cast<int>(count++);
+            }
+            refined[b] = static_cast<std::uint16_t>(remap[key]);
+        }
+        classes     = refined;
+        class_count = count;
+    }
+
+    std::vector<unsigned char> representative(class_count);
+    for (unsigned b = 256; b-- > 0;)
+    {
+        representative[classes[b]] = static_cast<unsigned char>(b);
+    }
+
+    std::vector<std::uint32_t>   marks(nfa.size(), 0);
+    std::uint32_t                generation = 0;
+    std::map<std::vector<int>, std::int32_t> ids;
+    std::vector<std::vector<int>>            states;
+
+    std::vector<int> initial{start};
+    closure(initial, marks, ++generation);
+    ids.emplace(initial, 0);
+    states.push_back(std::move(initial));
+
+    for (std::size_t i = 0; i < states.size(); i++)
+    {
+        for (std::size_t k = 0; k < class_count; k++)
+        {
+            std::vector<int> next;
+            for (const int s : states[i])
+            {
+                if (nfa[s].set >= 0 && sets[nfa[s].set][representative[k]])
+                {
+                    next.push_back(nfa[s].out);
+                }
+            }
+            closure(next, marks, ++generation);
+
+            auto [it, inserted] = ids.emplace(next, static_cast<std::int32_t>(states.size()));
+            if (inserted)
+            {
+                if (states.size() >= max_dfa_states)
+                {
+                    return false;
+                }
+                states.push_back(std::move(next));
+            }
+            table.push_back(it->second);
+        }
+    }
+
+    accepting.resize(states.size());
+    for (std::size_t i = 0; i < states.size(); i++)
+    {
+        accepting[i] = std::binary_search(states[i].begin(), states[i].end(), accept);
+        if (states[i].empty())
+        {
+            dead = static_cast<std::int32_t>(i);
+        }
+    }
+    return true;
+}
+
+/** -----------------------------------------------------------------------------------------------
+ * @brief Match a whole string by tracking the set of active NFA states.
+ */
+inline bool regex_dfa::simulate(const std::string_view s) const
+{
+    thread_local std::vector<std::uint32_t> marks;
+    thread_local std::uint32_t              generation = 0;
+    if (marks.size() < nfa.size())
+    {
+        marks.assign(nfa.size(), 0);
+        generation = 0;
+    }
+    if (generation > std::numeric_limits<std::uint32_t>::max() - s.size() - 2)
+    {
+        std::fill(marks.begin(), marks.end(), 0);
+        generation = 0;
+    }
+
+    std::vector<int> current{start};
+    std::vector<int> next;
+    closure(current, marks, ++generation);
+
+    for (const char c : s)
+    {
+        next.clear();
+        for (const int st : current)
+        {
+            if (nfa[st].set >= 0 && sets[nfa[st].set][static_cast<unsigned char>(c)])
+            {
+                next.push_back(nfa[st].out);
+            }
+        }
+        closure(next, marks, ++generation);
+        if (next.empty())
+        {
+            return false;
+        }
+        std::swap(current, next);
+    }
+
+    return std::binary_search(current.begin(), current.end(), accept);
+}
+
+}        // namespace stringvec_detail
+
+/**
+ * @}
+ */
+
+
+
+/** ===============================================================================================
+ *  REGEX CACHE
+ *
+ * @defgroup STRINGVEC_REGEX_CACHE              Regex Cache
+ * @{
+ */
+
+/** -----------------------------------------------------------------------------------------------
+ * @class   compiled_regex
+ *
+ * @brief   A regular expression compiled once, along with the pattern and flags it was built from.
+ */
+class compiled_regex
+{
+public:
+    inline explicit compiled_regex(const std::string_view pattern,
+                                   std::regex::flag_type flags = std::regex::ECMAScript,
+                                   regex_engine engine         = default_engine());
+
+    inline bool match(const std::string_view s) const;
+
+    inline const std::string&    pattern() const;
+    inline std::regex::flag_type flags() const;
+    inline regex_engine          engine() const;
+
+    inline static regex_engine default_engine();
+    inline static void         set_default_engine(regex_engine engine);
+
+private:
+    enum class literal_kind : std::uint8_t
+    {
+        none,
+        exact,
+        prefix,
+        suffix,
+        contains,
+    };
+
+    inline bool                analyze_literal();
+    inline std::optional<bool> match_literal(const std::string_view s) const;
+
+    inline static std::atomic<regex_engine>& engine_setting();
+
+    std::string           source;
+    std::regex::flag_type flag;
+    regex_engine          eng;
+    literal_kind          kind = literal_kind::none;
+    std::string           literal;
+
+    std::unique_ptr<stringvec_detail::regex_dfa> dfa;
+    std::optional<std::regex>                    reg;
+#ifdef STRINGVEC_USE_RE2
+    std::unique_ptr<re2::RE2> re2;
+#endif
+};
+
+/** -----------------------------------------------------------------------------------------------
+ * @brief   Handle to a precompiled regex, as accepted by the regex overloads of the classes.
+ */
+using regex_handle = std::shared_ptr<const compiled_regex>;
+
+/** -----------------------------------------------------------------------------------------------
+ * @class   regex_cache
+ *
+ * @brief   Bounded, thread-safe LRU cache of compiled regexes, keyed by pattern, flags and engine.
+ *
+ * @details Every regex overload taking a pattern string goes through `regex_cache::global()`, so
+ *          calling the same filter repeatedly only compiles its pattern once.
+ */
+class regex_cache
+{
+public:
+    struct statistics
+    {
+        std::size_t hits      = 0;
+        std::size_t misses    = 0;
+        std::size_t evictions = 0;
+        std::size_t size      = 0;
+        std::size_t capacity  = 0;
+    };
+
+    inline explicit regex_cache(std::size_t capacity = 64);
+
+    inline regex_handle get(const std::string_view pattern,
+                            std::regex::flag_type flags = std::regex::ECMAScript,
+                            regex_engine engine         = compiled_regex::default_engine());
+
+    inline void       clear();
+    inline void       set_capacity(std::size_t capacity);
+    inline statistics stats() const;
+    inline void       reset_stats();
+
+    inline static regex_cache& global();
+
+private:
+    struct key
+    {
+        std::string_view      pattern;
+        std::regex::flag_type flags;
+        regex_engine          engine;
+
+        bool operator==(const key&) const = default;
+    };
+
+    struct key_hash
+    {
+        std::size_t operator()(const key& k) const
+        {
+            const std::size_t h = std::hash<std::string_view>{}(k.pattern);
+            const std::size_t o = static_cast<std::size_t>(k.flags) << 4
+                                  | static_cast<std::size_t>(k.engine);
+            return h ^ (o * 0x9E3779B97F4A7C15ull);
+        }
+    };
+
+    inline void evict();
+
+    mutable std::mutex      mtx;
+    std::size_t             cap;
+    std::list<regex_handle> lru;
+    std::unordered_map<key, std::list<regex_handle>::iterator, key_hash> map;
+    statistics              counters;
+};
+
+
+/** -----------------------------------------------------------------------------------------------
+ * @brief Compile a regex.
+ * @param pattern: Regular Expression to compile.
+ * @param flags:   Syntax options of the regex.
+ * @param engine:  Engine used to match strings against the regex.
+ *
+ * @throw std::regex_error if the pattern is invalid, or if `regex_engine::dfa` is requested for a
+ *        pattern using features the DFA cannot express.
+ * @throw std::runtime_error if `regex_engine::re2` is requested without `STRINGVEC_USE_RE2`.
+ *
+ * @details With `regex_engine::automatic`, plain literals and `.*`-globs such as `".*berry"` are
+ *          matched with `memcmp`/`memmem` without running any automaton, other ECMAScript
+ *          patterns are run by the DFA, and `std::regex` is only built for what the DFA does not
+ *          support (back-references, assertions, other grammars, ...).
+ */
+inline compiled_regex::compiled_regex(const std::string_view pattern,
+                                      std::regex::flag_type flags,
+                                      regex_engine engine)
+: source{pattern}, flag{flags}, eng{engine}
+{
+    using namespace std::regex_constants;
+
+#if STRINGVEC_STATS
+    stringvec_stats::record_regex_compilation();
+#endif
+
+    const bool ecmascript = (flags & (basic | extended | awk | grep | egrep | multiline)) == 0;
+    const bool icase      = (flags & std::regex::icase) != 0;
+
+    switch (engine)
+    {
+        case regex_engine::std_regex:
+            reg.emplace(source, flags);
+            break;
+
+        case regex_engine::re2:
+        {
+#ifdef STRINGVEC_USE_RE2
+            RE2::Options options{RE2::Latin1};
+            options.set_case_sensitive(!icase);
+            options.set_log_errors(false);
+            re2 = std::make_unique<re2::RE2>(source, options);
+            if (!re2->ok())
+            {
+                /* Valid patterns RE2 does not support, such as back-references. */
+                reg.emplace(source, flags);
+                throw std::regex_error(error_complexity);
+            }
+            break;
+#else
+            throw std::runtime_error("RE2 regex engine requested without STRINGVEC_USE_RE2");
+#endif
+        }
+
+        case regex_engine::dfa:
+        case regex_engine::automatic:
+        default:
+        {
+            if (ecmascript)
+            {
+                if (engine == regex_engine::automatic && !icase)
+                {
+                    analyze_literal();
+                }
+
+                std::optional<stringvec_detail::regex_node> tree =
+                  stringvec_detail::regex_parser{source, icase}.parse();
+                if (tree)
+                {
+                    dfa = stringvec_detail::regex_dfa::compile(*tree);
+                }
+            }
+
+            if (!dfa)
+            {
+                /* Also validates the pattern, so invalid patterns keep their usual error. */
+                reg.emplace(source, flags);
+                if (engine == regex_engine::dfa)
+                {
+                    throw std::regex_error(error_complexity);
+                }
+            }
+            break;
+        }
+    }
+}
+
+/** -----------------------------------------------------------------------------------------------
+ * @brief Check if a whole string matches the regex.
+ */
+inline bool compiled_regex::match(const std::string_view s) const
+{
+    if (kind != literal_kind::none)
+    {
+        if (std::optional<bool> result = match_literal(s))
+        {
+            return *result;
+        }
+    }
+
+    if (dfa)
+    {
+        return dfa->match(s);
+    }
+
+#ifdef STRINGVEC_USE_RE2
+    if (re2)
+    {
+        return RE2::FullMatch(re2::StringPiece{s.data(), s.size()}, *re2);
+    }
+#endif
+
+    return std::regex_match(s.begin(), s.end(), *reg);
+}
+
+inline const std::string& compiled_regex::pattern() const
+{
+    return source;
+}
+
+inline std::regex::flag_type compiled_regex::flags() const
+{
+    return flag;
+}
+
+inline regex_engine compiled_regex::engine() const
+{
+    return eng;
+}
+
+/** -----------------------------------------------------------------------------------------------
+ * @brief Get the engine used when none is specified.
+ *
+ * @details Defaults to `STRINGVEC_DEFAULT_REGEX_ENGINE`, which can be defined before including
+ *          this header.
+ */
+inline regex_engine compiled_regex::default_engine()
+{
+    return engine_setting().load(std::memory_order_relaxed);
+}
+
+/** -----------------------------------------------------------------------------------------------
+ * @brief Change the engine used when none is specified.
+ *
+ * @details Regexes already compiled, including those held by `regex_cache`, keep their engine.
+ */
+inline void compiled_regex::set_default_engine(regex_engine engine)
+{
+    engine_setting().store(engine, std::memory_order_relaxed);
+}
+
+inline std::atomic<regex_engine>& compiled_regex::engine_setting()
+{
+    static std::atomic<regex_engine> setting{STRINGVEC_DEFAULT_REGEX_ENGINE};
+    return setting;
+}
+
+/** -----------------------------------------------------------------------------------------------
+ * @brief Detect patterns made of a literal, optionally surrounded by `.*`.
+ * @return True if the pattern can be matched with `match_literal`.
+ */
+inline bool compiled_regex::analyze_literal()
+{
+    std::string_view p = source;
+    if (p.starts_with('^'))
+    {
+        p.remove_prefix(1);
+    }
+    if (p.ends_with('$'))
+    {
+        /* Only strip the anchor if it is not escaped. */
+        std::size_t backslashes = 0;
+        while (backslashes + 1 < p.size() && p[p.size() - 2 - backslashes] == '\\')
+        {
+            backslashes++;
+        }
+        if (backslashes % 2 == 0)
+        {
+            p.remove_suffix(1);
+        }
+    }
+
+    const bool leading = p.starts_with(".*");
+    if (leading)
+    {
+        p.remove_prefix(2);
+    }
+    const bool trailing = p.ends_with(".*");
+    if (trailing)
+    {
+        p.remove_suffix(2);
+    }
+
+    std::string text;
+    for (std::size_t i = 0; i < p.size(); i++)
+    {
+        const unsigned char c = static_cast<unsigned char>(p[i]);
+        if (c == '\\')
+        {
+            if (++i == p.size() || !std::ispunct(static_cast<unsigned char>(p[i])))
+            {
+                return false;
+            }
+            text.push_back(p[i]);
+        }
+        else if (std::string_view{"^$.*+?()[]{}|"}.find(c) != std::string_view::npos)
+        {
+            return false;
+        }
+        else
+        {
+            text.push_back(static_cast<char>(c));
+        }
+    }
+
+    literal = std::move(text);
+    kind    = leading ? (trailing ? literal_kind::contains : literal_kind::suffix)
+                      : (trailing ? literal_kind::prefix : literal_kind::exact);
+    return true;
+}
+
+/** -----------------------------------------------------------------------------------------------
+ * @brief Match a string against a literal pattern.
+ * @return Whether the string matches, or nothing if the automaton has to decide.
+ *
+ * @details `.*` does not match line terminators, so the parts of the string it covers are checked
+ *          for `'\n'` and `'\r'`.
+ */
+inline std::optional<bool> compiled_regex::match_literal(const std::string_view s) const
+{
+    const auto has_terminator = [](const std::string_view x)
+                                {
+                                    return std::memchr(x.data(), '\n', x.size()) != nullptr
+                                           || std::memchr(x.data(), '\r', x.size()) != nullptr;
+                                };
+
+    switch (kind)
+    {
+        case literal_kind::exact:
+            return s == literal;
+
+        case literal_kind::prefix:
+            return s.starts_with(literal) && !has_terminator(s.substr(literal.size()));
+
+        case literal_kind::suffix:
+            return s.ends_with(literal)
+                   && !has_terminator(s.substr(0, s.size() - literal.size()));
+
+        case literal_kind::contains:
+            if (has_terminator(s))
+            {
+                return std::nullopt;
+            }
+#ifdef __GLIBC__
+            return literal.empty()
+                   || ::memmem(s.data(), s.size(), literal.data(), literal.size()) != nullptr;
+#else
+            return s.find(literal) != std::string_view::npos;
+#endif
+
+        case literal_kind::none:
+        default:
+            return std::nullopt;
+    }
+}
+
+
+/** -----------------------------------------------------------------------------------------------
+ * @brief Create an empty cache.
+ * @param capacity: Maximum number of compiled regexes kept alive by the cache.
+ */
+inline regex_cache::regex_cache(std::size_t capacity) : cap{capacity}
+{
+}
+
+/** -----------------------------------------------------------------------------------------------
+ * @brief Get the compiled regex of a pattern, compiling it on a cache miss.
+ * @param pattern: Regular Expression to compile.
+ * @param flags:   Syntax options of the regex.
+ * @param engine:  Engine used to match strings against the regex.
+ *
+ * @throw std::regex_error if the pattern is invalid. Invalid patterns are not cached.
+ *
+ * @details The returned handle stays valid even if the entry is later evicted.
+ */
+inline regex_handle regex_cache::get(const std::string_view pattern,
+                                     std::regex::flag_type flags,
+                                     regex_engine engine)
+{
+    std::lock_guard<std::mutex> lock{mtx};
+
+    if (auto it = map.find(key{pattern, flags, engine}); it != map.end())
+    {
+        counters.hits++;
+        lru.splice(lru.begin(), lru, it->second);
+        return *it->second;
+    }
+
+    counters.misses++;
+    auto reg = std::make_shared<const compiled_regex>(pattern, flags, engine);
+    if (cap == 0)
+    {
+        return reg;
+    }
+
+    lru.push_front(reg);
+    map.emplace(key{reg->pattern(), flags, engine}, lru.begin());
+    evict();
+
+    return reg;
+}
+
+/** -----------------------------------------------------------------------------------------------
+ * @brief Drop every cached regex. Outstanding handles stay valid.
+ */
+inline void regex_cache::clear()
+{
+    std::lock_guard<std::mutex> lock{mtx};
+    map.clear();
+    lru.clear();
+}
+
+/** -----------------------------------------------------------------------------------------------
+ * @brief Change the maximum number of entries, evicting the least recently used if needed.
+ */
+inline void regex_cache::set_capacity(std::size_t capacity)
+{
+    std::lock_guard<std::mutex> lock{mtx};
+    cap = capacity;
+    evict();
+}
+
+/** -----------------------------------------------------------------------------------------------
+ * @brief Get a snapshot of the hit, miss and eviction counters.
+ */
+inline regex_cache::statistics regex_cache::stats() const
+{
+    std::lock_guard<std::mutex> lock{mtx};
+    statistics s = counters;
+    s.size       = map.size();
+    s.capacity   = cap;
+    return s;
+}
+
+inline void regex_cache::reset_stats()
+{
+    std::lock_guard<std::mutex> lock{mtx};
+    counters = statistics{};
+}
+
+/** -----------------------------------------------------------------------------------------------
+ * @brief Get the cache shared by every `stringvec` and `stringview_vec`.
+ */
+inline regex_cache& regex_cache::global()
+{
+    static regex_cache cache;
+    return cache;
+}
+
+/** -----------------------------------------------------------------------------------------------
+ * @brief Remove the least recently used entries until the cache fits in its capacity.
+ *        The mutex must be held by the caller.
+ */
+inline void regex_cache::evict()
+{
+    while (map.size() > cap)
+    {
+        const regex_handle& oldest = lru.back();
+        map.erase(key{oldest->pattern(), oldest->flags(), oldest->engine()});
+        lru.pop_back();
+        counters.evictions++;
+    }
+}
+
+/**
+ * @}
+ */
+
+
+
+/** ===============================================================================================
+ *  PATTERN SETS
+ *
+ * @defgroup STRINGVEC_PATTERN_SETS             Pattern Sets
+ * @{
+ */
+
+namespace stringvec_detail
+{
+
+/** -----------------------------------------------------------------------------------------------
+ * @class   aho_corasick
+ *
+ * @brief   Aho-Corasick automaton, finding any of a set of substrings in a single pass.
+ *
+ * @details The failure links are folded into a full transition table, so each byte of the
+ *          searched string costs exactly one lookup. Bytes are first mapped to classes, bytes
+ *          used by none of the substrings sharing class 0, which keeps the table small.
+ *          Every entry is the offset of the row of the next state, its top bit telling whether
+ *          that state ends a substring.
+ */
+class aho_corasick
+{
+public:
+    static constexpr std::size_t npos = std::numeric_limits<std::size_t>::max();
+
+    aho_corasick() = default;
+    inline explicit aho_corasick(const std::vector<std::string_view>& patterns);
+
+    inline bool        empty() const;
+    inline bool        contains_any(const std::string_view s) const;
+    inline std::size_t find_lowest(const std::string_view s) const;
+
+private:
+    static constexpr std::uint32_t ends = std::uint32_t{1} << 31;
+    static constexpr std::uint32_t none = std::numeric_limits<std::uint32_t>::max();
+
+    std::array<std::uint16_t, 256> classes{};
+    std::size_t                    class_count = 1;
+    std::vector<std::uint32_t>     table;
+    std::vector<std::uint32_t>     output;        ///< Lowest substring ending at each state
+};
+
+/** -----------------------------------------------------------------------------------------------
+ * @brief Build the automaton of a set of substrings.
+ * @param patterns: Substrings to find, numbered in order.
+ */
+inline aho_corasick::aho_corasick(const std::vector<std::string_view>& patterns)
+{
+    if (patterns.empty())
+    {
+        return;
+    }
+
+    std::bitset<256> used;
+    for (const std::string_view p : patterns)
+    {
+        for (const char c : p)
+        {
+            used.set(static_cast<unsigned char>(c));
+        }
+    }
+    for (std::size_t b = 0; b < 256; b++)
+    {
+        if (used.test(b))
+        {
+            classes[b] = static_cast<std::uint16_t>(class_count++);
+        }
+    }
+
+    /* Trie of the substrings, 0 meaning no transition yet since no edge leads back to the root. */
+    table.assign(class_count, 0);
+    output.assign(1, none);
+    for (std::size_t i = 0; i < patterns.size(); i++)
+    {
+        std::size_t node = 0;
+        for (const char c : patterns[i])
+        {
+            const std::size_t edge = node * class_count + classes[static_cast<unsigned char>(c)];
+            if (table[edge] == 0)
+            {
+                if (output.size() * class_count >= ends)
+                {
+                    throw std::length_error("Too many substrings for the automaton");
+                }
+                table[edge] = static_cast<std::uint32_t>(output.size());
+                table.resize(table.size() + class_count, 0);
+                output.push_back(none);
+            }
+            node = table[edge];
+        }
+        output[node] = std::min(output[node], static_cast<std::uint32_t>(i));
+    }
+
+    /* Breadth-first, so that the failure state of each state is complete before the state. */
+    std::vector<std::uint32_t> fail(output.size(), 0);
+    std::deque<std::uint32_t>  queue;
+    for (std::size_t c = 0; c < class_count; c++)
+    {
+        if (table[c] != 0)
+        {
+            queue.push_back(table[c]);
+        }
+    }
+    while (!queue.empty())
+    {
+        const std::uint32_t node = queue.front();
+        queue.pop_front();
+        output[node] = std::min(output[node], output[fail[node]]);
+
+        for (std::size_t c = 0; c < class_count; c++)
+        {
+            std::uint32_t&      next     = table[node * class_count + c];
+            const std::uint32_t fallback = table[fail[node] * class_count + c];
+            if (next != 0)
+            {
+                fail[next] = fallback;
+                queue.push_back(next);
+            }
+            else
+            {
+                next = fallback;
+            }
+        }
+    }
+
+    for (std::uint32_t& next : table)
+    {
+        next = static_cast<std::uint32_t>(next * class_count) | (output[next] != none ? ends : 0);
+    }
+}
+
+/** -----------------------------------------------------------------------------------------------
+ * @brief Check if the automaton has no substring.
+ */
+inline bool aho_corasick::empty() const
+{
+    return output.empty();
+}
+
+/** -----------------------------------------------------------------------------------------------
+ * @brief Check if a string contains any of the substrings, stopping at the first one found.
+ */
+inline bool aho_corasick::contains_any(const std::string_view s) const
+{
+    if (output.empty())
+    {
+        return false;
+    }
+    if (output[0] != none)
+    {
+        return true;
+    }
+
+    std::uint32_t state = 0;
+    for (const char c : s)
+    {
+        state = table[state + classes[static_cast<unsigned char>(c)]];
+        if ((state & ends) != 0)
+        {
+            return true;
+        }
+    }
+
+    return false;
+}
+
+/** -----------------------------------------------------------------------------------------------
+ * @brief Find the lowest-numbered substring contained in a string.
+ * @return Its number, or `npos` if the string contains none.
+ */
+inline std::size_t aho_corasick::find_lowest(const std::string_view s) const
+{
+    if (output.empty())
+    {
+        return npos;
+    }
+
+    std::uint32_t best  = output[0];
+    std::uint32_t state = 0;
+    for (std::size_t i = 0; i < s.size() && best != 0; i++)
+    {
+        state = table[state + classes[static_cast<unsigned char>(s[i])]];
+        if ((state & ends) != 0)
+        {
+            state &= ~ends;
+            best = std::min(best, output[state / class_count]);
+        }
+    }
+
+    return best == none ? npos : best;
+}
+
+/** -----------------------------------------------------------------------------------------------
+ * @brief Get the substring of a `.*substring.*` regex, whose metacharacters are all in the `.*`.
+ */
+inline std::optional<std::string_view> contained_literal(const std::string_view pattern)
+{
+    if (pattern.size() < 4 || !pattern.starts_with(".*") || !pattern.ends_with(".*"))
+    {
+        return std::nullopt;
+    }
+
+    const std::string_view literal = pattern.substr(2, pattern.size() - 4);
+    if (literal.find_first_of("^$.*+?()[]{}|\\\n\r") != std::string_view::npos)
+    {
+        return std::nullopt;
+    }
+
+    return literal;
+}
+
+}        // namespace stringvec_detail
+
+/** -----------------------------------------------------------------------------------------------
+ * @class   pattern_set
+ *
+ * @brief   Set of substrings and regexes compiled once, matched against a string in one pass.
+ *
+ * @details Patterns are numbered in order, the substrings first, then the regexes. A string
+ *          matches a substring if it contains it, and a regex if it matches it as a whole, as
+ *          with `filter_keep(regex)`.
+ *
+ *          The substrings are found with one Aho-Corasick automaton, as are the regexes written
+ *          as `.*substring.*`. The other regexes the DFA supports are merged into a single
+ *          automaton; with `regex_engine::std_regex` or `regex_engine::re2` as the default
+ *          engine, or for regexes the DFA does not support, they are matched one by one.
+ *
+ * @example
+ *      const pattern_set blocked = pattern_set::literals(substrings);
+ *      lines.filter_remove_any(blocked);
+ */
+class pattern_set
+{
+public:
+    static constexpr std::size_t npos = std::numeric_limits<std::size_t>::max();
+
+    pattern_set() = default;
+    inline pattern_set(std::span<const std::string> substrings,
+                       std::span<const std::string> regexes,
+                       std::regex::flag_type        flags = std::regex::ECMAScript);
+
+    inline static pattern_set literals(std::span<const std::string> substrings);
+    inline static pattern_set regexes(std::span<const std::string> patterns,
+                                      std::regex::flag_type        flags = std::regex::ECMAScript);
+
+    inline bool        match(const std::string_view s) const;
+    inline std::size_t which(const std::string_view s) const;
+    inline std::size_t size() const;
+
+private:
+    std::size_t substring_count = 0;
+
+    stringvec_detail::aho_corasick substrings;
+    stringvec_detail::aho_corasick contained;         ///< `.*substring.*` regexes
+    std::vector<std::size_t>       contained_owner;   ///< Pattern of each of these substrings
+
+    std::shared_ptr<const stringvec_detail::regex_dfa> combined;
+    std::vector<regex_handle>                          compiled;   ///< Every regex, in order
+    std::vector<std::size_t>                           separate;   ///< Regexes left out of the automata
+};
+
+/** -----------------------------------------------------------------------------------------------
+ * @brief Compile a set of substrings and regexes.
+ * @param substrings: Substrings to find anywhere in the strings, numbered first.
+ * @param regexes:    Regexes to match the whole strings against, numbered after the substrings.
+ * @param flags:      Syntax options of the regexes.
+ *
+ * @throw std::regex_error if any regex is invalid.
+ */
+inline pattern_set::pattern_set(std::span<const std::string> substrings,
+                                std::span<const std::string> regexes,
+                                std::regex::flag_type        flags)
+: substring_count{substrings.size()},
+  substrings{std::vector<std::string_view>(substrings.begin(), substrings.end())}
+{
+    using namespace std::regex_constants;
+
+    const regex_engine engine     = compiled_regex::default_engine();
+    const bool         ecmascript = (flags & (basic | extended | awk | grep | egrep | multiline)) == 0;
+    const bool         icase      = (flags & std::regex::icase) != 0;
+    const bool         merge      = ecmascript && engine != regex_engine::std_regex && engine != regex_engine::re2;
+
+    std::vector<std::string_view>             literals;
+    std::vector<stringvec_detail::regex_node> trees;
+    std::vector<std::size_t>                  merged;
+    compiled.reserve(regexes.size());
+    for (std::size_t i = 0; i < regexes.size(); i++)
+    {
+        /* Also validates the pattern. */
+        compiled.push_back(std::make_shared<const compiled_regex>(regexes[i], flags));
+
+        if (merge && !icase)
+        {
+            if (const std::optional<std::string_view> literal = stringvec_detail::contained_literal(regexes[i]))
+            {
+                literals.push_back(*literal);
+                contained_owner.push_back(substring_count + i);
+                continue;
+            }
+        }
+
+        std::optional<stringvec_detail::regex_node> tree;
+        if (merge)
+        {
+            tree = stringvec_detail::regex_parser{regexes[i], icase}.parse();
+        }
+        if (tree)
+        {
+            trees.push_back(std::move(*tree));
+            merged.push_back(i);
+        }
+        else
+        {
+            separate.push_back(i);
+        }
+    }
+    contained = stringvec_detail::aho_corasick{literals};
+
+    if (!trees.empty())
+    {
+        stringvec_detail::regex_node root;
+        root.kind     = stringvec_detail::regex_node::alternate;
+        root.children = std::move(trees);
+        combined      = stringvec_detail::regex_dfa::compile(root);
+        if (!combined)
+        {
+            /* Too large for a single automaton. */
+            separate.insert(separate.end(), merged.begin(), merged.end());
+            std::ranges::sort(separate);
+        }
+    }
+}
+
+/** -----------------------------------------------------------------------------------------------
+ * @brief Compile a set of substrings, found anywhere in the strings.
+ */
+inline pattern_set pattern_set::literals(std::span<const std::string> substrings)
+{
+    return pattern_set{substrings, {}};
+}
+
+/** -----------------------------------------------------------------------------------------------
+ * @brief Compile a set of regexes, matched against whole strings.
+ * @throw std::regex_error if any regex is invalid.
+ */
+inline pattern_set pattern_set::regexes(std::span<const std::string> patterns, std::regex::flag_type flags)
+{
+    return pattern_set{{}, patterns, flags};
+}
+
+/** -----------------------------------------------------------------------------------------------
+ * @brief Check if a string matches any of the patterns.
+ *
+ * @details `.*` does not match line terminators, so the `.*substring.*` regexes are only looked
+ *          for in strings without `'\n'` nor `'\r'`; they are matched as regexes otherwise.
+ */
+inline bool pattern_set::match(const std::string_view s) const
+{
+    if (substrings.contains_any(s))
+    {
+        return true;
+    }
+
+    if (!contained.empty())
+    {
+        if (s.find_first_of("\n\r") == std::string_view::npos)
+        {
+            if (contained.contains_any(s))
+            {
+                return true;
+            }
+        }
+        else
+        {
+            const std::size_t first = substring_count;
+            if (std::ranges::any_of(contained_owner, [this, s, first](std::size_t owner)
+                                                     {
+                                                         return compiled[owner - first]->match(s);
+                                                     }))
+            {
+                return true;
+            }
+        }
+    }
+
+    if (combined && combined->match(s))
+    {
+        return true;
+    }
+
+    return std::ranges::any_of(separate, [this, s](std::size_t i)
+                                         {
+                                             return compiled[i]->match(s);
+                                         });
+}
+
+/** -----------------------------------------------------------------------------------------------
+ * @brief Find which pattern a string matches.
+ * @return The lowest number of the patterns the string matches, or `npos` if it matches none.
+ */
+inline std::size_t pattern_set::which(const std::string_view s) const
+{
+    const std::size_t found = substrings.find_lowest(s);
+    if (found != npos)
+    {
+        return found;
+    }
+
+    std::size_t best = compiled.size();
+    if (!contained.empty() && s.find_first_of("\n\r") == std::string_view::npos)
+    {
+        const std::size_t local = contained.find_lowest(s);
+        if (local != npos)
+        {
+            best = contained_owner[local] - substring_count;
+        }
+    }
+    for (std::size_t i = 0; i < best; i++)
+    {
+        if (compiled[i]->match(s))
+        {
+            best = i;
+            break;
+        }
+    }
+
+    return best == compiled.size() ? npos : substring_count + best;
+}
+
+/** -----------------------------------------------------------------------------------------------
+ * @brief Get the number of patterns in the set.
+ */
+inline std::size_t pattern_set::size() const
+{
+    return substring_count + compiled.size();
+}
+
+/**
+ * @}
+ */
+
+
+
+/** ===============================================================================================
+ *  THREAD POOL
+ *
+ * @defgroup STRINGVEC_THREAD_POOL              Thread Pool
+ * @{
+ */
+
+/** -----------------------------------------------------------------------------------------------
+ * @class   thread_pool
+ *
+ * @brief   Fixed set of worker threads running the parallel overloads of the classes.
+ *
+ * @details The thread calling `parallel_for` works on the chunks too, so a pool of size 1 has no
+ *          worker thread and runs everything inline.
+ */
+class thread_pool
+{
+public:
+    inline explicit thread_pool(std::size_t threads = 0);
+    inline ~thread_pool();
+
+    thread_pool(const thread_pool&)            = delete;
+    thread_pool& operator=(const thread_pool&) = delete;
+
+    inline std::size_t size() const;
+    inline std::size_t chunks(std::size_t count, std::size_t grain) const;
+
+    template <class Func>
+    inline void parallel_for(std::size_t count, std::size_t grain, Func&& func);
+
+    inline static thread_pool& global();
+
+private:
+    inline void run();
+    inline bool run_one();
+
+    std::vector<std::thread>          workers;
+    std::deque<std::function<void()>> tasks;
+    std::mutex                        mtx;
+    std::condition_variable           cv;
+    bool                              stopping = false;
+};
+
+
+/** -----------------------------------------------------------------------------------------------
+ * @brief   Execution policies accepted by the parallel overloads, besides a `thread_pool&`.
+ */
+namespace stringvec_execution
+{
+
+struct sequenced_policy
+{
+};
+
+struct parallel_policy
+{
+    thread_pool* pool  = nullptr;        ///< Pool to run on, `thread_pool::global()` if null
+    std::size_t  grain = 4096;           ///< Minimum number of elements per chunk
+};
+
+inline constexpr sequenced_policy seq{};
+inline constexpr parallel_policy  par{};
+
+template <class T>
+concept policy = std::same_as<std::remove_cvref_t<T>, sequenced_policy>
+                 || std::same_as<std::remove_cvref_t<T>, parallel_policy>
+                 || std::same_as<std::remove_cvref_t<T>, thread_pool>;
+
+}        // namespace stringvec_execution
+
+
+namespace stringvec_detail
+{
+
+template <class Policy>
+inline thread_pool* pool_of(const Policy& policy)
+{
+    using type = std::remove_cvref_t<Policy>;
+    if constexpr (std::same_as<type, thread_pool>)
+    {
+        return const_cast<thread_pool*>(&policy);
+    }
+    else if constexpr (std::same_as<type, stringvec_execution::parallel_policy>)
+    {
+        return policy.pool != nullptr ? policy.pool : &thread_pool::global();
+    }
+    else
+    {
+        return nullptr;
+    }
+}
+
+template <class Policy>
+inline std::size_t grain_of(const Policy& policy)
+{
+    if constexpr (std::same_as<std::remove_cvref_t<Policy>, stringvec_execution::parallel_policy>)
+    {
+        return std::max<std::size_t>(policy.grain, 1);
+    }
+    else
+    {
+        return stringvec_execution::parallel_policy{}.grain;
+    }
+}
+
+/** -----------------------------------------------------------------------------------------------
+ * @brief Apply a function to every element of a range, in parallel over contiguous chunks.
+ */
+template <class It, class Func>
+inline void parallel_for_each(thread_pool* pool, std::size_t grain, It first, It last, Func&& func)
+{
+    if (pool == nullptr)
+    {
+        std::for_each(first, last, func);
+        return;
+    }
+
+    pool->parallel_for(static_cast<std::size_t>(last - first), grain,
+                       [&](std::size_t begin, std::size_t end, std::size_t)
+                       {
+                           std::for_each(first + begin, first + end, func);
+                       });
+}
+
+/** -----------------------------------------------------------------------------------------------
+ * @brief Run a function over `[0, count)` in chunks on a pool, or in one chunk without one.
+ */
+template <class Func>
+inline void run_chunks(thread_pool* pool, std::size_t count, std::size_t grain, Func&& func)
+{
+    if (pool == nullptr)
+    {
+        func(std::size_t{0}, count, std::size_t{0});
+    }
+    else
+    {
+        pool->parallel_for(count, grain, func);
+    }
+}
+
+/** -----------------------------------------------------------------------------------------------
+ * @brief Keep the elements of a vector whose flag is set, preserving their order.
+ */
+template <class T>
+inline void compact_by_flags(thread_pool* pool, std::size_t grain, std::vector<T>& v, const std::vector<std::uint8_t>& flags)
+{
+    if (pool == nullptr)
+    {
+        std::size_t out = 0;
+        for (std::size_t i = 0; i < v.size(); i++)
+        {
+            if (flags[i] != 0)
+            {
+                if (out != i)
+                {
+                    v[out] = std::move(v[i]);
+                }
+                out++;
+            }
+        }
+        v.erase(v.begin() + out, v.end());
+        return;
+    }
+
+    const std::size_t        n      = v.size();
+    const std::size_t        chunks = pool->chunks(n, grain);
+    std::vector<std::size_t> offsets(chunks + 1, 0);
+
+    pool->parallel_for(n, grain, [&](std::size_t begin, std::size_t end, std::size_t chunk)
+                       {
+                           offsets[chunk + 1] = static_cast<std::size_t>(std::count(flags.begin() + begin,
+                                                                                    flags.begin() + end,
+                                                                                    std::uint8_t{1}));
+                       });
+
+    std::partial_sum(offsets.begin(), offsets.end(), offsets.begin());
+    if (offsets.back() == n)
+    {
+        return;
+    }
+
+    std::vector<T> kept(offsets.back());
+    pool->parallel_for(n, grain, [&](std::size_t begin, std::size_t end, std::size_t chunk)
+                       {
+                           std::size_t out = offsets[chunk];
+                           for (std::size_t i = begin; i < end; i++)
+                           {
+                               if (flags[i] != 0)
+                               {
+                                   kept[out++] = std::move(v[i]);
+                               }
+                           }
+                       });
+    v = std::move(kept);
+}
+
+/** -----------------------------------------------------------------------------------------------
+ * @brief Keep the elements of a vector for which `keep` returns true, preserving their order.
+ *
+ * @details The predicate is evaluated in parallel, then each chunk moves its kept elements to
+ *          their final position, computed from a prefix sum of the per-chunk counts.
+ */
+template <class T, class Keep>
+inline void parallel_filter(thread_pool* pool, std::size_t grain, std::vector<T>& v, Keep&& keep)
+{
+    if (pool == nullptr)
+    {
+        v.erase(std::remove_if(v.begin(), v.end(), [&keep](const T& x)
+                                                   {
+                                                       return !keep(x);
+                                                   }),
+                v.end());
+        return;
+    }
+
+    std::vector<std::uint8_t> flags(v.size());
+    pool->parallel_for(v.size(), grain, [&](std::size_t begin, std::size_t end, std::size_t)
+                       {
+                           for (std::size_t i = begin; i < end; i++)
+                           {
+                               flags[i] = keep(std::as_const(v[i])) ? 1 : 0;
+                           }
+                       });
+
+    compact_by_flags(pool, grain, v, flags);
+}
+
+/** -----------------------------------------------------------------------------------------------
+ * @brief Sort a range, sorting chunks in parallel and then merging them pairwise.
+ */
+template <class It, class Compare>
+inline void parallel_sort(thread_pool* pool, std::size_t grain, It first, It last, Compare comp)
+{
+    const std::size_t n = static_cast<std::size_t>(last - first);
+    if (pool == nullptr || pool->chunks(n, grain) < 2)
+    {
+        std::sort(first, last, comp);
+        return;
+    }
+
+    const std::size_t        chunks = pool->chunks(n, grain);
+    std::vector<std::size_t> bounds(chunks + 1);
+    for (std::size_t i = 0; i <= chunks; i++)
+    {
+        bounds[i] = n * i / chunks;
+    }
+
+    pool->parallel_for(chunks, 1, [&](std::size_t begin, std::size_t end, std::size_t)
+                       {
+                           for (std::size_t c = begin; c < end; c++)
+                           {
+                               std::sort(first + bounds[c], first + bounds[c + 1], comp);
+                           }
+                       });
+
+    for (std::size_t width = 1; width < chunks; width *= 2)
+    {
+        const std::size_t pairs = (chunks + 2 * width - 1) / (2 * width);
+        pool->parallel_for(pairs, 1, [&](std::size_t begin, std::size_t end, std::size_t)
+                           {
+                               for (std::size_t p = begin; p < end; p++)
+                               {
+                                   const std::size_t lo  = p * 2 * width;
+                                   const std::size_t mid = std::min(lo + width, chunks);
+                                   const std::size_t hi  = std::min(lo + 2 * width, chunks);
+                                   std::inplace_merge(first + bounds[lo],
+                                                      first + bounds[mid],
+                                                      first + bounds[hi],
+                                                      comp);
+                               }
+                           });
+    }
+}
+
+/** -----------------------------------------------------------------------------------------------
+ * @brief Find the first element matching a predicate, searching chunks in parallel.
+ *
+ * @details Chunks located after the best match found so far stop early, and the match with the
+ *          lowest position is returned, as a sequential search would.
+ */
+template <class It, class Pred>
+inline It parallel_find(thread_pool* pool, std::size_t grain, It first, It last, Pred&& pred)
+{
+    if (pool == nullptr)
+    {
+        return std::find_if(first, last, pred);
+    }
+
+    const std::size_t        n = static_cast<std::size_t>(last - first);
+    std::atomic<std::size_t> best{n};
+
+    pool->parallel_for(n, grain, [&](std::size_t begin, std::size_t end, std::size_t)
+                       {
+                           for (std::size_t i = begin; i < end; i++)
+                           {
+                               if ((i % 1024) == 0 && i >= best.load(std::memory_order_relaxed))
+                               {
+                                   return;
+                               }
+                               if (pred(std::as_const(first[i])))
+                               {
+                                   std::size_t current = best.load();
+                                   while (i < current && !best.compare_exchange_weak(current, i))
+                                   {
+                                   }
+                                   return;
+                               }
+                           }
+                       });
+
+    return first + best.load();
+}
+
+/** -----------------------------------------------------------------------------------------------
+ * @brief Find the last element matching a predicate, searching chunks in parallel.
+ * @return An iterator to the element, or `last` if none match.
+ */
+template <class It, class Pred>
+inline It parallel_find_last(thread_pool* pool, std::size_t grain, It first, It last, Pred&& pred)
+{
+    const std::size_t n = static_cast<std::size_t>(last - first);
+    if (pool == nullptr)
+    {
+        for (std::size_t i = n; i-- > 0;)
+        {
+            if (pred(std::as_const(first[i])))
+            {
+                return first + i;
+            }
+        }
+        return last;
+    }
+
+    /* Positions are shifted by one, so that 0 means no match. */
+    std::atomic<std::size_t> best{0};
+
+    pool->parallel_for(n, grain, [&](std::size_t begin, std::size_t end, std::size_t)
+                       {
+                           for (std::size_t i = end; i-- > begin;)
+                           {
+                               if ((i % 1024) == 0 && i + 1 <= best.load(std::memory_order_relaxed))
+                               {
+                                   return;
+                               }
+                               if (pred(std::as_const(first[i])))
+                               {
+                                   std::size_t current = best.load();
+                                   while (i + 1 > current && !best.compare_exchange_weak(current, i + 1))
+                                   {
+                                   }
+                                   return;
+                               }
+                           }
+                       });
+
+    return best.load() == 0 ? last : first + (best.load() - 1);
+}
+
+/** -----------------------------------------------------------------------------------------------
+ * @brief Concatenate the positions gathered by each chunk, in chunk order.
+ */
+inline std::vector<std::size_t> join_positions(std::vector<std::vector<std::size_t>>& chunks)
+{
+    if (chunks.size() == 1)
+    {
+        return std::move(chunks.front());
+    }
+
+    std::size_t total = 0;
+    for (const std::vector<std::size_t>& chunk : chunks)
+    {
+        total += chunk.size();
+    }
+
+    std::vector<std::size_t> positions;
+    positions.reserve(total);
+    for (const std::vector<std::size_t>& chunk : chunks)
+    {
+        positions.insert(positions.end(), chunk.begin(), chunk.end());
+    }
+    return positions;
+}
+
+/** -----------------------------------------------------------------------------------------------
+ * @brief Get the positions of the elements of a range matching a predicate, in order.
+ *
+ * @details Each chunk gathers its own positions, which are then concatenated in chunk order.
+ */
+template <class It, class Pred>
+inline std::vector<std::size_t> parallel_positions(thread_pool* pool, std::size_t grain, It first, It last, Pred&& pred)
+{
+    const std::size_t                     n      = static_cast<std::size_t>(last - first);
+    const std::size_t                     chunks = pool != nullptr ? pool->chunks(n, grain) : 1;
+    std::vector<std::vector<std::size_t>> found(chunks);
+
+    run_chunks(pool, n, grain, [&](std::size_t begin, std::size_t end, std::size_t chunk)
+               {
+                   for (std::size_t i = begin; i < end; i++)
+                   {
+                       if (pred(std::as_const(first[i])))
+                       {
+                           found[chunk].push_back(i);
+                       }
+                   }
+               });
+
+    return join_positions(found);
+}
+
+/** -----------------------------------------------------------------------------------------------
+ * @brief Get the positions of the elements of a range matching a predicate, then of the others,
+ *        both in order, evaluating the predicate once per element.
+ */
+template <class It, class Pred>
+inline std::pair<std::vector<std::size_t>, std::vector<std::size_t>>
+parallel_partition_positions(thread_pool* pool, std::size_t grain, It first, It last, Pred&& pred)
+{
+    const std::size_t                     n      = static_cast<std::size_t>(last - first);
+    const std::size_t                     chunks = pool != nullptr ? pool->chunks(n, grain) : 1;
+    std::vector<std::vector<std::size_t>> matching(chunks);
+    std::vector<std::vector<std::size_t>> others(chunks);
+
+    run_chunks(pool, n, grain, [&](std::size_t begin, std::size_t end, std::size_t chunk)
+               {
+                   for (std::size_t i = begin; i < end; i++)
+                   {
+                       (pred(std::as_const(first[i])) ? matching : others)[chunk].push_back(i);
+                   }
+               });
+
+    return {join_positions(matching), join_positions(others)};
+}
+
+/** -----------------------------------------------------------------------------------------------
+ * @brief Count the elements of a range matching a predicate, counting chunks in parallel.
+ */
+template <class It, class Pred>
+inline std::size_t parallel_count(thread_pool* pool, std::size_t grain, It first, It last, Pred&& pred)
+{
+    const std::size_t        n      = static_cast<std::size_t>(last - first);
+    const std::size_t        chunks = pool != nullptr ? pool->chunks(n, grain) : 1;
+    std::vector<std::size_t> counts(chunks);
+
+    run_chunks(pool, n, grain, [&](std::size_t begin, std::size_t end, std::size_t chunk)
+               {
+                   counts[chunk] = static_cast<std::size_t>(std::count_if(first + begin, first + end, pred));
+               });
+
+    return std::accumulate(counts.begin(), counts.end(), std::size_t{0});
+}
+
+/** -----------------------------------------------------------------------------------------------
+ * @brief Positions of a vector grouped by the hash of their element.
+ *
+ * @details Equal elements always land in the same partition, so each partition can be
+ *          deduplicated or matched against the same partition of another vector independently.
+ */
+struct hash_partitions
+{
+    std::vector<std::size_t> hashes;         ///< Hash of each element
+    std::vector<std::size_t> order;          ///< Positions grouped by partition, ascending in each
+    std::vector<std::size_t> offsets;        ///< Start of each partition in `order`
+};
+
+/** -----------------------------------------------------------------------------------------------
+ * @brief Get the number of partitions to split a vector into, a power of two.
+ */
+inline std::size_t partition_count(thread_pool* pool)
+{
+    return pool == nullptr ? 1 : std::bit_ceil(pool->size() * 4);
+}
+
+/** -----------------------------------------------------------------------------------------------
+ * @brief Hash the elements of a vector and group their positions by partition, in parallel.
+ * @param parts: Number of partitions, a power of two.
+ *
+ * @details Each chunk counts its elements per partition, a prefix sum over (partition, chunk)
+ *          gives every chunk its write position in each partition, and the chunks then scatter
+ *          their positions, which keeps them ascending in each partition.
+ */
+template <class T>
+inline hash_partitions partition_by_hash(thread_pool* pool, std::size_t grain, const std::vector<T>& v, std::size_t parts)
+{
+    const std::size_t n      = v.size();
+    const std::size_t chunks = pool == nullptr ? 1 : pool->chunks(n, grain);
+    const int         shift  = 64 - std::countr_zero(parts);
+
+    /* The high bits of a multiplicative hash pick the partition, the low bits stay for probing. */
+    const auto part_of = [parts, shift](std::size_t h) -> std::size_t
+                         {
+                             return parts == 1 ? 0 : (static_cast<std::uint64_t>(h) * 0x9E3779B97F4A7C15ull) >> shift;
+                         };
+
+    hash_partitions result;
+    result.hashes.resize(n);
+    result.order.resize(n);
+    result.offsets.assign(parts + 1, 0);
+
+    std::vector<std::size_t> counts(chunks * parts, 0);
+    run_chunks(pool, n, grain, [&](std::size_t begin, std::size_t end, std::size_t chunk)
+               {
+                   for (std::size_t i = begin; i < end; i++)
+                   {
+                       result.hashes[i] = std::hash<std::string_view>{}(std::string_view{v[i]});
+                       counts[chunk * parts + part_of(result.hashes[i])]++;
+                   }
+               });
+
+    std::size_t total = 0;
+    for (std::size_t p = 0; p < parts; p++)
+    {
+        result.offsets[p] = total;
+        for (std::size_t c = 0; c < chunks; c++)
+        {
+            const std::size_t count = counts[c * parts + p];
+            counts[c * parts + p]   = total;
+            total += count;
+        }
+    }
+    result.offsets[parts] = total;
+
+    run_chunks(pool, n, grain, [&](std::size_t begin, std::size_t end, std::size_t chunk)
+               {
+                   for (std::size_t i = begin; i < end; i++)
+                   {
+                       result.order[counts[chunk * parts + part_of(result.hashes[i])]++] = i;
+                   }
+               });
+
+    return result;
+}
+
+/** -----------------------------------------------------------------------------------------------
+ * @class   position_set
+ *
+ * @brief   Open-addressing set of positions in a vector, compared by the elements they point to.
+ */
+class position_set
+{
+public:
+    inline void reset(std::size_t count);
+
+    template <class Equal>
+    inline bool contains(std::size_t hash, Equal&& equal) const;
+    inline void insert(std::size_t hash, std::size_t pos);
+
+private:
+    struct slot
+    {
+        std::size_t hash;
+        std::size_t pos;
+    };
+
+    static constexpr std::size_t empty = std::numeric_limits<std::size_t>::max();
+
+    std::vector<slot> slots;
+    std::size_t       mask = 0;
+};
+
+/** -----------------------------------------------------------------------------------------------
+ * @brief Empty the set, sizing it for `count` positions.
+ */
+inline void position_set::reset(std::size_t count)
+{
+    slots.assign(std::bit_ceil(std::max<std::size_t>(count * 2, 16)), slot{0, empty});
+    mask = slots.size() - 1;
+}
+
+/** -----------------------------------------------------------------------------------------------
+ * @brief Check if the set holds a position for which `equal(pos)` is true.
+ */
+template <class Equal>
+inline bool position_set::contains(std::size_t hash, Equal&& equal) const
+{
+    for (std::size_t i = hash & mask; slots[i].pos != empty; i = (i + 1) & mask)
+    {
+        if (slots[i].hash == hash && equal(slots[i].pos))
+        {
+            return true;
+        }
+    }
+
+    return false;
+}
+
+inline void position_set::insert(std::size_t hash, std::size_t pos)
+{
+    std::size_t i = hash & mask;
+    while (slots[i].pos != empty)
+    {
+        i = (i + 1) & mask;
+    }
+    slots[i] = {hash, pos};
+}
+
+enum class set_operation
+{
+    unique,
+    intersect,
+    difference,
+};
+
+/** -----------------------------------------------------------------------------------------------
+ * @brief Flag the elements of a vector kept by a set operation, processing partitions in parallel.
+ * @param other: Vector to match against, unused for `set_operation::unique`.
+ *
+ * @details Only the first occurrence of each element can be kept; `intersect` then also requires
+ *          it to be in `other`, and `difference` to not be in it.
+ */
+template <class T>
+inline std::vector<std::uint8_t> set_flags(thread_pool*          pool,
+                                           std::size_t           grain,
+                                           const std::vector<T>& v,
+                                           const std::vector<T>& other,
+                                           set_operation         op)
+{
+    const std::size_t     parts  = partition_count(pool);
+    const hash_partitions mine   = partition_by_hash(pool, grain, v, parts);
+    const hash_partitions theirs = op == set_operation::unique ? hash_partitions{} :
+                                                                 partition_by_hash(pool, grain, other, parts);
+
+    std::vector<std::uint8_t> flags(v.size(), 0);
+    run_chunks(pool, parts, 1, [&](std::size_t begin, std::size_t end, std::size_t)
+               {
+                   position_set seen;
+                   position_set members;
+                   for (std::size_t p = begin; p < end; p++)
+                   {
+                       if (op != set_operation::unique)
+                       {
+                           members.reset(theirs.offsets[p + 1] - theirs.offsets[p]);
+                           for (std::size_t k = theirs.offsets[p]; k < theirs.offsets[p + 1]; k++)
+                           {
+                               /* Duplicates are skipped, they would only lengthen the probes. */
+                               const std::size_t      j = theirs.order[k];
+                               const std::string_view s = other[j];
+                               if (!members.contains(theirs.hashes[j], [&other, s](std::size_t m)
+                                                                       {
+                                                                           return std::string_view{other[m]} == s;
+                                                                       }))
+                               {
+                                   members.insert(theirs.hashes[j], j);
+                               }
+                           }
+                       }
+
+                       seen.reset(mine.offsets[p + 1] - mine.offsets[p]);
+                       for (std::size_t k = mine.offsets[p]; k < mine.offsets[p + 1]; k++)
+                       {
+                           const std::size_t      i = mine.order[k];
+                           const std::size_t      h = mine.hashes[i];
+                           const std::string_view s = v[i];
+
+                           if (seen.contains(h, [&v, s](std::size_t j)
+                                                {
+                                                    return std::string_view{v[j]} == s;
+                                                }))
+                           {
+                               continue;
+                           }
+                           seen.insert(h, i);
+
+                           bool keep = true;
+                           if (op != set_operation::unique)
+                           {
+                               const bool found = members.contains(h, [&other, s](std::size_t j)
+                                                                      {
+                                                                          return std::string_view{other[j]} == s;
+                                                                      });
+                               keep = found == (op == set_operation::intersect);
+                           }
+                           flags[i] = keep ? 1 : 0;
+                       }
+                   }
+               });
+
+    return flags;
+}
+
+/** -----------------------------------------------------------------------------------------------
+ * @brief Sort entry of the string sort: a cached prefix of the string, and its position.
+ *
+ * @details `rest` holds the position of the string in its low 60 bits, and in its high 4 bits
+ *          how many bytes are left after the cached prefix, capped at 9. Comparing entries as
+ *          (key, rest) thus orders strings by their prefix, then shorter strings first, then by
+ *          position, which makes the sort stable.
+ */
+struct prefix_entry
+{
+    std::uint64_t key;
+    std::uint64_t rest;
+
+    constexpr bool operator<(const prefix_entry& other) const
+    {
+        return key != other.key ? key < other.key : rest < other.rest;
+    }
+};
+
+constexpr std::size_t   prefix_bytes = 8;
+constexpr std::uint64_t prefix_tail  = prefix_bytes + 1;
+constexpr int           prefix_shift = 60;
+
+/** -----------------------------------------------------------------------------------------------
+ * @brief Load 8 bytes of a string from `depth` as a big-endian integer, padded with zeros.
+ */
+inline std::uint64_t load_prefix(const std::string_view s, std::size_t depth)
+{
+    std::uint64_t key = 0;
+    if (s.size() > depth)
+    {
+        std::memcpy(&key, s.data() + depth, std::min(prefix_bytes, s.size() - depth));
+    }
+    if constexpr (std::endian::native == std::endian::little)
+    {
+        key = std::byteswap(key);
+    }
+
+    return key;
+}
+
+inline prefix_entry make_prefix_entry(const std::string_view s, std::size_t pos, std::size_t depth)
+{
+    const std::uint64_t tail = std::min<std::uint64_t>(s.size() - depth, prefix_tail);
+    return {load_prefix(s, depth), (tail << prefix_shift) | pos};
+}
+
+inline std::size_t entry_position(const prefix_entry& entry)
+{
+    return static_cast<std::size_t>(entry.rest & ((std::uint64_t{1} << prefix_shift) - 1));
+}
+
+/** -----------------------------------------------------------------------------------------------
+ * @brief Sort entries whose prefixes were loaded at `depth`, then refine the ties 8 bytes deeper.
+ *
+ * @details Entries sharing both their prefix and a tail longer than the prefix come from strings
+ *          equal on their first `depth + 8` bytes and longer than that, so only they need another
+ *          pass. The strings are only touched to load their prefixes, never compared directly.
+ *          The ties are refined from an explicit stack rather than by recursion, since strings
+ *          sharing a long prefix need one pass per 8 bytes of it.
+ */
+template <class T>
+inline void sort_prefix_entries(const std::vector<T>& v, prefix_entry* first, prefix_entry* last, std::size_t depth)
+{
+    struct tie_run
+    {
+        prefix_entry* first;
+        prefix_entry* last;
+        std::size_t   depth;
+    };
+
+    std::vector<tie_run> pending{{first, last, depth}};
+    while (!pending.empty())
+    {
+        const tie_run range = pending.back();
+        pending.pop_back();
+
+        std::sort(range.first, range.last);
+
+        prefix_entry* it = range.first;
+        while (it != range.last)
+        {
+            prefix_entry* run = it + 1;
+            while (run != range.last && run->key == it->key && (run->rest >> prefix_shift) == (it->rest >> prefix_shift))
+            {
+                run++;
+            }
+
+            if (run - it > 1 && (it->rest >> prefix_shift) == prefix_tail)
+            {
+                const std::size_t next = range.depth + prefix_bytes;
+                for (prefix_entry* tie = it; tie != run; tie++)
+                {
+                    const std::size_t pos = entry_position(*tie);
+                    *tie                  = make_prefix_entry(std::string_view{v[pos]}, pos, next);
+                }
+                pending.push_back({it, run, next});
+            }
+
+            it = run;
+        }
+    }
+}
+
+/** -----------------------------------------------------------------------------------------------
+ * @brief Reorder a vector following sorted entries, moving each element once.
+ */
+template <class T>
+inline void apply_entries(thread_pool* pool, std::size_t grain, std::vector<T>& v, const std::vector<prefix_entry>& entries)
+{
+    std::vector<T> sorted(v.size());
+    run_chunks(pool, v.size(), grain, [&](std::size_t begin, std::size_t end, std::size_t)
+               {
+                   for (std::size_t i = begin; i < end; i++)
+                   {
+                       sorted[i] = std::move(v[entry_position(entries[i])]);
+                   }
+               });
+    v = std::move(sorted);
+}
+
+/** -----------------------------------------------------------------------------------------------
+ * @brief Sort strings in lexicographic order of their bytes, as `operator<` does.
+ *
+ * @details Strings are sorted through entries caching an 8-byte prefix of each, which keeps the
+ *          comparisons on contiguous integers instead of chasing a pointer per string and
+ *          re-comparing shared prefixes. With a pool, the entries are first distributed in 256
+ *          buckets on their first byte (an MSD radix pass), and the buckets are sorted in
+ *          parallel. The sort is stable.
+ */
+template <class T>
+inline void radix_sort_strings(thread_pool* pool, std::size_t grain, std::vector<T>& v)
+{
+    const std::size_t n = v.size();
+    if (n < 2)
+    {
+        return;
+    }
+
+    std::vector<prefix_entry> entries(n);
+    run_chunks(pool, n, grain, [&](std::size_t begin, std::size_t end, std::size_t)
+               {
+                   for (std::size_t i = begin; i < end; i++)
+                   {
+                       entries[i] = make_prefix_entry(std::string_view{v[i]}, i, 0);
+                   }
+               });
+
+    if (pool == nullptr || pool->chunks(n, grain) < 2)
+    {
+        sort_prefix_entries(v, entries.data(), entries.data() + n, 0);
+        apply_entries(pool, grain, v, entries);
+        return;
+    }
+
+    /* Bucket on the first byte, keeping the entries of a bucket in order of position. */
+    constexpr std::size_t     buckets = 256;
+    const std::size_t         chunks  = pool->chunks(n, grain);
+    std::vector<std::size_t>  counts(chunks * buckets, 0);
+    std::vector<std::size_t>  starts(buckets + 1, 0);
+    std::vector<prefix_entry> bucketed(n);
+
+    pool->parallel_for(n, grain, [&](std::size_t begin, std::size_t end, std::size_t chunk)
+                       {
+                           for (std::size_t i = begin; i < end; i++)
+                           {
+                               counts[chunk * buckets + (entries[i].key >> 56)]++;
+                           }
+                       });
+
+    std::size_t total = 0;
+    for (std::size_t b = 0; b < buckets; b++)
+    {
+        starts[b] = total;
+        for (std::size_t c = 0; c < chunks; c++)
+        {
+            const std::size_t count     = counts[c * buckets + b];
+            counts[c * buckets + b]     = total;
+            total                      += count;
+        }
+    }
+    starts[buckets] = total;
+
+    pool->parallel_for(n, grain, [&](std::size_t begin, std::size_t end, std::size_t chunk)
+                       {
+                           for (std::size_t i = begin; i < end; i++)
+                           {
+                               bucketed[counts[chunk * buckets + (entries[i].key >> 56)]++] = entries[i];
+                           }
+                       });
+
+    pool->parallel_for(buckets, 1, [&](std::size_t begin, std::size_t end, std::size_t)
+                       {
+                           for (std::size_t b = begin; b < end; b++)
+                           {
+                               sort_prefix_entries(v, bucketed.data() + starts[b], bucketed.data() + starts[b + 1], 0);
+                           }
+                       });
+
+    apply_entries(pool, grain, v, bucketed);
+}
+
+/** -----------------------------------------------------------------------------------------------
+ * @brief Sort strings by length with a stable counting sort.
+ *
+ * @details Each chunk builds a histogram of the lengths, a prefix sum over (length, chunk) gives
+ *          every chunk its write position for each length, and the chunks then move their
+ *          strings in place. When the longest string would make the histograms too large, a
+ *          stable comparison sort is used instead.
+ */
+template <class T>
+inline void counting_sort_length(thread_pool* pool, std::size_t grain, std::vector<T>& v)
+{
+    constexpr std::size_t max_parallel_keys   = std::size_t{1} << 12;
+    constexpr std::size_t max_sequential_keys = std::size_t{1} << 16;
+
+    const std::size_t n = v.size();
+    if (n < 2)
+    {
+        return;
+    }
+
+    std::size_t longest = 0;
+    for (const T& s : v)
+    {
+        longest = std::max(longest, std::string_view{s}.size());
+    }
+
+    const std::size_t keys = longest + 1;
+    if (pool != nullptr && keys > max_parallel_keys)
+    {
+        pool = nullptr;
+    }
+    if (keys > std::max(max_sequential_keys, n))
+    {
+        std::stable_sort(v.begin(), v.end(), [](const T& a, const T& b)
+                                             {
+                                                 return std::string_view{a}.size() < std::string_view{b}.size();
+                                             });
+        return;
+    }
+
+    const std::size_t        chunks = pool == nullptr ? 1 : pool->chunks(n, grain);
+    std::vector<std::size_t> counts(chunks * keys, 0);
+    run_chunks(pool, n, grain, [&](std::size_t begin, std::size_t end, std::size_t chunk)
+               {
+                   for (std::size_t i = begin; i < end; i++)
+                   {
+                       counts[chunk * keys + std::string_view{v[i]}.size()]++;
+                   }
+               });
+
+    std::size_t total = 0;
+    for (std::size_t k = 0; k < keys; k++)
+    {
+        for (std::size_t c = 0; c < chunks; c++)
+        {
+            const std::size_t count = counts[c * keys + k];
+            counts[c * keys + k]    = total;
+            total                  += count;
+        }
+    }
+
+    std::vector<T> sorted(n);
+    run_chunks(pool, n, grain, [&](std::size_t begin, std::size_t end, std::size_t chunk)
+               {
+                   for (std::size_t i = begin; i < end; i++)
+                   {
+                       sorted[counts[chunk * keys + std::string_view{v[i]}.size()]++] = std::move(v[i]);
+                   }
+               });
+    v = std::move(sorted);
+}
+
+}        // namespace stringvec_detail
+
+
+/** -----------------------------------------------------------------------------------------------
+ * @brief Start the worker threads.
+ * @param threads: Total number of threads working on a `parallel_for`, including the calling one.
+ *                 0 uses `std::thread::hardware_concurrency()`.
+ */
+inline thread_pool::thread_pool(std::size_t threads)
+{
+    if (threads == 0)
+    {
+        threads = std::max<std::size_t>(std::thread::hardware_concurrency(), 1);
+    }
+
+    workers.reserve(threads - 1);
+    for (std::size_t i = 1; i < threads; i++)
+    {
+        workers.emplace_back([this]()
+                             {
+                                 run();
+                             });
+    }
+}
+
+inline thread_pool::~thread_pool()
+{
+    {
+        std::lock_guard<std::mutex> lock{mtx};
+        stopping = true;
+    }
+    cv.notify_all();
+
+    for (std::thread& worker : workers)
+    {
+        worker.join();
+    }
+}
+
+/** -----------------------------------------------------------------------------------------------
+ * @brief Get the number of threads working on a `parallel_for`, including the calling one.
+ */
+inline std::size_t thread_pool::size() const
+{
+    return workers.size() + 1;
+}
+
+/** -----------------------------------------------------------------------------------------------
+ * @brief Get the number of chunks `parallel_for` splits `count` elements into.
+ */
+inline std::size_t thread_pool::chunks(std::size_t count, std::size_t grain) const
+{
+    const std::size_t wanted = (count + grain - 1) / std::max<std::size_t>(grain, 1);
+    return std::clamp<std::size_t>(wanted, 1, size() * 4);
+}
+
+/** -----------------------------------------------------------------------------------------------
+ * @brief Split `[0, count)` into contiguous chunks and process them on the pool.
+ * @param count: Number of elements.
+ * @param grain: Minimum number of elements per chunk.
+ * @param func:  Function called as `func(begin, end, chunk_index)` for each chunk.
+ *
+ * @details Blocks until every chunk is done. If a chunk throws, the first exception is rethrown
+ *          once all the chunks have finished.
+ */
+template <class Func>
+inline void thread_pool::parallel_for(std::size_t count, std::size_t grain, Func&& func)
+{
+    const std::size_t n = chunks(count, grain);
+    if (n == 1)
+    {
+        func(std::size_t{0}, count, std::size_t{0});
+        return;
+    }
+
+    struct job
+    {
+        std::mutex              mtx;
+        std::condition_variable done;
+        std::size_t             remaining;
+        std::exception_ptr      error;
+    } state;
+    state.remaining = n;
+
+    const auto chunk = [&state, &func, count, n](std::size_t c)
+                       {
+                           try
+                           {
+                               func(count * c / n, count * (c + 1) / n, c);
+                           }
+                           catch (...)
+                           {
+                               std::lock_guard<std::mutex> lock{state.mtx};
+                               if (!state.error)
+                               {
+                                   state.error = std::current_exception();
+                               }
+                           }
+
+                           std::lock_guard<std::mutex> lock{state.mtx};
+                           if (--state.remaining == 0)
+                           {
+                               state.done.notify_all();
+                           }
+                       };
+
+    {
+        std::lock_guard<std::mutex> lock{mtx};
+        for (std::size_t c = 1; c < n; c++)
+        {
+            tasks.emplace_back([&chunk, c]()
+                               {
+                                   chunk(c);
+                               });
+        }
+    }
+    cv.notify_all();
+
+    chunk(0);
+
+    /* Help with the queue instead of sleeping, which also makes nested calls safe. */
+    while (run_one())
+    {
+    }
+
+    std::unique_lock<std::mutex> lock{state.mtx};
+    state.done.wait(lock, [&state]()
+                    {
+                        return state.remaining == 0;
+                    });
+
+    if (state.error)
+    {
+        std::rethrow_exception(state.error);
+    }
+}
+
+/** -----------------------------------------------------------------------------------------------
+ * @brief Get the pool used by `stringvec_execution::par`, sized for the whole machine.
+ */
+inline thread_pool& thread_pool::global()
+{
+    static thread_pool pool;
+    return pool;
+}
+
+inline void thread_pool::run()
+{
+    while (true)
+    {
+        std::function<void()> task;
+        {
+            std::unique_lock<std::mutex> lock{mtx};
+            cv.wait(lock, [this]()
+                    {
+                        return stopping || !tasks.empty();
+                    });
+            if (tasks.empty())
+            {
+                return;
+            }
+
+            task = std::move(tasks.front());
+            tasks.pop_front();
+        }
+        task();
+    }
+}
+
+/** -----------------------------------------------------------------------------------------------
+ * @brief Run one queued task on the calling thread.
+ * @return False if the queue was empty.
+ */
+inline bool thread_pool::run_one()
+{
+    std::function<void()> task;
+    {
+        std::lock_guard<std::mutex> lock{mtx};
+        if (tasks.empty())
+        {
+            return false;
+        }
+
+        task = std::move(tasks.front());
+        tasks.pop_front();
+    }
+    task();
+    return true;
+}
+
+/**
+ * @}
+ */
+
+
+
+/** ===============================================================================================
+ *  MAPPED FILE
+ *
+ * @defgroup STRINGVEC_MAPPED_FILE              Mapped File
+ * @{
+ */
+
+/** -----------------------------------------------------------------------------------------------
+ * @class   mapped_file
+ *
+ * @brief   Read-only memory mapping of a whole file.
+ *
+ * @details On platforms without `mmap`, the file is read into a private buffer instead, so the
+ *          class can be used unconditionally.
+ */
+class mapped_file
+{
+public:
+    inline explicit mapped_file(const std::string& path);
+    inline ~mapped_file();
+
+    mapped_file(const mapped_file&)            = delete;
+    mapped_file& operator=(const mapped_file&) = delete;
+
+    inline const char*      data() const;
+    inline std::size_t      size() const;
+    inline std::string_view view() const;
+
+private:
+    const char* ptr = nullptr;
+    std::size_t len = 0;
+#if !STRINGVEC_HAS_MMAP
+    std::string buffer;
+#endif
+};
+
+/** -----------------------------------------------------------------------------------------------
+ * @brief Map a file in memory.
+ * @param path: File to map.
+ */
+inline mapped_file::mapped_file(const std::string& path)
+{
+#if STRINGVEC_HAS_MMAP
+    const int fd = ::open(path.c_str(), O_RDONLY);
+    if (fd < 0)
+    {
+        throw std::runtime_error("Couldn't open file: " + path);
+    }
+
+    struct stat st;
+    if (::fstat(fd, &st) != 0)
+    {
+        ::close(fd);
+        throw std::runtime_error("Couldn't stat file: " + path);
+    }
+
+    len = static_cast<std::size_t>(st.st_size);
+    if (len != 0)
+    {
+        void* p = ::mmap(nullptr, len, PROT_READ, MAP_PRIVATE, fd, 0);
+        if (p == MAP_FAILED)
+        {
+            ::close(fd);
+            throw std::runtime_error("Couldn't map file: " + path);
+        }
+        ::madvise(p, len, MADV_SEQUENTIAL);
+        ptr = static_cast<const char*>(p);
+    }
+
+    /* The mapping stays valid once the descriptor is closed. */
+    ::close(fd);
+#else
+    std::ifstream input(path, std::ios::binary);
+    if (!input)
+    {
+        throw std::runtime_error("Couldn't open file: " + path);
+    }
+
+    buffer.assign(std::istreambuf_iterator<char>(input), std::istreambuf_iterator<char>());
+    ptr = buffer.data();
+    len = buffer.size();
+#endif
+}
+
+inline mapped_file::~mapped_file()
+{
+#if STRINGVEC_HAS_MMAP
+    if (ptr != nullptr)
+    {
+        ::munmap(const_cast<char*>(ptr), len);
+    }
+#endif
+}
+
+/** -----------------------------------------------------------------------------------------------
+ * @brief Get a pointer to the first byte of the file.
+ */
+inline const char* mapped_file::data() const
+{
+    return ptr;
+}
+
+/** -----------------------------------------------------------------------------------------------
+ * @brief Get the size of the file, in bytes.
+ */
+inline std::size_t mapped_file::size() const
+{
+    return len;
+}
+
+/** -----------------------------------------------------------------------------------------------
+ * @brief Get the whole content of the file.
+ */
+inline std::string_view mapped_file::view() const
+{
+    return {ptr, len};
+}
+
+namespace stringvec_detail
+{
+
+/** -----------------------------------------------------------------------------------------------
+ * @brief Call a function on every line of a buffer, with the same semantics as `std::getline`.
+ * @param first: Start of the buffer.
+ * @param last:  End of the buffer.
+ * @param func:  Function called with each line, as a `std::string_view` without its '\n'.
+ *
+ * @details A last line without a terminating '\n' is reported, an empty one is not.
+ *          With SSE2, the newlines are located 16 bytes at a time, which is faster than calling
+ *          `memchr` once per line when lines are short.
+ */
+template <class Func>
+inline void for_each_line(const char* first, const char* last, Func&& func)
+{
+    const char* line = first;
+    const char* p    = first;
+
+#if STRINGVEC_HAS_SSE2
+    const __m128i newline = _mm_set1_epi8('\n');
+    for (; last - p >= 16; p += 16)
+    {
+        const __m128i block = _mm_loadu_si128(reinterpret_cast<const __m128i*>(p));
+        unsigned int  mask  = static_cast<unsigned int>(_mm_movemask_epi8(_mm_cmpeq_epi8(block, newline)));
+        while (mask != 0)
+        {
+            const char* eol = p + std::countr_zero(mask);
+            func(std::string_view{line, static_cast<std::size_t>(eol - line)});
+            line = eol + 1;
+            mask &= mask - 1;
+        }
+    }
+#endif
+
+    for (; p < last; p++)
+    {
+        if (*p == '\n')
+        {
+            func(std::string_view{line, static_cast<std::size_t>(p - line)});
+            line = p + 1;
+        }
+    }
+
+    if (line != last)
+    {
+        func(std::string_view{line, static_cast<std::size_t>(last - line)});
+    }
+}
+
+/** -----------------------------------------------------------------------------------------------
+ * @brief Split chunks of a file into lines as `std::getline` does, carrying the line cut at the
+ *        end of each chunk over to the next one.
+ */
+struct line_splitter
+{
+    std::string carry;
+
+    template <class Func>
+    inline void feed(const char* first, const char* last, Func&& func)
+    {
+        const char* eol = static_cast<const char*>(std::memchr(first, '\n', static_cast<std::size_t>(last - first)));
+        if (eol == nullptr)
+        {
+            carry.append(first, last);
+            return;
+        }
+
+        carry.append(first, eol);
+        func(std::string_view{carry});
+        carry.clear();
+
+        const std::size_t end = std::string_view{eol + 1, last}.rfind('\n');
+        if (end != std::string_view::npos)
+        {
+            for_each_line(eol + 1, eol + 2 + end, func);
+            eol += end + 1;
+        }
+        carry.assign(eol + 1, last);
+    }
+
+    template <class Func>
+    inline void finish(Func&& func)
+    {
+        if (!carry.empty())
+        {
+            func(std::string_view{carry});
+            carry.clear();
+        }
+    }
+};
+
+/** -----------------------------------------------------------------------------------------------
+ * @brief Split a buffer into lines, scanning byte ranges of it in parallel.
+ * @param pool: Pool to run on, or null to scan on the calling thread.
+ * @param data: Buffer to split.
+ * @param out:  Vector the lines are appended to, in order.
+ * @param make: Function converting each line to an element of `out`.
+ *
+ * @details The buffer is cut in one range per chunk, and each cut is moved just past the next
+ *          '\n', so that no line straddles two ranges. The ranges are split concurrently, then
+ *          their lines are moved into `out` at offsets given by a prefix sum of their counts.
+ */
+template <class T, class Make>
+inline void parallel_read_lines(thread_pool* pool, std::string_view data, std::vector<T>& out, Make&& make)
+{
+    constexpr std::size_t grain = std::size_t{1} << 20;
+
+    if (pool == nullptr || pool->chunks(data.size(), grain) < 2)
+    {
+        for_each_line(data.data(), data.data() + data.size(), [&out, &make](std::string_view line)
+                                                              {
+                                                                  out.push_back(make(line));
+                                                              });
+        return;
+    }
+
+    const std::size_t        chunks = pool->chunks(data.size(), grain);
+    std::vector<std::size_t> bounds(chunks + 1, data.size());
+    bounds[0] = 0;
+    for (std::size_t c = 1; c < chunks; c++)
+    {
+        const std::size_t cut = std::max(data.size() / chunks * c, bounds[c - 1]);
+        const std::size_t eol = data.find('\n', cut);
+        bounds[c] = eol == std::string_view::npos ? data.size() : eol + 1;
+    }
+
+    std::vector<std::vector<T>> parts(chunks);
+    pool->parallel_for(chunks, 1, [&](std::size_t begin, std::size_t end, std::size_t)
+                       {
+                           for (std::size_t c = begin; c < end; c++)
+                           {
+                               std::vector<T>& part = parts[c];
+                               for_each_line(data.data() + bounds[c],
+                                             data.data() + bounds[c + 1],
+                                             [&part, &make](std::string_view line)
+                                             {
+                                                 part.push_back(make(line));
+                                             });
+                           }
+                       });
+
+    std::vector<std::size_t> offsets(chunks + 1, out.size());
+    for (std::size_t c = 0; c < chunks; c++)
+    {
+        offsets[c + 1] = offsets[c] + parts[c].size();
+    }
+
+    out.resize(offsets.back());
+    pool->parallel_for(chunks, 1, [&](std::size_t begin, std::size_t end, std::size_t)
+                       {
+                           for (std::size_t c = begin; c < end; c++)
+                           {
+                               std::move(parts[c].begin(), parts[c].end(), out.begin() + offsets[c]);
+                               std::vector<T>{}.swap(parts[c]);
+                           }
+                       });
+}
+
+}        // namespace stringvec_detail
+
+namespace stringvec_detail
+{
+
+/** -----------------------------------------------------------------------------------------------
+ * @class   delimiter_set
+ *
+ * @brief   Set of single-character delimiters, searched for like `strpbrk` does.
+ *
+ * @details With SSE2 and up to 8 delimiters, 16 bytes are compared against every delimiter at
+ *          once. Otherwise, each byte is looked up in a 256-entry table.
+ */
+class delimiter_set
+{
+public:
+    inline explicit delimiter_set(const std::string_view chars);
+
+    inline bool        contains(char c) const;
+    inline const char* find(const char* first, const char* last) const;
+
+private:
+    static constexpr std::size_t max_vector_chars = 8;
+
+    std::bitset<256> table;
+    std::size_t      count = 0;
+#if STRINGVEC_HAS_SSE2
+    __m128i          needles[max_vector_chars];
+#endif
+};
+
+inline delimiter_set::delimiter_set(const std::string_view chars)
+{
+    for (const char c : chars)
+    {
+        const unsigned char u = static_cast<unsigned char>(c);
+        if (table.test(u))
+        {
+            continue;
+        }
+
+        table.set(u);
+#if STRINGVEC_HAS_SSE2
+        if (count < max_vector_chars)
+        {
+            needles[count] = _mm_set1_epi8(c);
+        }
+#endif
+        count++;
+    }
+}
+
+inline bool delimiter_set::contains(char c) const
+{
+    return table.test(static_cast<unsigned char>(c));
+}
+
+/** -----------------------------------------------------------------------------------------------
+ * @brief Find the first delimiter of a buffer.
+ * @return A pointer to the delimiter, or `last` if there is none.
+ */
+inline const char* delimiter_set::find(const char* first, const char* last) const
+{
+#if STRINGVEC_HAS_SSE2
+    if (count <= max_vector_chars)
+    {
+        for (; last - first >= 16; first += 16)
+        {
+            const __m128i block = _mm_loadu_si128(reinterpret_cast<const __m128i*>(first));
+            __m128i       hits  = _mm_setzero_si128();
+            for (std::size_t i = 0; i < count; i++)
+            {
+                hits = _mm_or_si128(hits, _mm_cmpeq_epi8(block, needles[i]));
+            }
+
+            const unsigned int mask = static_cast<unsigned int>(_mm_movemask_epi8(hits));
+            if (mask != 0)
+            {
+                return first + std::countr_zero(mask);
+            }
+        }
+    }
+#endif
+
+    for (; first < last; first++)
+    {
+        if (contains(*first))
+        {
+            return first;
+        }
+    }
+
+    return last;
+}
+
+/** -----------------------------------------------------------------------------------------------
+ * @brief Call a function on every token of a string separated by a delimiter string.
+ *
+ * @details Consecutive delimiters produce empty tokens, and a string without any delimiter is a
+ *          single token. An empty delimiter does not split the string.
+ */
+template <class Func>
+inline void for_each_token(const std::string_view s, const std::string_view delimiter, Func&& func)
+{
+    std::size_t start = 0;
+    if (!delimiter.empty())
+    {
+        std::size_t end;
+        while ((end = s.find(delimiter, start)) != std::string_view::npos)
+        {
+            func(s.substr(start, end - start));
+            start = end + delimiter.length();
+        }
+    }
+    func(s.substr(start));
+}
+
+/** -----------------------------------------------------------------------------------------------
+ * @brief Call a function on every token of a string separated by any of a set of characters.
+ */
+template <class Func>
+inline void for_each_token(const std::string_view s, const delimiter_set& delimiters, Func&& func)
+{
+    const char* const last  = s.data() + s.size();
+    const char*       start = s.data();
+    const char*       end;
+    while ((end = delimiters.find(start, last)) != last)
+    {
+        func(std::string_view{start, static_cast<std::size_t>(end - start)});
+        start = end + 1;
+    }
+    func(std::string_view{start, static_cast<std::size_t>(last - start)});
+}
+
+}        // namespace stringvec_detail
+
+namespace stringvec_detail
+{
+
+/** -----------------------------------------------------------------------------------------------
+ * @brief Check if a character is whitespace, as `std::isspace` does in the "C" locale.
+ */
+constexpr bool is_space(char c)
+{
+    return c == ' ' || (c >= '\t' && c <= '\r');
+}
+
+#if STRINGVEC_HAS_AVX2
+/** -----------------------------------------------------------------------------------------------
+ * @brief Get a mask with a bit set for every byte of a 32-byte block that is not whitespace.
+ */
+inline std::uint32_t non_space_mask(const char* p)
+{
+    const __m256i block = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(p));
+    const __m256i blank = _mm256_cmpeq_epi8(block, _mm256_set1_epi8(' '));
+
+    /* '\t' to '\r' are contiguous: (c - '\t') <= 4, as an unsigned comparison. */
+    const __m256i shifted = _mm256_sub_epi8(block, _mm256_set1_epi8('\t'));
+    const __m256i control = _mm256_cmpeq_epi8(_mm256_max_epu8(shifted, _mm256_set1_epi8(4)),
+                                              _mm256_set1_epi8(4));
+
+    return ~static_cast<std::uint32_t>(_mm256_movemask_epi8(_mm256_or_si256(blank, control)));
+}
+
+constexpr std::size_t space_block = 32;
+#elif STRINGVEC_HAS_SSE2
+/** -----------------------------------------------------------------------------------------------
+ * @brief Get a mask with a bit set for every byte of a 16-byte block that is not whitespace.
+ */
+inline std::uint32_t non_space_mask(const char* p)
+{
+    const __m128i block = _mm_loadu_si128(reinterpret_cast<const __m128i*>(p));
+    const __m128i blank = _mm_cmpeq_epi8(block, _mm_set1_epi8(' '));
+
+    /* '\t' to '\r' are contiguous: (c - '\t') <= 4, as an unsigned comparison. */
+    const __m128i shifted = _mm_sub_epi8(block, _mm_set1_epi8('\t'));
+    const __m128i control = _mm_cmpeq_epi8(_mm_max_epu8(shifted, _mm_set1_epi8(4)), _mm_set1_epi8(4));
+
+    return ~static_cast<std::uint32_t>(_mm_movemask_epi8(_mm_or_si128(blank, control))) & 0xFFFFu;
+}
+
+constexpr std::size_t space_block = 16;
+#endif
+
+/** -----------------------------------------------------------------------------------------------
+ * @brief Get the position of the first character of a string that is not whitespace.
+ * @return The position, or the size of the string if it is blank.
+ *
+ * @details 16 or 32 bytes are classified at once with SSE2 or AVX2, with a scalar fallback.
+ */
+inline std::size_t first_non_space(const std::string_view s)
+{
+    std::size_t i = 0;
+
+#if STRINGVEC_HAS_AVX2 || STRINGVEC_HAS_SSE2
+    for (; s.size() - i >= space_block; i += space_block)
+    {
+        const std::uint32_t mask = non_space_mask(s.data() + i);
+        if (mask != 0)
+        {
+            return i + std::countr_zero(mask);
+        }
+    }
+#endif
+
+    while (i < s.size() && is_space(s[i]))
+    {
+        i++;
+    }
+
+    return i;
+}
+
+/** -----------------------------------------------------------------------------------------------
+ * @brief Get the position following the last character of a string that is not whitespace.
+ * @return The position, or 0 if the string is blank.
+ */
+inline std::size_t last_non_space(const std::string_view s)
+{
+    std::size_t end = s.size();
+
+#if STRINGVEC_HAS_AVX2 || STRINGVEC_HAS_SSE2
+    for (; end >= space_block; end -= space_block)
+    {
+        const std::uint32_t mask = non_space_mask(s.data() + end - space_block);
+        if (mask != 0)
+        {
+            return end - space_block + (32 - std::countl_zero(mask));
+        }
+    }
+#endif
+
+    while (end > 0 && is_space(s[end - 1]))
+    {
+        end--;
+    }
+
+    return end;
+}
+
+/** -----------------------------------------------------------------------------------------------
+ * @brief Check if a string is empty or only made of whitespace.
+ */
+inline bool is_blank(const std::string_view s)
+{
+    return first_non_space(s) == s.size();
+}
+
+/** -----------------------------------------------------------------------------------------------
+ * @brief Get the part of a string between its leading and trailing whitespace.
+ */
+inline std::string_view trim_view(const std::string_view s)
+{
+    const std::size_t start = first_non_space(s);
+    if (start == s.size())
+    {
+        return s.substr(s.size());
+    }
+
+    return s.substr(start, last_non_space(s) - start);
+}
+
+/** -----------------------------------------------------------------------------------------------
+ * @brief Flip the case of the ASCII letters from `First` to `First + 25` of a buffer, in place,
+ *        leaving every other byte as is.
+ *
+ * @details With SSE2, 16 bytes are converted at once: moving `First` to the lowest signed byte
+ *          turns the range check into a single signed comparison.
+ */
+template <char First>
+inline void flip_ascii_case(char* p, const std::size_t n)
+{
+    std::size_t i = 0;
+
+#if STRINGVEC_HAS_SSE2
+    const __m128i shift = _mm_set1_epi8(static_cast<char>(-128 - First));
+    const __m128i limit = _mm_set1_epi8(static_cast<char>(-128 + 26));
+    const __m128i bit   = _mm_set1_epi8(0x20);
+    for (; n - i >= 16; i += 16)
+    {
+        const __m128i block   = _mm_loadu_si128(reinterpret_cast<const __m128i*>(p + i));
+        const __m128i letters = _mm_cmplt_epi8(_mm_add_epi8(block, shift), limit);
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(p + i), _mm_xor_si128(block, _mm_and_si128(letters, bit)));
+    }
+#endif
+
+    for (; i < n; i++)
+    {
+        if (static_cast<unsigned char>(p[i] - First) < 26)
+        {
+            p[i] = static_cast<char>(p[i] ^ 0x20);
+        }
+    }
+}
+
+/** -----------------------------------------------------------------------------------------------
+ * @brief Get the length of the ASCII prefix of a string, checking 16 bytes at once with SSE2.
+ */
+inline std::size_t ascii_prefix(const std::string_view s)
+{
+    std::size_t i = 0;
+
+#if STRINGVEC_HAS_SSE2
+    for (; s.size() - i >= 16; i += 16)
+    {
+        const __m128i      block = _mm_loadu_si128(reinterpret_cast<const __m128i*>(s.data() + i));
+        const unsigned int high  = static_cast<unsigned int>(_mm_movemask_epi8(block));
+        if (high != 0)
+        {
+            return i + std::countr_zero(high);
+        }
+    }
+#endif
+
+    while (i < s.size() && static_cast<unsigned char>(s[i]) < 0x80)
+    {
+        i++;
+    }
+
+    return i;
+}
+
+/** -----------------------------------------------------------------------------------------------
+ * @brief Decode the code point starting at position `i` of a string.
+ * @return The code point and its length in bytes, or a length of 0 if the bytes there are not
+ *         valid UTF-8: a stray or truncated sequence, an overlong encoding, a surrogate, or a code
+ *         point above U+10FFFF.
+ */
+inline std::pair<char32_t, std::size_t> decode_utf8(const std::string_view s, std::size_t i)
+{
+    const unsigned char lead = static_cast<unsigned char>(s[i]);
+    if (lead < 0x80)
+    {
+        return {lead, 1};
+    }
+
+    std::size_t length   = 0;
+    char32_t    cp       = 0;
+    char32_t    smallest = 0;
+    if ((lead & 0xE0) == 0xC0)
+    {
+        length   = 2;
+        cp       = lead & 0x1F;
+        smallest = 0x80;
+    }
+    else if ((lead & 0xF0) == 0xE0)
+    {
+        length   = 3;
+        cp       = lead & 0x0F;
+        smallest = 0x800;
+    }
+    else if ((lead & 0xF8) == 0xF0)
+    {
+        length   = 4;
+        cp       = lead & 0x07;
+        smallest = 0x10000;
+    }
+    else
+    {
+        return {0, 0};
+    }
+
+    if (s.size() - i < length)
+    {
+        return {0, 0};
+    }
+    for (std::size_t k = 1; k < length; k++)
+    {
+        const unsigned char next = static_cast<unsigned char>(s[i + k]);
+        if ((next & 0xC0) != 0x80)
+        {
+            return {0, 0};
+        }
+        cp = (cp << 6) | (next & 0x3F);
+    }
+
+    if (cp < smallest || cp > 0x10FFFF || (cp >= 0xD800 && cp < 0xE000))
+    {
+        return {0, 0};
+    }
+    return {cp, length};
+}
+
+/** -----------------------------------------------------------------------------------------------
+ * @brief Encode a code point in UTF-8.
+ * @return The number of bytes written to `out`, from 1 to 4.
+ */
+inline std::size_t encode_utf8(char32_t cp, char* out)
+{
+    if (cp < 0x80)
+    {
+        out[0] = static_cast<char>(cp);
+        return 1;
+    }
+    if (cp < 0x800)
+    {
+        out[0] = static_cast<char>(0xC0 | (cp >> 6));
+        out[1] = static_cast<char>(0x80 | (cp & 0x3F));
+        return 2;
+    }
+    if (cp < 0x10000)
+    {
+        out[0] = static_cast<char>(0xE0 | (cp >> 12));
+        out[1] = static_cast<char>(0x80 | ((cp >> 6) & 0x3F));
+        out[2] = static_cast<char>(0x80 | (cp & 0x3F));
+        return 3;
+    }
+    out[0] = static_cast<char>(0xF0 | (cp >> 18));
+    out[1] = static_cast<char>(0x80 | ((cp >> 12) & 0x3F));
+    out[2] = static_cast<char>(0x80 | ((cp >> 6) & 0x3F));
+    out[3] = static_cast<char>(0x80 | (cp & 0x3F));
+    return 4;
+}
+
+/** -----------------------------------------------------------------------------------------------
+ * @brief Check if a string is valid UTF-8, skipping over ASCII 16 bytes at a time with SSE2.
+ */
+inline bool valid_utf8(const std::string_view s)
+{
+    std::size_t i = 0;
+    while (i < s.size())
+    {
+        i += ascii_prefix(s.substr(i));
+        if (i == s.size())
+        {
+            break;
+        }
+
+        const std::size_t length = decode_utf8(s, i).second;
+        if (length == 0)
+        {
+            return false;
+        }
+        i += length;
+    }
+
+    return true;
+}
+
+/** -----------------------------------------------------------------------------------------------
+ * @brief Run of code points folded by adding `delta`, every `stride` code points from `first`.
+ */
+struct fold_range
+{
+    char32_t     first;
+    char32_t     last;
+    std::int32_t delta;
+    std::int32_t stride;
+};
+
+/** -----------------------------------------------------------------------------------------------
+ * @brief Simple case folding of the non-ASCII code points, the mappings of status C and S of
+ *        `CaseFolding.txt` from Unicode 14.0, sorted and not overlapping.
+ */
+inline constexpr fold_range fold_ranges[] = {
+    {0x000B5, 0x000B5,    775, 1}, {0x000C0, 0x000D6,     32, 1}, {0x000D8, 0x000DE,     32, 1},
+    {0x00100, 0x0012E,      1, 2}, {0x00132, 0x00136,      1, 2}, {0x00139, 0x00147,      1, 2},
+    {0x0014A, 0x00176,      1, 2}, {0x00178, 0x00178,   -121, 1}, {0x00179, 0x0017D,      1, 2},
+    {0x0017F, 0x0017F,   -268, 1}, {0x00181, 0x00181,    210, 1}, {0x00182, 0x00184,      1, 2},
+    {0x00186, 0x00186,    206, 1}, {0x00187, 0x00187,      1, 1}, {0x00189, 0x0018A,    205, 1},
+    {0x0018B, 0x0018B,      1, 1}, {0x0018E, 0x0018E,     79, 1}, {0x0018F, 0x0018F,    202, 1},
+    {0x00190, 0x00190,    203, 1}, {0x00191, 0x00191,      1, 1}, {0x00193, 0x00193,    205, 1},
+    {0x00194, 0x00194,    207, 1}, {0x00196, 0x00196,    211, 1}, {0x00197, 0x00197,    209, 1},
+    {0x00198, 0x00198,      1, 1}, {0x0019C, 0x0019C,    211, 1}, {0x0019D, 0x0019D,    213, 1},
+    {0x0019F, 0x0019F,    214, 1}, {0x001A0, 0x001A4,      1, 2}, {0x001A6, 0x001A6,    218, 1},
+    {0x001A7, 0x001A7,      1, 1}, {0x001A9, 0x001A9,    218, 1}, {0x001AC, 0x001AC,      1, 1},
+    {0x001AE, 0x001AE,    218, 1}, {0x001AF, 0x001AF,      1, 1}, {0x001B1, 0x001B2,    217, 1},
+    {0x001B3, 0x001B5,      1, 2}, {0x001B7, 0x001B7,    219, 1}, {0x001B8, 0x001B8,      1, 1},
+    {0x001BC, 0x001BC,      1, 1}, {0x001C4, 0x001C4,      2, 1}, {0x001C5, 0x001C5,      1, 1},
+    {0x001C7, 0x001C7,      2, 1}, {0x001C8, 0x001C8,      1, 1}, {0x001CA, 0x001CA,      2, 1},
+    {0x001CB, 0x001DB,      1, 2}, {0x001DE, 0x001EE,      1, 2}, {0x001F1, 0x001F1,      2, 1},
+    {0x001F2, 0x001F4,      1, 2}, {0x001F6, 0x001F6,    -97, 1}, {0x001F7, 0x001F7,    -56, 1},
+    {0x001F8, 0x0021E,      1, 2}, {0x00220, 0x00220,   -130, 1}, {0x00222, 0x00232,      1, 2},
+    {0x0023A, 0x0023A,  10795, 1}, {0x0023B, 0x0023B,      1, 1}, {0x0023D, 0x0023D,   -163, 1},
+    {0x0023E, 0x0023E,  10792, 1}, {0x00241, 0x00241,      1, 1}, {0x00243, 0x00243,   -195, 1},
+    {0x00244, 0x00244,     69, 1}, {0x00245, 0x00245,     71, 1}, {0x00246, 0x0024E,      1, 2},
+    {0x00345, 0x00345,    116, 1}, {0x00370, 0x00372,      1, 2}, {0x00376, 0x00376,      1, 1},
+    {0x0037F, 0x0037F,    116, 1}, {0x00386, 0x00386,     38, 1}, {0x00388, 0x0038A,     37, 1},
+    {0x0038C, 0x0038C,     64, 1}, {0x0038E, 0x0038F,     63, 1}, {0x00391, 0x003A1,     32, 1},
+    {0x003A3, 0x003AB,     32, 1}, {0x003C2, 0x003C2,      1, 1}, {0x003CF, 0x003CF,      8, 1},
+    {0x003D0, 0x003D0,    -30, 1}, {0x003D1, 0x003D1,    -25, 1}, {0x003D5, 0x003D5,    -15, 1},
+    {0x003D6, 0x003D6,    -22, 1}, {0x003D8, 0x003EE,      1, 2}, {0x003F0, 0x003F0,    -54, 1},
+    {0x003F1, 0x003F1,    -48, 1}, {0x003F4, 0x003F4,    -60, 1}, {0x003F5, 0x003F5,    -64, 1},
+    {0x003F7, 0x003F7,      1, 1}, {0x003F9, 0x003F9,     -7, 1}, {0x003FA, 0x003FA,      1, 1},
+    {0x003FD, 0x003FF,   -130, 1}, {0x00400, 0x0040F,     80, 1}, {0x00410, 0x0042F,     32, 1},
+    {0x00460, 0x00480,      1, 2}, {0x0048A, 0x004BE,      1, 2}, {0x004C0, 0x004C0,     15, 1},
+    {0x004C1, 0x004CD,      1, 2}, {0x004D0, 0x0052E,      1, 2}, {0x00531, 0x00556,     48, 1},
+    {0x010A0, 0x010C5,   7264, 1}, {0x010C7, 0x010C7,   7264, 1}, {0x010CD, 0x010CD,   7264, 1},
+    {0x013F8, 0x013FD,     -8, 1}, {0x01C80, 0x01C80,  -6222, 1}, {0x01C81, 0x01C81,  -6221, 1},
+    {0x01C82, 0x01C82,  -6212, 1}, {0x01C83, 0x01C84,  -6210, 1}, {0x01C85, 0x01C85,  -6211, 1},
+    {0x01C86, 0x01C86,  -6204, 1}, {0x01C87, 0x01C87,  -6180, 1}, {0x01C88, 0x01C88,  35267, 1},
+    {0x01C90, 0x01CBA,  -3008, 1}, {0x01CBD, 0x01CBF,  -3008, 1}, {0x01E00, 0x01E94,      1, 2},
+    {0x01E9B, 0x01E9B,    -58, 1}, {0x01E9E, 0x01E9E,  -7615, 1}, {0x01EA0, 0x01EFE,      1, 2},
+    {0x01F08, 0x01F0F,     -8, 1}, {0x01F18, 0x01F1D,     -8, 1}, {0x01F28, 0x01F2F,     -8, 1},
+    {0x01F38, 0x01F3F,     -8, 1}, {0x01F48, 0x01F4D,     -8, 1}, {0x01F59, 0x01F5F,     -8, 2},
+    {0x01F68, 0x01F6F,     -8, 1}, {0x01F88, 0x01F8F,     -8, 1}, {0x01F98, 0x01F9F,     -8, 1},
+    {0x01FA8, 0x01FAF,     -8, 1}, {0x01FB8, 0x01FB9,     -8, 1}, {0x01FBA, 0x01FBB,    -74, 1},
+    {0x01FBC, 0x01FBC,     -9, 1}, {0x01FBE, 0x01FBE,  -7173, 1}, {0x01FC8, 0x01FCB,    -86, 1},
+    {0x01FCC, 0x01FCC,     -9, 1}, {0x01FD8, 0x01FD9,     -8, 1}, {0x01FDA, 0x01FDB,   -100, 1},
+    {0x01FE8, 0x01FE9,     -8, 1}, {0x01FEA, 0x01FEB,   -112, 1}, {0x01FEC, 0x01FEC,     -7, 1},
+    {0x01FF8, 0x01FF9,   -128, 1}, {0x01FFA, 0x01FFB,   -126, 1}, {0x01FFC, 0x01FFC,     -9, 1},
+    {0x02126, 0x02126,  -7517, 1}, {0x0212A, 0x0212A,  -8383, 1}, {0x0212B, 0x0212B,  -8262, 1},
+    {0x02132, 0x02132,     28, 1}, {0x02160, 0x0216F,     16, 1}, {0x02183, 0x02183,      1, 1},
+    {0x024B6, 0x024CF,     26, 1}, {0x02C00, 0x02C2F,     48, 1}, {0x02C60, 0x02C60,      1, 1},
+    {0x02C62, 0x02C62, -10743, 1}, {0x02C63, 0x02C63,  -3814, 1}, {0x02C64, 0x02C64, -10727, 1},
+    {0x02C67, 0x02C6B,      1, 2}, {0x02C6D, 0x02C6D, -10780, 1}, {0x02C6E, 0x02C6E, -10749, 1},
+    {0x02C6F, 0x02C6F, -10783, 1}, {0x02C70, 0x02C70, -10782, 1}, {0x02C72, 0x02C72,      1, 1},
+    {0x02C75, 0x02C75,      1, 1}, {0x02C7E, 0x02C7F, -10815, 1}, {0x02C80, 0x02CE2,      1, 2},
+    {0x02CEB, 0x02CED,      1, 2}, {0x02CF2, 0x02CF2,      1, 1}, {0x0A640, 0x0A66C,      1, 2},
+    {0x0A680, 0x0A69A,      1, 2}, {0x0A722, 0x0A72E,      1, 2}, {0x0A732, 0x0A76E,      1, 2},
+    {0x0A779, 0x0A77B,      1, 2}, {0x0A77D, 0x0A77D, -35332, 1}, {0x0A77E, 0x0A786,      1, 2},
+    {0x0A78B, 0x0A78B,      1, 1}, {0x0A78D, 0x0A78D, -42280, 1}, {0x0A790, 0x0A792,      1, 2},
+    {0x0A796, 0x0A7A8,      1, 2}, {0x0A7AA, 0x0A7AA, -42308, 1}, {0x0A7AB, 0x0A7AB, -42319, 1},
+    {0x0A7AC, 0x0A7AC, -42315, 1}, {0x0A7AD, 0x0A7AD, -42305, 1}, {0x0A7AE, 0x0A7AE, -42308, 1},
+    {0x0A7B0, 0x0A7B0, -42258, 1}, {0x0A7B1, 0x0A7B1, -42282, 1}, {0x0A7B2, 0x0A7B2, -42261, 1},
+    {0x0A7B3, 0x0A7B3,    928, 1}, {0x0A7B4, 0x0A7C2,      1, 2}, {0x0A7C4, 0x0A7C4,    -48, 1},
+    {0x0A7C5, 0x0A7C5, -42307, 1}, {0x0A7C6, 0x0A7C6, -35384, 1}, {0x0A7C7, 0x0A7C9,      1, 2},
+    {0x0A7D0, 0x0A7D0,      1, 1}, {0x0A7D6, 0x0A7D8,      1, 2}, {0x0A7F5, 0x0A7F5,      1, 1},
+    {0x0AB70, 0x0ABBF, -38864, 1}, {0x0FF21, 0x0FF3A,     32, 1}, {0x10400, 0x10427,     40, 1},
+    {0x104B0, 0x104D3,     40, 1}, {0x10570, 0x1057A,     39, 1}, {0x1057C, 0x1058A,     39, 1},
+    {0x1058C, 0x10592,     39, 1}, {0x10594, 0x10595,     39, 1}, {0x10C80, 0x10CB2,     64, 1},
+    {0x118A0, 0x118BF,     32, 1}, {0x16E40, 0x16E5F,     32, 1}, {0x1E900, 0x1E921,     34, 1},
+};
+
+/** -----------------------------------------------------------------------------------------------
+ * @brief Get the simple case folding of a code point, itself if it has none.
+ */
+inline char32_t fold_code_point(char32_t cp)
+{
+    if (cp < 0x80)
+    {
+        return cp - U'A' < 26 ? cp + 0x20 : cp;
+    }
+
+    const fold_range* range = std::upper_bound(std::begin(fold_ranges), std::end(fold_ranges), cp,
+                                               [](char32_t c, const fold_range& r)
+                                               {
+                                                   return c < r.first;
+                                               });
+    if (range == std::begin(fold_ranges))
+    {
+        return cp;
+    }
+
+    range--;
+    if (cp > range->last || (cp - range->first) % static_cast<char32_t>(range->stride) != 0)
+    {
+        return cp;
+    }
+    return static_cast<char32_t>(static_cast<std::int32_t>(cp) + range->delta);
+}
+
+/** -----------------------------------------------------------------------------------------------
+ * @brief Apply simple case folding to a UTF-8 string, in place.
+ *
+ * @details Runs of ASCII are lowercased 16 bytes at a time, see `flip_ascii_case`, and the other
+ *          code points are folded one at a time. Bytes that are not valid UTF-8 are kept as is.
+ *          Folding only rarely makes a code point longer, as U+023A to U+2C65 does; the rest of the
+ *          string is then built in a new buffer.
+ */
+inline void casefold_utf8(std::string& s)
+{
+    std::size_t read = ascii_prefix(s);
+    flip_ascii_case<'A'>(s.data(), read);
+    if (read == s.size())
+    {
+        return;
+    }
+
+    std::size_t write = read;
+    std::string grown;
+    bool        growing = false;
+
+    /* Append `n` bytes folded from the `consumed` bytes at `read`, shifting them back in place. */
+    const auto emit = [&](const char* p, std::size_t n, std::size_t consumed)
+                      {
+                          if (!growing && write + n > read + consumed)
+                          {
+                              grown.reserve(s.size() + 16);
+                              grown.assign(s, 0, write);
+                              growing = true;
+                          }
+
+                          char* out = nullptr;
+                          if (growing)
+                          {
+                              grown.append(p, n);
+                              out = grown.data() + grown.size() - n;
+                          }
+                          else
+                          {
+                              std::memmove(s.data() + write, p, n);
+                              out = s.data() + write;
+                              write += n;
+                          }
+                          read += consumed;
+                          return out;
+                      };
+
+    while (read < s.size())
+    {
+        const std::size_t run = ascii_prefix(std::string_view{s}.substr(read));
+        if (run != 0)
+        {
+            char* out = emit(s.data() + read, run, run);
+            flip_ascii_case<'A'>(out, run);
+            continue;
+        }
+
+        const auto [cp, length] = decode_utf8(s, read);
+        if (length == 0)
+        {
+            emit(s.data() + read, 1, 1);
+            continue;
+        }
+
+        char              buffer[4];
+        const std::size_t n = encode_utf8(fold_code_point(cp), buffer);
+        emit(buffer, n, length);
+    }
+
+    if (growing)
+    {
+        s = std::move(grown);
+    }
+    else
+    {
+        s.resize(write);
+    }
+}
+
+/** -----------------------------------------------------------------------------------------------
+ * @class   icase_needle
+ *
+ * @brief   String compared to others regardless of case, both sides being case folded.
+ *
+ * @details The folded copy of the other string is kept between calls to save its allocation, so
+ *          an instance must not be shared between threads.
+ */
+class icase_needle
+{
+public:
+    inline explicit icase_needle(const std::string_view s);
+
+    inline bool found_in(const std::string_view s) const;
+    inline bool equals  (const std::string_view s) const;
+
+private:
+    inline std::string_view fold(const std::string_view s) const;
+
+    std::string         needle;
+    mutable std::string folded;
+};
+
+inline icase_needle::icase_needle(const std::string_view s)
+: needle{s}
+{
+    casefold_utf8(needle);
+}
+
+/** -----------------------------------------------------------------------------------------------
+ * @brief Check if a string contains the needle, regardless of case.
+ */
+inline bool icase_needle::found_in(const std::string_view s) const
+{
+    return fold(s).find(needle) != std::string_view::npos;
+}
+
+/** -----------------------------------------------------------------------------------------------
+ * @brief Check if a string is equal to the needle, regardless of case.
+ */
+inline bool icase_needle::equals(const std::string_view s) const
+{
+    return fold(s) == needle;
+}
+
+inline std::string_view icase_needle::fold(const std::string_view s) const
+{
+    folded.assign(s);
+    casefold_utf8(folded);
+    return folded;
+}
+
+}        // namespace stringvec_detail
+
+namespace stringvec_detail
+{
+
+/** -----------------------------------------------------------------------------------------------
+ * @class   flat_index
+ *
+ * @brief   Open-addressing hash table mapping the content of strings to their first and last
+ *          positions in a vector.
+ *
+ * @details The table is a single array probed linearly, kept at most half full. Slots store the
+ *          full hash, so the strings themselves are only compared on a hash match.
+ *          The index does not hold the strings: it must be queried with the vector it was built
+ *          from, and discarded whenever that vector changes.
+ */
+class flat_index
+{
+public:
+    static constexpr std::size_t npos = std::numeric_limits<std::size_t>::max();
+
+    template <class T>
+    inline explicit flat_index(const std::vector<T>& v);
+
+    template <class T>
+    inline std::size_t find (const std::vector<T>& v, const std::string_view s) const;
+    template <class T>
+    inline std::size_t rfind(const std::vector<T>& v, const std::string_view s) const;
+
+    inline std::size_t size() const;
+
+    inline void                                     save(std::vector<std::uint64_t>& out) const;
+    inline static std::shared_ptr<const flat_index> load(const char* data,
+                                                         std::size_t slot_count,
+                                                         std::size_t elements);
+    inline static std::uint64_t                     hash_check();
+
+private:
+    struct slot
+    {
+        std::size_t hash  = 0;
+        std::size_t first = npos;
+        std::size_t last  = npos;
+    };
+
+    flat_index() = default;
+
+    inline static std::size_t hash_of(const std::string_view s);
+
+    template <class T>
+    inline const slot* lookup(const std::vector<T>& v, const std::string_view s) const;
+
+    std::vector<slot> slots;
+    std::size_t       mask  = 0;
+    std::size_t       count = 0;
+};
+
+/** -----------------------------------------------------------------------------------------------
+ * @brief Index every string of a vector.
+ */
+template <class T>
+inline flat_index::flat_index(const std::vector<T>& v)
+{
+    slots.resize(std::bit_ceil(std::max<std::size_t>(v.size() * 2, 16)));
+    mask = slots.size() - 1;
+
+    for (std::size_t i = 0; i < v.size(); i++)
+    {
+        const std::string_view s = v[i];
+        const std::size_t      h = hash_of(s);
+        for (std::size_t pos = h & mask;; pos = (pos + 1) & mask)
+        {
+            slot& entry = slots[pos];
+            if (entry.first == npos)
+            {
+                entry = {h, i, i};
+                count++;
+                break;
+            }
+            if (entry.hash == h && std::string_view{v[entry.first]} == s)
+            {
+                entry.last = i;
+                break;
+            }
+        }
+    }
+}
+
+/** -----------------------------------------------------------------------------------------------
+ * @brief Get the position of the first string equal to `s`, or `npos`.
+ */
+template <class T>
+inline std::size_t flat_index::find(const std::vector<T>& v, const std::string_view s) const
+{
+    const slot* entry = lookup(v, s);
+    return entry != nullptr ? entry->first : npos;
+}
+
+/** -----------------------------------------------------------------------------------------------
+ * @brief Get the position of the last string equal to `s`, or `npos`.
+ */
+template <class T>
+inline std::size_t flat_index::rfind(const std::vector<T>& v, const std::string_view s) const
+{
+    const slot* entry = lookup(v, s);
+    return entry != nullptr ? entry->last : npos;
+}
+
+/** -----------------------------------------------------------------------------------------------
+ * @brief Get the number of distinct strings in the index.
+ */
+inline std::size_t flat_index::size() const
+{
+    return count;
+}
+
+/** -----------------------------------------------------------------------------------------------
+ * @brief Append the number of distinct strings, then the hash, first and last position of every
+ *        slot, to a buffer.
+ */
+inline void flat_index::save(std::vector<std::uint64_t>& out) const
+{
+    out.reserve(out.size() + 1 + slots.size() * 3);
+    out.push_back(count);
+    for (const slot& entry : slots)
+    {
+        out.insert(out.end(), {entry.hash, entry.first, entry.last});
+    }
+}
+
+/** -----------------------------------------------------------------------------------------------
+ * @brief Rebuild an index from what `save` wrote, without hashing any string.
+ * @param data:       Saved index, aligned or not.
+ * @param slot_count: Number of slots, a power of two.
+ * @param elements:   Size of the vector the index was built from.
+ * @return The index, or `nullptr` if it refers to positions outside of the vector.
+ */
+inline std::shared_ptr<const flat_index> flat_index::load(const char* data,
+                                                         std::size_t slot_count,
+                                                         std::size_t elements)
+{
+    static_assert(sizeof(slot) == 3 * sizeof(std::uint64_t));
+
+    auto index = std::shared_ptr<flat_index>{new flat_index{}};
+    std::memcpy(&index->count, data, sizeof(std::uint64_t));
+    index->slots.resize(slot_count);
+    std::memcpy(index->slots.data(), data + sizeof(std::uint64_t), slot_count * sizeof(slot));
+    index->mask = slot_count - 1;
+
+    /* Lookups stop at the first free slot, so at least one must be left. */
+    std::size_t used = 0;
+    for (const slot& entry : index->slots)
+    {
+        if (entry.first == npos)
+        {
+            continue;
+        }
+        if (entry.first > entry.last || entry.last >= elements)
+        {
+            return nullptr;
+        }
+        used++;
+    }
+    if (used != index->count || used == slot_count)
+    {
+        return nullptr;
+    }
+
+    return index;
+}
+
+/** -----------------------------------------------------------------------------------------------
+ * @brief Hash of a fixed string, telling whether a saved index used the same hash function.
+ */
+inline std::uint64_t flat_index::hash_check()
+{
+    return hash_of("stringvec");
+}
+
+inline std::size_t flat_index::hash_of(const std::string_view s)
+{
+    return std::hash<std::string_view>{}(s);
+}
+
+template <class T>
+inline const flat_index::slot* flat_index::lookup(const std::vector<T>& v, const std::string_view s) const
+{
+    const std::size_t h = hash_of(s);
+    for (std::size_t pos = h & mask;; pos = (pos + 1) & mask)
+    {
+        const slot& entry = slots[pos];
+        if (entry.first == npos)
+        {
+            return nullptr;
+        }
+        if (entry.hash == h && std::string_view{v[entry.first]} == s)
+        {
+            return &entry;
+        }
+    }
+}
+
+/** -----------------------------------------------------------------------------------------------
+ * @class   suffix_segment
+ *
+ * @brief   Suffix array over a run of consecutive strings of a vector.
+ *
+ * @details The strings are copied one after the other, each followed by a null byte, and every
+ *          position of that text is sorted by the suffix starting there. A needle without null
+ *          bytes cannot match across two strings, so its occurrences are one range of the array.
+ *          The suffixes starting a string, kept in the same order, answer prefix queries.
+ */
+class suffix_segment
+{
+public:
+    static constexpr std::size_t max_text = std::numeric_limits<std::uint32_t>::max();
+
+    template <class T>
+    inline suffix_segment(const std::vector<T>& v, std::size_t first, std::size_t last);
+
+    template <class Func>
+    inline void for_each_containing (const std::string_view s, Func&& func) const;
+    template <class Func>
+    inline void for_each_with_prefix(const std::string_view s, Func&& func) const;
+
+    inline std::size_t size() const;
+    inline std::size_t bytes() const;
+
+private:
+    inline void        sort_suffixes();
+    inline std::size_t string_at(std::uint32_t pos) const;
+
+    template <class Func>
+    inline void for_each_match(const std::vector<std::uint32_t>& sorted,
+                               const std::string_view            s,
+                               Func&&                            func) const;
+
+    std::string                text;
+    std::vector<std::uint32_t> starts;          //!< Position of each string in the text, then its size.
+    std::vector<std::uint32_t> suffixes;        //!< Every position of the text, sorted by suffix.
+    std::vector<std::uint32_t> heads;           //!< Starts of the strings, sorted by suffix.
+};
+
+/** -----------------------------------------------------------------------------------------------
+ * @brief Index the strings in `[first, last)` of a vector, of at most `max_text` bytes in total
+ *        counting a terminator each.
+ */
+template <class T>
+inline suffix_segment::suffix_segment(const std::vector<T>& v, std::size_t first, std::size_t last)
+{
+    std::size_t total = 0;
+    for (std::size_t i = first; i < last; i++)
+    {
+        total += std::string_view{v[i]}.size() + 1;
+    }
+
+    text.reserve(total);
+    starts.reserve(last - first + 1);
+    for (std::size_t i = first; i < last; i++)
+    {
+        starts.push_back(static_cast<std::uint32_t>(text.size()));
+        text.append(std::string_view{v[i]});
+        text.push_back('\0');
+    }
+    starts.push_back(static_cast<std::uint32_t>(text.size()));
+
+    sort_suffixes();
+
+    std::vector<bool> is_start(text.size());
+    for (std::size_t i = 0; i + 1 < starts.size(); i++)
+    {
+        is_start[starts[i]] = true;
+    }
+    heads.reserve(last - first);
+    for (const std::uint32_t pos : suffixes)
+    {
+        if (is_start[pos])
+        {
+            heads.push_back(pos);
+        }
+    }
+}
+
+/** -----------------------------------------------------------------------------------------------
+ * @brief Call `func(i)` for each occurrence of `s` in the `i`-th string of the segment, in no
+ *        particular order. `s` must neither be empty nor contain a null byte.
+ */
+template <class Func>
+inline void suffix_segment::for_each_containing(const std::string_view s, Func&& func) const
+{
+    for_each_match(suffixes, s, std::forward<Func>(func));
+}
+
+/** -----------------------------------------------------------------------------------------------
+ * @brief Call `func(i)` for each `i`-th string of the segment starting with `s`, in no particular
+ *        order. `s` must neither be empty nor contain a null byte.
+ */
+template <class Func>
+inline void suffix_segment::for_each_with_prefix(const std::string_view s, Func&& func) const
+{
+    for_each_match(heads, s, std::forward<Func>(func));
+}
+
+/** -----------------------------------------------------------------------------------------------
+ * @brief Get the number of strings in the segment.
+ */
+inline std::size_t suffix_segment::size() const
+{
+    return starts.size() - 1;
+}
+
+/** -----------------------------------------------------------------------------------------------
+ * @brief Get the size of the text of the segment, terminators included.
+ */
+inline std::size_t suffix_segment::bytes() const
+{
+    return text.size();
+}
+
+/** -----------------------------------------------------------------------------------------------
+ * @brief Sort the suffixes by prefix doubling: once sorted on their first `k` bytes, the rank of
+ *        the suffix `k` bytes further sorts them on `2k`, with two counting sorts.
+ */
+inline void suffix_segment::sort_suffixes()
+{
+    const std::size_t n = text.size();
+    suffixes.resize(n);
+    if (n == 0)
+    {
+        return;
+    }
+
+    std::vector<std::uint32_t> rank(n);
+    std::vector<std::uint32_t> next(n);
+    std::vector<std::uint32_t> by_second(n);
+    std::vector<std::uint32_t> counts(std::max<std::size_t>(n, 256) + 1);
+
+    for (std::size_t i = 0; i < n; i++)
+    {
+        rank[i] = static_cast<unsigned char>(text[i]);
+        counts[rank[i] + 1]++;
+    }
+    std::partial_sum(counts.begin(), counts.begin() + 257, counts.begin());
+    for (std::size_t i = 0; i < n; i++)
+    {
+        suffixes[counts[rank[i]]++] = static_cast<std::uint32_t>(i);
+    }
+
+    std::size_t classes = 256;
+    for (std::size_t k = 1;; k *= 2)
+    {
+        /* Suffixes with nothing `k` bytes further come first, then in the order of that suffix. */
+        std::size_t count = 0;
+        for (std::size_t i = n - std::min(k, n); i < n; i++)
+        {
+            by_second[count++] = static_cast<std::uint32_t>(i);
+        }
+        for (const std::uint32_t pos : suffixes)
+        {
+            if (pos >= k)
+            {
+                by_second[count++] = static_cast<std::uint32_t>(pos - k);
+            }
+        }
+
+        /* Stable counting sort on the rank of the first `k` bytes. */
+        std::fill(counts.begin(), counts.begin() + classes + 1, 0);
+        for (std::size_t i = 0; i < n; i++)
+        {
+            counts[rank[i] + 1]++;
+        }
+        std::partial_sum(counts.begin(), counts.begin() + classes + 1, counts.begin());
+        for (const std::uint32_t pos : by_second)
+        {
+            suffixes[counts[rank[pos]]++] = pos;
+        }
+
+        const auto second = [&](std::uint32_t pos) -> std::size_t
+                            {
+                                return pos + k < n ? rank[pos + k] + std::size_t{1} : 0;
+                            };
+        next[suffixes[0]] = 0;
+        classes           = 1;
+        for (std::size_t i = 1; i < n; i++)
+        {
+            const std::uint32_t pos  = suffixes[i];
+            const std::uint32_t prev = suffixes[i - 1];
+            if (rank[pos] != rank[prev] || second(pos) != second(prev))
+            {
+                classes++;
+            }
+            next[pos] = static_cast<std::uint32_t>(classes - 1);
+        }
+        rank.swap(next);
+
+        if (classes == n)
+        {
+            return;
+        }
+    }
+}
+
+inline std::size_t suffix_segment::string_at(std::uint32_t pos) const
+{
+    return static_cast<std::size_t>(std::upper_bound(starts.begin(), starts.end(), pos) - starts.begin()) - 1;
+}
+
+template <class Func>
+inline void suffix_segment::for_each_match(const std::vector<std::uint32_t>& sorted,
+                                           const std::string_view            s,
+                                           Func&&                            func) const
+{
+    const std::string_view all{text};
+    const auto head = [&](std::uint32_t pos)
+                      {
+                          return all.substr(pos, s.size());
+                      };
+
+    const auto first = std::partition_point(sorted.begin(), sorted.end(), [&](std::uint32_t pos)
+                                                                          {
+                                                                              return head(pos) < s;
+                                                                          });
+    const auto last  = std::partition_point(first, sorted.end(), [&](std::uint32_t pos)
+                                                                 {
+                                                                     return head(pos) == s;
+                                                                 });
+    for (auto it = first; it != last; ++it)
+    {
+        func(string_at(*it));
+    }
+}
+
+/** -----------------------------------------------------------------------------------------------
+ * @class   search_index
+ *
+ * @brief   Substring and prefix index of a vector of strings, made of suffix array segments.
+ *
+ * @details Each part maps a run of live strings of a segment to their positions in the vector.
+ *          Strings pushed at the back are scanned by every query until `tail_limit` of them
+ *          gather, then get a segment of their own, merged with the previous ones while of
+ *          comparable size so that there are O(log N) of them. Erasing a range only trims or
+ *          splits the parts over it, and a segment is rebuilt once most of its strings are gone.
+ *          As with `flat_index`, queries take the vector the index was kept up to date with. An
+ *          index is never modified once built, so that copies of the vector can share it.
+ */
+class search_index
+{
+public:
+    static constexpr std::size_t tail_limit = 4096;
+
+    template <class T>
+    inline explicit search_index(const std::vector<T>& v);
+
+    template <class T>
+    inline std::shared_ptr<const search_index> appended(const std::vector<T>& v) const;
+    template <class T>
+    inline std::shared_ptr<const search_index> erased(const std::vector<T>& v,
+                                                      std::size_t           first,
+                                                      std::size_t           last) const;
+
+    template <class T>
+    inline std::vector<std::size_t> containing (const std::vector<T>& v, const std::string_view s) const;
+    template <class T>
+    inline std::vector<std::size_t> with_prefix(const std::vector<T>& v, const std::string_view s) const;
+
+    template <class T, class Pred>
+    inline static std::vector<std::size_t> scan(const std::vector<T>& v, std::size_t first, Pred&& pred);
+
+private:
+    struct part
+    {
+        std::shared_ptr<const suffix_segment> segment;
+        std::size_t                           first;           //!< First live string of the segment.
+        std::size_t                           last;            //!< End of the live strings of the segment.
+        std::size_t                           position;        //!< Position of string `first` in the vector.
+
+        std::size_t live() const
+        {
+            return last - first;
+        }
+    };
+
+    search_index() = default;
+
+    template <class T>
+    inline static void index_range(const std::vector<T>& v,
+                                   std::size_t           first,
+                                   std::size_t           last,
+                                   std::vector<part>&    out);
+    template <class T>
+    inline void settle(const std::vector<T>& v);
+
+    template <class T, class Query, class Pred>
+    inline std::vector<std::size_t> query(const std::vector<T>& v,
+                                          const std::string_view s,
+                                          Query&&                from_segment,
+                                          Pred&&                 pred) const;
+
+    std::vector<part> parts;
+    std::size_t       indexed = 0;        //!< Strings covered by the parts, all the others being the tail.
+};
+
+/** -----------------------------------------------------------------------------------------------
+ * @brief Index every string of a vector.
+ * @throw std::length_error if a string does not fit in a segment.
+ */
+template <class T>
+inline search_index::search_index(const std::vector<T>& v)
+{
+    index_range(v, 0, v.size(), parts);
+    indexed = v.size();
+}
+
+/** -----------------------------------------------------------------------------------------------
+ * @brief Get the index of a vector after strings were pushed at its back.
+ */
+template <class T>
+inline std::shared_ptr<const search_index> search_index::appended(const std::vector<T>& v) const
+{
+    auto index = std::make_shared<search_index>(*this);
+    index->settle(v);
+    return index;
+}
+
+/** -----------------------------------------------------------------------------------------------
+ * @brief Get the index of a vector after the strings in `[first, last)` were erased from it.
+ */
+template <class T>
+inline std::shared_ptr<const search_index> search_index::erased(const std::vector<T>& v,
+                                                                std::size_t           first,
+                                                                std::size_t           last) const
+{
+    const std::size_t removed = last - first;
+
+    auto index = std::shared_ptr<search_index>{new search_index{}};
+    for (const part& p : parts)
+    {
+        const std::size_t start = p.position;
+        const std::size_t end   = p.position + p.live();
+        if (end <= first)
+        {
+            index->parts.push_back(p);
+        }
+        else if (start >= last)
+        {
+            index->parts.push_back({p.segment, p.first, p.last, start - removed});
+        }
+        else
+        {
+            /* Keep what is left on either side of the erased range. */
+            if (start < first)
+            {
+                index->parts.push_back({p.segment, p.first, p.first + (first - start), start});
+            }
+            if (end > last)
+            {
+                index->parts.push_back({p.segment, p.last - (end - last), p.last, first});
+            }
+        }
+    }
+    index->indexed = indexed - (std::min(last, indexed) - std::min(first, indexed));
+
+    index->settle(v);
+    return index;
+}
+
+/** -----------------------------------------------------------------------------------------------
+ * @brief Get the positions of the strings containing `s`, in order.
+ */
+template <class T>
+inline std::vector<std::size_t> search_index::containing(const std::vector<T>& v, const std::string_view s) const
+{
+    return query(v,
+                 s,
+                 [](const suffix_segment& segment, const std::string_view needle, auto&& func)
+                 {
+                     segment.for_each_containing(needle, func);
+                 },
+                 [s](const std::string_view x)
+                 {
+                     return x.find(s) != std::string_view::npos;
+                 });
+}
+
+/** -----------------------------------------------------------------------------------------------
+ * @brief Get the positions of the strings starting with `s`, in order.
+ */
+template <class T>
+inline std::vector<std::size_t> search_index::with_prefix(const std::vector<T>& v, const std::string_view s) const
+{
+    return query(v,
+                 s,
+                 [](const suffix_segment& segment, const std::string_view needle, auto&& func)
+                 {
+                     segment.for_each_with_prefix(needle, func);
+                 },
+                 [s](const std::string_view x)
+                 {
+                     return x.starts_with(s);
+                 });
+}
+
+/** -----------------------------------------------------------------------------------------------
+ * @brief Get the positions, from `first` on, of the strings of a vector matching a predicate.
+ */
+template <class T, class Pred>
+inline std::vector<std::size_t> search_index::scan(const std::vector<T>& v, std::size_t first, Pred&& pred)
+{
+    std::vector<std::size_t> positions;
+    for (std::size_t i = first; i < v.size(); i++)
+    {
+        if (pred(std::string_view{v[i]}))
+        {
+            positions.push_back(i);
+        }
+    }
+    return positions;
+}
+
+/** -----------------------------------------------------------------------------------------------
+ * @brief Append parts indexing the strings in `[first, last)`, split into segments that fit.
+ */
+template <class T>
+inline void search_index::index_range(const std::vector<T>& v,
+                                      std::size_t           first,
+                                      std::size_t           last,
+                                      std::vector<part>&    out)
+{
+    const auto add = [&](std::size_t from, std::size_t to)
+                     {
+                         out.push_back({std::make_shared<const suffix_segment>(v, from, to), 0, to - from, from});
+                     };
+
+    std::size_t start = first;
+    std::size_t bytes = 0;
+    for (std::size_t i = first; i < last; i++)
+    {
+        const std::size_t length = std::string_view{v[i]}.size() + 1;
+        if (length > suffix_segment::max_text)
+        {
+            throw std::length_error("String too long for the search index");
+        }
+        if (bytes + length > suffix_segment::max_text)
+        {
+            add(start, i);
+            start = i;
+            bytes = 0;
+        }
+        bytes += length;
+    }
+    if (start < last)
+    {
+        add(start, last);
+    }
+}
+
+/** -----------------------------------------------------------------------------------------------
+ * @brief Rebuild the segments mostly made of erased strings, index the tail once it is long enough,
+ *        and merge the newest segments while they are of comparable size.
+ */
+template <class T>
+inline void search_index::settle(const std::vector<T>& v)
+{
+    std::vector<part> kept;
+    kept.reserve(parts.size());
+    for (const part& p : parts)
+    {
+        if (p.live() * 2 < p.segment->size())
+        {
+            index_range(v, p.position, p.position + p.live(), kept);
+        }
+        else
+        {
+            kept.push_back(p);
+        }
+    }
+    parts = std::move(kept);
+
+    if (v.size() - indexed < tail_limit)
+    {
+        return;
+    }
+    index_range(v, indexed, v.size(), parts);
+    indexed = v.size();
+
+    while (parts.size() >= 2)
+    {
+        const part older = parts[parts.size() - 2];
+        const part newer = parts.back();
+        if (older.live() > newer.live() * 2 ||
+            older.segment->bytes() + newer.segment->bytes() > suffix_segment::max_text)
+        {
+            break;
+        }
+
+        parts.resize(parts.size() - 2);
+        index_range(v, older.position, newer.position + newer.live(), parts);
+    }
+}
+
+template <class T, class Query, class Pred>
+inline std::vector<std::size_t> search_index::query(const std::vector<T>& v,
+                                                    const std::string_view s,
+                                                    Query&&                from_segment,
+                                                    Pred&&                 pred) const
+{
+    /* Empty needles match every string, and needles with a null byte may cross the terminators. */
+    if (s.empty() || s.find('\0') != std::string_view::npos)
+    {
+        return scan(v, 0, pred);
+    }
+
+    std::vector<std::size_t> positions;
+    for (const part& p : parts)
+    {
+        from_segment(*p.segment, s, [&](std::size_t i)
+                                    {
+                                        if (i >= p.first && i < p.last)
+                                        {
+                                            positions.push_back(p.position + (i - p.first));
+                                        }
+                                    });
+    }
+    std::sort(positions.begin(), positions.end());
+    positions.erase(std::unique(positions.begin(), positions.end()), positions.end());
+
+    const std::vector<std::size_t> tail = scan(v, indexed, pred);
+    positions.insert(positions.end(), tail.begin(), tail.end());
+
+    return positions;
+}
+
+/** -----------------------------------------------------------------------------------------------
+ * @brief Comparison of strings and views by length only.
+ */
+struct length_less
+{
+    template <class A, class B>
+    constexpr bool operator()(const A& a, const B& b) const
+    {
+        return std::string_view{a}.size() < std::string_view{b}.size();
+    }
+};
+
+}        // namespace stringvec_detail
+
+/**
+ * @}
+ */
+
+
+
+/** ===============================================================================================
+ *  FILE WRITER
+ *
+ * @defgroup STRINGVEC_FILE_WRITER              File Writer
+ * @{
+ */
+
+/** -----------------------------------------------------------------------------------------------
+ * @enum    compression
+ *
+ * @brief   Codec of a compressed file.
+ */
+enum class compression
+{
+    automatic,        ///< From the magic bytes when reading, from the extension when writing
+    none,             ///< Plain text
+    gzip,             ///< gzip (`.gz`), only available when compiled with `STRINGVEC_USE_ZLIB`
+    zstd,             ///< Zstandard (`.zst`), only available when compiled with `STRINGVEC_USE_ZSTD`
+    lz4,              ///< LZ4 frames (`.lz4`), only available when compiled with `STRINGVEC_USE_LZ4`
+};
+
+/** -----------------------------------------------------------------------------------------------
+ * @brief Options of the `write_file` methods.
+ */
+struct write_options
+{
+    std::size_t buffer_size = 1 << 20;                  //!< Bytes gathered before each write.
+    bool        direct      = false;                    //!< Bypass the page cache with `O_DIRECT`, if supported.
+    bool        sync        = false;                    //!< Flush the data to the device before returning.
+    compression codec       = compression::automatic;   //!< Codec of the file, see `compression`.
+    int         level       = 0;                        //!< Compression level, 0 for the default of the codec.
+    std::size_t threads     = 0;                        //!< zstd compression threads, 0 for one per core.
+};
+
+/** -----------------------------------------------------------------------------------------------
+ * @class   file_writer
+ *
+ * @brief   Write-only file gathering small writes into large blocks.
+ *
+ * @details Chunks at least as large as half of the buffer skip it and are written straight from
+ *          their storage with `writev`, next to whatever was buffered. With `O_DIRECT`, the buffer
+ *          is block-aligned, everything goes through it, and the unaligned tail is written once
+ *          direct I/O is turned off again. On platforms without POSIX I/O, an `std::ofstream` is
+ *          used instead, so the class can be used unconditionally.
+ */
+class file_writer
+{
+public:
+    inline explicit file_writer(const std::string& path, const write_options& options = {});
+    inline ~file_writer();
+
+    file_writer(const file_writer&)            = delete;
+    file_writer& operator=(const file_writer&) = delete;
+
+    inline void write(std::string_view s);
+    inline void close();
+
+private:
+    static constexpr std::size_t alignment = 4096;
+
+    inline void              flush(std::string_view extra = {});
+    [[noreturn]] inline void fail() const;
+
+    struct free_deleter
+    {
+        void operator()(char* p) const
+        {
+            std::free(p);
+        }
+    };
+
+    std::string                        file;
+    std::unique_ptr<char, free_deleter> buffer;
+    std::size_t                        capacity = 0;
+    std::size_t                        used     = 0;
+    bool                               direct   = false;
+    bool                               sync     = false;
+#if STRINGVEC_HAS_MMAP
+    int fd = -1;
+#else
+    std::ofstream output;
+#endif
+};
+
+/** -----------------------------------------------------------------------------------------------
+ * @brief Create or truncate a file for writing.
+ * @param path:    File to write to.
+ * @param options: Buffering and synchronisation options, see `write_options`.
+ */
+inline file_writer::file_writer(const std::string& path, const write_options& options)
+    : file{path}, sync{options.sync}
+{
+    capacity = std::max(options.buffer_size, alignment);
+
+#if STRINGVEC_HAS_MMAP
+#ifdef O_DIRECT
+    if (options.direct)
+    {
+        /* Not every filesystem supports direct I/O: fall back to buffered writes. */
+        fd     = ::open(path.c_str(), O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC | O_DIRECT, 0666);
+        direct = fd >= 0;
+    }
+#endif
+    if (fd < 0)
+    {
+        fd = ::open(path.c_str(), O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0666);
+    }
+    if (fd < 0)
+    {
+        fail();
+    }
+#else
+    output.open(path, std::ios::binary);
+    if (!output)
+    {
+        fail();
+    }
+#endif
+
+    if (direct)
+    {
+        capacity = (capacity + alignment - 1) / alignment * alignment;
+    }
+    buffer.reset(static_cast<char*>(std::aligned_alloc(alignment, (capacity + alignment - 1) / alignment * alignment)));
+    if (!buffer)
+    {
+        throw std::bad_alloc{};
+    }
+}
+
+/** -----------------------------------------------------------------------------------------------
+ * @brief Write the remaining data and close the file, ignoring errors. Call `close` to get them.
+ */
+inline file_writer::~file_writer()
+{
+    try
+    {
+        close();
+    }
+    catch (const std::exception&)
+    {
+#if STRINGVEC_HAS_MMAP
+        if (fd >= 0)
+        {
+            ::close(fd);
+        }
+#endif
+    }
+}
+
+/** -----------------------------------------------------------------------------------------------
+ * @brief Append bytes to the file.
+ * @param s: Bytes to write.
+ */
+inline void file_writer::write(std::string_view s)
+{
+    if (!direct && s.size() >= capacity / 2)
+    {
+        flush(s);
+        return;
+    }
+
+    while (!s.empty())
+    {
+        const std::size_t count = std::min(s.size(), capacity - used);
+        std::memcpy(buffer.get() + used, s.data(), count);
+        used += count;
+        s.remove_prefix(count);
+
+        if (used == capacity)
+        {
+            flush();
+        }
+    }
+}
+
+/** -----------------------------------------------------------------------------------------------
+ * @brief Write the remaining data, synchronise it if requested, and close the file.
+ *
+ * @throws std::runtime_error if any write failed.
+ */
+inline void file_writer::close()
+{
+#if STRINGVEC_HAS_MMAP
+    if (fd < 0)
+    {
+        return;
+    }
+
+    if (direct && used % alignment != 0)
+    {
+        /* Write the aligned blocks directly, then the tail through the page cache. */
+        const std::size_t blocks = used / alignment * alignment;
+        const std::size_t tail   = used - blocks;
+        used                     = blocks;
+        flush();
+        std::memmove(buffer.get(), buffer.get() + blocks, tail);
+        used   = tail;
+        direct = false;
+        if (::fcntl(fd, F_SETFL, ::fcntl(fd, F_GETFL) & ~O_DIRECT) != 0)
+        {
+            fail();
+        }
+    }
+    flush();
+
+    if (sync && ::fdatasync(fd) != 0)
+    {
+        fail();
+    }
+
+    const int closing = fd;
+    fd                = -1;
+    if (::close(closing) != 0)
+    {
+        throw std::runtime_error("Couldn't write to file: " + file);
+    }
+#else
+    if (!output.is_open())
+    {
+        return;
+    }
+
+    flush();
+    output.close();
+    if (!output)
+    {
+        fail();
+    }
+#endif
+}
+
+/** -----------------------------------------------------------------------------------------------
+ * @brief Write the buffered data, followed by extra bytes written straight from their storage.
+ * @param extra: Bytes written after the buffer.
+ */
+inline void file_writer::flush(std::string_view extra)
+{
+#if STRINGVEC_HAS_MMAP
+    iovec parts[2] = {{buffer.get(), used}, {const_cast<char*>(extra.data()), extra.size()}};
+    iovec* part    = parts;
+    int    count   = 2;
+    while (count != 0)
+    {
+        if (part->iov_len == 0)
+        {
+            part++;
+            count--;
+            continue;
+        }
+
+        const ssize_t written = ::writev(fd, part, count);
+        if (written < 0)
+        {
+            if (errno == EINTR)
+            {
+                continue;
+            }
+            fail();
+        }
+
+        /* Resume after a partial write. */
+        for (std::size_t left = static_cast<std::size_t>(written); left != 0;)
+        {
+            const std::size_t done = std::min(left, part->iov_len);
+            part->iov_base         = static_cast<char*>(part->iov_base) + done;
+            part->iov_len         -= done;
+            left                  -= done;
+            if (part->iov_len == 0)
+            {
+                part++;
+                count--;
+            }
+        }
+    }
+#else
+    output.write(buffer.get(), static_cast<std::streamsize>(used));
+    output.write(extra.data(), static_cast<std::streamsize>(extra.size()));
+#endif
+    used = 0;
+}
+
+inline void file_writer::fail() const
+{
+    throw std::runtime_error("Couldn't write to file: " + file);
+}
+
+/**
+ * @}
+ */
+
+
+
+/** ===============================================================================================
+ *  COMPRESSION
+ *
+ * @defgroup STRINGVEC_COMPRESSION              Compression
+ * @{
+ */
+
+namespace stringvec_detail
+{
+
+/** -----------------------------------------------------------------------------------------------
+ * @brief Check if a codec was compiled in.
+ */
+constexpr bool compression_available(compression codec)
+{
+    switch (codec)
+    {
+#ifdef STRINGVEC_USE_ZLIB
+        case compression::gzip:
+            return true;
+#endif
+#ifdef STRINGVEC_USE_ZSTD
+        case compression::zstd:
+            return true;
+#endif
+#ifdef STRINGVEC_USE_LZ4
+        case compression::lz4:
+            return true;
+#endif
+        case compression::none:
+            return true;
+        default:
+            return false;
+    }
+}
+
+/** -----------------------------------------------------------------------------------------------
+ * @brief Throw if a codec requested explicitly was not compiled in.
+ */
+inline void check_compression(compression codec)
+{
+    if (codec == compression::automatic || compression_available(codec))
+    {
+        return;
+    }
+
+    switch (codec)
+    {
+        case compression::gzip:
+            throw std::runtime_error("gzip compression requested without STRINGVEC_USE_ZLIB");
+        case compression::zstd:
+            throw std::runtime_error("zstd compression requested without STRINGVEC_USE_ZSTD");
+        default:
+            throw std::runtime_error("lz4 compression requested without STRINGVEC_USE_LZ4");
+    }
+}
+
+/** -----------------------------------------------------------------------------------------------
+ * @brief Find the codec of a file from its first bytes.
+ * @param head: Start of the file, at least 4 bytes of it when available.
+ * @return The codec, or `compression::none` if it is not recognized or was not compiled in, in
+ *         which case the file is read as plain text as before.
+ */
+inline compression compression_of_content(const std::string_view head)
+{
+    compression codec = compression::none;
+    if (head.starts_with("\x1f\x8b"))
+    {
+        codec = compression::gzip;
+    }
+    else if (head.starts_with("\x28\xb5\x2f\xfd"))
+    {
+        codec = compression::zstd;
+    }
+    else if (head.starts_with("\x04\x22\x4d\x18"))
+    {
+        codec = compression::lz4;
+    }
+
+    return compression_available(codec) ? codec : compression::none;
+}
+
+/** -----------------------------------------------------------------------------------------------
+ * @brief Find the codec of a file to write.
+ * @param path:  File to write to.
+ * @param codec: Requested codec; with `compression::automatic`, it is chosen from the extension
+ *               of the path, among the codecs compiled in.
+ */
+inline compression compression_of_path(const std::string_view path, compression codec)
+{
+    check_compression(codec);
+    if (codec != compression::automatic)
+    {
+        return codec;
+    }
+
+    if (path.ends_with(".gz"))
+    {
+        codec = compression::gzip;
+    }
+    else if (path.ends_with(".zst"))
+    {
+        codec = compression::zstd;
+    }
+    else if (path.ends_with(".lz4"))
+    {
+        codec = compression::lz4;
+    }
+
+    return compression_available(codec) ? codec : compression::none;
+}
+
+/** -----------------------------------------------------------------------------------------------
+ * @class   decompressor
+ *
+ * @brief   Streaming decoder of a compressed file, producing its content one block at a time.
+ *
+ * @details Concatenated gzip members and zstd or lz4 frames are decoded one after the other, as
+ *          the command-line tools do. Only one block of decompressed data is held at a time.
+ */
+class decompressor
+{
+public:
+    static constexpr std::size_t block_size = std::size_t{1} << 20;
+
+    inline decompressor(compression codec, const std::string& path);
+    inline ~decompressor();
+
+    decompressor(const decompressor&)            = delete;
+    decompressor& operator=(const decompressor&) = delete;
+
+    template <class Func>
+    inline void run(std::string_view input, Func&& func);
+
+private:
+    [[noreturn]] inline void fail() const;
+
+    compression       codec;
+    std::string       file;
+    std::vector<char> buffer;
+
+#ifdef STRINGVEC_USE_ZLIB
+    z_stream gzip = {};
+#endif
+#ifdef STRINGVEC_USE_ZSTD
+    ZSTD_DCtx* zstd = nullptr;
+#endif
+#ifdef STRINGVEC_USE_LZ4
+    LZ4F_dctx* lz4 = nullptr;
+#endif
+};
+
+/** -----------------------------------------------------------------------------------------------
+ * @brief Create the decoder of a codec.
+ * @param codec: Codec of the file, which must have been compiled in.
+ * @param path:  File being decoded, for error messages.
+ */
+inline decompressor::decompressor(compression codec, const std::string& path)
+: codec{codec}, file{path}, buffer(block_size)
+{
+    check_compression(codec);
+
+    switch (codec)
+    {
+#ifdef STRINGVEC_USE_ZLIB
+        case compression::gzip:
+            /* 32 enables the detection of both the gzip and zlib headers. */
+            if (inflateInit2(&gzip, MAX_WBITS + 32) != Z_OK)
+            {
+                throw std::bad_alloc{};
+            }
+            break;
+#endif
+#ifdef STRINGVEC_USE_ZSTD
+        case compression::zstd:
+            zstd = ZSTD_createDCtx();
+            if (zstd == nullptr)
+            {
+                throw std::bad_alloc{};
+            }
+            break;
+#endif
+#ifdef STRINGVEC_USE_LZ4
+        case compression::lz4:
+            if (LZ4F_isError(LZ4F_createDecompressionContext(&lz4, LZ4F_VERSION)))
+            {
+                throw std::bad_alloc{};
+            }
+            break;
+#endif
+        default:
+            break;
+    }
+}
+
+inline decompressor::~decompressor()
+{
+    switch (codec)
+    {
+#ifdef STRINGVEC_USE_ZLIB
+        case compression::gzip:
+            inflateEnd(&gzip);
+            break;
+#endif
+#ifdef STRINGVEC_USE_ZSTD
+        case compression::zstd:
+            ZSTD_freeDCtx(zstd);
+            break;
+#endif
+#ifdef STRINGVEC_USE_LZ4
+        case compression::lz4:
+            LZ4F_freeDecompressionContext(lz4);
+            break;
+#endif
+        default:
+            break;
+    }
+}
+
+/** -----------------------------------------------------------------------------------------------
+ * @brief Decode a whole compressed file.
+ * @param input: Compressed content of the file.
+ * @param func:  Function called as `func(first, last)` with each block of decompressed data.
+ *
+ * @throws std::runtime_error if the data is corrupted or truncated.
+ */
+template <class Func>
+inline void decompressor::run(std::string_view input, Func&& func)
+{
+    switch (codec)
+    {
+#ifdef STRINGVEC_USE_ZLIB
+        case compression::gzip:
+        {
+            bool ended = false;
+            bool full  = false;
+            /* A full buffer may leave decoded data behind, to get with no more input. */
+            while (!input.empty() || (full && !ended))
+            {
+                const uInt size = static_cast<uInt>(std::min<std::size_t>(input.size(), std::size_t{1} << 30));
+                gzip.next_in    = reinterpret_cast<Bytef*>(const_cast<char*>(input.data()));
+                gzip.avail_in   = size;
+                gzip.next_out   = reinterpret_cast<Bytef*>(buffer.data());
+                gzip.avail_out  = static_cast<uInt>(buffer.size());
+
+                const int status = inflate(&gzip, Z_NO_FLUSH);
+                if (status != Z_OK && status != Z_STREAM_END)
+                {
+                    fail();
+                }
+                input.remove_prefix(size - gzip.avail_in);
+                full = gzip.avail_out == 0;
+                func(buffer.data(), buffer.data() + buffer.size() - gzip.avail_out);
+
+                ended = status == Z_STREAM_END;
+                if (ended)
+                {
+                    /* Another member may follow; anything else is trailing garbage, ignored. */
+                    if (!input.starts_with("\x1f\x8b"))
+                    {
+                        break;
+                    }
+                    inflateReset(&gzip);
+                }
+            }
+            if (!ended)
+            {
+                fail();
+            }
+            break;
+        }
+#endif
+#ifdef STRINGVEC_USE_ZSTD
+        case compression::zstd:
+        {
+            ZSTD_inBuffer  in  = {input.data(), input.size(), 0};
+            ZSTD_outBuffer out = {};
+            std::size_t    hint = 0;
+            /* 0 once a frame is decoded and flushed; a full buffer may otherwise leave data behind. */
+            do
+            {
+                out  = {buffer.data(), buffer.size(), 0};
+                hint = ZSTD_decompressStream(zstd, &out, &in);
+                if (ZSTD_isError(hint))
+                {
+                    fail();
+                }
+                func(buffer.data(), buffer.data() + out.pos);
+            } while (in.pos < in.size || (out.pos == out.size && hint != 0));
+
+            /* Not 0 when the last frame is incomplete. */
+            if (hint != 0)
+            {
+                fail();
+            }
+            break;
+        }
+#endif
+#ifdef STRINGVEC_USE_LZ4
+        case compression::lz4:
+        {
+            std::size_t hint = 0;
+            while (true)
+            {
+                std::size_t       produced = buffer.size();
+                std::size_t       consumed = input.size();
+                const std::size_t result   = LZ4F_decompress(lz4, buffer.data(), &produced, input.data(), &consumed, nullptr);
+                if (LZ4F_isError(result))
+                {
+                    fail();
+                }
+                if (consumed == 0 && produced == 0)
+                {
+                    break;
+                }
+                hint = result;
+                input.remove_prefix(consumed);
+                func(buffer.data(), buffer.data() + produced);
+
+                /* A full buffer may leave decoded data behind, to get with no more input. */
+                if (input.empty() && produced < buffer.size())
+                {
+                    break;
+                }
+            }
+
+            /* Not 0 when the last frame is incomplete. */
+            if (hint != 0)
+            {
+                fail();
+            }
+            break;
+        }
+#endif
+        default:
+            func(input.data(), input.data() + input.size());
+            break;
+    }
+}
+
+inline void decompressor::fail() const
+{
+    throw std::runtime_error("Couldn't decompress file: " + file);
+}
+
+/** -----------------------------------------------------------------------------------------------
+ * @brief Call a function on every line of a compressed file, decompressing it block by block.
+ * @param input: Compressed content of the file.
+ * @param codec: Codec of the file.
+ * @param path:  File being read, for error messages.
+ * @param func:  Function called with each line, as a `std::string_view` without its '\n'.
+ *
+ * @details The lines are the same as with `std::getline` on the decompressed file; the
+ *          decompressed file as a whole is never held in memory.
+ */
+template <class Func>
+inline void for_each_compressed_line(std::string_view   input,
+                                     compression        codec,
+                                     const std::string& path,
+                                     Func&&             func)
+{
+    decompressor  decoder{codec, path};
+    line_splitter splitter;
+    decoder.run(input,
+                [&splitter, &func](const char* first, const char* last)
+                {
+                    splitter.feed(first, last, func);
+                });
+    splitter.finish(func);
+}
+
+/** -----------------------------------------------------------------------------------------------
+ * @class   compressed_writer
+ *
+ * @brief   Write-only file compressing what is written to it, with the interface of `file_writer`.
+ *
+ * @details Small writes are gathered before being handed to the encoder, whose output goes through
+ *          a `file_writer` with the same options. zstd compresses on `write_options::threads`
+ *          threads.
+ */
+class compressed_writer
+{
+public:
+    static constexpr std::size_t block_size = std::size_t{1} << 18;
+
+    inline compressed_writer(const std::string& path, compression codec, const write_options& options);
+    inline ~compressed_writer();
+
+    compressed_writer(const compressed_writer&)            = delete;
+    compressed_writer& operator=(const compressed_writer&) = delete;
+
+    inline void write(std::string_view s);
+    inline void close();
+
+private:
+    inline void              encode(std::string_view s, bool end);
+    [[noreturn]] inline void fail() const;
+
+    file_writer       output;
+    compression       codec;
+    std::string       file;
+    std::string       pending;
+    std::vector<char> buffer;
+    bool              closed = false;
+
+#ifdef STRINGVEC_USE_ZLIB
+    z_stream gzip = {};
+#endif
+#ifdef STRINGVEC_USE_ZSTD
+    ZSTD_CCtx* zstd = nullptr;
+#endif
+#ifdef STRINGVEC_USE_LZ4
+    LZ4F_cctx*         lz4         = nullptr;
+    LZ4F_preferences_t preferences = {};
+#endif
+};
+
+/** -----------------------------------------------------------------------------------------------
+ * @brief Create a file and the encoder of a codec.
+ * @param path:    File to write to.
+ * @param codec:   Codec of the file, which must have been compiled in.
+ * @param options: Options of the file and of the codec, see `write_options`.
+ */
+inline compressed_writer::compressed_writer(const std::string&   path,
+                                            compression          codec,
+                                            const write_options& options)
+: output{path, options}, codec{codec}, file{path}
+{
+    check_compression(codec);
+    pending.reserve(block_size);
+
+    switch (codec)
+    {
+#ifdef STRINGVEC_USE_ZLIB
+        case compression::gzip:
+            /* 16 writes a gzip header and trailer instead of the zlib ones. */
+            if (deflateInit2(&gzip,
+                             options.level != 0 ? options.level : Z_DEFAULT_COMPRESSION,
+                             Z_DEFLATED,
+                             MAX_WBITS + 16,
+                             8,
+                             Z_DEFAULT_STRATEGY) != Z_OK)
+            {
+                fail();
+            }
+            buffer.resize(block_size);
+            break;
+#endif
+#ifdef STRINGVEC_USE_ZSTD
+        case compression::zstd:
+        {
+            zstd = ZSTD_createCCtx();
+            if (zstd == nullptr)
+            {
+                throw std::bad_alloc{};
+            }
+            const std::size_t threads = options.threads != 0 ? options.threads
+                                                             : std::max<std::size_t>(std::thread::hardware_concurrency(), 1);
+            ZSTD_CCtx_setParameter(zstd, ZSTD_c_compressionLevel, options.level != 0 ? options.level : ZSTD_CLEVEL_DEFAULT);
+            /* Fails, leaving compression on the calling thread, if the library is single-threaded. */
+            if (threads > 1)
+            {
+                ZSTD_CCtx_setParameter(zstd, ZSTD_c_nbWorkers, static_cast<int>(threads));
+            }
+            buffer.resize(ZSTD_CStreamOutSize());
+            break;
+        }
+#endif
+#ifdef STRINGVEC_USE_LZ4
+        case compression::lz4:
+        {
+            if (LZ4F_isError(LZ4F_createCompressionContext(&lz4, LZ4F_VERSION)))
+            {
+                throw std::bad_alloc{};
+            }
+            preferences.compressionLevel = options.level;
+            buffer.resize(LZ4F_compressBound(block_size, &preferences));
+
+            const std::size_t header = LZ4F_compressBegin(lz4, buffer.data(), buffer.size(), &preferences);
+            if (LZ4F_isError(header))
+            {
+                fail();
+            }
+            output.write({buffer.data(), header});
+            break;
+        }
+#endif
+        default:
+            break;
+    }
+}
+
+/** -----------------------------------------------------------------------------------------------
+ * @brief Finish the file, ignoring errors. Call `close` to get them.
+ */
+inline compressed_writer::~compressed_writer()
+{
+    try
+    {
+        close();
+    }
+    catch (const std::exception&)
+    {
+    }
+
+    switch (codec)
+    {
+#ifdef STRINGVEC_USE_ZLIB
+        case compression::gzip:
+            deflateEnd(&gzip);
+            break;
+#endif
+#ifdef STRINGVEC_USE_ZSTD
+        case compression::zstd:
+            ZSTD_freeCCtx(zstd);
+            break;
+#endif
+#ifdef STRINGVEC_USE_LZ4
+        case compression::lz4:
+            LZ4F_freeCompressionContext(lz4);
+            break;
+#endif
+        default:
+            break;
+    }
+}
+
+/** -----------------------------------------------------------------------------------------------
+ * @brief Append bytes to the file, before compression.
+ * @param s: Bytes to write.
+ */
+inline void compressed_writer::write(std::string_view s)
+{
+    if (pending.size() + s.size() <= block_size)
+    {
+        pending.append(s);
+        return;
+    }
+
+    encode(pending, false);
+    pending.clear();
+    if (s.size() >= block_size)
+    {
+        encode(s, false);
+    }
+    else
+    {
+        pending.append(s);
+    }
+}
+
+/** -----------------------------------------------------------------------------------------------
+ * @brief Compress the remaining data, end the compressed stream and close the file.
+ *
+ * @throws std::runtime_error if any write failed.
+ */
+inline void compressed_writer::close()
+{
+    if (closed)
+    {
+        return;
+    }
+    closed = true;
+
+    encode(pending, true);
+    pending.clear();
+    output.close();
+}
+
+/** -----------------------------------------------------------------------------------------------
+ * @brief Compress bytes, writing whatever the encoder outputs.
+ * @param s:   Bytes to compress.
+ * @param end: Whether these are the last bytes, after which the stream is ended.
+ */
+inline void compressed_writer::encode(std::string_view s, [[maybe_unused]] bool end)
+{
+    switch (codec)
+    {
+#ifdef STRINGVEC_USE_ZLIB
+        case compression::gzip:
+        {
+            do
+            {
+                const uInt size = static_cast<uInt>(std::min<std::size_t>(s.size(), std::size_t{1} << 30));
+                const bool last = size == s.size();
+                gzip.next_in    = reinterpret_cast<Bytef*>(const_cast<char*>(s.data()));
+                gzip.avail_in   = size;
+                do
+                {
+                    gzip.next_out  = reinterpret_cast<Bytef*>(buffer.data());
+                    gzip.avail_out = static_cast<uInt>(buffer.size());
+                    if (deflate(&gzip, end && last ? Z_FINISH : Z_NO_FLUSH) == Z_STREAM_ERROR)
+                    {
+                        fail();
+                    }
+                    output.write({buffer.data(), buffer.size() - gzip.avail_out});
+                } while (gzip.avail_out == 0);
+                s.remove_prefix(size);
+            } while (!s.empty());
+            break;
+        }
+#endif
+#ifdef STRINGVEC_USE_ZSTD
+        case compression::zstd:
+        {
+            ZSTD_inBuffer in   = {s.data(), s.size(), 0};
+            bool          done = false;
+            while (!done)
+            {
+                ZSTD_outBuffer    out  = {buffer.data(), buffer.size(), 0};
+                const std::size_t left = ZSTD_compressStream2(zstd, &out, &in, end ? ZSTD_e_end : ZSTD_e_continue);
+                if (ZSTD_isError(left))
+                {
+                    fail();
+                }
+                output.write({buffer.data(), out.pos});
+                done = end ? left == 0 : in.pos == in.size;
+            }
+            break;
+        }
+#endif
+#ifdef STRINGVEC_USE_LZ4
+        case compression::lz4:
+        {
+            while (!s.empty())
+            {
+                const std::size_t size    = std::min(s.size(), block_size);
+                const std::size_t written = LZ4F_compressUpdate(lz4, buffer.data(), buffer.size(), s.data(), size, nullptr);
+                if (LZ4F_isError(written))
+                {
+                    fail();
+                }
+                output.write({buffer.data(), written});
+                s.remove_prefix(size);
+            }
+            if (end)
+            {
+                const std::size_t written = LZ4F_compressEnd(lz4, buffer.data(), buffer.size(), nullptr);
+                if (LZ4F_isError(written))
+                {
+                    fail();
+                }
+                output.write({buffer.data(), written});
+            }
+            break;
+        }
+#endif
+        default:
+            output.write(s);
+            break;
+    }
+}
+
+inline void compressed_writer::fail() const
+{
+    throw std::runtime_error("Couldn't compress file: " + file);
+}
+
+}        // namespace stringvec_detail
+
+namespace stringvec_detail
+{
+
+/** -----------------------------------------------------------------------------------------------
+ * @brief Write strings separated by a separator, without a trailing one.
+ */
+template <class Writer, class Container>
+inline void write_joined(Writer& output, const Container& v, const std::string_view sep)
+{
+    for (auto it = v.begin(); it != v.end(); it++)
+    {
+        if (it != v.begin())
+        {
+            output.write(sep);
+        }
+        output.write(*it);
+    }
+    output.close();
+}
+
+/** -----------------------------------------------------------------------------------------------
+ * @brief Write strings separated by a separator to a file, compressed if requested or if the
+ *        extension of the path asks for it.
+ */
+template <class Container>
+inline void write_strings(const std::string&      path,
+                          const Container&        v,
+                          const std::string_view  sep,
+                          const write_options&    options)
+{
+    const compression codec = compression_of_path(path, options.codec);
+    if (codec != compression::none)
+    {
+        compressed_writer output{path, codec, options};
+        write_joined(output, v, sep);
+        return;
+    }
+
+    file_writer output{path, options};
+    write_joined(output, v, sep);
+}
+
+/** -----------------------------------------------------------------------------------------------
+ * @brief Print strings separated by a separator, with unformatted writes.
+ */
+template <class Container>
+inline void print_strings(std::ostream& os, const Container& v, const std::string_view sep, bool keep_last_sep)
+{
+    for (auto it = v.begin(); it != v.end(); it++)
+    {
+        if (it != v.begin())
+        {
+            os.write(sep.data(), static_cast<std::streamsize>(sep.size()));
+        }
+        const std::string_view s = *it;
+        os.write(s.data(), static_cast<std::streamsize>(s.size()));
+    }
+    if (keep_last_sep && v.begin() != v.end())
+    {
+        os.write(sep.data(), static_cast<std::streamsize>(sep.size()));
+    }
+    os.flush();
+}
+
+}        // namespace stringvec_detail
+
+/**
+ * @}
+ */
+
+
+
+/** ===============================================================================================
+ *  CLASS DEFINITION
+ *
+ * @defgroup STRINGVEC_CLASS_DEF                 Class Definition
+ * @{
+ */
+
+template <class Container, class... Stages>
+class lazy_pipeline;
+class stream_pipeline;
+class file_follower;
+class column_table;
+
+/** -----------------------------------------------------------------------------------------------
+ * @class   stringvec
+ *
+ * @brief   Vector of string utility class.
+ */
+class stringvec
+{
+public:
+    using iter   = std::vector<std::string>::iterator;
+    using riter  = std::vector<std::string>::reverse_iterator;
+    using citer  = std::vector<std::string>::const_iterator;
+    using criter = std::vector<std::string>::const_reverse_iterator;
+
+    /** Order the vector is known to be sorted in. */
+    enum class ordering
+    {
+        none,
+        alphabetical,
+        length,
+    };
+
+    // Constructors / Destructors
+    ~stringvec()                               = default;
+    stringvec()                                = default;
+    stringvec(const stringvec&)                = default;
+    stringvec(stringvec&&) noexcept            = default;
+    stringvec& operator=(const stringvec&)     = default;
+    stringvec& operator=(stringvec&&) noexcept = default;
+    stringvec(const std::vector<std::string>& orig) : vec{orig} {};
+    stringvec(std::vector<std::string>&& orig) noexcept : vec{std::move(orig)} {};
+    stringvec(const std::initializer_list<std::string>&& orig) : vec{orig} {};
+
+    // Input / Output
+    inline stringvec&  read_file (const std::string& path) &;
+    inline stringvec&& read_file (const std::string& path) &&;
+    template <stringvec_execution::policy Policy>
+    inline stringvec&  read_file (Policy&& policy, const std::string& path) &;
+    template <stringvec_execution::policy Policy>
+    inline stringvec&& read_file (Policy&& policy, const std::string& path) &&;
+    inline void        write_file(const std::string& path, const std::string_view sep) const;
+    inline void        write_file(const std::string& path, char sep = '\n') const;
+    inline void        write_file(const std::string&    path,
+                                  const std::string_view sep,
+                                  const write_options&   options) const;
+
+    inline void print(std::ostream& os = std::cout,
+                      const std::string_view sep = "\n",
+                      bool keep_last_sep = true) const;
+
+    inline static std::future<stringvec>              read_file_async(std::string path);
+    inline static std::future<std::vector<stringvec>> read_files_async(std::vector<std::string> paths);
+    inline std::future<void> write_file_async(std::string   path,
+                                              std::string   sep     = "\n",
+                                              write_options options = {}) const&;
+    inline std::future<void> write_file_async(std::string   path,
+                                              std::string   sep     = "\n",
+                                              write_options options = {}) &&;
+
+    inline file_follower follow(std::string path) &;
+    inline file_follower follow(std::string path, const stream_pipeline& pipeline) &;
+
+    // Snapshots
+    inline void        save_snapshot(const std::string& path) const;
+    inline stringvec&  load_snapshot(const std::string& path) &;
+    inline stringvec&& load_snapshot(const std::string& path) &&;
+
+    // Lazy evaluation
+    inline lazy_pipeline<std::vector<std::string>> pipeline() const;
+
+    // Statistics
+    inline static stringvec_stats::snapshot stats();
+    inline static void                      reset_stats();
+
+    // Filtering
+    inline stringvec&  filter_remove(const std::function<bool(const std::string)> func) &;
+    inline stringvec&& filter_remove(const std::function<bool(const std::string)> func) &&;
+    inline stringvec&  filter_remove(const std::string& regex) &;
+    inline stringvec&& filter_remove(const std::string& regex) &&;
+    inline stringvec&  filter_remove(const regex_handle& regex) &;
+    inline stringvec&& filter_remove(const regex_handle& regex) &&;
+    inline stringvec&  filter_keep  (const std::function<bool(const std::string)> func) &;
+    inline stringvec&& filter_keep  (const std::function<bool(const std::string)> func) &&;
+    inline stringvec&  filter_keep  (const std::string& regex) &;
+    inline stringvec&& filter_keep  (const std::string& regex) &&;
+    inline stringvec&  filter_keep  (const regex_handle& regex) &;
+    inline stringvec&& filter_keep  (const regex_handle& regex) &&;
+
+    template <std::predicate<const std::string&> Pred>
+    inline stringvec&  filter_remove(Pred&& func) &;
+    template <std::predicate<const std::string&> Pred>
+    inline stringvec&& filter_remove(Pred&& func) &&;
+    template <std::predicate<const std::string&> Pred>
+    inline stringvec&  filter_keep  (Pred&& func) &;
+    template <std::predicate<const std::string&> Pred>
+    inline stringvec&& filter_keep  (Pred&& func) &&;
+    inline stringvec&  filter_remove_any(std::span<const std::string> regexes) &;
+    inline stringvec&& filter_remove_any(std::span<const std::string> regexes) &&;
+    inline stringvec&  filter_remove_any(const pattern_set& patterns) &;
+    inline stringvec&& filter_remove_any(const pattern_set& patterns) &&;
+    inline stringvec&  filter_keep_any  (std::span<const std::string> regexes) &;
+    inline stringvec&& filter_keep_any  (std::span<const std::string> regexes) &&;
+    inline stringvec&  filter_keep_any  (const pattern_set& patterns) &;
+    inline stringvec&& filter_keep_any  (const pattern_set& patterns) &&;
+    inline stringvec&  filter_remove_icase(const std::string_view s) &;
+    inline stringvec&& filter_remove_icase(const std::string_view s) &&;
+    inline stringvec&  filter_keep_icase  (const std::string_view s) &;
+    inline stringvec&& filter_keep_icase  (const std::string_view s) &&;
+    inline stringvec&  filter_empty (bool keep_whitespace = false) &;
+    inline stringvec&& filter_empty (bool keep_whitespace = false) &&;
+
+    inline stringvec&  remove_first(std::size_t count = 1) &;
+    inline stringvec&& remove_first(std::size_t count = 1) &&;
+    inline stringvec&  remove_last(std::size_t count = 1) &;
+    inline stringvec&& remove_last(std::size_t count = 1) &&;
+    inline stringvec&  remove_nth(std::size_t pos) &;
+    inline stringvec&& remove_nth(std::size_t pos) &&;
+    inline stringvec&  remove_range(std::size_t first, std::size_t last) &;
+    inline stringvec&& remove_range(std::size_t first, std::size_t last) &&;
+    inline stringvec&  remove_indices(std::span<const std::size_t> positions) &;
+    inline stringvec&& remove_indices(std::span<const std::size_t> positions) &&;
+
+    // Transforming
+    inline stringvec&  transform(const std::function<std::string(const std::string)> func) &;
+    inline stringvec&& transform(const std::function<std::string(const std::string)> func) &&;
+    template <std::invocable<const std::string&> Func>
+    inline stringvec&  transform(Func&& func) &;
+    template <std::invocable<const std::string&> Func>
+    inline stringvec&& transform(Func&& func) &&;
+    template <std::invocable<std::string&> Func>
+    inline stringvec&  transform_inplace(Func&& func) &;
+    template <std::invocable<std::string&> Func>
+    inline stringvec&& transform_inplace(Func&& func) &&;
+    inline stringvec&  trim() &;
+    inline stringvec&& trim() &&;
+    inline stringvec&  to_lower() &;
+    inline stringvec&& to_lower() &&;
+    inline stringvec&  to_upper() &;
+    inline stringvec&& to_upper() &&;
+    inline stringvec&  casefold_utf8() &;
+    inline stringvec&& casefold_utf8() &&;
+    inline bool        validate_utf8() const;
+    inline stringvec&  split(const std::string_view delimiter = " ") &;
+    inline stringvec&& split(const std::string_view delimiter = " ") &&;
+    inline stringvec&  split_any(const std::string_view delimiters) &;
+    inline stringvec&& split_any(const std::string_view delimiters) &&;
+    inline column_table split_columns(const std::string_view delimiter) const;
+
+    // Ordering
+    inline stringvec&  reverse() &;
+    inline stringvec&& reverse() &&;
+    inline stringvec&  sort(const std::function<bool(const std::string_view,
+                                                     const std::string_view)> func) &;
+    inline stringvec&& sort(const std::function<bool(const std::string_view,
+                                                     const std::string_view)> func) &&;
+    inline stringvec&  sort_alphabetically() &;
+    inline stringvec&& sort_alphabetically() &&;
+    inline stringvec&  sort_length() &;
+    inline stringvec&& sort_length() &&;
+    inline ordering    sort_order() const;
+    inline stringvec&  insert_sorted(std::string s) &;
+    inline stringvec&& insert_sorted(std::string s) &&;
+    inline stringvec&  merge(const stringvec& other) &;
+    inline stringvec&& merge(const stringvec& other) &&;
+    inline stringvec&  append(stringvec other) &;
+    inline stringvec&& append(stringvec other) &&;
+
+    // Set operations
+    inline stringvec&  unique(bool sorted = false) &;
+    inline stringvec&& unique(bool sorted = false) &&;
+    inline stringvec&  merge_union(const stringvec& other) &;
+    inline stringvec&& merge_union(const stringvec& other) &&;
+    inline stringvec&  intersect  (const stringvec& other) &;
+    inline stringvec&& intersect  (const stringvec& other) &&;
+    inline stringvec&  difference (const stringvec& other) &;
+    inline stringvec&& difference (const stringvec& other) &&;
+
+    // Searching
+    inline  iter find     (const std::function<bool(const std::string&)> func);
+    inline citer find     (const std::function<bool(const std::string&)> func) const;
+    inline  iter rfind    (const std::function<bool(const std::string&)> func);
+    inline citer rfind    (const std::function<bool(const std::string&)> func) const;
+    template <std::predicate<const std::string&> Pred>
+    inline  iter find     (Pred&& func);
+    template <std::predicate<const std::string&> Pred>
+    inline citer find     (Pred&& func) const;
+    template <std::predicate<const std::string&> Pred>
+    inline  iter rfind    (Pred&& func);
+    template <std::predicate<const std::string&> Pred>
+    inline citer rfind    (Pred&& func) const;
+    inline  iter find     (const std::string_view s);
+    inline citer find     (const std::string_view s) const;
+    inline  iter rfind    (const std::string_view s);
+    inline citer rfind    (const std::string_view s) const;
+    inline  iter find_reg (const std::string& regex);
+    inline citer find_reg (const std::string& regex) const;
+    inline  iter rfind_reg(const std::string& regex);
+    inline citer rfind_reg(const std::string& regex) const;
+    inline  iter find_reg (const regex_handle& regex);
+    inline citer find_reg (const regex_handle& regex) const;
+    inline  iter rfind_reg(const regex_handle& regex);
+    inline citer rfind_reg(const regex_handle& regex) const;
+    inline bool  contains (const std::string_view s) const;
+    inline  iter find_icase(const std::string_view s);
+    inline citer find_icase(const std::string_view s) const;
+
+    inline std::pair< iter, std::size_t> find_any(const pattern_set& patterns);
+    inline std::pair<citer, std::size_t> find_any(const pattern_set& patterns) const;
+
+    inline std::vector<std::size_t> find_all_containing (const std::string_view s) const;
+    inline std::vector<std::size_t> find_all_with_prefix(const std::string_view s) const;
+
+    template <std::predicate<const std::string&> Pred>
+    inline std::vector<std::size_t> find_all    (Pred&& func) const;
+    inline std::vector<std::size_t> find_all    (const std::string_view s) const;
+    inline std::vector<std::size_t> find_all_reg(const std::string& regex) const;
+    inline std::vector<std::size_t> find_all_reg(const regex_handle& regex) const;
+    template <std::predicate<const std::string&> Pred>
+    inline std::size_t              count_if    (Pred&& func) const;
+    inline std::size_t              count_reg   (const std::string& regex) const;
+    inline std::size_t              count_reg   (const regex_handle& regex) const;
+    inline std::pair<std::vector<std::size_t>, std::vector<std::size_t>> partition_by(const std::string& regex) const;
+    inline std::pair<std::vector<std::size_t>, std::vector<std::size_t>> partition_by(const regex_handle& regex) const;
+
+    // Indexing
+    inline stringvec&  build_index() &;
+    inline stringvec&& build_index() &&;
+    inline void        drop_index();
+    inline bool        has_index() const;
+    inline stringvec&  build_search_index() &;
+    inline stringvec&& build_search_index() &&;
+    inline void        drop_search_index();
+    inline bool        has_search_index() const;
+ 
+    // Parallel execution
+    template <stringvec_execution::policy Policy, std::predicate<const std::string&> Pred>
+    inline stringvec&  filter_remove(Policy&& policy, Pred&& func) &;
+    template <stringvec_execution::policy Policy, std::predicate<const std::string&> Pred>
+    inline stringvec&& filter_remove(Policy&& policy, Pred&& func) &&;
+    template <stringvec_execution::policy Policy>
+    inline stringvec&  filter_remove(Policy&& policy, const std::string& regex) &;
+    template <stringvec_execution::policy Policy>
+    inline stringvec&& filter_remove(Policy&& policy, const std::string& regex) &&;
+    template <stringvec_execution::policy Policy>
+    inline stringvec&  filter_remove(Policy&& policy, const regex_handle& regex) &;
+    template <stringvec_execution::policy Policy>
+    inline stringvec&& filter_remove(Policy&& policy, const regex_handle& regex) &&;
+    template <stringvec_execution::policy Policy, std::predicate<const std::string&> Pred>
+    inline stringvec&  filter_keep  (Policy&& policy, Pred&& func) &;
+    template <stringvec_execution::policy Policy, std::predicate<const std::string&> Pred>
+    inline stringvec&& filter_keep  (Policy&& policy, Pred&& func) &&;
+    template <stringvec_execution::policy Policy>
+    inline stringvec&  filter_keep  (Policy&& policy, const std::string& regex) &;
+    template <stringvec_execution::policy Policy>
+    inline stringvec&& filter_keep  (Policy&& policy, const std::string& regex) &&;
+    template <stringvec_execution::policy Policy>
+    inline stringvec&  filter_keep  (Policy&& policy, const regex_handle& regex) &;
+    template <stringvec_execution::policy Policy>
+    inline stringvec&& filter_keep  (Policy&& policy, const regex_handle& regex) &&;
+    template <stringvec_execution::policy Policy>
+    inline stringvec&  filter_remove_any(Policy&& policy, const pattern_set& patterns) &;
+    template <stringvec_execution::policy Policy>
+    inline stringvec&& filter_remove_any(Policy&& policy, const pattern_set& patterns) &&;
+    template <stringvec_execution::policy Policy>
+    inline stringvec&  filter_keep_any  (Policy&& policy, const pattern_set& patterns) &;
+    template <stringvec_execution::policy Policy>
+    inline stringvec&& filter_keep_any  (Policy&& policy, const pattern_set& patterns) &&;
+
+    template <stringvec_execution::policy Policy, std::invocable<const std::string&> Func>
+    inline stringvec&  transform(Policy&& policy, Func&& func) &;
+    template <stringvec_execution::policy Policy, std::invocable<const std::string&> Func>
+    inline stringvec&& transform(Policy&& policy, Func&& func) &&;
+    template <stringvec_execution::policy Policy, std::invocable<std::string&> Func>
+    inline stringvec&  transform_inplace(Policy&& policy, Func&& func) &;
+    template <stringvec_execution::policy Policy, std::invocable<std::string&> Func>
+    inline stringvec&& transform_inplace(Policy&& policy, Func&& func) &&;
+    template <stringvec_execution::policy Policy>
+    inline stringvec&  trim(Policy&& policy) &;
+    template <stringvec_execution::policy Policy>
+    inline stringvec&& trim(Policy&& policy) &&;
+
+    template <stringvec_execution::policy Policy, class Compare>
+        requires std::predicate<Compare&, const std::string&, const std::string&>
+    inline stringvec&  sort(Policy&& policy, Compare&& comp) &;
+    template <stringvec_execution::policy Policy, class Compare>
+        requires std::predicate<Compare&, const std::string&, const std::string&>
+    inline stringvec&& sort(Policy&& policy, Compare&& comp) &&;
+    template <stringvec_execution::policy Policy>
+    inline stringvec&  sort_alphabetically(Policy&& policy) &;
+    template <stringvec_execution::policy Policy>
+    inline stringvec&& sort_alphabetically(Policy&& policy) &&;
+    template <stringvec_execution::policy Policy>
+    inline stringvec&  sort_length(Policy&& policy) &;
+    template <stringvec_execution::policy Policy>
+    inline stringvec&& sort_length(Policy&& policy) &&;
+
+    template <stringvec_execution::policy Policy>
+    inline stringvec&  unique(Policy&& policy, bool sorted = false) &;
+    template <stringvec_execution::policy Policy>
+    inline stringvec&& unique(Policy&& policy, bool sorted = false) &&;
+    template <stringvec_execution::policy Policy>
+    inline stringvec&  merge_union(Policy&& policy, const stringvec& other) &;
+    template <stringvec_execution::policy Policy>
+    inline stringvec&& merge_union(Policy&& policy, const stringvec& other) &&;
+    template <stringvec_execution::policy Policy>
+    inline stringvec&  intersect  (Policy&& policy, const stringvec& other) &;
+    template <stringvec_execution::policy Policy>
+    inline stringvec&& intersect  (Policy&& policy, const stringvec& other) &&;
+    template <stringvec_execution::policy Policy>
+    inline stringvec&  difference (Policy&& policy, const stringvec& other) &;
+    template <stringvec_execution::policy Policy>
+    inline stringvec&& difference (Policy&& policy, const stringvec& other) &&;
+
+    template <stringvec_execution::policy Policy, std::predicate<const std::string&> Pred>
+    inline  iter find     (Policy&& policy, Pred&& func);
+    template <stringvec_execution::policy Policy, std::predicate<const std::string&> Pred>
+    inline citer find     (Policy&& policy, Pred&& func) const;
+    template <stringvec_execution::policy Policy, std::predicate<const std::string&> Pred>
+    inline  iter rfind    (Policy&& policy, Pred&& func);
+    template <stringvec_execution::policy Policy, std::predicate<const std::string&> Pred>
+    inline citer rfind    (Policy&& policy, Pred&& func) const;
+    template <stringvec_execution::policy Policy>
+    inline  iter find     (Policy&& policy, const std::string_view s);
+    template <stringvec_execution::policy Policy>
+    inline citer find     (Policy&& policy, const std::string_view s) const;
+    template <stringvec_execution::policy Policy>
+    inline  iter rfind    (Policy&& policy, const std::string_view s);
+    template <stringvec_execution::policy Policy>
+    inline citer rfind    (Policy&& policy, const std::string_view s) const;
+    template <stringvec_execution::policy Policy>
+    inline  iter find_reg (Policy&& policy, const std::string& regex);
+    template <stringvec_execution::policy Policy>
+    inline citer find_reg (Policy&& policy, const std::string& regex) const;
+    template <stringvec_execution::policy Policy>
+    inline  iter rfind_reg(Policy&& policy, const std::string& regex);
+    template <stringvec_execution::policy Policy>
+    inline citer rfind_reg(Policy&& policy, const std::string& regex) const;
+    template <stringvec_execution::policy Policy>
+    inline  iter find_reg (Policy&& policy, const regex_handle& regex);
+    template <stringvec_execution::policy Policy>
+    inline citer find_reg (Policy&& policy, const regex_handle& regex) const;
+    template <stringvec_execution::policy Policy>
+    inline  iter rfind_reg(Policy&& policy, const regex_handle& regex);
+    template <stringvec_execution::policy Policy>
+    inline citer rfind_reg(Policy&& policy, const regex_handle& regex) const;
+
+    template <stringvec_execution::policy Policy, std::predicate<const std::string&> Pred>
+    inline std::vector<std::size_t> find_all    (Policy&& policy, Pred&& func) const;
+    template <stringvec_execution::policy Policy>
+    inline std::vector<std::size_t> find_all_reg(Policy&& policy, const std::string& regex) const;
+    template <stringvec_execution::policy Policy>
+    inline std::vector<std::size_t> find_all_reg(Policy&& policy, const regex_handle& regex) const;
+    template <stringvec_execution::policy Policy, std::predicate<const std::string&> Pred>
+    inline std::size_t              count_if    (Policy&& policy, Pred&& func) const;
+    template <stringvec_execution::policy Policy>
+    inline std::size_t              count_reg   (Policy&& policy, const std::string& regex) const;
+    template <stringvec_execution::policy Policy>
+    inline std::size_t              count_reg   (Policy&& policy, const regex_handle& regex) const;
+    template <stringvec_execution::policy Policy>
+    inline std::pair<std::vector<std::size_t>, std::vector<std::size_t>> partition_by(Policy&&           policy,
+                                                                                      const std::string& regex) const;
+    template <stringvec_execution::policy Policy>
+    inline std::pair<std::vector<std::size_t>, std::vector<std::size_t>> partition_by(Policy&&            policy,
+                                                                                      const regex_handle& regex) const;
+
+    // Accessing
+    inline std::vector<std::string>&       get();
+    inline const std::vector<std::string>& get() const;
+
+    inline iter  begin();
+    inline citer begin() const;
+    inline citer cbegin() const;
+    inline iter  end();
+    inline citer end() const;
+    inline citer cend() const;
+
+    inline       std::string& operator[](std::size_t index);
+    inline const std::string& operator[](std::size_t index) const;
+
+    // Comparison
+    inline bool operator== (const stringvec& other) const;
+    inline bool operator!= (const stringvec& other) const;
+    inline std::strong_ordering operator<=>(const stringvec& other) const;
+
+
+private:
+    template <class Delimiter>
+    inline void        split_tokens(const Delimiter& delimiter);
+    inline static void trim_string(std::string& s);
+    inline void        invalidate(bool keeps_order, bool keeps_search = false);
+    inline void        extend_search_index();
+
+    std::vector<std::string>                              vec;
+    std::shared_ptr<const stringvec_detail::flat_index>   index;
+    std::shared_ptr<const stringvec_detail::search_index> search;
+    ordering                                              order = ordering::none;
+};
+
+/**
+ * @}
+ */
+
+
+
+/** ===============================================================================================
+ *  METHOD DEFINITIONS
+ *
+ * @defgroup STRINGVEC_METHOD_DEF                 Method Definitions
+ * @{
+ */
+
+
+/** -----------------------------------------------------------------------------------------------
+ * @brief Read a file line by line, pushing each line into the vector of string.
+ * @param path: File to read the lines from.
+ *
+ * @details Files compressed with a codec compiled in are recognized by their first bytes, and
+ *          decompressed block by block as their lines are read, see `compression`.
+ */
+inline stringvec& stringvec::read_file(const std::string& path) &
+{
+    STRINGVEC_STAT(read_file);
+
+    invalidate(false, true);
+
+    /* Check if file is valid and open it. */
+    std::ifstream input(path);
+    if(!input)
+    {
+        throw std::runtime_error("Couldn't open file: " + path);
+    }
+
+    char head[4] = {};
+    input.read(head, sizeof(head));
+    const compression codec = stringvec_detail::compression_of_content({head, static_cast<std::size_t>(input.gcount())});
+    if (codec != compression::none)
+    {
+        const mapped_file map{path};
+        stringvec_detail::for_each_compressed_line(map.view(), codec, path, [this](std::string_view line)
+                                                                            {
+                                                                                vec.emplace_back(line);
+                                                                            });
+        extend_search_index();
+        return *this;
+    }
+    input.clear();
+    input.seekg(0);
+
+    /* Read all lines of file into the vector. */
+    std::string line;
+    while(std::getline(input, line))
+    {
+        vec.push_back(line);
+    }
+
+    extend_search_index();
+    return *this;
+}
+
+/** -----------------------------------------------------------------------------------------------
+ * @brief Read a file, splitting it into lines on several threads.
+ * @param policy: Execution policy or thread pool to split the file with.
+ * @param path:   File to read the lines from.
+ *
+ * @details The file is mapped in memory and cut into newline-aligned byte ranges, which are
+ *          split concurrently. The lines are the same, and in the same order, as with `getline`.
+ *          Compressed files are decompressed on the calling thread, as with `read_file(path)`.
+ */
+template <stringvec_execution::policy Policy>
+inline stringvec& stringvec::read_file(Policy&& policy, const std::string& path) &
+{
+    STRINGVEC_STAT(read_file);
+
+    invalidate(false, true);
+
+    const mapped_file map{path};
+    const compression codec = stringvec_detail::compression_of_content(map.view().substr(0, 4));
+    if (codec != compression::none)
+    {
+        stringvec_detail::for_each_compressed_line(map.view(), codec, path, [this](std::string_view line)
+                                                                            {
+                                                                                vec.emplace_back(line);
+                                                                            });
+        extend_search_index();
+        return *this;
+    }
+
+    stringvec_detail::parallel_read_lines(stringvec_detail::pool_of(policy),
+                                          map.view(),
+                                          vec,
+                                          [](std::string_view line)
+                                          {
+                                              return std::string{line};
+                                          });
+
+    extend_search_index();
+    return *this;
+}
+
+/** -----------------------------------------------------------------------------------------------
+ * @brief Write to a file every string from the vector, separated by a specified string.
+ * @param path: File to write the strings to.
+ * @param sep:  Separator string between the strings in the vector when writing back to file.
+ *
+ * @details The strings are gathered into large blocks, see `file_writer`.
+ */
+inline void stringvec::write_file(const std::string& path, const std::string_view sep) const
+{
+    STRINGVEC_STAT(write_file);
+
+    write_file(path, sep, write_options{});
+}
+
+/** -----------------------------------------------------------------------------------------------
+ * @brief Write to a file every string from the vector, separated by a character.
+ * @param path: File to write the strings to.
+ * @param sep:  Separator character. `'\0'` writes the strings with no separator between them.
+ */
+inline void stringvec::write_file(const std::string& path, char sep) const
+{
+    STRINGVEC_STAT(write_file);
+
+    /* A null separator writes none, as a one-character C string would. */
+    return write_file(path, sep == '\0' ? std::string_view{} : std::string_view{&sep, 1});
+}
+
+/** -----------------------------------------------------------------------------------------------
+ * @brief Write to a file every string from the vector, with control over buffering and syncing.
+ * @param path:    File to write the strings to.
+ * @param sep:     Separator string between the strings in the vector when writing back to file.
+ * @param options: Buffer size, direct I/O and `fdatasync`, see `write_options`.
+ */
+inline void stringvec::write_file(const std::string&     path,
+                                  const std::string_view sep,
+                                  const write_options&   options) const
+{
+    STRINGVEC_STAT(write_file);
+
+    stringvec_detail::write_strings(path, vec, sep, options);
+}
+
+/** -----------------------------------------------------------------------------------------------
+ * @brief Print the vector of strings line by line, then flush the output buffer.
+ */
+inline void stringvec::print(std::ostream& os,
+                             const std::string_view sep,
+                             bool keep_last_sep) const
+{
+    stringvec_detail::print_strings(os, vec, sep, keep_last_sep);
+}
+
+/** -----------------------------------------------------------------------------------------------
+ * @brief Get a snapshot of the counters of every operation, see `stringvec_stats`.
+ *
+ * @details The counters are only updated when compiling with `STRINGVEC_STATS`.
+ */
+inline stringvec_stats::snapshot stringvec::stats()
+{
+    return stringvec_stats::get();
+}
+
+inline void stringvec::reset_stats()
+{
+    stringvec_stats::reset();
+}
+
+
+/** -----------------------------------------------------------------------------------------------
+ * @brief Check all strings against a provided func, remove all strings that match.
+ * @param func: Function object to check against
+ */
+inline stringvec& stringvec::filter_remove(const std::function<bool(const std::string)> func) &
+{
+    STRINGVEC_STAT(filter_remove);
+
+    index.reset();
+    search.reset();
+
+    vec.erase(std::remove_if(vec.begin(), vec.end(), func),
+              vec.end());
+
+    return *this;
+}
+
+/** -----------------------------------------------------------------------------------------------
+ * @brief Check all strings against a predicate, remove all strings that match.
+ * @param func: Predicate to check against
+ *
+ * @details Unlike the `std::function` overload, the predicate is called directly on each element,
+ *          without type erasure nor copy of the strings, and can be inlined.
+ */
+template <std::predicate<const std::string&> Pred>
+inline stringvec& stringvec::filter_remove(Pred&& func) &
+{
+    STRINGVEC_STAT(filter_remove);
+
+    index.reset();
+    search.reset();
+
+    vec.erase(std::remove_if(vec.begin(), vec.end(), [&func](const std::string& s)
+                                                     {
+                                                         return std::invoke(func, s);
+                                                     }),
+              vec.end());
+
+    return *this;
+}
+
+/** -----------------------------------------------------------------------------------------------
+ * @brief Check all strings against a provided regex, remove all strings that match the regex.
+ * @param regex: Regular Expression to check against.
+ */
+inline stringvec& stringvec::filter_remove(const std::string& regex) &
+{
+    STRINGVEC_STAT(filter_remove);
+
+    index.reset();
+    search.reset();
+
+    try
+    {
+        filter_remove(regex_cache::global().get(regex));
+    }
+    catch (const std::regex_error& e)
+    {
+        std::cerr << "Error: Invalid regex pattern '" << regex << "'. "
+                  << "Details: " << e.what() << std::endl;
+    }
+
+    return *this;
+}
+
+/** -----------------------------------------------------------------------------------------------
+ * @brief Check all strings against a precompiled regex, remove all strings that match the regex.
+ * @param regex: Precompiled Regular Expression to check against.
+ */
+inline stringvec& stringvec::filter_remove(const regex_handle& regex) &
+{
+    STRINGVEC_STAT(filter_remove);
+
+    index.reset();
+    search.reset();
+
+    filter_remove([&regex](const std::string& s)
+                  {
+                      return regex->match(s);
+                  });
+
+    return *this;
+}
+
+/** -----------------------------------------------------------------------------------------------
+ * @brief Check all strings against a provided func, keep only strings that match.
+ * @param func: Function object to check against
+ */
+inline stringvec& stringvec::filter_keep(const std::function<bool(const std::string)> func) &
+{
+    STRINGVEC_STAT(filter_keep);
+
+    index.reset();
+    search.reset();
+
+    vec.erase(std::remove_if(vec.begin(), vec.end(), [&func](const std::string& s)
+                                                     {
+                                                         return !func(s);
+                                                     }),
+              vec.end());
+
+    return *this;
+}
+
+/** -----------------------------------------------------------------------------------------------
+ * @brief Check all strings against a predicate, keep only strings that match.
+ * @param func: Predicate to check against
+ */
+template <std::predicate<const std::string&> Pred>
+inline stringvec& stringvec::filter_keep(Pred&& func) &
+{
+    STRINGVEC_STAT(filter_keep);
+
+    index.reset();
+    search.reset();
+
+    vec.erase(std::remove_if(vec.begin(), vec.end(), [&func](const std::string& s)
+                                                     {
+                                                         return !std::invoke(func, s);
+                                                     }),
+              vec.end());
+
+    return *this;
+}
+
+/** -----------------------------------------------------------------------------------------------
+ * @brief Check all strings against a provided regex, keep only strings that match the regex.
+ * @param regex: Regular Expression to check against.
+ */
+inline stringvec& stringvec::filter_keep(const std::string& regex) &
+{
+    STRINGVEC_STAT(filter_keep);
+
+    index.reset();
+    search.reset();
+
+    try
+    {
+        filter_keep(regex_cache::global().get(regex));
+    }
+    catch (const std::regex_error& e)
+    {
+        std::cerr << "Error: Invalid regex pattern '" << regex << "'. "
+                  << "Details: " << e.what() << std::endl;
+    }
+
+    return *this;
+}
+
+/** -----------------------------------------------------------------------------------------------
+ * @brief Check all strings against a precompiled regex, keep only strings that match the regex.
+ * @param regex: Precompiled Regular Expression to check against.
+ */
+inline stringvec& stringvec::filter_keep(const regex_handle& regex) &
+{
+    STRINGVEC_STAT(filter_keep);
+
+    index.reset();
+    search.reset();
+
+    filter_keep([&regex](const std::string& s)
+                {
+                    return regex->match(s);
+                });
+
+    return *this;
+}
+
+/** -----------------------------------------------------------------------------------------------
+ * @brief Check all strings against a set of regexes, remove all strings that match any of them.
+ * @param regexes: Regular Expressions to check against, compiled once into a `pattern_set`.
+ *
+ * @details The strings are checked in a single pass, instead of one pass per regex.
+ */
+inline stringvec& stringvec::filter_remove_any(std::span<const std::string> regexes) &
+{
+    STRINGVEC_STAT(filter_remove);
+
+    index.reset();
+    search.reset();
+
+    try
+    {
+        filter_remove_any(pattern_set::regexes(regexes));
+    }
+    catch (const std::regex_error& e)
+    {
+        std::cerr << "Error: Invalid regex pattern in set. "
+                  << "Details: " << e.what() << std::endl;
+    }
+
+    return *this;
+}
+
+/** -----------------------------------------------------------------------------------------------
+ * @brief Remove all strings matching any pattern of a compiled set.
+ * @param patterns: Substrings and regexes to check against, see `pattern_set`.
+ */
+inline stringvec& stringvec::filter_remove_any(const pattern_set& patterns) &
+{
+    STRINGVEC_STAT(filter_remove);
+
+    index.reset();
+    search.reset();
+
+    filter_remove([&patterns](const std::string& s)
+                  {
+                      return patterns.match(s);
+                  });
+
+    return *this;
+}
+
+/** -----------------------------------------------------------------------------------------------
+ * @brief Check all strings against a set of regexes, keep only strings that match any of them.
+ * @param regexes: Regular Expressions to check against, compiled once into a `pattern_set`.
+ *
+ * @details The strings are checked in a single pass, instead of one pass per regex.
+ */
+inline stringvec& stringvec::filter_keep_any(std::span<const std::string> regexes) &
+{
+    STRINGVEC_STAT(filter_keep);
+
+    index.reset();
+    search.reset();
+
+    try
+    {
+        filter_keep_any(pattern_set::regexes(regexes));
+    }
+    catch (const std::regex_error& e)
+    {
+        std::cerr << "Error: Invalid regex pattern in set. "
+                  << "Details: " << e.what() << std::endl;
+    }
+
+    return *this;
+}
+
+/** -----------------------------------------------------------------------------------------------
+ * @brief Keep only strings matching any pattern of a compiled set.
+ * @param patterns: Substrings and regexes to check against, see `pattern_set`.
+ */
+inline stringvec& stringvec::filter_keep_any(const pattern_set& patterns) &
+{
+    STRINGVEC_STAT(filter_keep);
+
+    index.reset();
+    search.reset();
+
+    filter_keep([&patterns](const std::string& s)
+                {
+                    return patterns.match(s);
+                });
+
+    return *this;
+}
+
+/** -----------------------------------------------------------------------------------------------
+ * @brief Remove all strings containing a substring, regardless of case.
+ * @param s: Substring to look for, compared after UTF-8 case folding, see `casefold_utf8`.
+ *
+ * @details Unlike a regex compiled with `std::regex::icase`, which only folds ASCII letters, this
+ *          matches "STRASSE" against "strasse" and "ΣΊΣΥΦΟΣ" against "σίσυφος".
+ */
+inline stringvec& stringvec::filter_remove_icase(const std::string_view s) &
+{
+    STRINGVEC_STAT(filter_remove);
+
+    index.reset();
+    search.reset();
+
+    const stringvec_detail::icase_needle needle{s};
+    filter_remove([&needle](const std::string& x)
+                  {
+                      return needle.found_in(x);
+                  });
+
+    return *this;
+}
+
+/** -----------------------------------------------------------------------------------------------
+ * @brief Keep only the strings containing a substring, regardless of case.
+ * @param s: Substring to look for, compared after UTF-8 case folding, see `casefold_utf8`.
+ */
+inline stringvec& stringvec::filter_keep_icase(const std::string_view s) &
+{
+    STRINGVEC_STAT(filter_keep);
+
+    index.reset();
+    search.reset();
+
+    const stringvec_detail::icase_needle needle{s};
+    filter_keep([&needle](const std::string& x)
+                {
+                    return needle.found_in(x);
+                });
+
+    return *this;
+}
+
+/** -----------------------------------------------------------------------------------------------
+ * @brief Remove all empty strings from the vector.
+ * @param keep_whitespace: If true, keep strings containing only whitespace.
+ */
+inline stringvec& stringvec::filter_empty(bool keep_whitespace) &
+{
+    STRINGVEC_STAT(filter_empty);
+
+    index.reset();
+    search.reset();
+
+    if (keep_whitespace)
+    {
+        filter_remove([](const std::string& s)
+                      {
+                          return s.empty();
+                      });
+    }
+    else
+    {
+        filter_remove([](const std::string& s)
+                      {
+                          return stringvec_detail::is_blank(s);
+                      });
+    }
+
+    return *this;
+}
+
+
+/** -----------------------------------------------------------------------------------------------
+ * @brief Remove the first elements from the vector, in a single shift of the others.
+ * @param count: Number of elements to remove, clamped to the size of the vector.
+ *
+ * @details Call `remove_first(n)` rather than `remove_first()` `n` times, which shifts the
+ *          remaining elements on every call.
+ */
+inline stringvec& stringvec::remove_first(std::size_t count) &
+{
+    STRINGVEC_STAT(remove_first);
+
+    index.reset();
+
+    return remove_range(0, count);
+}
+
+/** -----------------------------------------------------------------------------------------------
+ * @brief Remove the last elements from the vector, in O(count).
+ * @param count: Number of elements to remove, clamped to the size of the vector.
+ */
+inline stringvec& stringvec::remove_last(std::size_t count) &
+{
+    STRINGVEC_STAT(remove_last);
+
+    invalidate(true, true);
+
+    count = std::min(count, vec.size());
+    vec.erase(end() - static_cast<std::ptrdiff_t>(count), end());
+
+    if (search && count != 0)
+    {
+        search = search->erased(vec, vec.size(), vec.size() + count);
+    }
+
+    return *this;
+}
+
+/** -----------------------------------------------------------------------------------------------
+ * @brief Remove an element from the vector from its index.
+ */
+inline stringvec& stringvec::remove_nth(std::size_t pos) &
+{
+    STRINGVEC_STAT(remove_nth);
+
+    index.reset();
+
+    return remove_range(pos, pos + 1);
+}
+
+/** -----------------------------------------------------------------------------------------------
+ * @brief Remove the elements at positions `[first, last)`, in a single shift of the others.
+ * @param first: Position of the first element to remove.
+ * @param last:  Position after the last element to remove, clamped to the size of the vector.
+ */
+inline stringvec& stringvec::remove_range(std::size_t first, std::size_t last) &
+{
+    STRINGVEC_STAT(remove_range);
+
+    invalidate(true, true);
+
+    last = std::min(last, vec.size());
+    if (first >= last)
+    {
+        return *this;
+    }
+
+    vec.erase(begin() + static_cast<std::ptrdiff_t>(first), begin() + static_cast<std::ptrdiff_t>(last));
+
+    /* The search index follows the erasure rather than being discarded, see `build_search_index`. */
+    if (search)
+    {
+        search = search->erased(vec, first, last);
+    }
+
+    return *this;
+}
+
+/** -----------------------------------------------------------------------------------------------
+ * @brief Remove the elements at a set of positions, moving each remaining element at most once.
+ * @param positions: Positions to remove, in any order. Duplicates and out-of-range positions are
+ *                   ignored.
+ */
+inline stringvec& stringvec::remove_indices(std::span<const std::size_t> positions) &
+{
+    STRINGVEC_STAT(remove_indices);
+
+    index.reset();
+    search.reset();
+
+    if (positions.empty())
+    {
+        return *this;
+    }
+
+    std::vector<std::uint8_t> flags(vec.size(), 1);
+    for (const std::size_t pos : positions)
+    {
+        if (pos < flags.size())
+        {
+            flags[pos] = 0;
+        }
+    }
+    stringvec_detail::compact_by_flags(nullptr, 0, vec, flags);
+
+    return *this;
+}
+
+
+/** -----------------------------------------------------------------------------------------------
+ * @brief Apply a function to all the elements of the vector
+ * @param func: Function to apply
+ */
+inline stringvec& stringvec::transform(const std::function<std::string(const std::string)> func) &
+{
+    STRINGVEC_STAT(transform);
+
+    index.reset();
+    search.reset();
+    order = ordering::none;
+
+    std::for_each(begin(), end(), [func](std::string& s) {
+        s = func(s);
+    });
+
+    return *this;
+}
+
+/** -----------------------------------------------------------------------------------------------
+ * @brief Apply a function to all the elements of the vector
+ * @param func: Function to apply, returning the new value of each string
+ *
+ * @details If the function takes its argument by value, each string is moved into it instead of
+ *          being copied.
+ */
+template <std::invocable<const std::string&> Func>
+inline stringvec& stringvec::transform(Func&& func) &
+{
+    STRINGVEC_STAT(transform);
+
+    index.reset();
+    search.reset();
+    order = ordering::none;
+
+    for (std::string& s : vec)
+    {
+        if constexpr (std::invocable<Func&, std::string&&>)
+        {
+            s = std::invoke(func, std::move(s));
+        }
+        else
+        {
+            s = std::invoke(func, std::as_const(s));
+        }
+    }
+
+    return *this;
+}
+
+/** -----------------------------------------------------------------------------------------------
+ * @brief Apply a function modifying each element of the vector in place.
+ * @param func: Function to apply, taking each string by non-const reference
+ *
+ * @details No string is copied nor reallocated unless the function itself grows it.
+ */
+template <std::invocable<std::string&> Func>
+inline stringvec& stringvec::transform_inplace(Func&& func) &
+{
+    STRINGVEC_STAT(transform_inplace);
+
+    index.reset();
+    search.reset();
+    order = ordering::none;
+
+    for (std::string& s : vec)
+    {
+        std::invoke(func, s);
+    }
+
+    return *this;
+}
+
+/** -----------------------------------------------------------------------------------------------
+ * @brief Trim trailing and leading whitespace from all strings in the vector, including newlines.
+ *
+ * @details The strings are trimmed in place, keeping their buffer.
+ */
+inline stringvec& stringvec::trim() &
+{
+    STRINGVEC_STAT(trim);
+
+    index.reset();
+    search.reset();
+    order = ordering::none;
+
+    transform_inplace(trim_string);
+
+    return *this;
+}
+
+inline void stringvec::trim_string(std::string& s)
+{
+    const std::size_t end = stringvec_detail::last_non_space(s);
+    if (end == 0)
+    {
+        s.clear();
+        return;
+    }
+
+    /* Both erasures are no-ops on strings that are already trimmed. */
+    s.erase(end);
+    s.erase(0, stringvec_detail::first_non_space(s));
+}
+
+/** -----------------------------------------------------------------------------------------------
+ * @brief Lowercase the ASCII letters of all strings in place, 16 bytes at a time with SSE2.
+ *
+ * @details Other bytes are left as is, so UTF-8 text stays valid; see `casefold_utf8` to also
+ *          fold the letters of other scripts.
+ */
+inline stringvec& stringvec::to_lower() &
+{
+    STRINGVEC_STAT(transform);
+
+    index.reset();
+    search.reset();
+    order = ordering::none;
+
+    for (std::string& s : vec)
+    {
+        stringvec_detail::flip_ascii_case<'A'>(s.data(), s.size());
+    }
+
+    return *this;
+}
+
+/** -----------------------------------------------------------------------------------------------
+ * @brief Uppercase the ASCII letters of all strings in place, 16 bytes at a time with SSE2.
+ */
+inline stringvec& stringvec::to_upper() &
+{
+    STRINGVEC_STAT(transform);
+
+    index.reset();
+    search.reset();
+    order = ordering::none;
+
+    for (std::string& s : vec)
+    {
+        stringvec_detail::flip_ascii_case<'a'>(s.data(), s.size());
+    }
+
+    return *this;
+}
+
+/** -----------------------------------------------------------------------------------------------
+ * @brief Apply Unicode simple case folding to all strings in place, as UTF-8.
+ *
+ * @details Strings that differ only by case fold to the same string, in every script with case,
+ *          which is what case-insensitive comparisons need; it is not a locale-aware lowercase.
+ *          Code points with a one-to-many folding, such as 'ß', are kept as they are. ASCII runs
+ *          are folded 16 bytes at a time, and bytes that are not valid UTF-8 are left unchanged.
+ */
+inline stringvec& stringvec::casefold_utf8() &
+{
+    STRINGVEC_STAT(transform);
+
+    index.reset();
+    search.reset();
+    order = ordering::none;
+
+    for (std::string& s : vec)
+    {
+        stringvec_detail::casefold_utf8(s);
+    }
+
+    return *this;
+}
+
+/** -----------------------------------------------------------------------------------------------
+ * @brief Check if all strings are valid UTF-8.
+ *
+ * @details Overlong encodings, surrogates and code points above U+10FFFF are invalid. ASCII is
+ *          checked 16 bytes at a time with SSE2. Use `find_all` with a predicate to locate the
+ *          invalid strings.
+ */
+inline bool stringvec::validate_utf8() const
+{
+    STRINGVEC_STAT(validate_utf8);
+
+    return std::all_of(vec.begin(), vec.end(), [](const std::string_view s)
+                                               {
+                                                   return stringvec_detail::valid_utf8(s);
+                                               });
+}
+
+/** -----------------------------------------------------------------------------------------------
+ * @brief Split all strings in-place with a specified delimiter string.
+ *
+ * @param delimiter: String to use as a separation point for the string.
+ * 
+ * @details The delimiter string is removed from each split.
+ */
+inline stringvec& stringvec::split(const std::string_view delimiter) &
+{
+    STRINGVEC_STAT(split);
+
+    index.reset();
+    search.reset();
+    order = ordering::none;
+
+    split_tokens(delimiter);
+
+    return *this;
+}
+
+/** -----------------------------------------------------------------------------------------------
+ * @brief Split all strings in-place on any of a set of single-character delimiters.
+ *
+ * @param delimiters: Characters to use as separation points, e.g. `" \t,;"`.
+ *
+ * @details The delimiters are removed from each split. The strings are scanned for all the
+ *          delimiters at once, with SIMD when available.
+ */
+inline stringvec& stringvec::split_any(const std::string_view delimiters) &
+{
+    STRINGVEC_STAT(split_any);
+
+    index.reset();
+    search.reset();
+    order = ordering::none;
+
+    split_tokens(stringvec_detail::delimiter_set{delimiters});
+
+    return *this;
+}
+
+/** -----------------------------------------------------------------------------------------------
+ * @brief Split all strings, in a counting pass that sizes the result followed by a copying one.
+ *
+ * @details Strings without any delimiter are moved as they are, and the buffer of every other
+ *          string is reused for its last token, so only the other tokens are allocated.
+ */
+template <class Delimiter>
+inline void stringvec::split_tokens(const Delimiter& delimiter)
+{
+    std::size_t count = 0;
+    for (const std::string& s : vec)
+    {
+        stringvec_detail::for_each_token(s, delimiter, [&count](std::string_view)
+                                                       {
+                                                           count++;
+                                                       });
+    }
+
+    if (count == vec.size())
+    {
+        return;
+    }
+
+    std::vector<std::string> newStrings;
+    newStrings.reserve(count);
+    for (std::string& s : vec)
+    {
+        std::string_view last;
+        bool             first = true;
+        stringvec_detail::for_each_token(s, delimiter, [&](std::string_view token)
+                                                       {
+                                                           if (!first)
+                                                           {
+                                                               newStrings.emplace_back(last);
+                                                           }
+                                                           last  = token;
+                                                           first = false;
+                                                       });
+
+        /* The last token always extends to the end of the string. */
+        s.erase(0, static_cast<std::size_t>(last.data() - s.data()));
+        newStrings.push_back(std::move(s));
+    }
+
+    vec = std::move(newStrings);
+}
+
+
+/** -----------------------------------------------------------------------------------------------
+ * @brief Reverse the order of the vector's elements.
+ */
+inline stringvec& stringvec::reverse() &
+{
+    STRINGVEC_STAT(reverse);
+
+    index.reset();
+    search.reset();
+    order = ordering::none;
+
+    std::reverse(begin(), end());
+
+    return *this;
+}
+
+/** -----------------------------------------------------------------------------------------------
+ * @brief Sort each string in the vector in O(N logN)
+ * @param func: Comparison function
+ */
+inline stringvec& stringvec::sort(const std::function<bool(const std::string_view,
+                                                           const std::string_view)> func) &
+{
+    STRINGVEC_STAT(sort);
+
+    index.reset();
+    search.reset();
+    order = ordering::none;
+
+    std::sort(begin(), end(), func);
+
+    return *this;
+}
+
+/** -----------------------------------------------------------------------------------------------
+ * @brief Sort the vector alphabetically
+ * 
+ * @details The order is the one of `operator<` on `std::string`, comparing bytes as unsigned.
+ *          The strings are sorted through cached 8-byte prefixes rather than compared directly,
+ *          and equal strings keep their relative order.
+ */
+inline stringvec& stringvec::sort_alphabetically() &
+{
+    STRINGVEC_STAT(sort_alphabetically);
+
+    index.reset();
+    search.reset();
+
+    stringvec_detail::radix_sort_strings(nullptr, 0, vec);
+    order = ordering::alphabetical;
+
+    return *this;
+}
+
+/** -----------------------------------------------------------------------------------------------
+ * @brief Sort the vector by length of the strings
+ *
+ * @details Uses a counting sort on the lengths, so strings of the same length keep their
+ *          relative order.
+ */
+inline stringvec& stringvec::sort_length() &
+{
+    STRINGVEC_STAT(sort_length);
+
+    index.reset();
+    search.reset();
+
+    stringvec_detail::counting_sort_length(nullptr, 0, vec);
+    order = ordering::length;
+
+    return *this;
+}
+
+/** -----------------------------------------------------------------------------------------------
+ * @brief Get the order the vector is known to be sorted in.
+ *
+ * @details `sort_alphabetically` and `sort_length` set it. Removing elements keeps it, while the
+ *          other modifying methods and the non-const `get` reset it to `ordering::none`. Writing
+ *          through iterators or `operator[]` does not, so re-sort after doing so.
+ */
+inline stringvec::ordering stringvec::sort_order() const
+{
+    return order;
+}
+
+/** -----------------------------------------------------------------------------------------------
+ * @brief Insert a string at its place in the current ordering, in O(N).
+ * @param s: String to insert, after any equal element.
+ *
+ * @details If the vector is not known to be sorted, it is sorted alphabetically first.
+ */
+inline stringvec& stringvec::insert_sorted(std::string s) &
+{
+    STRINGVEC_STAT(insert_sorted);
+
+    index.reset();
+    search.reset();
+
+    if (order == ordering::none)
+    {
+        sort_alphabetically();
+    }
+
+    const iter pos = order == ordering::alphabetical ?
+                     std::upper_bound(begin(), end(), s, std::less<>{}) :
+                     std::upper_bound(begin(), end(), s, stringvec_detail::length_less{});
+    vec.insert(pos, std::move(s));
+
+    return *this;
+}
+
+/** -----------------------------------------------------------------------------------------------
+ * @brief Merge the strings of another vector, keeping the current ordering, in O(N + M).
+ * @param other: Vector to merge. It is sorted first if it is not already in the same order.
+ *
+ * @details If this vector is not known to be sorted, it is sorted alphabetically first. On ties,
+ *          the strings of this vector come first.
+ */
+inline stringvec& stringvec::merge(const stringvec& other) &
+{
+    STRINGVEC_STAT(merge);
+
+    if (&other == this)
+    {
+        return merge(stringvec{other});
+    }
+
+    index.reset();
+    search.reset();
+
+    if (order == ordering::none)
+    {
+        sort_alphabetically();
+    }
+
+    const std::vector<std::string>* source = &other.vec;
+    stringvec                       sorted;
+    if (other.order != order)
+    {
+        sorted = other;
+        order == ordering::alphabetical ? sorted.sort_alphabetically() : sorted.sort_length();
+        source = &sorted.vec;
+    }
+
+    std::vector<std::string> merged;
+    merged.reserve(vec.size() + source->size());
+    if (order == ordering::alphabetical)
+    {
+        std::merge(std::make_move_iterator(vec.begin()), std::make_move_iterator(vec.end()),
+                   source->begin(), source->end(),
+                   std::back_inserter(merged), std::less<>{});
+    }
+    else
+    {
+        std::merge(std::make_move_iterator(vec.begin()), std::make_move_iterator(vec.end()),
+                   source->begin(), source->end(),
+                   std::back_inserter(merged), stringvec_detail::length_less{});
+    }
+    vec = std::move(merged);
+
+    return *this;
+}
+
+/** -----------------------------------------------------------------------------------------------
+ * @brief Move the strings of another vector to the end of this one.
+ * @param other: Vector to append.
+ *
+ * @details Unlike appending through `get()`, the suffix array is extended rather than dropped.
+ */
+inline stringvec& stringvec::append(stringvec other) &
+{
+    STRINGVEC_STAT(append);
+
+    index.reset();
+    order = ordering::none;
+
+    if (vec.empty())
+    {
+        vec = std::move(other.vec);
+    }
+    else
+    {
+        vec.insert(vec.end(), std::make_move_iterator(other.vec.begin()), std::make_move_iterator(other.vec.end()));
+    }
+
+    extend_search_index();
+    return *this;
+}
+
+
+/** -----------------------------------------------------------------------------------------------
+ * @brief Remove duplicated strings.
+ * @param sorted: If true, sort the remaining strings alphabetically, otherwise keep the first
+ *                occurrence of each string in its original order.
+ *
+ * @details See the overload taking an execution policy to spread the work across threads.
+ */
+inline stringvec& stringvec::unique(bool sorted) &
+{
+    STRINGVEC_STAT(unique);
+
+    index.reset();
+    search.reset();
+
+    return unique(stringvec_execution::seq, sorted);
+}
+
+/** -----------------------------------------------------------------------------------------------
+ * @brief Keep every distinct string of both vectors: the ones of this vector, followed by the
+ *        ones only found in `other`, each in order of first occurrence.
+ */
+inline stringvec& stringvec::merge_union(const stringvec& other) &
+{
+    STRINGVEC_STAT(merge_union);
+
+    index.reset();
+    search.reset();
+    order = ordering::none;
+
+    return merge_union(stringvec_execution::seq, other);
+}
+
+/** -----------------------------------------------------------------------------------------------
+ * @brief Keep the distinct strings that are also found in `other`, in order of first occurrence.
+ */
+inline stringvec& stringvec::intersect(const stringvec& other) &
+{
+    STRINGVEC_STAT(intersect);
+
+    index.reset();
+    search.reset();
+
+    return intersect(stringvec_execution::seq, other);
+}
+
+/** -----------------------------------------------------------------------------------------------
+ * @brief Keep the distinct strings that are not found in `other`, in order of first occurrence.
+ */
+inline stringvec& stringvec::difference(const stringvec& other) &
+{
+    STRINGVEC_STAT(difference);
+
+    index.reset();
+    search.reset();
+
+    return difference(stringvec_execution::seq, other);
+}
+
+
+/** -----------------------------------------------------------------------------------------------
+ * @brief Find the first element matching the input function.
+ * @param func: Function to match in the vector.
+ */
+inline stringvec::iter stringvec::find(const std::function<bool(const std::string&)> func)
+{
+    STRINGVEC_STAT(find);
+
+    return std::find_if(begin(), end(), func);
+}
+
+inline stringvec::citer stringvec::find(const std::function<bool(const std::string&)> func) const
+{
+    STRINGVEC_STAT(find);
+
+    return const_cast<stringvec*>(this)->find(func);
+}
+
+/** -----------------------------------------------------------------------------------------------
+ * @brief Find the last element matching the input function.
+ * @param func: Function to match in the vector.
+ */
+inline stringvec::iter stringvec::rfind(const std::function<bool(const std::string&)> func)
+{
+    STRINGVEC_STAT(rfind);
+
+    riter it = std::find_if(vec.rbegin(), vec.rend(), func);
+
+    // https://stackoverflow.com/q/4407985
+    if (it != vec.crend())
+    {
+        return iter{--(it.base())};
+    }
+    else
+    {
+        return vec.end();
+    }
+}
+
+inline stringvec::citer stringvec::rfind(const std::function<bool(const std::string&)> func) const
+{
+    STRINGVEC_STAT(rfind);
+
+    return const_cast<stringvec*>(this)->rfind(func);
+}
+
+/** -----------------------------------------------------------------------------------------------
+ * @brief Find the first element matching a predicate.
+ * @param func: Predicate to match in the vector.
+ */
+template <std::predicate<const std::string&> Pred>
+inline stringvec::iter stringvec::find(Pred&& func)
+{
+    STRINGVEC_STAT(find);
+
+    return std::find_if(begin(), end(), [&func](const std::string& s)
+                                        {
+                                            return std::invoke(func, s);
+                                        });
+}
+
+template <std::predicate<const std::string&> Pred>
+inline stringvec::citer stringvec::find(Pred&& func) const
+{
+    STRINGVEC_STAT(find);
+
+    return const_cast<stringvec*>(this)->find(std::forward<Pred>(func));
+}
+
+/** -----------------------------------------------------------------------------------------------
+ * @brief Find the last element matching a predicate.
+ * @param func: Predicate to match in the vector.
+ */
+template <std::predicate<const std::string&> Pred>
+inline stringvec::iter stringvec::rfind(Pred&& func)
+{
+    STRINGVEC_STAT(rfind);
+
+    riter it = std::find_if(vec.rbegin(), vec.rend(), [&func](const std::string& s)
+                                                      {
+                                                          return std::invoke(func, s);
+                                                      });
+
+    return it != vec.rend() ? iter{--(it.base())} : vec.end();
+}
+
+template <std::predicate<const std::string&> Pred>
+inline stringvec::citer stringvec::rfind(Pred&& func) const
+{
+    STRINGVEC_STAT(rfind);
+
+    return const_cast<stringvec*>(this)->rfind(std::forward<Pred>(func));
+}
+
+/** -----------------------------------------------------------------------------------------------
+ * @brief Find the first element matching the input string.
+ * @param s: String to find in the vector.
+ *
+ * @details Answered in O(1) from the hash index while it is valid, see `build_index`, or in
+ *          O(log N) while the vector is known to be sorted, see `sort_order`.
+ */
+inline stringvec::iter stringvec::find(const std::string_view s)
+{
+    STRINGVEC_STAT(find);
+
+    if (index)
+    {
+        const std::size_t pos = index->find(vec, s);
+        return pos != stringvec_detail::flat_index::npos ? begin() + pos : end();
+    }
+
+    if (order == ordering::alphabetical)
+    {
+        const iter it = std::lower_bound(begin(), end(), s, std::less<>{});
+        return it != end() && *it == s ? it : end();
+    }
+
+    if (order == ordering::length)
+    {
+        const auto [first, last] = std::equal_range(begin(), end(), s, stringvec_detail::length_less{});
+        const iter it            = std::find(first, last, s);
+        return it != last ? it : end();
+    }
+
+    return find([s](const std::string_view x){return x == s;});
+}
+
+inline stringvec::citer stringvec::find(const std::string_view s) const
+{
+    STRINGVEC_STAT(find);
+
+    return const_cast<stringvec*>(this)->find(s);
+}
+
+/** -----------------------------------------------------------------------------------------------
+ * @brief Find the first element equal to the input string, regardless of case.
+ * @param s: String to find, compared after UTF-8 case folding, see `casefold_utf8`.
+ */
+inline stringvec::iter stringvec::find_icase(const std::string_view s)
+{
+    STRINGVEC_STAT(find);
+
+    const stringvec_detail::icase_needle needle{s};
+    return find([&needle](const std::string& x)
+                {
+                    return needle.equals(x);
+                });
+}
+
+inline stringvec::citer stringvec::find_icase(const std::string_view s) const
+{
+    STRINGVEC_STAT(find);
+
+    return const_cast<stringvec*>(this)->find_icase(s);
+}
+
+/** -----------------------------------------------------------------------------------------------
+ * @brief Find the last element matching the input string.
+ * @param s: String to find in the vector.
+ */
+inline stringvec::iter stringvec::rfind(const std::string_view s)
+{
+    STRINGVEC_STAT(rfind);
+
+    if (index)
+    {
+        const std::size_t pos = index->rfind(vec, s);
+        return pos != stringvec_detail::flat_index::npos ? begin() + pos : end();
+    }
+
+    if (order == ordering::alphabetical)
+    {
+        const iter it = std::upper_bound(begin(), end(), s, std::less<>{});
+        return it != begin() && *(it - 1) == s ? it - 1 : end();
+    }
+
+    if (order == ordering::length)
+    {
+        const auto [first, last] = std::equal_range(begin(), end(), s, stringvec_detail::length_less{});
+        for (iter it = last; it != first; it--)
+        {
+            if (*(it - 1) == s)
+            {
+                return it - 1;
+            }
+        }
+        return end();
+    }
+
+    return rfind([s](const std::string_view x){return x == s;});
+}
+
+inline stringvec::citer stringvec::rfind(const std::string_view s) const
+{
+    STRINGVEC_STAT(rfind);
+
+    return const_cast<stringvec*>(this)->rfind(s);
+}
+
+/** -----------------------------------------------------------------------------------------------
+ * @brief Check if the vector contains a string.
+ * @param s: String to look for.
+ */
+inline bool stringvec::contains(const std::string_view s) const
+{
+    return find(s) != end();
+}
+
+
+/** -----------------------------------------------------------------------------------------------
+ * @brief Build a hash index of the strings, used by `find`, `rfind` and `contains` on strings.
+ *
+ * @details The index costs O(N) to build, then makes each exact-match lookup O(1).
+ *          Every modifying method discards it, as does the non-const `get`; modifying strings
+ *          through iterators or `operator[]` does not, so call `drop_index` before doing so.
+ *          Copies of the vector share the index.
+ */
+inline stringvec& stringvec::build_index() &
+{
+    STRINGVEC_STAT(build_index);
+
+    index = std::make_shared<const stringvec_detail::flat_index>(vec);
+
+    return *this;
+}
+
+/** -----------------------------------------------------------------------------------------------
+ * @brief Discard the hash index, going back to linear searches.
+ */
+inline void stringvec::drop_index()
+{
+    index.reset();
+}
+
+/** -----------------------------------------------------------------------------------------------
+ * @brief Check if the hash index is currently valid.
+ */
+inline bool stringvec::has_index() const
+{
+    return index != nullptr;
+}
+
+/** -----------------------------------------------------------------------------------------------
+ * @brief Build a suffix array of the strings, used by `find_all_containing` and
+ *        `find_all_with_prefix`.
+ *
+ * @details The index costs O(B log B) to build over B bytes, and about 5 bytes per byte of the
+ *          strings to keep. It follows the vector through `read_file`, which appends, and the
+ *          `remove_first`, `remove_last`, `remove_nth` and `remove_range` methods, which erase a
+ *          range: appended strings are scanned until enough of them gather into a new segment,
+ *          and erased ones are skipped until most of a segment is gone, see `search_index`. Every
+ *          other modifying method discards it, as with `build_index`.
+ *          Copies of the vector share the index.
+ * @throw   std::length_error if a string holds 4 GiB or more.
+ */
+inline stringvec& stringvec::build_search_index() &
+{
+    STRINGVEC_STAT(build_index);
+
+    search = std::make_shared<const stringvec_detail::search_index>(vec);
+
+    return *this;
+}
+
+/** -----------------------------------------------------------------------------------------------
+ * @brief Discard the suffix array, going back to linear searches.
+ */
+inline void stringvec::drop_search_index()
+{
+    search.reset();
+}
+
+/** -----------------------------------------------------------------------------------------------
+ * @brief Check if the suffix array is currently valid.
+ */
+inline bool stringvec::has_search_index() const
+{
+    return search != nullptr;
+}
+
+/** -----------------------------------------------------------------------------------------------
+ * @brief Discard what is known about the strings, before modifying them.
+ * @param keeps_order:  Whether the modification keeps the strings in the order they are known to
+ *                      be sorted in, as removing some of them does.
+ * @param keeps_search: Whether the caller updates the suffix array itself, see
+ *                      `build_search_index`, rather than having it discarded.
+ */
+inline void stringvec::invalidate(bool keeps_order, bool keeps_search)
+{
+    index.reset();
+    if (!keeps_search)
+    {
+        search.reset();
+    }
+    if (!keeps_order)
+    {
+        order = ordering::none;
+    }
+}
+
+/** -----------------------------------------------------------------------------------------------
+ * @brief Follow strings appended to the vector with the suffix array, if there is one.
+ */
+inline void stringvec::extend_search_index()
+{
+    if (search)
+    {
+        search = search->appended(vec);
+    }
+}
+
+
+/** -----------------------------------------------------------------------------------------------
+ * @brief Find the first element matching the input regex.
+ * @param regex: Regex to match in the vector.
+ */
+inline stringvec::iter stringvec::find_reg(const std::string& regex)
+{
+    STRINGVEC_STAT(find_reg);
+
+    try
+    {
+        return find_reg(regex_cache::global().get(regex));
+    }
+    catch (const std::regex_error& e)
+    {
+        std::cerr << "Error: Invalid regex pattern '" << regex << "'. "
+                  << "Details: " << e.what() << std::endl;
+
+        return end();
+    }
+}
+
+inline stringvec::citer stringvec::find_reg(const std::string& regex) const
+{
+    STRINGVEC_STAT(find_reg);
+
+    return const_cast<stringvec*>(this)->find_reg(regex);
+}
+
+/** -----------------------------------------------------------------------------------------------
+ * @brief Find the first element matching the precompiled regex.
+ * @param regex: Precompiled Regex to match in the vector.
+ */
+inline stringvec::iter stringvec::find_reg(const regex_handle& regex)
+{
+    STRINGVEC_STAT(find_reg);
+
+    return find([&regex](const std::string& s)
+                {
+                    return regex->match(s);
+                });
+}
+
+inline stringvec::citer stringvec::find_reg(const regex_handle& regex) const
+{
+    STRINGVEC_STAT(find_reg);
+
+    return const_cast<stringvec*>(this)->find_reg(regex);
+}
+
+/** -----------------------------------------------------------------------------------------------
+ * @brief Find the last element matching the input regex.
+ * @param regex: Regex to match in the vector.
+ */
+inline stringvec::iter stringvec::rfind_reg(const std::string& regex)
+{
+    STRINGVEC_STAT(rfind_reg);
+
+    try
+    {
+        return rfind_reg(regex_cache::global().get(regex));
+    }
+    catch (const std::regex_error& e)
+    {
+        std::cerr << "Error: Invalid regex pattern '" << regex << "'. "
+                  << "Details: " << e.what() << std::endl;
+
+        return end();
+    }
+}
+
+inline stringvec::citer stringvec::rfind_reg(const std::string& regex) const
+{
+    STRINGVEC_STAT(rfind_reg);
+
+    return const_cast<stringvec*>(this)->rfind_reg(regex);
+}
+
+/** -----------------------------------------------------------------------------------------------
+ * @brief Find the last element matching the precompiled regex.
+ * @param regex: Precompiled Regex to match in the vector.
+ */
+inline stringvec::iter stringvec::rfind_reg(const regex_handle& regex)
+{
+    STRINGVEC_STAT(rfind_reg);
+
+    return rfind([&regex](const std::string& s)
+                 {
+                     return regex->match(s);
+                 });
+}
+
+inline stringvec::citer stringvec::rfind_reg(const regex_handle& regex) const
+{
+    STRINGVEC_STAT(rfind_reg);
+
+    return const_cast<stringvec*>(this)->rfind_reg(regex);
+}
+
+/** -----------------------------------------------------------------------------------------------
+ * @brief Find the first string matching any pattern of a set, and which pattern it matches.
+ * @param patterns: Substrings and regexes to check against, see `pattern_set`.
+ * @return The string, or `end()`, and the lowest number of the patterns it matches, or
+ *         `pattern_set::npos`.
+ */
+inline std::pair<stringvec::iter, std::size_t> stringvec::find_any(const pattern_set& patterns)
+{
+    STRINGVEC_STAT(find);
+
+    const iter it = std::find_if(vec.begin(), vec.end(), [&patterns](const std::string_view s)
+                                                         {
+                                                             return patterns.match(s);
+                                                         });
+
+    return {it, it != vec.end() ? patterns.which(*it) : pattern_set::npos};
+}
+
+inline std::pair<stringvec::citer, std::size_t> stringvec::find_any(const pattern_set& patterns) const
+{
+    STRINGVEC_STAT(find);
+
+    const auto [it, pattern] = const_cast<stringvec*>(this)->find_any(patterns);
+    return {it, pattern};
+}
+
+/** -----------------------------------------------------------------------------------------------
+ * @brief Get the positions of all the strings containing a substring, in order.
+ * @param s: Substring to look for.
+ *
+ * @details Answered from the suffix array while there is one, see `build_search_index`, in
+ *          O(|s| log N) plus the number of occurrences, or with a linear scan.
+ */
+inline std::vector<std::size_t> stringvec::find_all_containing(const std::string_view s) const
+{
+    STRINGVEC_STAT(find);
+
+    if (search)
+    {
+        return search->containing(vec, s);
+    }
+
+    return stringvec_detail::search_index::scan(vec, 0, [s](const std::string_view x)
+                                                        {
+                                                            return x.find(s) != std::string_view::npos;
+                                                        });
+}
+
+/** -----------------------------------------------------------------------------------------------
+ * @brief Get the positions of all the strings starting with a prefix, in order.
+ * @param s: Prefix to look for.
+ *
+ * @details Answered from the suffix array while there is one, or in O(log N) while the vector is
+ *          known to be sorted alphabetically, or with a linear scan.
+ */
+inline std::vector<std::size_t> stringvec::find_all_with_prefix(const std::string_view s) const
+{
+    STRINGVEC_STAT(find);
+
+    if (search)
+    {
+        return search->with_prefix(vec, s);
+    }
+
+    if (order == ordering::alphabetical)
+    {
+        /* Strings starting with `s` are a range, as the strings with a given first |s| bytes. */
+        const auto head  = [&s](const std::string_view x)
+                           {
+                               return x.substr(0, s.size());
+                           };
+        const citer first = std::partition_point(begin(), end(), [&](const std::string_view x)
+                                                                 {
+                                                                     return head(x) < s;
+                                                                 });
+        const citer last  = std::partition_point(first, end(), [&](const std::string_view x)
+                                                               {
+                                                                   return head(x) == s;
+                                                               });
+
+        std::vector<std::size_t> positions(static_cast<std::size_t>(last - first));
+        std::iota(positions.begin(), positions.end(), static_cast<std::size_t>(first - begin()));
+        return positions;
+    }
+
+    return stringvec_detail::search_index::scan(vec, 0, [s](const std::string_view x)
+                                                        {
+                                                            return x.starts_with(s);
+                                                        });
+}
+
+/** -----------------------------------------------------------------------------------------------
+ * @brief Get the positions of all the elements matching a predicate, in order.
+ * @param func: Predicate taking a string.
+ */
+template <std::predicate<const std::string&> Pred>
+inline std::vector<std::size_t> stringvec::find_all(Pred&& func) const
+{
+    STRINGVEC_STAT(find);
+
+    return find_all(stringvec_execution::seq, std::forward<Pred>(func));
+}
+
+/** -----------------------------------------------------------------------------------------------
+ * @brief Get the positions of all the elements equal to a string, in order.
+ * @param s: String to find in the vector.
+ *
+ * @details Only the positions between the first and last match are compared while the hash index
+ *          is valid, and the matches are found in O(log N) while the vector is known to be sorted.
+ */
+inline std::vector<std::size_t> stringvec::find_all(const std::string_view s) const
+{
+    STRINGVEC_STAT(find);
+
+    const auto equal = [s](const std::string_view x)
+                       {
+                           return x == s;
+                       };
+
+    std::size_t first = 0;
+    std::size_t last  = vec.size();
+    if (index)
+    {
+        first = index->find(vec, s);
+        if (first == stringvec_detail::flat_index::npos)
+        {
+            return {};
+        }
+        last = index->rfind(vec, s) + 1;
+    }
+    else if (order == ordering::alphabetical)
+    {
+        const auto [lo, hi] = std::equal_range(begin(), end(), s, std::less<>{});
+        first               = static_cast<std::size_t>(lo - begin());
+        last                = static_cast<std::size_t>(hi - begin());
+    }
+    else if (order == ordering::length)
+    {
+        const auto [lo, hi] = std::equal_range(begin(), end(), s, stringvec_detail::length_less{});
+        first               = static_cast<std::size_t>(lo - begin());
+        last                = static_cast<std::size_t>(hi - begin());
+    }
+
+    std::vector<std::size_t> positions;
+    for (std::size_t i = first; i < last; i++)
+    {
+        if (equal(vec[i]))
+        {
+            positions.push_back(i);
+        }
+    }
+    return positions;
+}
+
+/** -----------------------------------------------------------------------------------------------
+ * @brief Get the positions of all the elements matching a regex, in order.
+ * @param regex: Regex to match in the vector.
+ */
+inline std::vector<std::size_t> stringvec::find_all_reg(const std::string& regex) const
+{
+    STRINGVEC_STAT(find_reg);
+
+    return find_all_reg(stringvec_execution::seq, regex);
+}
+
+inline std::vector<std::size_t> stringvec::find_all_reg(const regex_handle& regex) const
+{
+    STRINGVEC_STAT(find_reg);
+
+    return find_all_reg(stringvec_execution::seq, regex);
+}
+
+/** -----------------------------------------------------------------------------------------------
+ * @brief Count the elements matching a predicate.
+ * @param func: Predicate taking a string.
+ */
+template <std::predicate<const std::string&> Pred>
+inline std::size_t stringvec::count_if(Pred&& func) const
+{
+    STRINGVEC_STAT(find);
+
+    return count_if(stringvec_execution::seq, std::forward<Pred>(func));
+}
+
+/** -----------------------------------------------------------------------------------------------
+ * @brief Count the elements matching a regex.
+ * @param regex: Regex to match in the vector.
+ */
+inline std::size_t stringvec::count_reg(const std::string& regex) const
+{
+    STRINGVEC_STAT(find_reg);
+
+    return count_reg(stringvec_execution::seq, regex);
+}
+
+inline std::size_t stringvec::count_reg(const regex_handle& regex) const
+{
+    STRINGVEC_STAT(find_reg);
+
+    return count_reg(stringvec_execution::seq, regex);
+}
+
+/** -----------------------------------------------------------------------------------------------
+ * @brief Get the positions of the elements matching a regex, then of the others, in order.
+ * @param regex: Regex to match in the vector.
+ *
+ * @details Every position is in exactly one of the two vectors, so that the vector can be split
+ *          without matching each string twice. An invalid regex matches nothing.
+ */
+inline std::pair<std::vector<std::size_t>, std::vector<std::size_t>> stringvec::partition_by(const std::string& regex) const
+{
+    STRINGVEC_STAT(find_reg);
+
+    return partition_by(stringvec_execution::seq, regex);
+}
+
+inline std::pair<std::vector<std::size_t>, std::vector<std::size_t>> stringvec::partition_by(const regex_handle& regex) const
+{
+    STRINGVEC_STAT(find_reg);
+
+    return partition_by(stringvec_execution::seq, regex);
+}
+
+
+/** -----------------------------------------------------------------------------------------------
+ * @brief Parallel overloads of the filtering, transforming, ordering and searching methods.
+ *
+ * @details The first argument selects where the work runs: `stringvec_execution::seq` runs it on
+ *          the calling thread, `stringvec_execution::par` on `thread_pool::global()`, and a
+ *          `thread_pool&` on that pool. The results are the same as the sequential methods: the
+ *          filters keep the order of the remaining elements and the searches return the same
+ *          element, so the functions passed must only be safe to call concurrently.
+ */
+template <stringvec_execution::policy Policy, std::predicate<const std::string&> Pred>
+inline stringvec& stringvec::filter_remove(Policy&& policy, Pred&& func) &
+{
+    STRINGVEC_STAT(filter_remove);
+
+    index.reset();
+    search.reset();
+
+    stringvec_detail::parallel_filter(stringvec_detail::pool_of(policy),
+                                      stringvec_detail::grain_of(policy),
+                                      vec,
+                                      [&func](const std::string& s)
+                                      {
+                                          return !std::invoke(func, s);
+                                      });
+
+    return *this;
+}
+
+template <stringvec_execution::policy Policy>
+inline stringvec& stringvec::filter_remove(Policy&& policy, const std::string& regex) &
+{
+    STRINGVEC_STAT(filter_remove);
+
+    index.reset();
+    search.reset();
+
+    try
+    {
+        filter_remove(policy, regex_cache::global().get(regex));
+    }
+    catch (const std::regex_error& e)
+    {
+        std::cerr << "Error: Invalid regex pattern '" << regex << "'. "
+                  << "Details: " << e.what() << std::endl;
+    }
+
+    return *this;
+}
+
+template <stringvec_execution::policy Policy>
+inline stringvec& stringvec::filter_remove(Policy&& policy, const regex_handle& regex) &
+{
+    STRINGVEC_STAT(filter_remove);
+
+    index.reset();
+    search.reset();
+
+    return filter_remove(policy, [&regex](const std::string& s)
+                                 {
+                                     return regex->match(s);
+                                 });
+}
+
+template <stringvec_execution::policy Policy, std::predicate<const std::string&> Pred>
+inline stringvec& stringvec::filter_keep(Policy&& policy, Pred&& func) &
+{
+    STRINGVEC_STAT(filter_keep);
+
+    index.reset();
+    search.reset();
+
+    stringvec_detail::parallel_filter(stringvec_detail::pool_of(policy),
+                                      stringvec_detail::grain_of(policy),
+                                      vec,
+                                      [&func](const std::string& s)
+                                      {
+                                          return static_cast<bool>(std::invoke(func, s));
+                                      });
+
+    return *this;
+}
+
+template <stringvec_execution::policy Policy>
+inline stringvec& stringvec::filter_keep(Policy&& policy, const std::string& regex) &
+{
+    STRINGVEC_STAT(filter_keep);
+
+    index.reset();
+    search.reset();
+
+    try
+    {
+        filter_keep(policy, regex_cache::global().get(regex));
+    }
+    catch (const std::regex_error& e)
+    {
+        std::cerr << "Error: Invalid regex pattern '" << regex << "'. "
+                  << "Details: " << e.what() << std::endl;
+    }
+
+    return *this;
+}
+
+template <stringvec_execution::policy Policy>
+inline stringvec& stringvec::filter_keep(Policy&& policy, const regex_handle& regex) &
+{
+    STRINGVEC_STAT(filter_keep);
+
+    index.reset();
+    search.reset();
+
+    return filter_keep(policy, [&regex](const std::string& s)
+                               {
+                                   return regex->match(s);
+                               });
+}
+
+template <stringvec_execution::policy Policy>
+inline stringvec& stringvec::filter_remove_any(Policy&& policy, const pattern_set& patterns) &
+{
+    STRINGVEC_STAT(filter_remove);
+
+    index.reset();
+    search.reset();
+
+    return filter_remove(policy, [&patterns](const std::string& s)
+                                 {
+                                     return patterns.match(s);
+                                 });
+}
+
+template <stringvec_execution::policy Policy>
+inline stringvec& stringvec::filter_keep_any(Policy&& policy, const pattern_set& patterns) &
+{
+    STRINGVEC_STAT(filter_keep);
+
+    index.reset();
+    search.reset();
+
+    return filter_keep(policy, [&patterns](const std::string& s)
+                               {
+                                   return patterns.match(s);
+                               });
+}
+
+template <stringvec_execution::policy Policy, std::invocable<const std::string&> Func>
+inline stringvec& stringvec::transform(Policy&& policy, Func&& func) &
+{
+    STRINGVEC_STAT(transform);
+
+    index.reset();
+    search.reset();
+    order = ordering::none;
+
+    stringvec_detail::parallel_for_each(stringvec_detail::pool_of(policy),
+                                        stringvec_detail::grain_of(policy),
+                                        vec.begin(),
+                                        vec.end(),
+                                        [&func](std::string& s)
+                                        {
+                                            if constexpr (std::invocable<Func&, std::string&&>)
+                                            {
+                                                s = std::invoke(func, std::move(s));
+                                            }
+                                            else
+                                            {
+                                                s = std::invoke(func, std::as_const(s));
+                                            }
+                                        });
+
+    return *this;
+}
+
+template <stringvec_execution::policy Policy, std::invocable<std::string&> Func>
+inline stringvec& stringvec::transform_inplace(Policy&& policy, Func&& func) &
+{
+    STRINGVEC_STAT(transform_inplace);
+
+    index.reset();
+    search.reset();
+    order = ordering::none;
+
+    stringvec_detail::parallel_for_each(stringvec_detail::pool_of(policy),
+                                        stringvec_detail::grain_of(policy),
+                                        vec.begin(),
+                                        vec.end(),
+                                        [&func](std::string& s)
+                                        {
+                                            std::invoke(func, s);
+                                        });
+
+    return *this;
+}
+
+template <stringvec_execution::policy Policy>
+inline stringvec& stringvec::trim(Policy&& policy) &
+{
+    STRINGVEC_STAT(trim);
+
+    index.reset();
+    search.reset();
+    order = ordering::none;
+
+    return transform_inplace(policy, trim_string);
+}
+
+template <stringvec_execution::policy Policy, class Compare>
+    requires std::predicate<Compare&, const std::string&, const std::string&>
+inline stringvec& stringvec::sort(Policy&& policy, Compare&& comp) &
+{
+    STRINGVEC_STAT(sort);
+
+    index.reset();
+    search.reset();
+    order = ordering::none;
+
+    stringvec_detail::parallel_sort(stringvec_detail::pool_of(policy),
+                                    stringvec_detail::grain_of(policy),
+                                    vec.begin(),
+                                    vec.end(),
+                                    [&comp](const std::string& a, const std::string& b)
+                                    {
+                                        return static_cast<bool>(std::invoke(comp, a, b));
+                                    });
+
+    return *this;
+}
+
+template <stringvec_execution::policy Policy>
+inline stringvec& stringvec::sort_alphabetically(Policy&& policy) &
+{
+    STRINGVEC_STAT(sort_alphabetically);
+
+    index.reset();
+    search.reset();
+
+    stringvec_detail::radix_sort_strings(stringvec_detail::pool_of(policy), stringvec_detail::grain_of(policy), vec);
+    order = ordering::alphabetical;
+
+    return *this;
+}
+
+template <stringvec_execution::policy Policy>
+inline stringvec& stringvec::sort_length(Policy&& policy) &
+{
+    STRINGVEC_STAT(sort_length);
+
+    index.reset();
+    search.reset();
+
+    stringvec_detail::counting_sort_length(stringvec_detail::pool_of(policy), stringvec_detail::grain_of(policy), vec);
+    order = ordering::length;
+
+    return *this;
+}
+
+/** -----------------------------------------------------------------------------------------------
+ * @brief Set operations, on hash partitions processed in parallel.
+ *
+ * @details The strings of both vectors are hashed and their positions grouped by the high bits of
+ *          their hash, so that equal strings always share a partition. Each partition is then
+ *          deduplicated and matched against its counterpart independently, and the kept strings
+ *          are compacted in their original order.
+ */
+template <stringvec_execution::policy Policy>
+inline stringvec& stringvec::unique(Policy&& policy, bool sorted) &
+{
+    STRINGVEC_STAT(unique);
+
+    index.reset();
+    search.reset();
+
+    thread_pool*      pool  = stringvec_detail::pool_of(policy);
+    const std::size_t grain = stringvec_detail::grain_of(policy);
+
+    const std::vector<std::uint8_t> flags = stringvec_detail::set_flags(pool, grain, vec, vec,
+                                                                        stringvec_detail::set_operation::unique);
+    stringvec_detail::compact_by_flags(pool, grain, vec, flags);
+
+    if (sorted)
+    {
+        stringvec_detail::radix_sort_strings(pool, grain, vec);
+        order = ordering::alphabetical;
+    }
+
+    return *this;
+}
+
+template <stringvec_execution::policy Policy>
+inline stringvec& stringvec::merge_union(Policy&& policy, const stringvec& other) &
+{
+    STRINGVEC_STAT(merge_union);
+
+    index.reset();
+    search.reset();
+    order = ordering::none;
+
+    thread_pool*      pool  = stringvec_detail::pool_of(policy);
+    const std::size_t grain = stringvec_detail::grain_of(policy);
+
+    /* Flags are computed before any change, in case `other` is this vector. */
+    const std::vector<std::uint8_t> mine   = stringvec_detail::set_flags(pool, grain, vec, vec,
+                                                                         stringvec_detail::set_operation::unique);
+    const std::vector<std::uint8_t> theirs = stringvec_detail::set_flags(pool, grain, other.vec, vec,
+                                                                         stringvec_detail::set_operation::difference);
+
+    std::vector<std::string> extra;
+    extra.reserve(static_cast<std::size_t>(std::count(theirs.begin(), theirs.end(), std::uint8_t{1})));
+    for (std::size_t i = 0; i < theirs.size(); i++)
+    {
+        if (theirs[i] != 0)
+        {
+            extra.push_back(other.vec[i]);
+        }
+    }
+
+    stringvec_detail::compact_by_flags(pool, grain, vec, mine);
+    vec.insert(vec.end(), std::make_move_iterator(extra.begin()), std::make_move_iterator(extra.end()));
+
+    return *this;
+}
+
+template <stringvec_execution::policy Policy>
+inline stringvec& stringvec::intersect(Policy&& policy, const stringvec& other) &
+{
+    STRINGVEC_STAT(intersect);
+
+    index.reset();
+    search.reset();
+
+    thread_pool*      pool  = stringvec_detail::pool_of(policy);
+    const std::size_t grain = stringvec_detail::grain_of(policy);
+
+    const std::vector<std::uint8_t> flags = stringvec_detail::set_flags(pool, grain, vec, other.vec,
+                                                                        stringvec_detail::set_operation::intersect);
+    stringvec_detail::compact_by_flags(pool, grain, vec, flags);
+
+    return *this;
+}
+
+template <stringvec_execution::policy Policy>
+inline stringvec& stringvec::difference(Policy&& policy, const stringvec& other) &
+{
+    STRINGVEC_STAT(difference);
+
+    index.reset();
+    search.reset();
+
+    thread_pool*      pool  = stringvec_detail::pool_of(policy);
+    const std::size_t grain = stringvec_detail::grain_of(policy);
+
+    const std::vector<std::uint8_t> flags = stringvec_detail::set_flags(pool, grain, vec, other.vec,
+                                                                        stringvec_detail::set_operation::difference);
+    stringvec_detail::compact_by_flags(pool, grain, vec, flags);
+
+    return *this;
+}
+
+template <stringvec_execution::policy Policy, std::predicate<const std::string&> Pred>
+inline stringvec::iter stringvec::find(Policy&& policy, Pred&& func)
+{
+    STRINGVEC_STAT(find);
+
+    return stringvec_detail::parallel_find(stringvec_detail::pool_of(policy),
+                                           stringvec_detail::grain_of(policy),
+                                           vec.begin(),
+                                           vec.end(),
+                                           [&func](const std::string& s)
+                                           {
+                                               return static_cast<bool>(std::invoke(func, s));
+                                           });
+}
+
+template <stringvec_execution::policy Policy, std::predicate<const std::string&> Pred>
+inline stringvec::citer stringvec::find(Policy&& policy, Pred&& func) const
+{
+    STRINGVEC_STAT(find);
+
+    return const_cast<stringvec*>(this)->find(policy, std::forward<Pred>(func));
+}
+
+template <stringvec_execution::policy Policy, std::predicate<const std::string&> Pred>
+inline stringvec::iter stringvec::rfind(Policy&& policy, Pred&& func)
+{
+    STRINGVEC_STAT(rfind);
+
+    return stringvec_detail::parallel_find_last(stringvec_detail::pool_of(policy),
+                                                stringvec_detail::grain_of(policy),
+                                                vec.begin(),
+                                                vec.end(),
+                                                [&func](const std::string& s)
+                                                {
+                                                    return static_cast<bool>(std::invoke(func, s));
+                                                });
+}
+
+template <stringvec_execution::policy Policy, std::predicate<const std::string&> Pred>
+inline stringvec::citer stringvec::rfind(Policy&& policy, Pred&& func) const
+{
+    STRINGVEC_STAT(rfind);
+
+    return const_cast<stringvec*>(this)->rfind(policy, std::forward<Pred>(func));
+}
+
+template <stringvec_execution::policy Policy>
+inline stringvec::iter stringvec::find(Policy&& policy, const std::string_view s)
+{
+    STRINGVEC_STAT(find);
+
+    return find(policy, [s](const std::string& str)
+                        {
+                            return str == s;
+                        });
+}
+
+template <stringvec_execution::policy Policy>
+inline stringvec::citer stringvec::find(Policy&& policy, const std::string_view s) const
+{
+    STRINGVEC_STAT(find);
+
+    return const_cast<stringvec*>(this)->find(policy, s);
+}
+
+template <stringvec_execution::policy Policy>
+inline stringvec::iter stringvec::rfind(Policy&& policy, const std::string_view s)
+{
+    STRINGVEC_STAT(rfind);
+
+    return rfind(policy, [s](const std::string& str)
+                         {
+                             return str == s;
+                         });
+}
+
+template <stringvec_execution::policy Policy>
+inline stringvec::citer stringvec::rfind(Policy&& policy, const std::string_view s) const
+{
+    STRINGVEC_STAT(rfind);
+
+    return const_cast<stringvec*>(this)->rfind(policy, s);
+}
+
+template <stringvec_execution::policy Policy>
+inline stringvec::iter stringvec::find_reg(Policy&& policy, const std::string& regex)
+{
+    STRINGVEC_STAT(find_reg);
+
+    try
+    {
+        return find_reg(policy, regex_cache::global().get(regex));
+    }
+    catch (const std::regex_error& e)
+    {
+        std::cerr << "Error: Invalid regex pattern '" << regex << "'. "
+                  << "Details: " << e.what() << std::endl;
+
+        return end();
+    }
+}
+
+template <stringvec_execution::policy Policy>
+inline stringvec::citer stringvec::find_reg(Policy&& policy, const std::string& regex) const
+{
+    STRINGVEC_STAT(find_reg);
+
+    return const_cast<stringvec*>(this)->find_reg(policy, regex);
+}
+
+template <stringvec_execution::policy Policy>
+inline stringvec::iter stringvec::rfind_reg(Policy&& policy, const std::string& regex)
+{
+    STRINGVEC_STAT(rfind_reg);
+
+    try
+    {
+        return rfind_reg(policy, regex_cache::global().get(regex));
+    }
+    catch (const std::regex_error& e)
+    {
+        std::cerr << "Error: Invalid regex pattern '" << regex << "'. "
+                  << "Details: " << e.what() << std::endl;
+
+        return end();
+    }
+}
+
+template <stringvec_execution::policy Policy>
+inline stringvec::citer stringvec::rfind_reg(Policy&& policy, const std::string& regex) const
+{
+    STRINGVEC_STAT(rfind_reg);
+
+    return const_cast<stringvec*>(this)->rfind_reg(policy, regex);
+}
+
+template <stringvec_execution::policy Policy>
+inline stringvec::iter stringvec::find_reg(Policy&& policy, const regex_handle& regex)
+{
+    STRINGVEC_STAT(find_reg);
+
+    return find(policy, [&regex](const std::string& s)
+                        {
+                            return regex->match(s);
+                        });
+}
+
+template <stringvec_execution::policy Policy>
+inline stringvec::citer stringvec::find_reg(Policy&& policy, const regex_handle& regex) const
+{
+    STRINGVEC_STAT(find_reg);
+
+    return const_cast<stringvec*>(this)->find_reg(policy, regex);
+}
+
+template <stringvec_execution::policy Policy>
+inline stringvec::iter stringvec::rfind_reg(Policy&& policy, const regex_handle& regex)
+{
+    STRINGVEC_STAT(rfind_reg);
+
+    return rfind(policy, [&regex](const std::string& s)
+                         {
+                             return regex->match(s);
+                         });
+}
+
+template <stringvec_execution::policy Policy>
+inline stringvec::citer stringvec::rfind_reg(Policy&& policy, const regex_handle& regex) const
+{
+    STRINGVEC_STAT(rfind_reg);
+
+    return const_cast<stringvec*>(this)->rfind_reg(policy, regex);
+}
+
+template <stringvec_execution::policy Policy, std::predicate<const std::string&> Pred>
+inline std::vector<std::size_t> stringvec::find_all(Policy&& policy, Pred&& func) const
+{
+    STRINGVEC_STAT(find);
+
+    return stringvec_detail::parallel_positions(stringvec_detail::pool_of(policy),
+                                                stringvec_detail::grain_of(policy),
+                                                begin(),
+                                                end(),
+                                                [&func](const std::string& s)
+                                                {
+                                                    return static_cast<bool>(std::invoke(func, s));
+                                                });
+}
+
+template <stringvec_execution::policy Policy>
+inline std::vector<std::size_t> stringvec::find_all_reg(Policy&& policy, const std::string& regex) const
+{
+    STRINGVEC_STAT(find_reg);
+
+    try
+    {
+        return find_all_reg(policy, regex_cache::global().get(regex));
+    }
+    catch (const std::regex_error& e)
+    {
+        std::cerr << "Error: Invalid regex pattern '" << regex << "'. "
+                  << "Details: " << e.what() << std::endl;
+
+        return {};
+    }
+}
+
+template <stringvec_execution::policy Policy>
+inline std::vector<std::size_t> stringvec::find_all_reg(Policy&& policy, const regex_handle& regex) const
+{
+    STRINGVEC_STAT(find_reg);
+
+    return find_all(policy, [&regex](const std::string& s)
+                            {
+                                return regex->match(s);
+                            });
+}
+
+template <stringvec_execution::policy Policy, std::predicate<const std::string&> Pred>
+inline std::size_t stringvec::count_if(Policy&& policy, Pred&& func) const
+{
+    STRINGVEC_STAT(find);
+
+    return stringvec_detail::parallel_count(stringvec_detail::pool_of(policy),
+                                            stringvec_detail::grain_of(policy),
+                                            begin(),
+                                            end(),
+                                            [&func](const std::string& s)
+                                            {
+                                                return static_cast<bool>(std::invoke(func, s));
+                                            });
+}
+
+template <stringvec_execution::policy Policy>
+inline std::size_t stringvec::count_reg(Policy&& policy, const std::string& regex) const
+{
+    STRINGVEC_STAT(find_reg);
+
+    try
+    {
+        return count_reg(policy, regex_cache::global().get(regex));
+    }
+    catch (const std::regex_error& e)
+    {
+        std::cerr << "Error: Invalid regex pattern '" << regex << "'. "
+                  << "Details: " << e.what() << std::endl;
+
+        return 0;
+    }
+}
+
+template <stringvec_execution::policy Policy>
+inline std::size_t stringvec::count_reg(Policy&& policy, const regex_handle& regex) const
+{
+    STRINGVEC_STAT(find_reg);
+
+    return count_if(policy, [&regex](const std::string& s)
+                            {
+                                return regex->match(s);
+                            });
+}
+
+template <stringvec_execution::policy Policy>
+inline std::pair<std::vector<std::size_t>, std::vector<std::size_t>> stringvec::partition_by(Policy&&           policy,
+                                                                                             const std::string& regex) const
+{
+    STRINGVEC_STAT(find_reg);
+
+    try
+    {
+        return partition_by(policy, regex_cache::global().get(regex));
+    }
+    catch (const std::regex_error& e)
+    {
+        std::cerr << "Error: Invalid regex pattern '" << regex << "'. "
+                  << "Details: " << e.what() << std::endl;
+
+        std::vector<std::size_t> all(vec.size());
+        std::iota(all.begin(), all.end(), std::size_t{0});
+        return {{}, std::move(all)};
+    }
+}
+
+template <stringvec_execution::policy Policy>
+inline std::pair<std::vector<std::size_t>, std::vector<std::size_t>> stringvec::partition_by(Policy&&            policy,
+                                                                                             const regex_handle& regex) const
+{
+    STRINGVEC_STAT(find_reg);
+
+    return stringvec_detail::parallel_partition_positions(stringvec_detail::pool_of(policy),
+                                                          stringvec_detail::grain_of(policy),
+                                                          begin(),
+                                                          end(),
+                                                          [&regex](const std::string& s)
+                                                          {
+                                                              return regex->match(s);
+                                                          });
+}
+
+
+/** -----------------------------------------------------------------------------------------------
+ * @brief Rvalue overloads of the modifying methods.
+ *
+ * @details They apply the same operation, then return the vector as an rvalue so that chains such
+ *          as `stringvec{}.read_file(path).split().filter_keep(regex)` can be moved into their
+ *          destination instead of being copied.
+ */
+inline stringvec&& stringvec::read_file(const std::string& path) &&
+{
+    return std::move(read_file(path));
+}
+
+template <stringvec_execution::policy Policy>
+inline stringvec&& stringvec::read_file(Policy&& policy, const std::string& path) &&
+{
+    return std::move(read_file(policy, path));
+}
+
+inline stringvec&& stringvec::filter_remove(const std::function<bool(const std::string)> func) &&
+{
+    return std::move(filter_remove(func));
+}
+
+template <std::predicate<const std::string&> Pred>
+inline stringvec&& stringvec::filter_remove(Pred&& func) &&
+{
+    return std::move(filter_remove(std::forward<Pred>(func)));
+}
+
+inline stringvec&& stringvec::filter_remove(const std::string& regex) &&
+{
+    return std::move(filter_remove(regex));
+}
+
+inline stringvec&& stringvec::filter_remove(const regex_handle& regex) &&
+{
+    return std::move(filter_remove(regex));
+}
+
+inline stringvec&& stringvec::filter_keep(const std::function<bool(const std::string)> func) &&
+{
+    return std::move(filter_keep(func));
+}
+
+template <std::predicate<const std::string&> Pred>
+inline stringvec&& stringvec::filter_keep(Pred&& func) &&
+{
+    return std::move(filter_keep(std::forward<Pred>(func)));
+}
+
+inline stringvec&& stringvec::filter_keep(const std::string& regex) &&
+{
+    return std::move(filter_keep(regex));
+}
+
+inline stringvec&& stringvec::filter_keep(const regex_handle& regex) &&
+{
+    return std::move(filter_keep(regex));
+}
+
+inline stringvec&& stringvec::filter_remove_any(std::span<const std::string> regexes) &&
+{
+    return std::move(filter_remove_any(regexes));
+}
+
+inline stringvec&& stringvec::filter_remove_any(const pattern_set& patterns) &&
+{
+    return std::move(filter_remove_any(patterns));
+}
+
+inline stringvec&& stringvec::filter_keep_any(std::span<const std::string> regexes) &&
+{
+    return std::move(filter_keep_any(regexes));
+}
+
+inline stringvec&& stringvec::filter_keep_any(const pattern_set& patterns) &&
+{
+    return std::move(filter_keep_any(patterns));
+}
+
+inline stringvec&& stringvec::filter_remove_icase(const std::string_view s) &&
+{
+    return std::move(filter_remove_icase(s));
+}
+
+inline stringvec&& stringvec::filter_keep_icase(const std::string_view s) &&
+{
+    return std::move(filter_keep_icase(s));
+}
+
+inline stringvec&& stringvec::filter_empty(bool keep_whitespace) &&
+{
+    return std::move(filter_empty(keep_whitespace));
+}
+
+inline stringvec&& stringvec::remove_first(std::size_t count) &&
+{
+    return std::move(remove_first(count));
+}
+
+inline stringvec&& stringvec::remove_last(std::size_t count) &&
+{
+    return std::move(remove_last(count));
+}
+
+inline stringvec&& stringvec::remove_nth(std::size_t pos) &&
+{
+    return std::move(remove_nth(pos));
+}
+
+inline stringvec&& stringvec::remove_range(std::size_t first, std::size_t last) &&
+{
+    return std::move(remove_range(first, last));
+}
+
+inline stringvec&& stringvec::remove_indices(std::span<const std::size_t> positions) &&
+{
+    return std::move(remove_indices(positions));
+}
+
+inline stringvec&& stringvec::transform(const std::function<std::string(const std::string)> func) &&
+{
+    return std::move(transform(func));
+}
+
+template <std::invocable<const std::string&> Func>
+inline stringvec&& stringvec::transform(Func&& func) &&
+{
+    return std::move(transform(std::forward<Func>(func)));
+}
+
+template <std::invocable<std::string&> Func>
+inline stringvec&& stringvec::transform_inplace(Func&& func) &&
+{
+    return std::move(transform_inplace(std::forward<Func>(func)));
+}
+
+inline stringvec&& stringvec::trim() &&
+{
+    return std::move(trim());
+}
+
+inline stringvec&& stringvec::to_lower() &&
+{
+    return std::move(to_lower());
+}
+
+inline stringvec&& stringvec::to_upper() &&
+{
+    return std::move(to_upper());
+}
+
+inline stringvec&& stringvec::casefold_utf8() &&
+{
+    return std::move(casefold_utf8());
+}
+
+inline stringvec&& stringvec::split(const std::string_view delimiter) &&
+{
+    return std::move(split(delimiter));
+}
+
+inline stringvec&& stringvec::split_any(const std::string_view delimiters) &&
+{
+    return std::move(split_any(delimiters));
+}
+
+inline stringvec&& stringvec::reverse() &&
+{
+    return std::move(reverse());
+}
+
+inline stringvec&& stringvec::sort(const std::function<bool(const std::string_view,
+                                                      const std::string_view)> func) &&
+{
+    return std::move(sort(func));
+}
+
+inline stringvec&& stringvec::sort_alphabetically() &&
+{
+    return std::move(sort_alphabetically());
+}
+
+inline stringvec&& stringvec::sort_length() &&
+{
+    return std::move(sort_length());
+}
+
+template <stringvec_execution::policy Policy, std::predicate<const std::string&> Pred>
+inline stringvec&& stringvec::filter_remove(Policy&& policy, Pred&& func) &&
+{
+    return std::move(filter_remove(policy, std::forward<Pred>(func)));
+}
+
+template <stringvec_execution::policy Policy>
+inline stringvec&& stringvec::filter_remove(Policy&& policy, const std::string& regex) &&
+{
+    return std::move(filter_remove(policy, regex));
+}
+
+template <stringvec_execution::policy Policy>
+inline stringvec&& stringvec::filter_remove(Policy&& policy, const regex_handle& regex) &&
+{
+    return std::move(filter_remove(policy, regex));
+}
+
+template <stringvec_execution::policy Policy, std::predicate<const std::string&> Pred>
+inline stringvec&& stringvec::filter_keep(Policy&& policy, Pred&& func) &&
+{
+    return std::move(filter_keep(policy, std::forward<Pred>(func)));
+}
+
+template <stringvec_execution::policy Policy>
+inline stringvec&& stringvec::filter_keep(Policy&& policy, const std::string& regex) &&
+{
+    return std::move(filter_keep(policy, regex));
+}
+
+template <stringvec_execution::policy Policy>
+inline stringvec&& stringvec::filter_keep(Policy&& policy, const regex_handle& regex) &&
+{
+    return std::move(filter_keep(policy, regex));
+}
+
+template <stringvec_execution::policy Policy>
+inline stringvec&& stringvec::filter_remove_any(Policy&& policy, const pattern_set& patterns) &&
+{
+    return std::move(filter_remove_any(policy, patterns));
+}
+
+template <stringvec_execution::policy Policy>
+inline stringvec&& stringvec::filter_keep_any(Policy&& policy, const pattern_set& patterns) &&
+{
+    return std::move(filter_keep_any(policy, patterns));
+}
+
+template <stringvec_execution::policy Policy, std::invocable<const std::string&> Func>
+inline stringvec&& stringvec::transform(Policy&& policy, Func&& func) &&
+{
+    return std::move(transform(policy, std::forward<Func>(func)));
+}
+
+template <stringvec_execution::policy Policy, std::invocable<std::string&> Func>
+inline stringvec&& stringvec::transform_inplace(Policy&& policy, Func&& func) &&
+{
+    return std::move(transform_inplace(policy, std::forward<Func>(func)));
+}
+
+template <stringvec_execution::policy Policy>
+inline stringvec&& stringvec::trim(Policy&& policy) &&
+{
+    return std::move(trim(policy));
+}
+
+template <stringvec_execution::policy Policy, class Compare>
+    requires std::predicate<Compare&, const std::string&, const std::string&>
+inline stringvec&& stringvec::sort(Policy&& policy, Compare&& comp) &&
+{
+    return std::move(sort(policy, std::forward<Compare>(comp)));
+}
+
+template <stringvec_execution::policy Policy>
+inline stringvec&& stringvec::sort_alphabetically(Policy&& policy) &&
+{
+    return std::move(sort_alphabetically(policy));
+}
+
+template <stringvec_execution::policy Policy>
+inline stringvec&& stringvec::sort_length(Policy&& policy) &&
+{
+    return std::move(sort_length(policy));
+}
+
+inline stringvec&& stringvec::build_index() &&
+{
+    return std::move(build_index());
+}
+
+inline stringvec&& stringvec::build_search_index() &&
+{
+    return std::move(build_search_index());
+}
+
+inline stringvec&& stringvec::insert_sorted(std::string s) &&
+{
+    return std::move(insert_sorted(std::move(s)));
+}
+
+inline stringvec&& stringvec::merge(const stringvec& other) &&
+{
+    return std::move(merge(other));
+}
+
+inline stringvec&& stringvec::append(stringvec other) &&
+{
+    return std::move(append(std::move(other)));
+}
+
+inline stringvec&& stringvec::unique(bool sorted) &&
+{
+    return std::move(unique(sorted));
+}
+
+inline stringvec&& stringvec::merge_union(const stringvec& other) &&
+{
+    return std::move(merge_union(other));
+}
+
+inline stringvec&& stringvec::intersect(const stringvec& other) &&
+{
+    return std::move(intersect(other));
+}
+
+inline stringvec&& stringvec::difference(const stringvec& other) &&
+{
+    return std::move(difference(other));
+}
+
+template <stringvec_execution::policy Policy>
+inline stringvec&& stringvec::unique(Policy&& policy, bool sorted) &&
+{
+    return std::move(unique(policy, sorted));
+}
+
+template <stringvec_execution::policy Policy>
+inline stringvec&& stringvec::merge_union(Policy&& policy, const stringvec& other) &&
+{
+    return std::move(merge_union(policy, other));
+}
+
+template <stringvec_execution::policy Policy>
+inline stringvec&& stringvec::intersect(Policy&& policy, const stringvec& other) &&
+{
+    return std::move(intersect(policy, other));
+}
+
+template <stringvec_execution::policy Policy>
+inline stringvec&& stringvec::difference(Policy&& policy, const stringvec& other) &&
+{
+    return std::move(difference(policy, other));
+}
+
+
+/** -----------------------------------------------------------------------------------------------
+ * @brief Get the vector of strings.
+ */
+inline std::vector<std::string>& stringvec::get()
+{
+    /* The caller may modify the vector, which would make the index and the ordering stale. */
+    index.reset();
+    search.reset();
+    order = ordering::none;
+
+    return vec;
+}
+
+inline const std::vector<std::string>& stringvec::get() const
+{
+    return vec;
+}
+
+
+/** -----------------------------------------------------------------------------------------------
+ * @brief Get an iterator to the first element of the vector.
+ */
+inline stringvec::iter stringvec::begin()
+{
+    return vec.begin();
+}
+
+inline stringvec::citer stringvec::begin() const
+{
+    return vec.cbegin();
+}
+
+inline stringvec::citer stringvec::cbegin() const
+{
+    return begin();
+}
+
+/** -----------------------------------------------------------------------------------------------
+ * @brief Get an iterator to the last element of the vector.
+ */
+inline stringvec::iter stringvec::end()
+{
+    return vec.end();
+}
+
+inline stringvec::citer stringvec::end() const
+{
+    return vec.cend();
+}
+
+inline stringvec::citer stringvec::cend() const
+{
+    return end();
+}
+
+
+/** -----------------------------------------------------------------------------------------------
+ * @brief Get the string at position `index`.
+ */
+inline std::string& stringvec::operator[](std::size_t index)
+{
+    return vec[index];
+}
+
+inline const std::string& stringvec::operator[](std::size_t index) const
+{
+    return vec[index];
+}
+
+
+
+inline bool stringvec::operator== (const stringvec& other) const
+{
+    return vec == other.vec;
+}
+
+inline bool stringvec::operator!= (const stringvec& other) const
+{
+    return !(*this == other);
+}
+
+inline std::strong_ordering stringvec::operator<=>(const stringvec& other) const
+{
+    return vec <=> other.vec;
+}
+
+
+
+/**
+ * @}
+ */
+
+
+
+/** ===============================================================================================
+ *  STREAM PIPELINE
+ *
+ * @defgroup STRINGVEC_STREAM_PIPELINE          Stream Pipeline
+ * @{
+ */
+
+/** -----------------------------------------------------------------------------------------------
+ * @class   stream_pipeline
+ *
+ * @brief   Sequence of `stringvec` operations, applied to a stream one chunk of lines at a time.
+ *
+ * @details The stages are declared once, with the same names and arguments as the `stringvec`
+ *          methods, then `run` reads the input in chunks of `chunk_size` bytes, cut on line
+ *          boundaries, applies every stage to each chunk and writes the result before reading the
+ *          next one. The memory used is therefore bounded by the chunk size (plus the longest
+ *          line, which is never cut), instead of by the size of the input.
+ *
+ *          Only operations that act on each line independently can be streamed, so the methods
+ *          that need the whole vector, such as `sort` or `reverse`, are not available.
+ *          `remove_first` removes the first lines of the whole stream, not of each chunk.
+ *
+ * @example
+ *      stream_pipeline{}.remove_first()
+ *                       .split()
+ *                       .filter_remove(".*[Aa]pple.*")
+ *                       .filter_keep(".*berry")
+ *                       .run("input.txt", "output.txt");
+ */
+class stream_pipeline
+{
+public:
+    using stage_func = std::function<void(stringvec&)>;
+
+    static constexpr std::size_t default_chunk_size = std::size_t{16} << 20;
+
+    inline explicit stream_pipeline(std::size_t chunk_size = default_chunk_size);
+
+    // Stages
+    inline stream_pipeline& stage(stage_func func);
+
+    template <class... Args>
+    inline stream_pipeline& filter_remove(Args&&... args);
+    template <class... Args>
+    inline stream_pipeline& filter_keep  (Args&&... args);
+    inline stream_pipeline& filter_empty (bool keep_whitespace = false);
+    inline stream_pipeline& remove_first (std::size_t count = 1);
+
+    template <class... Args>
+    inline stream_pipeline& transform        (Args&&... args);
+    template <class... Args>
+    inline stream_pipeline& transform_inplace(Args&&... args);
+    inline stream_pipeline& trim ();
+    inline stream_pipeline& split(const std::string_view delimiter = " ");
+    inline stream_pipeline& split_any(const std::string_view delimiters);
+
+    // Execution
+    inline void run(std::istream& input, std::ostream& output, const std::string_view sep = "\n") const;
+    inline void run(const std::string& input_path,
+                    const std::string& output_path,
+                    const std::string_view sep = "\n") const;
+    inline void run(std::istream& input, const stage_func& sink) const;
+
+    inline std::size_t chunk_size() const;
+
+private:
+    friend class file_follower;
+
+    std::vector<stage_func> stages;
+    std::size_t             chunk;
+};
+
+
+/** -----------------------------------------------------------------------------------------------
+ * @brief Create an empty pipeline.
+ * @param chunk_size: Number of bytes of input read per chunk.
+ */
+inline stream_pipeline::stream_pipeline(std::size_t chunk_size) : chunk{std::max<std::size_t>(chunk_size, 1)}
+{
+}
+
+/** -----------------------------------------------------------------------------------------------
+ * @brief Append a custom stage, applied to each chunk in turn.
+ * @param func: Function modifying the chunk of lines.
+ *
+ * @details The function is copied at the start of each run, so a stage holding a state (such as
+ *          a counter) starts afresh every time.
+ */
+inline stream_pipeline& stream_pipeline::stage(stage_func func)
+{
+    stages.push_back(std::move(func));
+
+    return *this;
+}
+
+/** -----------------------------------------------------------------------------------------------
+ * @brief Append a stage calling `stringvec::filter_remove` with the same arguments.
+ */
+template <class... Args>
+inline stream_pipeline& stream_pipeline::filter_remove(Args&&... args)
+{
+    return stage([... args = std::forward<Args>(args)](stringvec& sv)
+                 {
+                     sv.filter_remove(args...);
+                 });
+}
+
+/** -----------------------------------------------------------------------------------------------
+ * @brief Append a stage calling `stringvec::filter_keep` with the same arguments.
+ */
+template <class... Args>
+inline stream_pipeline& stream_pipeline::filter_keep(Args&&... args)
+{
+    return stage([... args = std::forward<Args>(args)](stringvec& sv)
+                 {
+                     sv.filter_keep(args...);
+                 });
+}
+
+/** -----------------------------------------------------------------------------------------------
+ * @brief Append a stage calling `stringvec::filter_empty`.
+ */
+inline stream_pipeline& stream_pipeline::filter_empty(bool keep_whitespace)
+{
+    return stage([keep_whitespace](stringvec& sv)
+                 {
+                     sv.filter_empty(keep_whitespace);
+                 });
+}
+
+/** -----------------------------------------------------------------------------------------------
+ * @brief Append a stage removing the first lines reaching it during a run.
+ * @param count: Number of lines to remove, across chunks if needed.
+ */
+inline stream_pipeline& stream_pipeline::remove_first(std::size_t count)
+{
+    return stage([remaining = count](stringvec& sv) mutable
+                 {
+                     const std::size_t removed = std::min(remaining, sv.get().size());
+                     sv.remove_first(removed);
+                     remaining -= removed;
+                 });
+}
+
+/** -----------------------------------------------------------------------------------------------
+ * @brief Append a stage calling `stringvec::transform` with the same arguments.
+ */
+template <class... Args>
+inline stream_pipeline& stream_pipeline::transform(Args&&... args)
+{
+    return stage([... args = std::forward<Args>(args)](stringvec& sv)
+                 {
+                     sv.transform(args...);
+                 });
+}
+
+/** -----------------------------------------------------------------------------------------------
+ * @brief Append a stage calling `stringvec::transform_inplace` with the same arguments.
+ */
+template <class... Args>
+inline stream_pipeline& stream_pipeline::transform_inplace(Args&&... args)
+{
+    return stage([... args = std::forward<Args>(args)](stringvec& sv)
+                 {
+                     sv.transform_inplace(args...);
+                 });
+}
+
+/** -----------------------------------------------------------------------------------------------
+ * @brief Append a stage calling `stringvec::trim`.
+ */
+inline stream_pipeline& stream_pipeline::trim()
+{
+    return stage([](stringvec& sv)
+                 {
+                     sv.trim();
+                 });
+}
+
+/** -----------------------------------------------------------------------------------------------
+ * @brief Append a stage calling `stringvec::split` with the same delimiter.
+ */
+inline stream_pipeline& stream_pipeline::split(const std::string_view delimiter)
+{
+    return stage([delimiter = std::string{delimiter}](stringvec& sv)
+                 {
+                     sv.split(delimiter);
+                 });
+}
+
+/** -----------------------------------------------------------------------------------------------
+ * @brief Append a stage calling `stringvec::split_any` with the same delimiters.
+ */
+inline stream_pipeline& stream_pipeline::split_any(const std::string_view delimiters)
+{
+    return stage([delimiters = std::string{delimiters}](stringvec& sv)
+                 {
+                     sv.split_any(delimiters);
+                 });
+}
+
+/** -----------------------------------------------------------------------------------------------
+ * @brief Run the pipeline over a stream, writing the resulting strings to another stream.
+ * @param input:  Stream to read the lines from.
+ * @param output: Stream to write the strings to.
+ * @param sep:    Separator written between the strings, as `stringvec::write_file` does.
+ */
+inline void stream_pipeline::run(std::istream& input, std::ostream& output, const std::string_view sep) const
+{
+    bool first = true;
+    run(input, [&output, &first, sep](stringvec& sv)
+               {
+                   for (const std::string& s : sv)
+                   {
+                       if (!first)
+                       {
+                           output << sep;
+                       }
+                       output << s;
+                       first = false;
+                   }
+               });
+    output.flush();
+}
+
+/** -----------------------------------------------------------------------------------------------
+ * @brief Run the pipeline over a file, writing the resulting strings to another file.
+ * @param input_path:  File to read the lines from.
+ * @param output_path: File to write the strings to.
+ * @param sep:         Separator written between the strings, as `stringvec::write_file` does.
+ */
+inline void stream_pipeline::run(const std::string& input_path,
+                                 const std::string& output_path,
+                                 const std::string_view sep) const
+{
+    std::ifstream input(input_path, std::ios::binary);
+    if (!input)
+    {
+        throw std::runtime_error("Couldn't open file: " + input_path);
+    }
+
+    std::ofstream output(output_path, std::ios::binary);
+    if (!output)
+    {
+        throw std::runtime_error("Couldn't write to file: " + output_path);
+    }
+
+    run(input, output, sep);
+}
+
+/** -----------------------------------------------------------------------------------------------
+ * @brief Run the pipeline over a stream, handing each processed chunk to a function.
+ * @param input: Stream to read the lines from.
+ * @param sink:  Function called with each chunk once every stage has been applied to it.
+ *
+ * @details Lines are split the same way `stringvec::read_file` does. The bytes following the last
+ *          newline of a chunk are carried over to the start of the next one.
+ */
+inline void stream_pipeline::run(std::istream& input, const stage_func& sink) const
+{
+    std::vector<stage_func> run_stages = stages;
+
+    std::string buffer;
+    std::size_t carry = 0;
+    stringvec   lines;
+
+    while (true)
+    {
+        buffer.resize(carry + chunk);
+        input.read(buffer.data() + carry, static_cast<std::streamsize>(chunk));
+        const std::size_t filled = carry + static_cast<std::size_t>(input.gcount());
+        const bool        last   = filled < buffer.size();
+
+        /* Only complete lines are processed, unless the end of the input was reached. */
+        std::size_t complete = filled;
+        if (!last)
+        {
+            const std::size_t eol = std::string_view{buffer.data(), filled}.rfind('\n');
+            complete              = eol == std::string_view::npos ? 0 : eol + 1;
+        }
+
+        lines.get().clear();
+        stringvec_detail::for_each_line(buffer.data(), buffer.data() + complete,
+                                        [&lines](std::string_view line)
+                                        {
+                                            lines.get().emplace_back(line);
+                                        });
+
+        if (lines.get().size() != 0)
+        {
+            for (const stage_func& func : run_stages)
+            {
+                func(lines);
+            }
+            sink(lines);
+        }
+
+        if (last)
+        {
+            break;
+        }
+
+        carry = filled - complete;
+        std::memmove(buffer.data(), buffer.data() + complete, carry);
+    }
+}
+
+/** -----------------------------------------------------------------------------------------------
+ * @brief Get the number of bytes of input read per chunk.
+ */
+inline std::size_t stream_pipeline::chunk_size() const
+{
+    return chunk;
+}
+
+/**
+ * @}
+ */
+
+
+
+/** ===============================================================================================
+ *  FILE FOLLOWER
+ *
+ * @defgroup STRINGVEC_FILE_FOLLOWER            File Follower
+ * @{
+ */
+
+/** -----------------------------------------------------------------------------------------------
+ * @class   file_follower
+ *
+ * @brief   Reader of the lines appended to a growing file, as `tail -F` does.
+ *
+ * @details Each `poll` reads only the bytes written since the previous one, from the offset it
+ *          remembers, runs the stages of a `stream_pipeline` on the complete lines and appends
+ *          what is left to the target vector. A line still missing its newline is held back until
+ *          it is complete. The first poll reads the whole file.
+ *
+ *          The file is followed by name: once another file takes its path (rotation), the rest of
+ *          the old one is read, then the new one from its start; once it shrinks (truncation), it
+ *          is read again from its start. A file that does not exist yet is waited for.
+ *          The identity of the file is its device and inode where POSIX is available; elsewhere,
+ *          only truncations are noticed.
+ *
+ *          `wait` sleeps until the directory of the file reports a change, through inotify on
+ *          Linux, or until the timeout otherwise, then polls.
+ *          The stages are copied once, so stateful ones such as `remove_first` span every poll.
+ *          The target vector must outlive the follower.
+ *
+ * @example
+ *      stringvec     errors;
+ *      file_follower follower = errors.follow("app.log", stream_pipeline{}.filter_keep(".*ERROR.*"));
+ *      while (running)
+ *      {
+ *          follower.wait(std::chrono::seconds{1});
+ *      }
+ */
+class file_follower
+{
+public:
+    inline file_follower(stringvec& target, std::string path);
+    inline file_follower(stringvec& target, std::string path, const stream_pipeline& pipeline);
+    inline ~file_follower();
+
+    file_follower(const file_follower&)            = delete;
+    file_follower(file_follower&&)                 = delete;
+    file_follower& operator=(const file_follower&) = delete;
+    file_follower& operator=(file_follower&&)      = delete;
+
+    inline std::size_t poll();
+    inline std::size_t wait(std::chrono::milliseconds timeout);
+
+    inline const std::string& path() const;
+    inline std::uint64_t      offset() const;
+
+private:
+    inline bool        open_file();
+    inline void        close_file();
+    inline bool        replaced() const;
+    inline std::size_t read_available();
+    inline std::size_t flush_partial();
+    inline std::size_t deliver(stringvec& lines);
+
+    stringvec*                               target;
+    std::string                              file;
+    std::vector<stream_pipeline::stage_func> stages;
+    std::size_t                              block;
+    stringvec_detail::line_splitter          splitter;
+    std::uint64_t                            position = 0;
+    std::string                              buffer;
+
+#if STRINGVEC_HAS_MMAP
+    int   fd     = -1;
+    dev_t device = 0;
+    ino_t inode  = 0;
+#else
+    bool  opened = false;
+#endif
+#if STRINGVEC_HAS_INOTIFY
+    int   notify = -1;
+#endif
+};
+
+
+/** -----------------------------------------------------------------------------------------------
+ * @brief Follow a file, appending its lines to a vector as they are written.
+ * @param target: Vector the lines are appended to.
+ * @param path:   File to follow. It does not need to exist yet.
+ */
+inline file_follower::file_follower(stringvec& target, std::string path) :
+    file_follower{target, std::move(path), stream_pipeline{}}
+{
+}
+
+/** -----------------------------------------------------------------------------------------------
+ * @brief Follow a file, appending its lines to a vector once the stages of a pipeline are applied.
+ * @param target:   Vector the lines are appended to.
+ * @param path:     File to follow. It does not need to exist yet.
+ * @param pipeline: Stages applied to each batch of new lines. Its chunk size bounds the bytes
+ *                  read at once.
+ */
+inline file_follower::file_follower(stringvec& target, std::string path, const stream_pipeline& pipeline) :
+    target{&target}, file{std::move(path)}, stages{pipeline.stages},
+    block{std::min<std::size_t>(pipeline.chunk_size(), std::size_t{1} << 20)}
+{
+#if STRINGVEC_HAS_INOTIFY
+    notify = ::inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+    if (notify >= 0)
+    {
+        /* The directory is watched rather than the file, to see the file being replaced. */
+        const std::size_t slash     = file.rfind('/');
+        const std::string directory = slash == std::string::npos ? "." : slash == 0 ? "/" : file.substr(0, slash);
+        if (::inotify_add_watch(notify, directory.c_str(),
+                                IN_MODIFY | IN_CLOSE_WRITE | IN_CREATE | IN_MOVED_TO | IN_MOVED_FROM | IN_DELETE) < 0)
+        {
+            ::close(notify);
+            notify = -1;
+        }
+    }
+#endif
+
+    open_file();
+}
+
+inline file_follower::~file_follower()
+{
+    close_file();
+#if STRINGVEC_HAS_INOTIFY
+    if (notify >= 0)
+    {
+        ::close(notify);
+    }
+#endif
+}
+
+/** -----------------------------------------------------------------------------------------------
+ * @brief Read what was written to the file since the last poll.
+ * @returns Number of strings appended to the target vector.
+ *
+ * @details A rotated file is drained before the new one is opened, and the line it ended on is
+ *          delivered even without a newline, as it is at the end of a file read by `read_file`.
+ */
+inline std::size_t file_follower::poll()
+{
+    std::size_t appended = 0;
+    while (open_file())
+    {
+        appended += read_available();
+        if (!replaced())
+        {
+            break;
+        }
+
+        /* Anything written to the old file before it was replaced was read above. */
+        appended += flush_partial();
+        close_file();
+    }
+
+    return appended;
+}
+
+/** -----------------------------------------------------------------------------------------------
+ * @brief Wait for the file to change, then poll it.
+ * @param timeout: Longest time to wait for a change.
+ * @returns Number of strings appended to the target vector.
+ *
+ * @details Returns at once if new lines were already waiting. Without inotify, the full timeout
+ *          is slept before polling.
+ */
+inline std::size_t file_follower::wait(std::chrono::milliseconds timeout)
+{
+    const std::size_t ready = poll();
+    if (ready != 0)
+    {
+        return ready;
+    }
+
+#if STRINGVEC_HAS_INOTIFY
+    if (notify >= 0)
+    {
+        const auto milliseconds = std::clamp<std::chrono::milliseconds::rep>(timeout.count(), 0,
+                                                                             std::numeric_limits<int>::max());
+        pollfd     events{notify, POLLIN, 0};
+        if (::poll(&events, 1, static_cast<int>(milliseconds)) > 0)
+        {
+            /* Only the wake-up matters, the events themselves are discarded. */
+            char discarded[4096];
+            while (::read(notify, discarded, sizeof(discarded)) > 0)
+            {
+            }
+        }
+        return poll();
+    }
+#endif
+
+    std::this_thread::sleep_for(timeout);
+    return poll();
+}
+
+/** -----------------------------------------------------------------------------------------------
+ * @brief Get the path of the followed file.
+ */
+inline const std::string& file_follower::path() const
+{
+    return file;
+}
+
+/** -----------------------------------------------------------------------------------------------
+ * @brief Get the number of bytes of the current file read so far.
+ */
+inline std::uint64_t file_follower::offset() const
+{
+    return position;
+}
+
+/** -----------------------------------------------------------------------------------------------
+ * @brief Open the file at its path if it is not opened yet, reading it from its start.
+ * @returns False if the file does not exist.
+ */
+inline bool file_follower::open_file()
+{
+#if STRINGVEC_HAS_MMAP
+    if (fd >= 0)
+    {
+        return true;
+    }
+
+    fd = ::open(file.c_str(), O_RDONLY | O_CLOEXEC);
+    if (fd < 0)
+    {
+        return false;
+    }
+
+    struct stat info {};
+    if (::fstat(fd, &info) != 0)
+    {
+        close_file();
+        return false;
+    }
+    device = info.st_dev;
+    inode  = info.st_ino;
+#else
+    if (opened)
+    {
+        return true;
+    }
+    opened = static_cast<bool>(std::ifstream{file, std::ios::binary});
+    if (!opened)
+    {
+        return false;
+    }
+#endif
+
+    position = 0;
+    return true;
+}
+
+inline void file_follower::close_file()
+{
+#if STRINGVEC_HAS_MMAP
+    if (fd >= 0)
+    {
+        ::close(fd);
+        fd = -1;
+    }
+#else
+    opened = false;
+#endif
+}
+
+/** -----------------------------------------------------------------------------------------------
+ * @brief Check if the path now names another file than the one opened.
+ *
+ * @details A path that no longer exists is not a replacement: the writer may still append to the
+ *          opened file until it creates the new one.
+ */
+inline bool file_follower::replaced() const
+{
+#if STRINGVEC_HAS_MMAP
+    struct stat info {};
+    if (::stat(file.c_str(), &info) != 0)
+    {
+        return false;
+    }
+    return info.st_dev != device || info.st_ino != inode;
+#else
+    return false;
+#endif
+}
+
+/** -----------------------------------------------------------------------------------------------
+ * @brief Read the opened file from the offset to its end, delivering each block of lines.
+ */
+inline std::size_t file_follower::read_available()
+{
+    std::size_t appended = 0;
+    buffer.resize(block);
+
+#if STRINGVEC_HAS_MMAP
+    struct stat info {};
+    if (::fstat(fd, &info) == 0 && static_cast<std::uint64_t>(info.st_size) < position)
+    {
+        appended += flush_partial();
+        position = 0;
+    }
+#else
+    std::ifstream input{file, std::ios::binary | std::ios::ate};
+    if (!input)
+    {
+        return 0;
+    }
+    if (static_cast<std::uint64_t>(input.tellg()) < position)
+    {
+        appended += flush_partial();
+        position = 0;
+    }
+    input.seekg(static_cast<std::streamoff>(position));
+#endif
+
+    stringvec lines;
+    while (true)
+    {
+#if STRINGVEC_HAS_MMAP
+        const ssize_t count = ::pread(fd, buffer.data(), buffer.size(), static_cast<off_t>(position));
+        if (count < 0 && errno == EINTR)
+        {
+            continue;
+        }
+#else
+        input.read(buffer.data(), static_cast<std::streamsize>(buffer.size()));
+        const std::streamsize count = input.gcount();
+#endif
+        if (count <= 0)
+        {
+            break;
+        }
+        position += static_cast<std::uint64_t>(count);
+
+        splitter.feed(buffer.data(), buffer.data() + count, [&lines](std::string_view line)
+                                                             {
+                                                                 lines.get().emplace_back(line);
+                                                             });
+        appended += deliver(lines);
+    }
+
+    return appended;
+}
+
+/** -----------------------------------------------------------------------------------------------
+ * @brief Deliver the line held back at the end of the previous file, if any.
+ */
+inline std::size_t file_follower::flush_partial()
+{
+    stringvec lines;
+    splitter.finish([&lines](std::string_view line)
+                    {
+                        lines.get().emplace_back(line);
+                    });
+    return deliver(lines);
+}
+
+/** -----------------------------------------------------------------------------------------------
+ * @brief Apply the stages to a batch of lines, then move what is left to the target vector.
+ */
+inline std::size_t file_follower::deliver(stringvec& lines)
+{
+    if (lines.get().empty())
+    {
+        return 0;
+    }
+
+    for (const stream_pipeline::stage_func& func : stages)
+    {
+        func(lines);
+    }
+
+    const std::size_t count = lines.get().size();
+    target->append(std::move(lines));
+    lines.get().clear();
+
+    return count;
+}
+
+/** -----------------------------------------------------------------------------------------------
+ * @brief Follow a file, appending its lines to the vector as they are written.
+ * @param path: File to follow. It does not need to exist yet.
+ *
+ * @details See `file_follower`. Nothing is read until the follower is polled.
+ */
+inline file_follower stringvec::follow(std::string path) &
+{
+    return file_follower{*this, std::move(path)};
+}
+
+/** -----------------------------------------------------------------------------------------------
+ * @brief Follow a file, appending its lines to the vector once the stages of a pipeline are applied.
+ * @param path:     File to follow. It does not need to exist yet.
+ * @param pipeline: Stages applied to each batch of new lines.
+ */
+inline file_follower stringvec::follow(std::string path, const stream_pipeline& pipeline) &
+{
+    return file_follower{*this, std::move(path), pipeline};
+}
+
+/**
+ * @}
+ */
+
+
+
+/** ===============================================================================================
+ *  STRING ARENA
+ *
+ * @defgroup STRINGVEC_STRING_ARENA             String Arena
+ * @{
+ */
+
+/** -----------------------------------------------------------------------------------------------
+ * @class   string_arena
+ *
+ * @brief   Append-only storage packing the characters of many strings into a few large blocks.
+ *
+ * @details Storing a string is a pointer bump in the current block, instead of one heap
+ *          allocation per string, and consecutive strings are contiguous in memory.
+ *          Strings are never freed individually: `reset` rewinds the arena in O(1) for reuse,
+ *          keeping its blocks, and destroying it frees one allocation per block.
+ *          Views returned by `store` stay valid until the arena is reset or destroyed.
+ */
+class string_arena
+{
+public:
+    static constexpr std::size_t default_block_size = std::size_t{64} << 10;
+
+    inline explicit string_arena(std::size_t block_size = default_block_size);
+
+    string_arena(const string_arena&)            = delete;
+    string_arena& operator=(const string_arena&) = delete;
+
+    inline std::string_view store(const std::string_view s);
+    inline char*            allocate(std::size_t size);
+    inline void             reset();
+
+    inline std::size_t size() const;
+    inline std::size_t capacity() const;
+
+private:
+    struct block
+    {
+        std::unique_ptr<char[]> data;
+        std::size_t             size;
+    };
+
+    std::vector<block> blocks;
+    std::size_t        current    = 0;
+    std::size_t        used       = 0;        ///< Bytes used in the current block
+    std::size_t        stored     = 0;        ///< Bytes used in all the blocks
+    std::size_t        block_size = default_block_size;
+};
+
+
+/** -----------------------------------------------------------------------------------------------
+ * @brief Create an empty arena. No memory is allocated until the first string is stored.
+ * @param block_size: Size of the blocks, strings longer than it get a block of their own.
+ */
+inline string_arena::string_arena(std::size_t block_size) : block_size{std::max<std::size_t>(block_size, 1)}
+{
+}
+
+/** -----------------------------------------------------------------------------------------------
+ * @brief Copy a string into the arena.
+ * @return A view of the copy.
+ */
+inline std::string_view string_arena::store(const std::string_view s)
+{
+    if (s.empty())
+    {
+        return {};
+    }
+
+    char* dst = allocate(s.size());
+    std::memcpy(dst, s.data(), s.size());
+
+    return {dst, s.size()};
+}
+
+/** -----------------------------------------------------------------------------------------------
+ * @brief Reserve `size` contiguous bytes in the arena.
+ * @return A pointer to the first reserved byte.
+ *
+ * @details When the current block is full, the next block large enough is reused, or a new one
+ *          is allocated.
+ */
+inline char* string_arena::allocate(std::size_t size)
+{
+    if (blocks.empty() || blocks[current].size - used < size)
+    {
+        std::size_t next = blocks.empty() ? 0 : current + 1;
+        while (next < blocks.size() && blocks[next].size < size)
+        {
+            next++;
+        }
+
+        if (next == blocks.size())
+        {
+            const std::size_t length = std::max(size, block_size);
+            blocks.push_back({std::make_unique_for_overwrite<char[]>(length), length});
+        }
+
+        current = next;
+        used    = 0;
+    }
+
+    char* ptr = blocks[current].data.get() + used;
+    used   += size;
+    stored += size;
+
+    return ptr;
+}
+
+/** -----------------------------------------------------------------------------------------------
+ * @brief Forget every stored string, keeping the blocks for the strings stored afterwards.
+ */
+inline void string_arena::reset()
+{
+    current = 0;
+    used    = 0;
+    stored  = 0;
+}
+
+/** -----------------------------------------------------------------------------------------------
+ * @brief Get the number of bytes stored since the last reset.
+ */
+inline std::size_t string_arena::size() const
+{
+    return stored;
+}
+
+/** -----------------------------------------------------------------------------------------------
+ * @brief Get the number of bytes allocated by the arena.
+ */
+inline std::size_t string_arena::capacity() const
+{
+    std::size_t total = 0;
+    for (const block& b : blocks)
+    {
+        total += b.size;
+    }
+
+    return total;
+}
+
+/**
+ * @}
+ */
+
+
+
+/** ===============================================================================================
+ *  VIEW VECTOR CLASS DEFINITION
+ *
+ * @defgroup STRINGVEC_VIEW_CLASS_DEF           View Vector Class Definition
+ * @{
+ */
+
+/** -----------------------------------------------------------------------------------------------
+ * @class   stringview_vec
+ *
+ * @brief   Zero-copy sibling of `stringvec`, holding `std::string_view` elements.
+ *
+ * @details The elements point either into memory-mapped files, or into an owned `string_arena`
+ *          used for strings that had to be materialized (by `transform`, or when copying from a
+ *          `stringvec`), so that they cost no allocation of their own.
+ *          The storage is shared between copies, so views taken from one copy stay valid for as
+ *          long as any copy is alive.
+ *
+ *          Distinct copies can be used from different threads, even when they share storage: a
+ *          copy never writes to an arena another copy holds, and stores its new strings in an
+ *          arena of its own instead. A single vector still needs external synchronization.
+ */
+class stringview_vec
+{
+public:
+    using iter   = std::vector<std::string_view>::iterator;
+    using riter  = std::vector<std::string_view>::reverse_iterator;
+    using citer  = std::vector<std::string_view>::const_iterator;
+    using criter = std::vector<std::string_view>::const_reverse_iterator;
+
+    // Constructors / Destructors
+    ~stringview_vec()                                    = default;
+    stringview_vec()                                     = default;
+    stringview_vec(const stringview_vec&)                = default;
+    stringview_vec(stringview_vec&&) noexcept            = default;
+    stringview_vec& operator=(const stringview_vec&)     = default;
+    stringview_vec& operator=(stringview_vec&&) noexcept = default;
+    inline stringview_vec(const stringvec& orig);
+    inline stringview_vec(const std::initializer_list<std::string_view>&& orig);
+
+    // Input / Output
+    inline stringview_vec&  read_file (const std::string& path) &;
+    inline stringview_vec&& read_file (const std::string& path) &&;
+    template <stringvec_execution::policy Policy>
+    inline stringview_vec&  read_file (Policy&& policy, const std::string& path) &;
+    template <stringvec_execution::policy Policy>
+    inline stringview_vec&& read_file (Policy&& policy, const std::string& path) &&;
+    inline void             write_file(const std::string& path, const std::string_view sep) const;
+    inline void             write_file(const std::string& path, char sep = '\n') const;
+    inline void             write_file(const std::string&    path,
+                                       const std::string_view sep,
+                                       const write_options&   options) const;
+
+    inline void print(std::ostream& os = std::cout,
+                      const std::string_view sep = "\n",
+                      bool keep_last_sep = true) const;
+
+    // Snapshots
+    inline void             save_snapshot(const std::string& path) const;
+    inline stringview_vec&  load_snapshot(const std::string& path) &;
+    inline stringview_vec&& load_snapshot(const std::string& path) &&;
+
+    // Lazy evaluation
+    inline lazy_pipeline<std::vector<std::string_view>> pipeline() const;
+
+    // Filtering
+    inline stringview_vec&  filter_remove(const std::function<bool(const std::string_view)> func) &;
+    inline stringview_vec&& filter_remove(const std::function<bool(const std::string_view)> func) &&;
+    inline stringview_vec&  filter_remove(const std::string& regex) &;
+    inline stringview_vec&& filter_remove(const std::string& regex) &&;
+    inline stringview_vec&  filter_remove(const regex_handle& regex) &;
+    inline stringview_vec&& filter_remove(const regex_handle& regex) &&;
+    inline stringview_vec&  filter_keep  (const std::function<bool(const std::string_view)> func) &;
+    inline stringview_vec&& filter_keep  (const std::function<bool(const std::string_view)> func) &&;
+    inline stringview_vec&  filter_keep  (const std::string& regex) &;
+    inline stringview_vec&& filter_keep  (const std::string& regex) &&;
+    inline stringview_vec&  filter_keep  (const regex_handle& regex) &;
+    inline stringview_vec&& filter_keep  (const regex_handle& regex) &&;
+
+    template <std::predicate<const std::string_view> Pred>
+    inline stringview_vec&  filter_remove(Pred&& func) &;
+    template <std::predicate<const std::string_view> Pred>
+    inline stringview_vec&& filter_remove(Pred&& func) &&;
+    template <std::predicate<const std::string_view> Pred>
+    inline stringview_vec&  filter_keep  (Pred&& func) &;
+    template <std::predicate<const std::string_view> Pred>
+    inline stringview_vec&& filter_keep  (Pred&& func) &&;
+    inline stringview_vec&  filter_remove_any(std::span<const std::string> regexes) &;
+    inline stringview_vec&& filter_remove_any(std::span<const std::string> regexes) &&;
+    inline stringview_vec&  filter_remove_any(const pattern_set& patterns) &;
+    inline stringview_vec&& filter_remove_any(const pattern_set& patterns) &&;
+    inline stringview_vec&  filter_keep_any  (std::span<const std::string> regexes) &;
+    inline stringview_vec&& filter_keep_any  (std::span<const std::string> regexes) &&;
+    inline stringview_vec&  filter_keep_any  (const pattern_set& patterns) &;
+    inline stringview_vec&& filter_keep_any  (const pattern_set& patterns) &&;
+    inline stringview_vec&  filter_remove_icase(const std::string_view s) &;
+    inline stringview_vec&& filter_remove_icase(const std::string_view s) &&;
+    inline stringview_vec&  filter_keep_icase  (const std::string_view s) &;
+    inline stringview_vec&& filter_keep_icase  (const std::string_view s) &&;
+    inline stringview_vec&  filter_empty (bool keep_whitespace = false) &;
+    inline stringview_vec&& filter_empty (bool keep_whitespace = false) &&;
+
+    inline stringview_vec&  remove_first(std::size_t count = 1) &;
+    inline stringview_vec&& remove_first(std::size_t count = 1) &&;
+    inline stringview_vec&  remove_last(std::size_t count = 1) &;
+    inline stringview_vec&& remove_last(std::size_t count = 1) &&;
+    inline stringview_vec&  remove_nth(std::size_t pos) &;
+    inline stringview_vec&& remove_nth(std::size_t pos) &&;
+    inline stringview_vec&  remove_range(std::size_t first, std::size_t last) &;
+    inline stringview_vec&& remove_range(std::size_t first, std::size_t last) &&;
+    inline stringview_vec&  remove_indices(std::span<const std::size_t> positions) &;
+    inline stringview_vec&& remove_indices(std::span<const std::size_t> positions) &&;
+    inline stringview_vec&  clear() &;
+    inline stringview_vec&& clear() &&;
+
+    // Transforming
+    inline stringview_vec&  transform(const std::function<std::string(const std::string_view)> func) &;
+    inline stringview_vec&& transform(const std::function<std::string(const std::string_view)> func) &&;
+    template <std::invocable<const std::string_view> Func>
+    inline stringview_vec&  transform(Func&& func) &;
+    template <std::invocable<const std::string_view> Func>
+    inline stringview_vec&& transform(Func&& func) &&;
+    inline stringview_vec&  trim() &;
+    inline stringview_vec&& trim() &&;
+    inline stringview_vec&  split(const std::string_view delimiter = " ") &;
+    inline stringview_vec&& split(const std::string_view delimiter = " ") &&;
+    inline stringview_vec&  split_any(const std::string_view delimiters) &;
+    inline stringview_vec&& split_any(const std::string_view delimiters) &&;
+    inline column_table     split_columns(const std::string_view delimiter) const;
+
+    // Ordering
+    inline stringview_vec&  reverse() &;
+    inline stringview_vec&& reverse() &&;
+    inline stringview_vec&  sort(const std::function<bool(const std::string_view,
+                                                          const std::string_view)> func) &;
+    inline stringview_vec&& sort(const std::function<bool(const std::string_view,
+                                                          const std::string_view)> func) &&;
+    inline stringview_vec&  sort_alphabetically() &;
+    inline stringview_vec&& sort_alphabetically() &&;
+    inline stringview_vec&  sort_length() &;
+    inline stringview_vec&& sort_length() &&;
+
+    // Searching
+    inline  iter find     (const std::function<bool(const std::string_view)> func);
+    inline citer find     (const std::function<bool(const std::string_view)> func) const;
+    inline  iter rfind    (const std::function<bool(const std::string_view)> func);
+    inline citer rfind    (const std::function<bool(const std::string_view)> func) const;
+    template <std::predicate<const std::string_view> Pred>
+    inline  iter find     (Pred&& func);
+    template <std::predicate<const std::string_view> Pred>
+    inline citer find     (Pred&& func) const;
+    template <std::predicate<const std::string_view> Pred>
+    inline  iter rfind    (Pred&& func);
+    template <std::predicate<const std::string_view> Pred>
+    inline citer rfind    (Pred&& func) const;
+    inline  iter find     (const std::string_view s);
+    inline citer find     (const std::string_view s) const;
+    inline  iter rfind    (const std::string_view s);
+    inline citer rfind    (const std::string_view s) const;
+    inline  iter find_reg (const std::string& regex);
+    inline citer find_reg (const std::string& regex) const;
+    inline  iter rfind_reg(const std::string& regex);
+    inline citer rfind_reg(const std::string& regex) const;
+    inline  iter find_reg (const regex_handle& regex);
+    inline citer find_reg (const regex_handle& regex) const;
+    inline  iter rfind_reg(const regex_handle& regex);
+    inline citer rfind_reg(const regex_handle& regex) const;
+    inline  iter find_icase(const std::string_view s);
+    inline citer find_icase(const std::string_view s) const;
+    inline bool  validate_utf8() const;
+
+    inline std::pair< iter, std::size_t> find_any(const pattern_set& patterns);
+    inline std::pair<citer, std::size_t> find_any(const pattern_set& patterns) const;
+
+    template <std::predicate<const std::string_view> Pred>
+    inline std::vector<std::size_t> find_all    (Pred&& func) const;
+    inline std::vector<std::size_t> find_all    (const std::string_view s) const;
+    inline std::vector<std::size_t> find_all_reg(const std::string& regex) const;
+    inline std::vector<std::size_t> find_all_reg(const regex_handle& regex) const;
+    template <std::predicate<const std::string_view> Pred>
+    inline std::size_t              count_if    (Pred&& func) const;
+    inline std::size_t              count_reg   (const std::string& regex) const;
+    inline std::size_t              count_reg   (const regex_handle& regex) const;
+    inline std::pair<std::vector<std::size_t>, std::vector<std::size_t>> partition_by(const std::string& regex) const;
+    inline std::pair<std::vector<std::size_t>, std::vector<std::size_t>> partition_by(const regex_handle& regex) const;
+
+    // Accessing
+    inline std::vector<std::string_view>&       get();
+    inline const std::vector<std::string_view>& get() const;
+    inline stringvec                            to_stringvec() const;
+
+    inline iter  begin();
+    inline citer begin() const;
+    inline citer cbegin() const;
+    inline iter  end();
+    inline citer end() const;
+    inline citer cend() const;
+
+    inline       std::string_view& operator[](std::size_t index);
+    inline const std::string_view& operator[](std::size_t index) const;
+
+    // Comparison
+    inline bool operator== (const stringview_vec& other) const;
+    inline bool operator!= (const stringview_vec& other) const;
+    inline std::strong_ordering operator<=>(const stringview_vec& other) const;
+
+
+private:
+    template <class Delimiter>
+    inline void             split_tokens(const Delimiter& delimiter);
+    inline std::string_view store(const std::string_view s);
+
+    std::vector<std::string_view>                   vec;
+    std::vector<std::shared_ptr<const mapped_file>>  maps;
+    std::vector<std::shared_ptr<const string_arena>> frozen;        ///< Arenas shared with other copies
+    std::shared_ptr<string_arena>                    owned;
+};
+
+/**
+ * @}
+ */
+
+
+
+/** ===============================================================================================
+ *  VIEW VECTOR METHOD DEFINITIONS
+ *
+ * @defgroup STRINGVEC_VIEW_METHOD_DEF          View Vector Method Definitions
+ * @{
+ */
+
+
+/** -----------------------------------------------------------------------------------------------
+ * @brief Copy the strings of a `stringvec` into the owned storage.
+ *
+ * @details The arena is sized up front, so all the characters end up in a single block.
+ */
+inline stringview_vec::stringview_vec(const stringvec& orig)
+{
+    std::size_t total = 0;
+    for (const std::string& s : orig)
+    {
+        total += s.size();
+    }
+    owned = std::make_shared<string_arena>(std::max(total, string_arena::default_block_size));
+
+    vec.reserve(orig.get().size());
+    for (const std::string& s : orig)
+    {
+        vec.push_back(store(s));
+    }
+}
+
+inline stringview_vec::stringview_vec(const std::initializer_list<std::string_view>&& orig)
+{
+    vec.reserve(orig.size());
+    for (const std::string_view s : orig)
+    {
+        vec.push_back(store(s));
+    }
+}
+
+
+/** -----------------------------------------------------------------------------------------------
+ * @brief Map a file in memory, pushing a view of each of its lines into the vector.
+ * @param path: File to read the lines from.
+ *
+ * @details Lines are split the same way `std::getline` does: a trailing newline at the end of the
+ *          file does not produce an empty last line.
+ *          No string is copied, the views point directly into the mapping. Compressed files, see
+ *          `compression`, are decompressed block by block and their lines stored in the owned
+ *          storage instead.
+ */
+inline stringview_vec& stringview_vec::read_file(const std::string& path) &
+{
+    return read_file(stringvec_execution::seq, path);
+}
+
+/** -----------------------------------------------------------------------------------------------
+ * @brief Map a file in memory, splitting it into line views on several threads.
+ * @param policy: Execution policy or thread pool to split the file with.
+ * @param path:   File to read the lines from.
+ *
+ * @details The views are the same, and in the same order, as with the sequential `read_file`.
+ */
+template <stringvec_execution::policy Policy>
+inline stringview_vec& stringview_vec::read_file(Policy&& policy, const std::string& path) &
+{
+    auto              map   = std::make_shared<const mapped_file>(path);
+    const compression codec = stringvec_detail::compression_of_content(map->view().substr(0, 4));
+    if (codec != compression::none)
+    {
+        stringvec_detail::for_each_compressed_line(map->view(), codec, path, [this](std::string_view line)
+                                                                             {
+                                                                                 vec.push_back(store(line));
+                                                                             });
+        return *this;
+    }
+
+    stringvec_detail::parallel_read_lines(stringvec_detail::pool_of(policy),
+                                          map->view(),
+                                          vec,
+                                          [](std::string_view line)
+                                          {
+                                              return line;
+                                          });
+    maps.push_back(std::move(map));
+
+    return *this;
+}
+
+/** -----------------------------------------------------------------------------------------------
+ * @brief Write to a file every string from the vector, separated by a specified string.
+ * @param path: File to write the strings to.
+ * @param sep:  Separator string between the strings in the vector when writing back to file.
+ */
+inline void stringview_vec::write_file(const std::string& path, const std::string_view sep) const
+{
+    write_file(path, sep, write_options{});
+}
+
+/** -----------------------------------------------------------------------------------------------
+ * @brief Write to a file every string from the vector, separated by a character.
+ * @param path: File to write the strings to.
+ * @param sep:  Separator character. `'\0'` writes the strings with no separator between them.
+ */
+inline void stringview_vec::write_file(const std::string& path, char sep) const
+{
+    /* A null separator writes none, as a one-character C string would. */
+    return write_file(path, sep == '\0' ? std::string_view{} : std::string_view{&sep, 1});
+}
+
+/** -----------------------------------------------------------------------------------------------
+ * @brief Write to a file every view from the vector, with control over buffering and syncing.
+ * @param path:    File to write the strings to.
+ * @param sep:     Separator string between the strings in the vector when writing back to file.
+ * @param options: Buffer size, direct I/O and `fdatasync`, see `write_options`.
+ */
+inline void stringview_vec::write_file(const std::string&     path,
+                                       const std::string_view sep,
+                                       const write_options&   options) const
+{
+    stringvec_detail::write_strings(path, vec, sep, options);
+}
+
+/** -----------------------------------------------------------------------------------------------
+ * @brief Print the vector of strings line by line, then flush the output buffer.
+ */
+inline void stringview_vec::print(std::ostream& os,
+                                  const std::string_view sep,
+                                  bool keep_last_sep) const
+{
+    stringvec_detail::print_strings(os, vec, sep, keep_last_sep);
+}
+
+
+/** -----------------------------------------------------------------------------------------------
+ * @brief Check all strings against a provided func, remove all strings that match.
+ * @param func: Function object to check against
+ */
+inline stringview_vec& stringview_vec::filter_remove(const std::function<bool(const std::string_view)> func) &
+{
+    vec.erase(std::remove_if(vec.begin(), vec.end(), func),
+              vec.end());
+
+    return *this;
+}
+
+/** -----------------------------------------------------------------------------------------------
+ * @brief Check all strings against a predicate, remove all strings that match.
+ * @param func: Predicate to check against
+ *
+ * @details Unlike the `std::function` overload, the predicate is called directly on each element,
+ *          without type erasure nor copy of the strings, and can be inlined.
+ */
+template <std::predicate<const std::string_view> Pred>
+inline stringview_vec& stringview_vec::filter_remove(Pred&& func) &
+{
+    vec.erase(std::remove_if(vec.begin(), vec.end(), [&func](const std::string_view s)
+                                                     {
+                                                         return std::invoke(func, s);
+                                                     }),
+              vec.end());
+
+    return *this;
+}
+
+/** -----------------------------------------------------------------------------------------------
+ * @brief Check all strings against a provided regex, remove all strings that match the regex.
+ * @param regex: Regular Expression to check against.
+ */
+inline stringview_vec& stringview_vec::filter_remove(const std::string& regex) &
+{
+    try
+    {
+        filter_remove(regex_cache::global().get(regex));
+    }
+    catch (const std::regex_error& e)
+    {
+        std::cerr << "Error: Invalid regex pattern '" << regex << "'. "
+                  << "Details: " << e.what() << std::endl;
+    }
+
+    return *this;
+}
+
+/** -----------------------------------------------------------------------------------------------
+ * @brief Check all strings against a precompiled regex, remove all strings that match the regex.
+ * @param regex: Precompiled Regular Expression to check against.
+ */
+inline stringview_vec& stringview_vec::filter_remove(const regex_handle& regex) &
+{
+    filter_remove([&regex](const std::string_view s)
+                  {
+                      return regex->match(s);
+                  });
+
+    return *this;
+}
+
+/** -----------------------------------------------------------------------------------------------
+ * @brief Check all strings against a provided func, keep only strings that match.
+ * @param func: Function object to check against
+ */
+inline stringview_vec& stringview_vec::filter_keep(const std::function<bool(const std::string_view)> func) &
+{
+    vec.erase(std::remove_if(vec.begin(), vec.end(), [&func](const std::string_view s)
+                                                     {
+                                                         return !func(s);
+                                                     }),
+              vec.end());
+
+    return *this;
+}
+
+/** -----------------------------------------------------------------------------------------------
+ * @brief Check all strings against a predicate, keep only strings that match.
+ * @param func: Predicate to check against
+ */
+template <std::predicate<const std::string_view> Pred>
+inline stringview_vec& stringview_vec::filter_keep(Pred&& func) &
+{
+    vec.erase(std::remove_if(vec.begin(), vec.end(), [&func](const std::string_view s)
+                                                     {
+                                                         return !std::invoke(func, s);
+                                                     }),
+              vec.end());
+
+    return *this;
+}
+
+/** -----------------------------------------------------------------------------------------------
+ * @brief Check all strings against a provided regex, keep only strings that match the regex.
+ * @param regex: Regular Expression to check against.
+ */
+inline stringview_vec& stringview_vec::filter_keep(const std::string& regex) &
+{
+    try
+    {
+        filter_keep(regex_cache::global().get(regex));
+    }
+    catch (const std::regex_error& e)
+    {
+        std::cerr << "Error: Invalid regex pattern '" << regex << "'. "
+                  << "Details: " << e.what() << std::endl;
+    }
+
+    return *this;
+}
+
+/** -----------------------------------------------------------------------------------------------
+ * @brief Check all strings against a precompiled regex, keep only strings that match the regex.
+ * @param regex: Precompiled Regular Expression to check against.
+ */
+inline stringview_vec& stringview_vec::filter_keep(const regex_handle& regex) &
+{
+    filter_keep([&regex](const std::string_view s)
+                {
+                    return regex->match(s);
+                });
+
+    return *this;
+}
+
+/** -----------------------------------------------------------------------------------------------
+ * @brief Check all strings against a set of regexes, remove all strings that match any of them.
+ * @param regexes: Regular Expressions to check against, compiled once into a `pattern_set`.
+ *
+ * @details The strings are checked in a single pass, instead of one pass per regex.
+ */
+inline stringview_vec& stringview_vec::filter_remove_any(std::span<const std::string> regexes) &
+{
+    try
+    {
+        filter_remove_any(pattern_set::regexes(regexes));
+    }
+    catch (const std::regex_error& e)
+    {
+        std::cerr << "Error: Invalid regex pattern in set. "
+                  << "Details: " << e.what() << std::endl;
+    }
+
+    return *this;
+}
+
+/** -----------------------------------------------------------------------------------------------
+ * @brief Remove all strings matching any pattern of a compiled set.
+ * @param patterns: Substrings and regexes to check against, see `pattern_set`.
+ */
+inline stringview_vec& stringview_vec::filter_remove_any(const pattern_set& patterns) &
+{
+    filter_remove([&patterns](const std::string_view s)
+                  {
+                      return patterns.match(s);
+                  });
+
+    return *this;
+}
+
+/** -----------------------------------------------------------------------------------------------
+ * @brief Check all strings against a set of regexes, keep only strings that match any of them.
+ * @param regexes: Regular Expressions to check against, compiled once into a `pattern_set`.
+ *
+ * @details The strings are checked in a single pass, instead of one pass per regex.
+ */
+inline stringview_vec& stringview_vec::filter_keep_any(std::span<const std::string> regexes) &
+{
+    try
+    {
+        filter_keep_any(pattern_set::regexes(regexes));
+    }
+    catch (const std::regex_error& e)
+    {
+        std::cerr << "Error: Invalid regex pattern in set. "
+                  << "Details: " << e.what() << std::endl;
+    }
+
+    return *this;
+}
+
+/** -----------------------------------------------------------------------------------------------
+ * @brief Keep only strings matching any pattern of a compiled set.
+ * @param patterns: Substrings and regexes to check against, see `pattern_set`.
+ */
+inline stringview_vec& stringview_vec::filter_keep_any(const pattern_set& patterns) &
+{
+    filter_keep([&patterns](const std::string_view s)
+                {
+                    return patterns.match(s);
+                });
+
+    return *this;
+}
+
+/** -----------------------------------------------------------------------------------------------
+ * @brief Remove all strings containing a substring, regardless of case.
+ * @param s: Substring to look for, compared after UTF-8 case folding, see `stringvec::casefold_utf8`.
+ */
+inline stringview_vec& stringview_vec::filter_remove_icase(const std::string_view s) &
+{
+    const stringvec_detail::icase_needle needle{s};
+    filter_remove([&needle](const std::string_view x)
+                  {
+                      return needle.found_in(x);
+                  });
+
+    return *this;
+}
+
+/** -----------------------------------------------------------------------------------------------
+ * @brief Keep only the strings containing a substring, regardless of case.
+ * @param s: Substring to look for, compared after UTF-8 case folding, see `stringvec::casefold_utf8`.
+ */
+inline stringview_vec& stringview_vec::filter_keep_icase(const std::string_view s) &
+{
+    const stringvec_detail::icase_needle needle{s};
+    filter_keep([&needle](const std::string_view x)
+                {
+                    return needle.found_in(x);
+                });
+
+    return *this;
+}
+
+/** -----------------------------------------------------------------------------------------------
+ * @brief Remove all empty strings from the vector.
+ * @param keep_whitespace: If true, keep strings containing only whitespace.
+ */
+inline stringview_vec& stringview_vec::filter_empty(bool keep_whitespace) &
+{
+    if (keep_whitespace)
+    {
+        filter_remove([](const std::string_view s)
+                      {
+                          return s.empty();
+                      });
+    }
+    else
+    {
+        filter_remove([](const std::string_view s)
+                      {
+                          return stringvec_detail::is_blank(s);
+                      });
+    }
+
+    return *this;
+}
+
+
+/** -----------------------------------------------------------------------------------------------
+ * @brief Remove the first elements from the vector, in a single shift of the others.
+ * @param count: Number of elements to remove, clamped to the size of the vector.
+ *
+ * @details Call `remove_first(n)` rather than `remove_first()` `n` times, which shifts the
+ *          remaining elements on every call.
+ */
+inline stringview_vec& stringview_vec::remove_first(std::size_t count) &
+{
+    return remove_range(0, count);
+}
+
+/** -----------------------------------------------------------------------------------------------
+ * @brief Remove the last elements from the vector, in O(count).
+ * @param count: Number of elements to remove, clamped to the size of the vector.
+ */
+inline stringview_vec& stringview_vec::remove_last(std::size_t count) &
+{
+    vec.erase(end() - static_cast<std::ptrdiff_t>(std::min(count, vec.size())), end());
+
+    return *this;
+}
+
+/** -----------------------------------------------------------------------------------------------
+ * @brief Remove an element from the vector from its index.
+ */
+inline stringview_vec& stringview_vec::remove_nth(std::size_t pos) &
+{
+    return remove_range(pos, pos + 1);
+}
+
+/** -----------------------------------------------------------------------------------------------
+ * @brief Remove the elements at positions `[first, last)`, in a single shift of the others.
+ * @param first: Position of the first element to remove.
+ * @param last:  Position after the last element to remove, clamped to the size of the vector.
+ */
+inline stringview_vec& stringview_vec::remove_range(std::size_t first, std::size_t last) &
+{
+    last = std::min(last, vec.size());
+    if (first >= last)
+    {
+        return *this;
+    }
+
+    vec.erase(begin() + static_cast<std::ptrdiff_t>(first), begin() + static_cast<std::ptrdiff_t>(last));
+
+    return *this;
+}
+
+/** -----------------------------------------------------------------------------------------------
+ * @brief Remove the elements at a set of positions, moving each remaining element at most once.
+ * @param positions: Positions to remove, in any order. Duplicates and out-of-range positions are
+ *                   ignored.
+ */
+inline stringview_vec& stringview_vec::remove_indices(std::span<const std::size_t> positions) &
+{
+    if (positions.empty())
+    {
+        return *this;
+    }
+
+    std::vector<std::uint8_t> flags(vec.size(), 1);
+    for (const std::size_t pos : positions)
+    {
+        if (pos < flags.size())
+        {
+            flags[pos] = 0;
+        }
+    }
+    stringvec_detail::compact_by_flags(nullptr, 0, vec, flags);
+
+    return *this;
+}
+
+/** -----------------------------------------------------------------------------------------------
+ * @brief Remove every element, and release the mappings and the owned storage.
+ *
+ * @details Views hold no memory of their own, so this is O(1) in the number of elements. When no
+ *          copy shares the arena, it is rewound and its blocks are reused by later strings.
+ */
+inline stringview_vec& stringview_vec::clear() &
+{
+    vec.clear();
+    maps.clear();
+    frozen.clear();
+
+    if (owned && owned.use_count() == 1)
+    {
+        owned->reset();
+    }
+    else
+    {
+        owned.reset();
+    }
+
+    return *this;
+}
+
+
+/** -----------------------------------------------------------------------------------------------
+ * @brief Apply a function to all the elements of the vector
+ * @param func: Function to apply
+ *
+ * @details A string is only materialized in the owned storage when the function actually
+ *          changes it; unchanged elements keep pointing into their original storage.
+ */
+inline stringview_vec& stringview_vec::transform(const std::function<std::string(const std::string_view)> func) &
+{
+    for (std::string_view& s : vec)
+    {
+        std::string result = func(s);
+        if (result != s)
+        {
+            s = store(result);
+        }
+    }
+
+    return *this;
+}
+
+/** -----------------------------------------------------------------------------------------------
+ * @brief Apply a function to all the elements of the vector
+ * @param func: Function to apply, returning the new value of each string
+ *
+ * @details As with the `std::function` overload, only the strings that change are materialized.
+ */
+template <std::invocable<const std::string_view> Func>
+inline stringview_vec& stringview_vec::transform(Func&& func) &
+{
+    for (std::string_view& s : vec)
+    {
+        decltype(auto) result = std::invoke(func, s);
+        if (std::string_view{result} != s)
+        {
+            s = store(std::string_view{result});
+        }
+    }
+
+    return *this;
+}
+
+/** -----------------------------------------------------------------------------------------------
+ * @brief Trim trailing and leading whitespace from all strings in the vector, including newlines.
+ *
+ * @details Only the views are narrowed, no string is copied.
+ */
+inline stringview_vec& stringview_vec::trim() &
+{
+    for (std::string_view& s : vec)
+    {
+        s = stringvec_detail::trim_view(s);
+    }
+
+    return *this;
+}
+
+/** -----------------------------------------------------------------------------------------------
+ * @brief Split all strings in-place with a specified delimiter string.
+ *
+ * @param delimiter: String to use as a separation point for the string.
+ *
+ * @details The delimiter string is removed from each split.
+ *          The resulting tokens are views into the same storage as the original strings.
+ */
+inline stringview_vec& stringview_vec::split(const std::string_view delimiter) &
+{
+    split_tokens(delimiter);
+
+    return *this;
+}
+
+/** -----------------------------------------------------------------------------------------------
+ * @brief Narrow the views on any of a set of single-character delimiters.
+ * @param delimiters: Characters to use as separation points.
+ */
+inline stringview_vec& stringview_vec::split_any(const std::string_view delimiters) &
+{
+    split_tokens(stringvec_detail::delimiter_set{delimiters});
+
+    return *this;
+}
+
+template <class Delimiter>
+inline void stringview_vec::split_tokens(const Delimiter& delimiter)
+{
+    std::size_t count = 0;
+    for (const std::string_view s : vec)
+    {
+        stringvec_detail::for_each_token(s, delimiter, [&count](std::string_view)
+                                                       {
+                                                           count++;
+                                                       });
+    }
+
+    if (count == vec.size())
+    {
+        return;
+    }
+
+    std::vector<std::string_view> newStrings;
+    newStrings.reserve(count);
+    for (const std::string_view s : vec)
+    {
+        stringvec_detail::for_each_token(s, delimiter, [&newStrings](std::string_view token)
+                                                       {
+                                                           newStrings.push_back(token);
+                                                       });
+    }
+
+    vec = std::move(newStrings);
+}
+
+
+/** -----------------------------------------------------------------------------------------------
+ * @brief Reverse the order of the vector's elements.
+ */
+inline stringview_vec& stringview_vec::reverse() &
+{
+    std::reverse(begin(), end());
+
+    return *this;
+}
+
+/** -----------------------------------------------------------------------------------------------
  * @brief Sort each string in the vector in O(N logN)
  * @param func: Comparison function
  */
-inline void stringvec::sort(const std::function<bool(const std::string_view,
-                                                     const std::string_view)> func)
+inline stringview_vec& stringview_vec::sort(const std::function<bool(const std::string_view,
+                                                                     const std::string_view)> func) &
+{
+    std::sort(begin(), end(), func);
+
+    return *this;
+}
+
+/** -----------------------------------------------------------------------------------------------
+ * @brief Sort the vector alphabetically
+ *
+ * @details Uses the same prefix-caching sort as `stringvec`, which is stable.
+ */
+inline stringview_vec& stringview_vec::sort_alphabetically() &
+{
+    stringvec_detail::radix_sort_strings(nullptr, 0, vec);
+
+    return *this;
+}
+
+/** -----------------------------------------------------------------------------------------------
+ * @brief Sort the vector by length of the strings, with a stable counting sort.
+ */
+inline stringview_vec& stringview_vec::sort_length() &
+{
+    stringvec_detail::counting_sort_length(nullptr, 0, vec);
+
+    return *this;
+}
+
+
+/** -----------------------------------------------------------------------------------------------
+ * @brief Find the first element matching the input function.
+ * @param func: Function to match in the vector.
+ */
+inline stringview_vec::iter stringview_vec::find(const std::function<bool(const std::string_view)> func)
+{
+    return std::find_if(begin(), end(), func);
+}
+
+inline stringview_vec::citer stringview_vec::find(const std::function<bool(const std::string_view)> func) const
+{
+    return const_cast<stringview_vec*>(this)->find(func);
+}
+
+/** -----------------------------------------------------------------------------------------------
+ * @brief Find the last element matching the input function.
+ * @param func: Function to match in the vector.
+ */
+inline stringview_vec::iter stringview_vec::rfind(const std::function<bool(const std::string_view)> func)
+{
+    riter it = std::find_if(vec.rbegin(), vec.rend(), func);
+
+    if (it != vec.rend())
+    {
+        return iter{--(it.base())};
+    }
+    else
+    {
+        return vec.end();
+    }
+}
+
+inline stringview_vec::citer stringview_vec::rfind(const std::function<bool(const std::string_view)> func) const
+{
+    return const_cast<stringview_vec*>(this)->rfind(func);
+}
+
+/** -----------------------------------------------------------------------------------------------
+ * @brief Find the first element matching a predicate.
+ * @param func: Predicate to match in the vector.
+ */
+template <std::predicate<const std::string_view> Pred>
+inline stringview_vec::iter stringview_vec::find(Pred&& func)
+{
+    return std::find_if(begin(), end(), [&func](const std::string_view s)
+                                        {
+                                            return std::invoke(func, s);
+                                        });
+}
+
+template <std::predicate<const std::string_view> Pred>
+inline stringview_vec::citer stringview_vec::find(Pred&& func) const
+{
+    return const_cast<stringview_vec*>(this)->find(std::forward<Pred>(func));
+}
+
+/** -----------------------------------------------------------------------------------------------
+ * @brief Find the last element matching a predicate.
+ * @param func: Predicate to match in the vector.
+ */
+template <std::predicate<const std::string_view> Pred>
+inline stringview_vec::iter stringview_vec::rfind(Pred&& func)
+{
+    riter it = std::find_if(vec.rbegin(), vec.rend(), [&func](const std::string_view s)
+                                                      {
+                                                          return std::invoke(func, s);
+                                                      });
+
+    return it != vec.rend() ? iter{--(it.base())} : vec.end();
+}
+
+template <std::predicate<const std::string_view> Pred>
+inline stringview_vec::citer stringview_vec::rfind(Pred&& func) const
+{
+    return const_cast<stringview_vec*>(this)->rfind(std::forward<Pred>(func));
+}
+
+/** -----------------------------------------------------------------------------------------------
+ * @brief Find the first element matching the input string.
+ * @param s: String to find in the vector.
+ */
+inline stringview_vec::iter stringview_vec::find(const std::string_view s)
+{
+    return std::find(begin(), end(), s);
+}
+
+inline stringview_vec::citer stringview_vec::find(const std::string_view s) const
+{
+    return const_cast<stringview_vec*>(this)->find(s);
+}
+
+/** -----------------------------------------------------------------------------------------------
+ * @brief Find the first element equal to the input string, regardless of case.
+ * @param s: String to find, compared after UTF-8 case folding, see `stringvec::casefold_utf8`.
+ */
+inline stringview_vec::iter stringview_vec::find_icase(const std::string_view s)
+{
+    const stringvec_detail::icase_needle needle{s};
+    return find([&needle](const std::string_view x)
+                {
+                    return needle.equals(x);
+                });
+}
+
+inline stringview_vec::citer stringview_vec::find_icase(const std::string_view s) const
+{
+    return const_cast<stringview_vec*>(this)->find_icase(s);
+}
+
+/** -----------------------------------------------------------------------------------------------
+ * @brief Check if all strings are valid UTF-8, see `stringvec::validate_utf8`.
+ */
+inline bool stringview_vec::validate_utf8() const
+{
+    return std::all_of(vec.begin(), vec.end(), [](const std::string_view s)
+                                               {
+                                                   return stringvec_detail::valid_utf8(s);
+                                               });
+}
+
+/** -----------------------------------------------------------------------------------------------
+ * @brief Find the last element matching the input string.
+ * @param s: String to find in the vector.
+ */
+inline stringview_vec::iter stringview_vec::rfind(const std::string_view s)
+{
+    return rfind([s](const std::string_view x){return x == s;});
+}
+
+inline stringview_vec::citer stringview_vec::rfind(const std::string_view s) const
+{
+    return const_cast<stringview_vec*>(this)->rfind(s);
+}
+
+/** -----------------------------------------------------------------------------------------------
+ * @brief Find the first element matching the input regex.
+ * @param regex: Regex to match in the vector.
+ */
+inline stringview_vec::iter stringview_vec::find_reg(const std::string& regex)
+{
+    try
+    {
+        return find_reg(regex_cache::global().get(regex));
+    }
+    catch (const std::regex_error& e)
+    {
+        std::cerr << "Error: Invalid regex pattern '" << regex << "'. "
+                  << "Details: " << e.what() << std::endl;
+
+        return end();
+    }
+}
+
+inline stringview_vec::citer stringview_vec::find_reg(const std::string& regex) const
+{
+    return const_cast<stringview_vec*>(this)->find_reg(regex);
+}
+
+/** -----------------------------------------------------------------------------------------------
+ * @brief Find the first element matching the precompiled regex.
+ * @param regex: Precompiled Regex to match in the vector.
+ */
+inline stringview_vec::iter stringview_vec::find_reg(const regex_handle& regex)
+{
+    return find([&regex](const std::string_view s)
+                {
+                    return regex->match(s);
+                });
+}
+
+inline stringview_vec::citer stringview_vec::find_reg(const regex_handle& regex) const
+{
+    return const_cast<stringview_vec*>(this)->find_reg(regex);
+}
+
+/** -----------------------------------------------------------------------------------------------
+ * @brief Find the last element matching the input regex.
+ * @param regex: Regex to match in the vector.
+ */
+inline stringview_vec::iter stringview_vec::rfind_reg(const std::string& regex)
+{
+    try
+    {
+        return rfind_reg(regex_cache::global().get(regex));
+    }
+    catch (const std::regex_error& e)
+    {
+        std::cerr << "Error: Invalid regex pattern '" << regex << "'. "
+                  << "Details: " << e.what() << std::endl;
+
+        return end();
+    }
+}
+
+inline stringview_vec::citer stringview_vec::rfind_reg(const std::string& regex) const
+{
+    return const_cast<stringview_vec*>(this)->rfind_reg(regex);
+}
+
+/** -----------------------------------------------------------------------------------------------
+ * @brief Find the last element matching the precompiled regex.
+ * @param regex: Precompiled Regex to match in the vector.
+ */
+inline stringview_vec::iter stringview_vec::rfind_reg(const regex_handle& regex)
+{
+    return rfind([&regex](const std::string_view s)
+                 {
+                     return regex->match(s);
+                 });
+}
+
+inline stringview_vec::citer stringview_vec::rfind_reg(const regex_handle& regex) const
+{
+    return const_cast<stringview_vec*>(this)->rfind_reg(regex);
+}
+
+/** -----------------------------------------------------------------------------------------------
+ * @brief Find the first string matching any pattern of a set, and which pattern it matches.
+ * @param patterns: Substrings and regexes to check against, see `pattern_set`.
+ * @return The string, or `end()`, and the lowest number of the patterns it matches, or
+ *         `pattern_set::npos`.
+ */
+inline std::pair<stringview_vec::iter, std::size_t> stringview_vec::find_any(const pattern_set& patterns)
+{
+    const iter it = std::find_if(vec.begin(), vec.end(), [&patterns](const std::string_view s)
+                                                         {
+                                                             return patterns.match(s);
+                                                         });
+
+    return {it, it != vec.end() ? patterns.which(*it) : pattern_set::npos};
+}
+
+inline std::pair<stringview_vec::citer, std::size_t> stringview_vec::find_any(const pattern_set& patterns) const
+{
+    const auto [it, pattern] = const_cast<stringview_vec*>(this)->find_any(patterns);
+    return {it, pattern};
+}
+
+/** -----------------------------------------------------------------------------------------------
+ * @brief Get the positions of all the elements matching a predicate, in order.
+ * @param func: Predicate taking a string view.
+ */
+template <std::predicate<const std::string_view> Pred>
+inline std::vector<std::size_t> stringview_vec::find_all(Pred&& func) const
+{
+    return stringvec_detail::parallel_positions(nullptr, 1, begin(), end(), [&func](const std::string_view s)
+                                                                            {
+                                                                                return static_cast<bool>(std::invoke(func, s));
+                                                                            });
+}
+
+/** -----------------------------------------------------------------------------------------------
+ * @brief Get the positions of all the elements equal to a string, in order.
+ * @param s: String to find in the vector.
+ */
+inline std::vector<std::size_t> stringview_vec::find_all(const std::string_view s) const
+{
+    return find_all([s](const std::string_view x)
+                    {
+                        return x == s;
+                    });
+}
+
+/** -----------------------------------------------------------------------------------------------
+ * @brief Get the positions of all the elements matching a regex, in order.
+ * @param regex: Regex to match in the vector.
+ */
+inline std::vector<std::size_t> stringview_vec::find_all_reg(const std::string& regex) const
+{
+    try
+    {
+        return find_all_reg(regex_cache::global().get(regex));
+    }
+    catch (const std::regex_error& e)
+    {
+        std::cerr << "Error: Invalid regex pattern '" << regex << "'. "
+                  << "Details: " << e.what() << std::endl;
+
+        return {};
+    }
+}
+
+inline std::vector<std::size_t> stringview_vec::find_all_reg(const regex_handle& regex) const
+{
+    return find_all([&regex](const std::string_view s)
+                    {
+                        return regex->match(s);
+                    });
+}
+
+/** -----------------------------------------------------------------------------------------------
+ * @brief Count the elements matching a predicate.
+ * @param func: Predicate taking a string view.
+ */
+template <std::predicate<const std::string_view> Pred>
+inline std::size_t stringview_vec::count_if(Pred&& func) const
+{
+    return stringvec_detail::parallel_count(nullptr, 1, begin(), end(), [&func](const std::string_view s)
+                                                                        {
+                                                                            return static_cast<bool>(std::invoke(func, s));
+                                                                        });
+}
+
+/** -----------------------------------------------------------------------------------------------
+ * @brief Count the elements matching a regex.
+ * @param regex: Regex to match in the vector.
+ */
+inline std::size_t stringview_vec::count_reg(const std::string& regex) const
+{
+    try
+    {
+        return count_reg(regex_cache::global().get(regex));
+    }
+    catch (const std::regex_error& e)
+    {
+        std::cerr << "Error: Invalid regex pattern '" << regex << "'. "
+                  << "Details: " << e.what() << std::endl;
+
+        return 0;
+    }
+}
+
+inline std::size_t stringview_vec::count_reg(const regex_handle& regex) const
+{
+    return count_if([&regex](const std::string_view s)
+                    {
+                        return regex->match(s);
+                    });
+}
+
+/** -----------------------------------------------------------------------------------------------
+ * @brief Get the positions of the elements matching a regex, then of the others, in order.
+ * @param regex: Regex to match in the vector.
+ *
+ * @details Every position is in exactly one of the two vectors. An invalid regex matches nothing.
+ */
+inline std::pair<std::vector<std::size_t>, std::vector<std::size_t>> stringview_vec::partition_by(const std::string& regex) const
+{
+    try
+    {
+        return partition_by(regex_cache::global().get(regex));
+    }
+    catch (const std::regex_error& e)
+    {
+        std::cerr << "Error: Invalid regex pattern '" << regex << "'. "
+                  << "Details: " << e.what() << std::endl;
+
+        std::vector<std::size_t> all(vec.size());
+        std::iota(all.begin(), all.end(), std::size_t{0});
+        return {{}, std::move(all)};
+    }
+}
+
+inline std::pair<std::vector<std::size_t>, std::vector<std::size_t>> stringview_vec::partition_by(const regex_handle& regex) const
+{
+    return stringvec_detail::parallel_partition_positions(nullptr, 1, begin(), end(), [&regex](const std::string_view s)
+                                                                                      {
+                                                                                          return regex->match(s);
+                                                                                      });
+}
+
+
+/** -----------------------------------------------------------------------------------------------
+ * @brief Rvalue overloads of the modifying methods.
+ *
+ * @details They apply the same operation, then return the vector as an rvalue so that chains such
+ *          as `stringview_vec{}.read_file(path).split().filter_keep(regex)` can be moved into their
+ *          destination instead of being copied.
+ */
+inline stringview_vec&& stringview_vec::read_file(const std::string& path) &&
+{
+    return std::move(read_file(path));
+}
+
+template <stringvec_execution::policy Policy>
+inline stringview_vec&& stringview_vec::read_file(Policy&& policy, const std::string& path) &&
+{
+    return std::move(read_file(policy, path));
+}
+
+inline stringview_vec&& stringview_vec::filter_remove(const std::function<bool(const std::string_view)> func) &&
+{
+    return std::move(filter_remove(func));
+}
+
+template <std::predicate<const std::string_view> Pred>
+inline stringview_vec&& stringview_vec::filter_remove(Pred&& func) &&
+{
+    return std::move(filter_remove(std::forward<Pred>(func)));
+}
+
+inline stringview_vec&& stringview_vec::filter_remove(const std::string& regex) &&
+{
+    return std::move(filter_remove(regex));
+}
+
+inline stringview_vec&& stringview_vec::filter_remove(const regex_handle& regex) &&
+{
+    return std::move(filter_remove(regex));
+}
+
+inline stringview_vec&& stringview_vec::filter_keep(const std::function<bool(const std::string_view)> func) &&
+{
+    return std::move(filter_keep(func));
+}
+
+template <std::predicate<const std::string_view> Pred>
+inline stringview_vec&& stringview_vec::filter_keep(Pred&& func) &&
+{
+    return std::move(filter_keep(std::forward<Pred>(func)));
+}
+
+inline stringview_vec&& stringview_vec::filter_keep(const std::string& regex) &&
+{
+    return std::move(filter_keep(regex));
+}
+
+inline stringview_vec&& stringview_vec::filter_keep(const regex_handle& regex) &&
+{
+    return std::move(filter_keep(regex));
+}
+
+inline stringview_vec&& stringview_vec::filter_remove_any(std::span<const std::string> regexes) &&
+{
+    return std::move(filter_remove_any(regexes));
+}
+
+inline stringview_vec&& stringview_vec::filter_remove_any(const pattern_set& patterns) &&
+{
+    return std::move(filter_remove_any(patterns));
+}
+
+inline stringview_vec&& stringview_vec::filter_keep_any(std::span<const std::string> regexes) &&
+{
+    return std::move(filter_keep_any(regexes));
+}
+
+inline stringview_vec&& stringview_vec::filter_keep_any(const pattern_set& patterns) &&
+{
+    return std::move(filter_keep_any(patterns));
+}
+
+inline stringview_vec&& stringview_vec::filter_remove_icase(const std::string_view s) &&
+{
+    return std::move(filter_remove_icase(s));
+}
+
+inline stringview_vec&& stringview_vec::filter_keep_icase(const std::string_view s) &&
+{
+    return std::move(filter_keep_icase(s));
+}
+
+inline stringview_vec&& stringview_vec::filter_empty(bool keep_whitespace) &&
+{
+    return std::move(filter_empty(keep_whitespace));
+}
+
+inline stringview_vec&& stringview_vec::remove_first(std::size_t count) &&
+{
+    return std::move(remove_first(count));
+}
+
+inline stringview_vec&& stringview_vec::remove_last(std::size_t count) &&
+{
+    return std::move(remove_last(count));
+}
+
+inline stringview_vec&& stringview_vec::remove_nth(std::size_t pos) &&
+{
+    return std::move(remove_nth(pos));
+}
+
+inline stringview_vec&& stringview_vec::remove_range(std::size_t first, std::size_t last) &&
+{
+    return std::move(remove_range(first, last));
+}
+
+inline stringview_vec&& stringview_vec::remove_indices(std::span<const std::size_t> positions) &&
+{
+    return std::move(remove_indices(positions));
+}
+
+inline stringview_vec&& stringview_vec::clear() &&
+{
+    return std::move(clear());
+}
+
+inline stringview_vec&& stringview_vec::transform(const std::function<std::string(const std::string_view)> func) &&
+{
+    return std::move(transform(func));
+}
+
+template <std::invocable<const std::string_view> Func>
+inline stringview_vec&& stringview_vec::transform(Func&& func) &&
+{
+    return std::move(transform(std::forward<Func>(func)));
+}
+
+inline stringview_vec&& stringview_vec::trim() &&
+{
+    return std::move(trim());
+}
+
+inline stringview_vec&& stringview_vec::split(const std::string_view delimiter) &&
+{
+    return std::move(split(delimiter));
+}
+
+inline stringview_vec&& stringview_vec::split_any(const std::string_view delimiters) &&
+{
+    return std::move(split_any(delimiters));
+}
+
+inline stringview_vec&& stringview_vec::reverse() &&
+{
+    return std::move(reverse());
+}
+
+inline stringview_vec&& stringview_vec::sort(const std::function<bool(const std::string_view,
+                                                                      const std::string_view)> func) &&
+{
+    return std::move(sort(func));
+}
+
+inline stringview_vec&& stringview_vec::sort_alphabetically() &&
+{
+    return std::move(sort_alphabetically());
+}
+
+inline stringview_vec&& stringview_vec::sort_length() &&
+{
+    return std::move(sort_length());
+}
+
+
+/** -----------------------------------------------------------------------------------------------
+ * @brief Get the vector of views.
+ */
+inline std::vector<std::string_view>& stringview_vec::get()
+{
+    return vec;
+}
+
+inline const std::vector<std::string_view>& stringview_vec::get() const
+{
+    return vec;
+}
+
+/** -----------------------------------------------------------------------------------------------
+ * @brief Materialize every view into a regular `stringvec`.
+ */
+inline stringvec stringview_vec::to_stringvec() const
+{
+    return stringvec{std::vector<std::string>(begin(), end())};
+}
+
+
+/** -----------------------------------------------------------------------------------------------
+ * @brief Get an iterator to the first element of the vector.
+ */
+inline stringview_vec::iter stringview_vec::begin()
+{
+    return vec.begin();
+}
+
+inline stringview_vec::citer stringview_vec::begin() const
+{
+    return vec.cbegin();
+}
+
+inline stringview_vec::citer stringview_vec::cbegin() const
+{
+    return begin();
+}
+
+/** -----------------------------------------------------------------------------------------------
+ * @brief Get an iterator to the last element of the vector.
+ */
+inline stringview_vec::iter stringview_vec::end()
+{
+    return vec.end();
+}
+
+inline stringview_vec::citer stringview_vec::end() const
+{
+    return vec.cend();
+}
+
+inline stringview_vec::citer stringview_vec::cend() const
+{
+    return end();
+}
+
+
+/** -----------------------------------------------------------------------------------------------
+ * @brief Get the string at position `index`.
+ */
+inline std::string_view& stringview_vec::operator[](std::size_t index)
+{
+    return vec[index];
+}
+
+inline const std::string_view& stringview_vec::operator[](std::size_t index) const
+{
+    return vec[index];
+}
+
+
+
+inline bool stringview_vec::operator== (const stringview_vec& other) const
+{
+    return vec == other.vec;
+}
+
+inline bool stringview_vec::operator!= (const stringview_vec& other) const
+{
+    return !(*this == other);
+}
+
+inline std::strong_ordering stringview_vec::operator<=>(const stringview_vec& other) const
+{
+    return vec <=> other.vec;
+}
+
+
+/** -----------------------------------------------------------------------------------------------
+ * @brief Copy a materialized string into the owned storage, returning a view to it.
+ *
+ * @details The arena never relocates what it stores, so previously returned views stay valid.
+ *          An arena shared with another copy, which may be storing into it on another thread, is
+ *          only kept alive for the views into it, and a new arena is started.
+ */
+inline std::string_view stringview_vec::store(const std::string_view s)
+{
+    if (owned && owned.use_count() > 1)
+    {
+        frozen.push_back(std::move(owned));
+        owned.reset();
+    }
+
+    if (!owned)
+    {
+        owned = std::make_shared<string_arena>();
+    }
+
+    return owned->store(s);
+}
+
+/**
+ * @}
+ */
+
+
+
+/** ===============================================================================================
+ *  COLUMN TABLE
+ *
+ * @defgroup STRINGVEC_COLUMN_TABLE             Column Table
+ * @{
+ */
+
+/** -----------------------------------------------------------------------------------------------
+ * @class   column_table
+ *
+ * @brief   Lines split into fields, stored column by column.
+ *
+ * @details Every line is a row, and its fields, separated by a delimiter string, are views kept in
+ *          one array per column, so a scan of a single field reads only that field, and no token
+ *          is copied into a `std::string` of its own. Rows shorter than the widest one read as
+ *          empty fields in the missing columns, as does any column past the widest row.
+ *          Fields are split as `split` does: consecutive delimiters produce empty fields, and
+ *          quotes are not interpreted.
+ *
+ *          The bytes the views point to are shared with the `stringview_vec` the table is built
+ *          from, or copied once into an arena when it is built from a `stringvec`, so the table
+ *          stays valid whatever happens to its source.
+ *
+ * @example
+ *      const stringvec lines = stringvec{}.read_file("prices.csv");
+ *      const stringvec names = lines.split_columns(",")
+ *                                   .filter_keep(2, "EUR|USD")
+ *                                   .sort_by(1)
+ *                                   .select({0, 1})
+ *                                   .join_rows(",");
+ */
+class column_table
+{
+public:
+    // Constructors / Destructors
+    ~column_table()                                  = default;
+    column_table()                                   = default;
+    column_table(const column_table&)                = default;
+    column_table(column_table&&) noexcept            = default;
+    column_table& operator=(const column_table&)     = default;
+    column_table& operator=(column_table&&) noexcept = default;
+    inline column_table(stringview_vec lines, const std::string_view delimiter);
+    inline column_table(const stringvec& lines, const std::string_view delimiter);
+
+    // Filtering
+    template <std::predicate<const std::string_view> Pred>
+    inline column_table&  filter_remove(std::size_t col, Pred&& func) &;
+    template <std::predicate<const std::string_view> Pred>
+    inline column_table&& filter_remove(std::size_t col, Pred&& func) &&;
+    template <std::predicate<const std::string_view> Pred>
+    inline column_table&  filter_keep  (std::size_t col, Pred&& func) &;
+    template <std::predicate<const std::string_view> Pred>
+    inline column_table&& filter_keep  (std::size_t col, Pred&& func) &&;
+    inline column_table&  filter_remove(std::size_t col, const std::string& regex) &;
+    inline column_table&& filter_remove(std::size_t col, const std::string& regex) &&;
+    inline column_table&  filter_remove(std::size_t col, const regex_handle& regex) &;
+    inline column_table&& filter_remove(std::size_t col, const regex_handle& regex) &&;
+    inline column_table&  filter_keep  (std::size_t col, const std::string& regex) &;
+    inline column_table&& filter_keep  (std::size_t col, const std::string& regex) &&;
+    inline column_table&  filter_keep  (std::size_t col, const regex_handle& regex) &;
+    inline column_table&& filter_keep  (std::size_t col, const regex_handle& regex) &&;
+
+    // Ordering
+    inline column_table&  sort_by(std::size_t col) &;
+    inline column_table&& sort_by(std::size_t col) &&;
+    inline column_table&  sort_by(std::size_t col, const std::function<bool(const std::string_view,
+                                                                            const std::string_view)> func) &;
+    inline column_table&& sort_by(std::size_t col, const std::function<bool(const std::string_view,
+                                                                            const std::string_view)> func) &&;
+
+    // Projection
+    inline column_table&  select(std::span<const std::size_t> cols) &;
+    inline column_table&& select(std::span<const std::size_t> cols) &&;
+    inline column_table&  select(std::initializer_list<std::size_t> cols) &;
+    inline column_table&& select(std::initializer_list<std::size_t> cols) &&;
+
+    // Accessing
+    inline std::size_t                       rows() const;
+    inline std::size_t                       columns() const;
+    inline std::span<const std::string_view> column(std::size_t col) const;
+    inline std::string_view                  field(std::size_t row, std::size_t col) const;
+    inline stringvec                         to_stringvec(std::size_t col) const;
+    inline stringvec                         join_rows(const std::string_view sep) const;
+
+    // Comparison
+    inline bool operator== (const column_table& other) const;
+    inline bool operator!= (const column_table& other) const;
+
+
+private:
+    template <class Pred>
+    inline void keep_rows(std::size_t col, Pred&& keep);
+
+    std::vector<std::vector<std::string_view>> fields;        ///< One array per column, of `rows()` views
+    std::size_t                                row_count = 0;
+    stringview_vec                             storage;       ///< Owner of the viewed bytes, without lines
+};
+
+
+/** -----------------------------------------------------------------------------------------------
+ * @brief Split lines into a table of fields.
+ * @param lines:     Lines to split, one row each. Their storage is shared, not copied.
+ * @param delimiter: String separating the fields of a line.
+ */
+inline column_table::column_table(stringview_vec lines, const std::string_view delimiter) : storage{std::move(lines)}
+{
+    const std::vector<std::string_view>& source = storage.get();
+    row_count = source.size();
+
+    for (std::size_t row = 0; row < row_count; row++)
+    {
+        std::size_t col = 0;
+        stringvec_detail::for_each_token(source[row], delimiter, [this, row, &col](std::string_view token)
+                                                                  {
+                                                                      if (col == fields.size())
+                                                                      {
+                                                                          /* A new widest row: earlier rows miss this field. */
+                                                                          fields.emplace_back();
+                                                                          fields.back().reserve(row_count);
+                                                                          fields.back().resize(row);
+                                                                      }
+                                                                      fields[col++].push_back(token);
+                                                                  });
+
+        for (; col < fields.size(); col++)
+        {
+            fields[col].emplace_back();
+        }
+    }
+
+    /* Only the storage is needed from now on. */
+    storage.get().clear();
+    storage.get().shrink_to_fit();
+}
+
+/** -----------------------------------------------------------------------------------------------
+ * @brief Split lines into a table of fields.
+ * @param lines:     Lines to split, one row each. Their characters are copied once into an arena.
+ * @param delimiter: String separating the fields of a line.
+ */
+inline column_table::column_table(const stringvec& lines, const std::string_view delimiter) :
+    column_table{stringview_vec{lines}, delimiter}
+{
+}
+
+/** -----------------------------------------------------------------------------------------------
+ * @brief Keep the rows whose field in a column satisfies a predicate, in one pass per column.
+ */
+template <class Pred>
+inline void column_table::keep_rows(std::size_t col, Pred&& keep)
+{
+    std::vector<unsigned char> kept(row_count);
+    const std::string_view*    field = col < fields.size() ? fields[col].data() : nullptr;
+    for (std::size_t row = 0; row < row_count; row++)
+    {
+        kept[row] = static_cast<bool>(keep(field != nullptr ? field[row] : std::string_view{}));
+    }
+
+    for (std::vector<std::string_view>& values : fields)
+    {
+        std::size_t count = 0;
+        for (std::size_t row = 0; row < row_count; row++)
+        {
+            if (kept[row])
+            {
+                values[count++] = values[row];
+            }
+        }
+        values.resize(count);
+    }
+    row_count = static_cast<std::size_t>(std::count(kept.begin(), kept.end(), 1));
+}
+
+/** -----------------------------------------------------------------------------------------------
+ * @brief Remove the rows whose field in a column satisfies a predicate.
+ * @param col:  Column the predicate is tested on.
+ * @param func: Predicate, called once per row with the field.
+ */
+template <std::predicate<const std::string_view> Pred>
+inline column_table& column_table::filter_remove(std::size_t col, Pred&& func) &
+{
+    keep_rows(col, [&func](const std::string_view s)
+                   {
+                       return !func(s);
+                   });
+
+    return *this;
+}
+
+/** -----------------------------------------------------------------------------------------------
+ * @brief Keep only the rows whose field in a column satisfies a predicate.
+ * @param col:  Column the predicate is tested on.
+ * @param func: Predicate, called once per row with the field.
+ */
+template <std::predicate<const std::string_view> Pred>
+inline column_table& column_table::filter_keep(std::size_t col, Pred&& func) &
+{
+    keep_rows(col, func);
+
+    return *this;
+}
+
+/** -----------------------------------------------------------------------------------------------
+ * @brief Remove the rows whose field in a column matches a regex.
+ * @param col:   Column the regex is matched against.
+ * @param regex: Regular Expression the whole field must match.
+ */
+inline column_table& column_table::filter_remove(std::size_t col, const std::string& regex) &
+{
+    try
+    {
+        filter_remove(col, regex_cache::global().get(regex));
+    }
+    catch (const std::regex_error& e)
+    {
+        std::cerr << "Error: Invalid regex pattern '" << regex << "'. "
+                  << "Details: " << e.what() << std::endl;
+    }
+
+    return *this;
+}
+
+/** -----------------------------------------------------------------------------------------------
+ * @brief Remove the rows whose field in a column matches a precompiled regex.
+ * @param col:   Column the regex is matched against.
+ * @param regex: Precompiled Regular Expression the whole field must match.
+ */
+inline column_table& column_table::filter_remove(std::size_t col, const regex_handle& regex) &
+{
+    return filter_remove(col, [&regex](const std::string_view s)
+                              {
+                                  return regex->match(s);
+                              });
+}
+
+/** -----------------------------------------------------------------------------------------------
+ * @brief Keep only the rows whose field in a column matches a regex.
+ * @param col:   Column the regex is matched against.
+ * @param regex: Regular Expression the whole field must match.
+ */
+inline column_table& column_table::filter_keep(std::size_t col, const std::string& regex) &
+{
+    try
+    {
+        filter_keep(col, regex_cache::global().get(regex));
+    }
+    catch (const std::regex_error& e)
+    {
+        std::cerr << "Error: Invalid regex pattern '" << regex << "'. "
+                  << "Details: " << e.what() << std::endl;
+    }
+
+    return *this;
+}
+
+/** -----------------------------------------------------------------------------------------------
+ * @brief Keep only the rows whose field in a column matches a precompiled regex.
+ * @param col:   Column the regex is matched against.
+ * @param regex: Precompiled Regular Expression the whole field must match.
+ */
+inline column_table& column_table::filter_keep(std::size_t col, const regex_handle& regex) &
+{
+    return filter_keep(col, [&regex](const std::string_view s)
+                            {
+                                return regex->match(s);
+                            });
+}
+
+/** -----------------------------------------------------------------------------------------------
+ * @brief Sort the rows alphabetically on the field of a column, keeping the order of ties.
+ * @param col: Column to sort on.
+ */
+inline column_table& column_table::sort_by(std::size_t col) &
+{
+    return sort_by(col, std::less<std::string_view>{});
+}
+
+/** -----------------------------------------------------------------------------------------------
+ * @brief Sort the rows on the field of a column, keeping the order of ties.
+ * @param col:  Column to sort on.
+ * @param func: Comparison function of two fields.
+ *
+ * @details Only the sorted column is read while sorting, the rows are then moved in one pass
+ *          per column.
+ */
+inline column_table& column_table::sort_by(std::size_t col, const std::function<bool(const std::string_view,
+                                                                                     const std::string_view)> func) &
+{
+    if (col >= fields.size() || row_count < 2)
+    {
+        return *this;
+    }
+
+    const std::vector<std::string_view>& keys = fields[col];
+    std::vector<std::size_t>             permutation(row_count);
+    std::iota(permutation.begin(), permutation.end(), std::size_t{0});
+    std::stable_sort(permutation.begin(), permutation.end(), [&keys, &func](std::size_t a, std::size_t b)
+                                                             {
+                                                                 return func(keys[a], keys[b]);
+                                                             });
+
+    std::vector<std::string_view> sorted(row_count);
+    for (std::vector<std::string_view>& values : fields)
+    {
+        for (std::size_t row = 0; row < row_count; row++)
+        {
+            sorted[row] = values[permutation[row]];
+        }
+        values.swap(sorted);
+    }
+
+    return *this;
+}
+
+/** -----------------------------------------------------------------------------------------------
+ * @brief Keep only some columns, in a given order.
+ * @param cols: Columns to keep. They can be repeated, and columns past the widest row are empty.
+ */
+inline column_table& column_table::select(std::span<const std::size_t> cols) &
+{
+    std::vector<std::vector<std::string_view>> selected;
+    selected.reserve(cols.size());
+    for (const std::size_t col : cols)
+    {
+        selected.push_back(col < fields.size() ? fields[col] : std::vector<std::string_view>(row_count));
+    }
+    fields = std::move(selected);
+
+    return *this;
+}
+
+/** -----------------------------------------------------------------------------------------------
+ * @brief Keep only some columns, in a given order.
+ * @param cols: Columns to keep. They can be repeated, and columns past the widest row are empty.
+ */
+inline column_table& column_table::select(std::initializer_list<std::size_t> cols) &
+{
+    return select(std::span<const std::size_t>{cols.begin(), cols.size()});
+}
+
+/** -----------------------------------------------------------------------------------------------
+ * @brief Get the number of rows.
+ */
+inline std::size_t column_table::rows() const
+{
+    return row_count;
+}
+
+/** -----------------------------------------------------------------------------------------------
+ * @brief Get the number of columns, the number of fields of the widest row or the selection.
+ */
+inline std::size_t column_table::columns() const
+{
+    return fields.size();
+}
+
+/** -----------------------------------------------------------------------------------------------
+ * @brief Get the fields of a column, one per row.
+ * @param col: Column to get.
+ *
+ * @throws std::out_of_range if `col` is not less than `columns()`.
+ */
+inline std::span<const std::string_view> column_table::column(std::size_t col) const
+{
+    if (col >= fields.size())
+    {
+        throw std::out_of_range("Column " + std::to_string(col) + " out of " + std::to_string(fields.size()));
+    }
+
+    return fields[col];
+}
+
+/** -----------------------------------------------------------------------------------------------
+ * @brief Get a field. No bounds checking is done on the row.
+ * @param row: Row of the field.
+ * @param col: Column of the field. Empty past the widest row.
+ */
+inline std::string_view column_table::field(std::size_t row, std::size_t col) const
+{
+    return col < fields.size() ? fields[col][row] : std::string_view{};
+}
+
+/** -----------------------------------------------------------------------------------------------
+ * @brief Copy the fields of a column to a vector of strings.
+ * @param col: Column to copy. Past the widest row, it is made of empty strings.
+ */
+inline stringvec column_table::to_stringvec(std::size_t col) const
+{
+    std::vector<std::string> values;
+    values.reserve(row_count);
+    for (std::size_t row = 0; row < row_count; row++)
+    {
+        values.emplace_back(field(row, col));
+    }
+
+    return stringvec{std::move(values)};
+}
+
+/** -----------------------------------------------------------------------------------------------
+ * @brief Join the fields of each row back into lines.
+ * @param sep: Separator written between the fields of a row.
+ */
+inline stringvec column_table::join_rows(const std::string_view sep) const
+{
+    std::vector<std::string> lines(row_count);
+    for (std::size_t row = 0; row < row_count; row++)
+    {
+        std::size_t length = fields.empty() ? 0 : sep.size() * (fields.size() - 1);
+        for (const std::vector<std::string_view>& values : fields)
+        {
+            length += values[row].size();
+        }
+
+        std::string& line = lines[row];
+        line.reserve(length);
+        for (std::size_t col = 0; col < fields.size(); col++)
+        {
+            if (col != 0)
+            {
+                line += sep;
+            }
+            line += fields[col][row];
+        }
+    }
+
+    return stringvec{std::move(lines)};
+}
+
+/** -----------------------------------------------------------------------------------------------
+ * @brief Compare the fields of two tables, wherever they are stored.
+ */
+inline bool column_table::operator==(const column_table& other) const
+{
+    return row_count == other.row_count && fields == other.fields;
+}
+
+inline bool column_table::operator!=(const column_table& other) const
+{
+    return !(*this == other);
+}
+
+template <std::predicate<const std::string_view> Pred>
+inline column_table&& column_table::filter_remove(std::size_t col, Pred&& func) &&
+{
+    return std::move(filter_remove(col, std::forward<Pred>(func)));
+}
+
+template <std::predicate<const std::string_view> Pred>
+inline column_table&& column_table::filter_keep(std::size_t col, Pred&& func) &&
+{
+    return std::move(filter_keep(col, std::forward<Pred>(func)));
+}
+
+inline column_table&& column_table::filter_remove(std::size_t col, const std::string& regex) &&
+{
+    return std::move(filter_remove(col, regex));
+}
+
+inline column_table&& column_table::filter_remove(std::size_t col, const regex_handle& regex) &&
+{
+    return std::move(filter_remove(col, regex));
+}
+
+inline column_table&& column_table::filter_keep(std::size_t col, const std::string& regex) &&
+{
+    return std::move(filter_keep(col, regex));
+}
+
+inline column_table&& column_table::filter_keep(std::size_t col, const regex_handle& regex) &&
+{
+    return std::move(filter_keep(col, regex));
+}
+
+inline column_table&& column_table::sort_by(std::size_t col) &&
+{
+    return std::move(sort_by(col));
+}
+
+inline column_table&& column_table::sort_by(std::size_t col, const std::function<bool(const std::string_view,
+                                                                                      const std::string_view)> func) &&
+{
+    return std::move(sort_by(col, func));
+}
+
+inline column_table&& column_table::select(std::span<const std::size_t> cols) &&
+{
+    return std::move(select(cols));
+}
+
+inline column_table&& column_table::select(std::initializer_list<std::size_t> cols) &&
+{
+    return std::move(select(cols));
+}
+
+/** -----------------------------------------------------------------------------------------------
+ * @brief Split every string into fields, as a table with one row per string.
+ * @param delimiter: String separating the fields of a string.
+ *
+ * @details Unlike `split`, the line structure is kept. The characters are copied once into the
+ *          table, see `column_table`.
+ */
+inline column_table stringvec::split_columns(const std::string_view delimiter) const
+{
+    return column_table{*this, delimiter};
+}
+
+/** -----------------------------------------------------------------------------------------------
+ * @brief Split every view into fields, as a table with one row per view.
+ * @param delimiter: String separating the fields of a view.
+ *
+ * @details The table shares the storage of the views, no character is copied.
+ */
+inline column_table stringview_vec::split_columns(const std::string_view delimiter) const
+{
+    return column_table{*this, delimiter};
+}
+
+/**
+ * @}
+ */
+
+
+
+/** ===============================================================================================
+ *  LAZY PIPELINE
+ *
+ * @defgroup STRINGVEC_LAZY_PIPELINE            Lazy Pipeline
+ * @{
+ */
+
+namespace stringvec_detail
+{
+
+/** -----------------------------------------------------------------------------------------------
+ * @brief Call a function on a view, or on a copy of it if the function needs a `std::string`.
+ */
+template <class Func>
+inline decltype(auto) invoke_on_view(Func& func, const std::string_view s)
+{
+    if constexpr (std::invocable<Func&, std::string_view>)
+    {
+        return std::invoke(func, s);
+    }
+    else
+    {
+        return std::invoke(func, std::string{s});
+    }
+}
+
+/** -----------------------------------------------------------------------------------------------
+ * @brief Compile a regex for a lazy stage, or return an empty handle if it is invalid.
+ */
+inline regex_handle lazy_regex(const std::string& regex)
+{
+    try
+    {
+        return regex_cache::global().get(regex);
+    }
+    catch (const std::regex_error& e)
+    {
+        std::cerr << "Error: Invalid regex pattern '" << regex << "'. "
+                  << "Details: " << e.what() << std::endl;
+        return nullptr;
+    }
+}
+
+}        // namespace stringvec_detail
+
+/** -----------------------------------------------------------------------------------------------
+ * @class   lazy_pipeline
+ *
+ * @brief   Sequence of `stringvec` operations fused into a single pass over a vector.
+ *
+ * @details Each stage is a function object taking a string and the rest of the pipeline, which it
+ *          calls for every string it lets through. Appending a stage returns a new pipeline type,
+ *          so the whole chain is inlined into one loop over the source: strings are filtered,
+ *          transformed and split as they are read, and only the strings reaching the end are
+ *          copied, into a new vector or straight to a file. Nothing happens until `collect`,
+ *          `write_to` or `for_each` is called.
+ *
+ *          The pipeline refers to the vector it was created from, which must outlive it. The
+ *          stages have the same names and results as the `stringvec` methods, including an
+ *          invalid regex leaving the strings unchanged.
+ *
+ * @example
+ *      sv.pipeline()
+ *        .split()
+ *        .filter_remove(".*[Aa]pple.*")
+ *        .filter_keep(".*berry")
+ *        .write_to("output.txt");
+ */
+template <class Container, class... Stages>
+class lazy_pipeline
+{
+public:
+    inline explicit lazy_pipeline(const Container& source, std::tuple<Stages...> stages = {});
+
+    // Stages
+    template <class Stage>
+    inline lazy_pipeline<Container, Stages..., std::decay_t<Stage>> stage(Stage&& func) const;
+
+    template <std::predicate<const std::string&> Pred>
+    inline auto filter_remove(Pred&& func) const;
+    inline auto filter_remove(const std::string& regex) const;
+    inline auto filter_remove(const regex_handle& regex) const;
+    template <std::predicate<const std::string&> Pred>
+    inline auto filter_keep(Pred&& func) const;
+    inline auto filter_keep(const std::string& regex) const;
+    inline auto filter_keep(const regex_handle& regex) const;
+    inline auto filter_empty(bool keep_whitespace = false) const;
+    inline auto remove_first(std::size_t count = 1) const;
+
+    template <class Func>
+    inline auto transform(Func&& func) const;
+    inline auto trim() const;
+    inline auto split(const std::string_view delimiter = " ") const;
+    inline auto split_any(const std::string_view delimiters) const;
+
+    // Execution
+    template <class Sink>
+    inline void      for_each(Sink&& sink) const;
+    inline stringvec collect() const;
+    inline void      write_to(const std::string&     path,
+                              const std::string_view sep     = "\n",
+                              const write_options&   options = {}) const;
+
+private:
+    template <std::size_t I, class Sink>
+    static inline void push(std::tuple<Stages...>& run_stages, const std::string_view s, Sink& sink);
+
+    const Container*      source;
+    std::tuple<Stages...> stages;
+};
+
+/** -----------------------------------------------------------------------------------------------
+ * @brief Create a pipeline reading from a vector.
+ * @param source: Vector of strings or views to read, which must outlive the pipeline.
+ * @param stages: Stages already appended.
+ */
+template <class Container, class... Stages>
+inline lazy_pipeline<Container, Stages...>::lazy_pipeline(const Container& source, std::tuple<Stages...> stages)
+    : source{&source}, stages{std::move(stages)}
+{
+}
+
+/** -----------------------------------------------------------------------------------------------
+ * @brief Append a custom stage.
+ * @param func: Function called as `func(s, next)` for each string `s`, calling
+ *              `next(std::string_view)` for every string it passes on, any number of times.
+ */
+template <class Container, class... Stages>
+template <class Stage>
+inline lazy_pipeline<Container, Stages..., std::decay_t<Stage>>
+lazy_pipeline<Container, Stages...>::stage(Stage&& func) const
+{
+    return lazy_pipeline<Container, Stages..., std::decay_t<Stage>>{
+      *source, std::tuple_cat(stages, std::make_tuple(std::forward<Stage>(func)))};
+}
+
+/** -----------------------------------------------------------------------------------------------
+ * @brief Append a stage dropping the strings matching a predicate.
+ */
+template <class Container, class... Stages>
+template <std::predicate<const std::string&> Pred>
+inline auto lazy_pipeline<Container, Stages...>::filter_remove(Pred&& func) const
+{
+    return stage([func = std::forward<Pred>(func)](const std::string_view s, auto& next) mutable
+                 {
+                     if (!stringvec_detail::invoke_on_view(func, s))
+                     {
+                         next(s);
+                     }
+                 });
+}
+
+template <class Container, class... Stages>
+inline auto lazy_pipeline<Container, Stages...>::filter_remove(const std::string& regex) const
+{
+    return filter_remove(stringvec_detail::lazy_regex(regex));
+}
+
+template <class Container, class... Stages>
+inline auto lazy_pipeline<Container, Stages...>::filter_remove(const regex_handle& regex) const
+{
+    return stage([regex](const std::string_view s, auto& next)
+                 {
+                     if (!regex || !regex->match(s))
+                     {
+                         next(s);
+                     }
+                 });
+}
+
+/** -----------------------------------------------------------------------------------------------
+ * @brief Append a stage keeping only the strings matching a predicate.
+ */
+template <class Container, class... Stages>
+template <std::predicate<const std::string&> Pred>
+inline auto lazy_pipeline<Container, Stages...>::filter_keep(Pred&& func) const
+{
+    return stage([func = std::forward<Pred>(func)](const std::string_view s, auto& next) mutable
+                 {
+                     if (stringvec_detail::invoke_on_view(func, s))
+                     {
+                         next(s);
+                     }
+                 });
+}
+
+template <class Container, class... Stages>
+inline auto lazy_pipeline<Container, Stages...>::filter_keep(const std::string& regex) const
+{
+    return filter_keep(stringvec_detail::lazy_regex(regex));
+}
+
+template <class Container, class... Stages>
+inline auto lazy_pipeline<Container, Stages...>::filter_keep(const regex_handle& regex) const
+{
+    return stage([regex](const std::string_view s, auto& next)
+                 {
+                     if (!regex || regex->match(s))
+                     {
+                         next(s);
+                     }
+                 });
+}
+
+/** -----------------------------------------------------------------------------------------------
+ * @brief Append a stage dropping the empty strings, and the blank ones unless `keep_whitespace`.
+ */
+template <class Container, class... Stages>
+inline auto lazy_pipeline<Container, Stages...>::filter_empty(bool keep_whitespace) const
+{
+    return stage([keep_whitespace](const std::string_view s, auto& next)
+                 {
+                     if (keep_whitespace ? !s.empty() : !stringvec_detail::is_blank(s))
+                     {
+                         next(s);
+                     }
+                 });
+}
+
+/** -----------------------------------------------------------------------------------------------
+ * @brief Append a stage dropping the first strings reaching it during a run.
+ * @param count: Number of strings to drop.
+ */
+template <class Container, class... Stages>
+inline auto lazy_pipeline<Container, Stages...>::remove_first(std::size_t count) const
+{
+    return stage([remaining = count](const std::string_view s, auto& next) mutable
+                 {
+                     if (remaining != 0)
+                     {
+                         remaining--;
+                         return;
+                     }
+                     next(s);
+                 });
+}
+
+/** -----------------------------------------------------------------------------------------------
+ * @brief Append a stage replacing each string by the result of a function.
+ * @param func: Function taking a `std::string_view` or a `std::string` and returning a string.
+ */
+template <class Container, class... Stages>
+template <class Func>
+inline auto lazy_pipeline<Container, Stages...>::transform(Func&& func) const
+{
+    return stage([func = std::forward<Func>(func)](const std::string_view s, auto& next) mutable
+                 {
+                     const std::string result = stringvec_detail::invoke_on_view(func, s);
+                     next(std::string_view{result});
+                 });
+}
+
+/** -----------------------------------------------------------------------------------------------
+ * @brief Append a stage removing the leading and trailing whitespace of each string.
+ */
+template <class Container, class... Stages>
+inline auto lazy_pipeline<Container, Stages...>::trim() const
+{
+    return stage([](const std::string_view s, auto& next)
+                 {
+                     next(stringvec_detail::trim_view(s));
+                 });
+}
+
+/** -----------------------------------------------------------------------------------------------
+ * @brief Append a stage splitting each string on a delimiter, as `stringvec::split` does.
+ */
+template <class Container, class... Stages>
+inline auto lazy_pipeline<Container, Stages...>::split(const std::string_view delimiter) const
+{
+    return stage([delimiter = std::string{delimiter}](const std::string_view s, auto& next)
+                 {
+                     stringvec_detail::for_each_token(s, std::string_view{delimiter}, next);
+                 });
+}
+
+/** -----------------------------------------------------------------------------------------------
+ * @brief Append a stage splitting each string on any of a set of characters, as
+ *        `stringvec::split_any` does.
+ */
+template <class Container, class... Stages>
+inline auto lazy_pipeline<Container, Stages...>::split_any(const std::string_view delimiters) const
+{
+    return stage([delimiters = stringvec_detail::delimiter_set{delimiters}](const std::string_view s, auto& next)
+                 {
+                     stringvec_detail::for_each_token(s, delimiters, next);
+                 });
+}
+
+/** -----------------------------------------------------------------------------------------------
+ * @brief Run the pipeline, calling a function with each resulting string.
+ * @param sink: Function taking a `std::string_view`, valid only during the call.
+ */
+template <class Container, class... Stages>
+template <class Sink>
+inline void lazy_pipeline<Container, Stages...>::for_each(Sink&& sink) const
+{
+    /* Stages holding a state, such as a counter, start afresh on every run. */
+    std::tuple<Stages...> run_stages = stages;
+    for (const std::string_view s : *source)
+    {
+        push<0>(run_stages, s, sink);
+    }
+}
+
+/** -----------------------------------------------------------------------------------------------
+ * @brief Run the pipeline, gathering the resulting strings into a new vector.
+ */
+template <class Container, class... Stages>
+inline stringvec lazy_pipeline<Container, Stages...>::collect() const
+{
+    std::vector<std::string> result;
+    if constexpr (sizeof...(Stages) == 0)
+    {
+        result.reserve(source->size());
+    }
+
+    for_each([&result](const std::string_view s)
+             {
+                 result.emplace_back(s);
+             });
+
+    return stringvec{std::move(result)};
+}
+
+/** -----------------------------------------------------------------------------------------------
+ * @brief Run the pipeline, writing the resulting strings to a file as `stringvec::write_file` does.
+ * @param path:    File to write the strings to. A `.gz`, `.zst` or `.lz4` extension compresses
+ *                 them, unless `options.codec` says otherwise.
+ * @param sep:     Separator written between the strings.
+ * @param options: Codec, buffer size, direct I/O and `fdatasync`, see `write_options`.
+ */
+template <class Container, class... Stages>
+inline void lazy_pipeline<Container, Stages...>::write_to(const std::string&     path,
+                                                          const std::string_view sep,
+                                                          const write_options&   options) const
+{
+    const auto write_all = [this, sep](auto& output)
+    {
+        bool first = true;
+        for_each([&output, &first, sep](const std::string_view s)
+                 {
+                     if (!first)
+                     {
+                         output.write(sep);
+                     }
+                     output.write(s);
+                     first = false;
+                 });
+        output.close();
+    };
+
+    const compression codec = stringvec_detail::compression_of_path(path, options.codec);
+    if (codec != compression::none)
+    {
+        stringvec_detail::compressed_writer output{path, codec, options};
+        write_all(output);
+        return;
+    }
+
+    file_writer output{path, options};
+    write_all(output);
+}
+
+/** -----------------------------------------------------------------------------------------------
+ * @brief Hand a string to stage `I`, or to the sink once every stage has let it through.
+ */
+template <class Container, class... Stages>
+template <std::size_t I, class Sink>
+inline void lazy_pipeline<Container, Stages...>::push(std::tuple<Stages...>& run_stages,
+                                                      const std::string_view s,
+                                                      Sink&                  sink)
+{
+    if constexpr (I == sizeof...(Stages))
+    {
+        sink(s);
+    }
+    else
+    {
+        auto next = [&run_stages, &sink](const std::string_view out)
+                    {
+                        push<I + 1>(run_stages, out, sink);
+                    };
+        std::get<I>(run_stages)(s, next);
+    }
+}
+
+/** -----------------------------------------------------------------------------------------------
+ * @brief Create a lazy pipeline over the strings of the vector, see `lazy_pipeline`.
+ */
+inline lazy_pipeline<std::vector<std::string>> stringvec::pipeline() const
+{
+    return lazy_pipeline<std::vector<std::string>>{vec};
+}
+
+/** -----------------------------------------------------------------------------------------------
+ * @brief Create a lazy pipeline over the views of the vector, see `lazy_pipeline`.
+ */
+inline lazy_pipeline<std::vector<std::string_view>> stringview_vec::pipeline() const
+{
+    return lazy_pipeline<std::vector<std::string_view>>{vec};
+}
+
+/**
+ * @}
+ */
+
+
+
+
+/** ===============================================================================================
+ *  ASYNCHRONOUS INPUT / OUTPUT
+ *
+ * @defgroup STRINGVEC_ASYNC_IO                 Asynchronous Input / Output
+ * @{
+ */
+
+namespace stringvec_detail
+{
+
+#if STRINGVEC_HAS_MMAP
+/** -----------------------------------------------------------------------------------------------
+ * @class   async_io
+ *
+ * @brief   Queue of positioned reads and writes, completed in the background.
+ *
+ * @details Operations are identified by a tag chosen by the caller, and `wait` returns the number
+ *          of bytes transferred. On Linux, they go through an io_uring: queued operations are
+ *          submitted together on the next `wait`, in a single system call. Where io_uring is not
+ *          available, or the kernel refuses to create one, each operation runs on a thread of its
+ *          own. In both cases, at most `depth` operations are in flight at once.
+ */
+class async_io
+{
+public:
+    inline explicit async_io(unsigned depth = 64);
+    inline ~async_io();
+
+    async_io(const async_io&)            = delete;
+    async_io& operator=(const async_io&) = delete;
+
+    inline void        read(int fd, char* buffer, std::size_t size, std::uint64_t offset, std::uint64_t tag);
+    inline void        write(int fd, const char* buffer, std::size_t size, std::uint64_t offset, std::uint64_t tag);
+    inline std::size_t wait(std::uint64_t tag);
+
+private:
+    inline void queue(bool write, int fd, const char* buffer, std::size_t size, std::uint64_t offset, std::uint64_t tag);
+    inline void reap_one();
+    inline void wait_all() noexcept;
+
+    unsigned                                         limit;
+    std::size_t                                      in_flight = 0;
+    std::unordered_map<std::uint64_t, std::int64_t>  results;
+
+    /* Thread fallback. */
+    std::deque<std::pair<std::uint64_t, std::future<std::int64_t>>> jobs;
+
+#if STRINGVEC_HAS_IO_URING
+    inline bool ring_setup(unsigned entries);
+    inline void ring_enter(unsigned wait_for);
+    inline void ring_reap();
+
+    int                ring = -1;
+    void*              sq_map = nullptr;
+    void*              cq_map = nullptr;
+    std::size_t        sq_map_size = 0;
+    std::size_t        cq_map_size = 0;
+    io_uring_sqe*      sqes = nullptr;
+    std::size_t        sqes_size = 0;
+    unsigned*          sq_head = nullptr;
+    unsigned*          sq_tail = nullptr;
+    unsigned*          sq_array = nullptr;
+    unsigned           sq_mask = 0;
+    unsigned           sq_entries = 0;
+    unsigned*          cq_head = nullptr;
+    unsigned*          cq_tail = nullptr;
+    io_uring_cqe*      cqes = nullptr;
+    unsigned           cq_mask = 0;
+    unsigned           pending = 0;
+#endif
+};
+
+/** -----------------------------------------------------------------------------------------------
+ * @brief Create a queue.
+ * @param depth: Maximum number of operations in flight.
+ */
+inline async_io::async_io(unsigned depth) : limit{std::max(depth, 1u)}
+{
+#if STRINGVEC_HAS_IO_URING
+    ring_setup(limit);
+#endif
+}
+
+/** -----------------------------------------------------------------------------------------------
+ * @brief Wait for the operations in flight, which may still use their buffers, and release the
+ *        queue.
+ */
+inline async_io::~async_io()
+{
+    wait_all();
+
+#if STRINGVEC_HAS_IO_URING
+    if (ring >= 0)
+    {
+        ::munmap(sqes, sqes_size);
+        if (cq_map != sq_map)
+        {
+            ::munmap(cq_map, cq_map_size);
+        }
+        ::munmap(sq_map, sq_map_size);
+        ::close(ring);
+    }
+#endif
+}
+
+/** -----------------------------------------------------------------------------------------------
+ * @brief Queue a read of `size` bytes at `offset` into `buffer`, which must stay valid until the
+ *        operation is waited for.
+ */
+inline void async_io::read(int fd, char* buffer, std::size_t size, std::uint64_t offset, std::uint64_t tag)
+{
+    queue(false, fd, buffer, size, offset, tag);
+}
+
+/** -----------------------------------------------------------------------------------------------
+ * @brief Queue a write of `size` bytes at `offset` from `buffer`, which must stay valid until the
+ *        operation is waited for.
+ */
+inline void async_io::write(int fd, const char* buffer, std::size_t size, std::uint64_t offset, std::uint64_t tag)
+{
+    queue(true, fd, buffer, size, offset, tag);
+}
+
+/** -----------------------------------------------------------------------------------------------
+ * @brief Wait for an operation to complete.
+ * @param tag: Tag the operation was queued with.
+ * @return Number of bytes transferred, which is less than requested at the end of a file.
+ *
+ * @throws std::system_error if the operation failed.
+ */
+inline std::size_t async_io::wait(std::uint64_t tag)
+{
+    while (true)
+    {
+        if (auto it = results.find(tag); it != results.end())
+        {
+            const std::int64_t result = it->second;
+            results.erase(it);
+            if (result < 0)
+            {
+                throw std::system_error(static_cast<int>(-result), std::generic_category());
+            }
+            return static_cast<std::size_t>(result);
+        }
+        reap_one();
+    }
+}
+
+inline void async_io::queue(bool write, int fd, const char* buffer, std::size_t size, std::uint64_t offset, std::uint64_t tag)
+{
+    /* Bound the number of operations in flight, and of completions not yet looked at. */
+    while (in_flight >= limit)
+    {
+        reap_one();
+    }
+    in_flight++;
+
+#if STRINGVEC_HAS_IO_URING
+    if (ring >= 0)
+    {
+        const unsigned tail  = *sq_tail;
+        const unsigned index = tail & sq_mask;
+        io_uring_sqe&  sqe   = sqes[index];
+        std::memset(&sqe, 0, sizeof(sqe));
+        sqe.opcode    = write ? IORING_OP_WRITE : IORING_OP_READ;
+        sqe.fd        = fd;
+        sqe.addr      = reinterpret_cast<std::uint64_t>(buffer);
+        sqe.len       = static_cast<unsigned>(std::min<std::size_t>(size, 1u << 30));
+        sqe.off       = offset;
+        sqe.user_data = tag;
+        sq_array[index] = index;
+        std::atomic_ref<unsigned>{*sq_tail}.store(tail + 1, std::memory_order_release);
+        pending++;
+        return;
+    }
+#endif
+
+    jobs.emplace_back(tag, std::async(std::launch::async, [=]()
+                                      {
+                                          const ssize_t done = write ? ::pwrite(fd, buffer, size, static_cast<off_t>(offset))
+                                                                     : ::pread(fd, const_cast<char*>(buffer), size,
+                                                                               static_cast<off_t>(offset));
+                                          return done < 0 ? -static_cast<std::int64_t>(errno)
+                                                          : static_cast<std::int64_t>(done);
+                                      }));
+}
+
+/** -----------------------------------------------------------------------------------------------
+ * @brief Submit the queued operations and collect at least one completion.
+ */
+inline void async_io::reap_one()
+{
+    if (in_flight == 0)
+    {
+        throw std::logic_error("async_io: waiting for an operation that was never queued");
+    }
+
+#if STRINGVEC_HAS_IO_URING
+    if (ring >= 0)
+    {
+        ring_enter(1);
+        ring_reap();
+        return;
+    }
+#endif
+
+    auto& [tag, job] = jobs.front();
+    results[tag]     = job.get();
+    jobs.pop_front();
+    in_flight--;
+}
+
+inline void async_io::wait_all() noexcept
+{
+    try
+    {
+        while (in_flight != 0)
+        {
+            reap_one();
+        }
+    }
+    catch (const std::exception&)
+    {
+    }
+}
+
+#if STRINGVEC_HAS_IO_URING
+/** -----------------------------------------------------------------------------------------------
+ * @brief Create the ring and map its queues, without liburing.
+ * @return False, leaving the thread fallback in use, if the kernel refused.
+ */
+inline bool async_io::ring_setup(unsigned entries)
+{
+    io_uring_params params{};
+    const int       fd = static_cast<int>(::syscall(__NR_io_uring_setup, entries, &params));
+    if (fd < 0)
+    {
+        return false;
+    }
+
+    sq_map_size = params.sq_off.array + params.sq_entries * sizeof(unsigned);
+    cq_map_size = params.cq_off.cqes + params.cq_entries * sizeof(io_uring_cqe);
+    if (params.features & IORING_FEAT_SINGLE_MMAP)
+    {
+        sq_map_size = cq_map_size = std::max(sq_map_size, cq_map_size);
+    }
+
+    sq_map = ::mmap(nullptr, sq_map_size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, fd, IORING_OFF_SQ_RING);
+    if (sq_map == MAP_FAILED)
+    {
+        ::close(fd);
+        return false;
+    }
+
+    cq_map = sq_map;
+    if (!(params.features & IORING_FEAT_SINGLE_MMAP))
+    {
+        cq_map = ::mmap(nullptr, cq_map_size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, fd, IORING_OFF_CQ_RING);
+        if (cq_map == MAP_FAILED)
+        {
+            ::munmap(sq_map, sq_map_size);
+            ::close(fd);
+            return false;
+        }
+    }
+
+    sqes_size   = params.sq_entries * sizeof(io_uring_sqe);
+    void* entry = ::mmap(nullptr, sqes_size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, fd, IORING_OFF_SQES);
+    if (entry == MAP_FAILED)
+    {
+        if (cq_map != sq_map)
+        {
+            ::munmap(cq_map, cq_map_size);
+        }
+        ::munmap(sq_map, sq_map_size);
+        ::close(fd);
+        return false;
+    }
+
+    char* sq = static_cast<char*>(sq_map);
+    char* cq = static_cast<char*>(cq_map);
+    sqes       = static_cast<io_uring_sqe*>(entry);
+    sq_head    = reinterpret_cast<unsigned*>(sq + params.sq_off.head);
+    sq_tail    = reinterpret_cast<unsigned*>(sq + params.sq_off.tail);
+    sq_array   = reinterpret_cast<unsigned*>(sq + params.sq_off.array);
+    sq_mask    = *reinterpret_cast<unsigned*>(sq + params.sq_off.ring_mask);
+    sq_entries = params.sq_entries;
+    cq_head    = reinterpret_cast<unsigned*>(cq + params.cq_off.head);
+    cq_tail    = reinterpret_cast<unsigned*>(cq + params.cq_off.tail);
+    cqes       = reinterpret_cast<io_uring_cqe*>(cq + params.cq_off.cqes);
+    cq_mask    = *reinterpret_cast<unsigned*>(cq + params.cq_off.ring_mask);
+
+    /* The number of operations in flight must fit the submission queue. */
+    limit = std::min(limit, sq_entries);
+    ring  = fd;
+    return true;
+}
+
+/** -----------------------------------------------------------------------------------------------
+ * @brief Submit the queued operations and wait for a number of completions.
+ */
+inline void async_io::ring_enter(unsigned wait_for)
+{
+    while (true)
+    {
+        const long submitted = ::syscall(__NR_io_uring_enter, ring, pending, wait_for, IORING_ENTER_GETEVENTS, nullptr, 0);
+        if (submitted >= 0)
+        {
+            pending -= static_cast<unsigned>(submitted);
+            return;
+        }
+        if (errno != EINTR)
+        {
+            throw std::system_error(errno, std::generic_category(), "io_uring_enter");
+        }
+    }
+}
+
+/** -----------------------------------------------------------------------------------------------
+ * @brief Move every available completion to the results.
+ */
+inline void async_io::ring_reap()
+{
+    unsigned       head = *cq_head;
+    const unsigned tail = std::atomic_ref<unsigned>{*cq_tail}.load(std::memory_order_acquire);
+    for (; head != tail; head++)
+    {
+        const io_uring_cqe& cqe = cqes[head & cq_mask];
+        results[cqe.user_data]  = cqe.res;
+        in_flight--;
+    }
+    std::atomic_ref<unsigned>{*cq_head}.store(head, std::memory_order_release);
+}
+#endif
+
+/** -----------------------------------------------------------------------------------------------
+ * @brief Open file descriptor, closed on destruction.
+ */
+class file_descriptor
+{
+public:
+    inline file_descriptor(const std::string& path, int flags)
+        : fd{::open(path.c_str(), flags | O_CLOEXEC, 0666)}
+    {
+        if (fd < 0)
+        {
+            throw std::runtime_error(((flags & O_WRONLY) ? "Couldn't write to file: " : "Couldn't open file: ") + path);
+        }
+    }
+
+    inline ~file_descriptor()
+    {
+        ::close(fd);
+    }
+
+    file_descriptor(const file_descriptor&)            = delete;
+    file_descriptor& operator=(const file_descriptor&) = delete;
+
+    inline int get() const
+    {
+        return fd;
+    }
+
+    inline std::uint64_t size() const
+    {
+        struct stat st;
+        return ::fstat(fd, &st) == 0 ? static_cast<std::uint64_t>(st.st_size) : 0;
+    }
+
+private:
+    int fd;
+};
+#endif
+
+inline constexpr std::size_t async_chunk_size = std::size_t{4} << 20;
+
+/** -----------------------------------------------------------------------------------------------
+ * @brief Read a file into lines, splitting each chunk while the next one is being read.
+ */
+inline std::vector<std::string> read_lines_overlapped(const std::string& path)
 {
-    std::sort(begin(), end(), func);
+    std::vector<std::string> out;
+#if STRINGVEC_HAS_MMAP
+    const file_descriptor file{path, O_RDONLY};
+
+    /* Compressed files are decompressed as their lines are split instead. */
+    char              head[4] = {};
+    const ::ssize_t   got     = ::pread(file.get(), head, sizeof(head), 0);
+    const compression codec   = compression_of_content({head, got > 0 ? static_cast<std::size_t>(got) : 0});
+    if (codec != compression::none)
+    {
+        const mapped_file map{path};
+        for_each_compressed_line(map.view(), codec, path, [&out](std::string_view line)
+                                                          {
+                                                              out.emplace_back(line);
+                                                          });
+        return out;
+    }
+
+    const std::uint64_t   size       = file.size();
+    std::vector<char>     buffers[2] = {std::vector<char>(async_chunk_size), std::vector<char>(async_chunk_size)};
+    line_splitter         splitter;
+    const auto            emit   = [&out](std::string_view line)
+    {
+        out.emplace_back(line);
+    };
+    std::uint64_t         offset = 0;
+    std::uint64_t         chunk  = 0;
+
+    /* Declared last, so that pending reads are waited for before the buffers are released. */
+    async_io io{2};
+    io.read(file.get(), buffers[0].data(), async_chunk_size, 0, 0);
+    while (true)
+    {
+        const std::size_t got = io.wait(chunk);
+        offset += got;
+
+        /* Read the next chunk into the other buffer while this one is split. */
+        const bool more = got != 0 && offset < size;
+        if (more)
+        {
+            io.read(file.get(), buffers[(chunk + 1) % 2].data(), async_chunk_size, offset, chunk + 1);
+        }
+        const char* data = buffers[chunk % 2].data();
+        splitter.feed(data, data + got, emit);
+
+        if (!more)
+        {
+            break;
+        }
+        chunk++;
+    }
+    splitter.finish(emit);
+#else
+    stringvec lines;
+    lines.read_file(path);
+    out = std::move(lines.get());
+#endif
+    return out;
 }
 
+}        // namespace stringvec_detail
+
 /** -----------------------------------------------------------------------------------------------
- * @brief Sort the vector alphabetically
- * 
- * @details The sort function defaults to using operator<.
- *          The default implementation of std::string provides an alphabetically-compared operator<
+ * @brief Read a file in the background.
+ * @param path: File to read the lines from.
+ * @return Future of the vector, with the same lines as `read_file`, or holding the exception.
+ *
+ * @details The file is read in chunks through `async_io`, and each chunk is split into lines while
+ *          the next one is being read.
  */
-inline void stringvec::sort_alphabetically()
+inline std::future<stringvec> stringvec::read_file_async(std::string path)
 {
-    std::sort(begin(), end());
+    return std::async(std::launch::async, [path = std::move(path)]()
+                      {
+                          return stringvec{stringvec_detail::read_lines_overlapped(path)};
+                      });
 }
 
 /** -----------------------------------------------------------------------------------------------
- * @brief Sort the vector by length of the strings
+ * @brief Read many files in the background, with their reads submitted together.
+ * @param paths: Files to read the lines from.
+ * @return Future of one vector per file, in the same order.
+ *
+ * @details Every file is opened and its first chunk is queued before waiting for any, so that an
+ *          io_uring receives them in a single submission, then each file is split as soon as it
+ *          is complete. This is much faster than one `read_file` at a time for many small files.
+ *          Compressed files are detected and decompressed per file, as with `read_file`.
  */
-inline void stringvec::sort_length()
+inline std::future<std::vector<stringvec>> stringvec::read_files_async(std::vector<std::string> paths)
 {
-    std::sort(begin(), end(), [](const std::string_view a, const std::string_view b)
+    return std::async(std::launch::async, [paths = std::move(paths)]()
+                      {
+                          std::vector<stringvec> result(paths.size());
+#if STRINGVEC_HAS_MMAP
+                          struct pending_file
+                          {
+                              std::unique_ptr<stringvec_detail::file_descriptor> file;
+                              std::uint64_t                                      size = 0;
+                              std::vector<char>                                  data;
+                          };
+
+                          std::vector<pending_file>  files(paths.size());
+                          stringvec_detail::async_io io{64};
+                          for (std::size_t i = 0; i < paths.size(); i++)
+                          {
+                              files[i].file = std::make_unique<stringvec_detail::file_descriptor>(paths[i], O_RDONLY);
+                              files[i].size = files[i].file->size();
+                              files[i].data.resize(std::min<std::uint64_t>(files[i].size, stringvec_detail::async_chunk_size));
+                              io.read(files[i].file->get(), files[i].data.data(), files[i].data.size(), 0, i);
+                          }
+
+                          for (std::size_t i = 0; i < paths.size(); i++)
+                          {
+                              pending_file& f    = files[i];
+                              std::size_t   read = io.wait(i);
+
+                              /* Files larger than a chunk are completed on their own. */
+                              if (read != 0 && read < f.size)
                               {
-                                  return a.length() < b.length();
-                              });
-}
+                                  f.data.resize(f.size);
+                                  while (read < f.size)
+                                  {
+                                      io.read(f.file->get(), f.data.data() + read, f.size - read, read, i);
+                                      const std::size_t got = io.wait(i);
+                                      if (got == 0)
+                                      {
+                                          break;
+                                      }
+                                      read += got;
+                                  }
+                              }
 
+                              const auto emit = [&lines = result[i].vec](std::string_view line)
+                              {
+                                  lines.emplace_back(line);
+                              };
 
-/** -----------------------------------------------------------------------------------------------
- * @brief Find the first element matching the input function.
- * @param func: Function to match in the vector.
- */
-inline stringvec::iter stringvec::find(const std::function<bool(const std::string&)> func)
-{
-    return std::find_if(begin(), end(), func);
+                              /* Compressed files are recognized by their first bytes, as `read_file` does. */
+                              const std::string_view  content{f.data.data(), read};
+                              const compression codec = stringvec_detail::compression_of_content(content.substr(0, 4));
+                              if (codec != compression::none)
+                              {
+                                  stringvec_detail::for_each_compressed_line(content, codec, paths[i], emit);
+                              }
+                              else
+                              {
+                                  stringvec_detail::for_each_line(content.data(), content.data() + content.size(), emit);
+                              }
+                              f = pending_file{};
+                          }
+#else
+                          for (std::size_t i = 0; i < paths.size(); i++)
+                          {
+                              result[i].read_file(paths[i]);
+                          }
+#endif
+                          return result;
+                      });
 }
 
-inline stringvec::citer stringvec::find(const std::function<bool(const std::string&)> func) const
+namespace stringvec_detail
 {
-    return const_cast<stringvec*>(this)->find(func);
-}
 
 /** -----------------------------------------------------------------------------------------------
- * @brief Find the last element matching the input function.
- * @param func: Function to match in the vector.
+ * @brief Write strings separated by a separator, filling one buffer while the other is written.
  */
-inline stringvec::iter stringvec::rfind(const std::function<bool(const std::string&)> func)
+inline void write_strings_overlapped(const std::string&              path,
+                                     const std::vector<std::string>& v,
+                                     const std::string_view          sep,
+                                     const write_options&            options)
 {
-    riter it = std::find_if(vec.rbegin(), vec.rend(), func);
+    /* Compression needs the output of the encoder, not the strings: write it from this thread. */
+    if (compression_of_path(path, options.codec) != compression::none)
+    {
+        write_strings(path, v, sep, options);
+        return;
+    }
 
-    // https://stackoverflow.com/q/4407985
-    if (it != vec.crend())
+#if STRINGVEC_HAS_MMAP
+    const file_descriptor file{path, O_WRONLY | O_CREAT | O_TRUNC};
+
+    const std::size_t capacity   = std::max<std::size_t>(options.buffer_size, 4096);
+    std::string       buffers[2] = {std::string(capacity, '\0'), std::string(capacity, '\0')};
+    std::size_t       sizes[2]   = {0, 0};
+    std::size_t       used       = 0;
+    std::uint64_t     offset     = 0;
+    std::uint64_t     chunk      = 0;
+    async_io          io{2};
+
+    /* A short write, such as on a full disk, is completed synchronously to get its error. */
+    auto complete = [&](std::uint64_t done, std::uint64_t at)
+                    {
+                        const char* data    = buffers[done % 2].data();
+                        std::size_t written = io.wait(done);
+                        while (written < sizes[done % 2])
+                        {
+                            const ssize_t more = ::pwrite(file.get(), data + written, sizes[done % 2] - written,
+                                                          static_cast<off_t>(at + written));
+                            if (more <= 0)
+                            {
+                                throw std::runtime_error("Couldn't write to file: " + path);
+                            }
+                            written += static_cast<std::size_t>(more);
+                        }
+                    };
+
+    /* The buffer of a chunk is refilled two chunks later, once its write completed. */
+    std::uint64_t offsets[2] = {0, 0};
+    auto          submit     = [&]()
+                               {
+                                   sizes[chunk % 2]   = used;
+                                   offsets[chunk % 2] = offset;
+                                   io.write(file.get(), buffers[chunk % 2].data(), used, offset, chunk);
+                                   offset += used;
+                                   used    = 0;
+                                   chunk++;
+                                   if (chunk >= 2)
+                                   {
+                                       complete(chunk - 2, offsets[chunk % 2]);
+                                   }
+                               };
+    auto append = [&](std::string_view s)
+                  {
+                      while (!s.empty())
+                      {
+                          const std::size_t count = std::min(s.size(), capacity - used);
+                          std::memcpy(buffers[chunk % 2].data() + used, s.data(), count);
+                          used += count;
+                          s.remove_prefix(count);
+                          if (used == capacity)
+                          {
+                              submit();
+                          }
+                      }
+                  };
+
+    for (std::size_t i = 0; i < v.size(); i++)
     {
-        return iter{--(it.base())};
+        if (i != 0)
+        {
+            append(sep);
+        }
+        append(v[i]);
     }
-    else
+    if (used != 0)
     {
-        return vec.end();
+        submit();
+    }
+    if (chunk >= 1)
+    {
+        complete(chunk - 1, offsets[(chunk - 1) % 2]);
     }
-}
 
-inline stringvec::citer stringvec::rfind(const std::function<bool(const std::string&)> func) const
-{
-    return const_cast<stringvec*>(this)->rfind(func);
+    if (options.sync && ::fdatasync(file.get()) != 0)
+    {
+        throw std::runtime_error("Couldn't write to file: " + path);
+    }
+#else
+    write_strings(path, v, sep, options);
+#endif
 }
 
+}        // namespace stringvec_detail
+
 /** -----------------------------------------------------------------------------------------------
- * @brief Find the first element matching the input string.
- * @param s: String to find in the vector.
+ * @brief Write the vector to a file in the background, as `write_file` does.
+ * @param path:    File to write the strings to.
+ * @param sep:     Separator string between the strings.
+ * @param options: Buffer size and `fdatasync`, see `write_options`. Direct I/O is not used.
+ * @return Future completed once the file is written, or holding the exception.
+ *
+ * @details The vector must outlive the future and stay unchanged until then; move it into the
+ *          call otherwise. One buffer is written while the next one is filled.
  */
-inline stringvec::iter stringvec::find(const std::string_view s)
+inline std::future<void> stringvec::write_file_async(std::string path, std::string sep, write_options options) const&
 {
-    return find([s](const std::string_view x){return x == s;});
+    return std::async(std::launch::async, [this, path = std::move(path), sep = std::move(sep), options]()
+                      {
+                          stringvec_detail::write_strings_overlapped(path, vec, sep, options);
+                      });
 }
 
-inline stringvec::citer stringvec::find(const std::string_view s) const
+inline std::future<void> stringvec::write_file_async(std::string path, std::string sep, write_options options) &&
 {
-    return const_cast<stringvec*>(this)->find(s);
+    return std::async(std::launch::async, [strings = std::move(vec), path = std::move(path), sep = std::move(sep), options]()
+                      {
+                          stringvec_detail::write_strings_overlapped(path, strings, sep, options);
+                      });
 }
 
+/**
+ * @}
+ */
+
+
+
+/** ===============================================================================================
+ *  SNAPSHOTS
+ *
+ * @defgroup STRINGVEC_SNAPSHOTS                Snapshots
+ * @{
+ */
+
+namespace stringvec_detail
+{
+
 /** -----------------------------------------------------------------------------------------------
- * @brief Find the last element matching the input string.
- * @param s: String to find in the vector.
+ * @brief   Fixed-size header at the start of a snapshot file.
+ *
+ * @details A snapshot is laid out as:
+ *          - this header;
+ *          - `count + 1` offsets into the blob, as 64-bit integers, the last one being its size;
+ *          - the blob, every string one after the other without separators;
+ *          - padding up to a multiple of 8 bytes;
+ *          - the hash index saved by `flat_index::save`, when `index_slots` is not 0.
+ *
+ *          Integers are stored in the byte order of the machine writing them; `byte_order` lets a
+ *          machine with another byte order reject the file.
  */
-inline stringvec::iter stringvec::rfind(const std::string_view s)
+struct snapshot_header
 {
-    return rfind([s](const std::string_view x){return x == s;});
+    static constexpr std::array<char, 8> expected_magic   = {'S', 'T', 'R', 'V', 'S', 'N', 'A', 'P'};
+    static constexpr std::uint32_t       expected_order   = 0x01020304;
+    static constexpr std::uint32_t       expected_version = 1;
+
+    std::array<char, 8>    magic       = expected_magic;
+    std::uint32_t          byte_order  = expected_order;
+    std::uint32_t          version     = expected_version;
+    std::uint64_t          count       = 0;
+    std::uint64_t          blob_size   = 0;
+    std::uint64_t          index_slots = 0;
+    std::uint64_t          hash_check  = 0;
+    std::uint8_t           order       = 0;
+    std::array<std::uint8_t, 7> reserved    = {};
+};
+
+static_assert(sizeof(snapshot_header) == 56);
+
+/** -----------------------------------------------------------------------------------------------
+ * @brief Get the bytes of an object, to be written as-is.
+ */
+template <class T>
+inline std::string_view bytes_of(const T& value)
+{
+    return {reinterpret_cast<const char*>(&value), sizeof(T)};
 }
 
-inline stringvec::citer stringvec::rfind(const std::string_view s) const
+template <class T>
+inline std::string_view bytes_of(const std::vector<T>& values)
 {
-    return const_cast<stringvec*>(this)->rfind(s);
+    return {reinterpret_cast<const char*>(values.data()), values.size() * sizeof(T)};
 }
 
 /** -----------------------------------------------------------------------------------------------
- * @brief Find the first element matching the input regex.
- * @param regex: Regex to match in the vector.
+ * @brief Write strings to a snapshot file.
+ * @param path:  File to write the snapshot to.
+ * @param v:     Strings to write.
+ * @param order: Sort order to store, as the value of `stringvec::ordering`.
+ * @param index: Hash index of the strings to store, or `nullptr`.
  */
-inline stringvec::iter stringvec::find_reg(const std::string& regex)
+template <class T>
+inline void write_snapshot(const std::string&    path,
+                           const std::vector<T>& v,
+                           std::uint8_t          order,
+                           const flat_index*     index)
 {
-    try
+    std::vector<std::uint64_t> offsets;
+    offsets.reserve(v.size() + 1);
+    offsets.push_back(0);
+    for (const T& s : v)
     {
-        std::regex reg{regex};
+        offsets.push_back(offsets.back() + std::string_view{s}.size());
+    }
 
-        return find([&reg](const std::string& s)
-                    {
-                        return std::regex_match(s, reg);
-                    });
+    std::vector<std::uint64_t> saved_index;
+    if (index != nullptr)
+    {
+        index->save(saved_index);
     }
-    catch (const std::regex_error& e)
+
+    snapshot_header header;
+    header.count       = v.size();
+    header.blob_size   = offsets.back();
+    header.index_slots = saved_index.empty() ? 0 : (saved_index.size() - 1) / 3;
+    header.hash_check  = flat_index::hash_check();
+    header.order       = order;
+
+    /* Written aside then renamed, so that the vectors still mapping the old file stay valid. */
+    const std::string temporary = path + ".tmp";
+    file_writer       writer{temporary};
+    writer.write(bytes_of(header));
+    writer.write(bytes_of(offsets));
+    for (const T& s : v)
     {
-        std::cerr << "Error: Invalid regex pattern '" << regex << "'. "
-                  << "Details: " << e.what() << std::endl;
+        writer.write(s);
+    }
+    writer.write(std::string_view{"\0\0\0\0\0\0\0", (8 - header.blob_size % 8) % 8});
+    writer.write(bytes_of(saved_index));
+    writer.close();
 
-        return end();
+    if (std::rename(temporary.c_str(), path.c_str()) != 0)
+    {
+        std::remove(temporary.c_str());
+        throw std::runtime_error("Couldn't write to file: " + path);
     }
 }
 
-inline stringvec::citer stringvec::find_reg(const std::string& regex) const
+/** -----------------------------------------------------------------------------------------------
+ * @brief   Snapshot file mapped in memory, checked to be consistent.
+ *
+ * @details Nothing is parsed: the strings are read straight from the mapping, through the offsets.
+ */
+class snapshot_file
 {
-    return const_cast<stringvec*>(this)->find_reg(regex);
-}
+public:
+    inline explicit snapshot_file(const std::string& path);
+
+    inline std::size_t      size() const;
+    inline std::string_view operator[](std::size_t i) const;
+    inline std::uint8_t     order() const;
+
+    inline std::shared_ptr<const flat_index>  index() const;
+    inline std::shared_ptr<const mapped_file> mapping() const;
+
+private:
+    inline std::uint64_t offset(std::size_t i) const;
+
+    std::shared_ptr<const mapped_file> map;
+    snapshot_header                    header;
+    const char*                        offsets = nullptr;
+    const char*                        blob    = nullptr;
+    const char*                        saved   = nullptr;
+};
 
 /** -----------------------------------------------------------------------------------------------
- * @brief Find the last element matching the input regex.
- * @param regex: Regex to match in the vector.
+ * @brief Map a snapshot file, checking its header and its offsets.
+ * @param path: Snapshot file, written by `save_snapshot`.
+ *
+ * @details Throws `std::runtime_error` if the file is not a snapshot, was written by a machine of
+ *          another byte order, or is truncated or corrupted.
  */
-inline stringvec::iter stringvec::rfind_reg(const std::string& regex)
+inline snapshot_file::snapshot_file(const std::string& path)
+: map{std::make_shared<const mapped_file>(path)}
 {
-    try
+    const auto invalid = [&path]()
     {
-        std::regex reg{regex};
+        return std::runtime_error("Invalid snapshot: " + path);
+    };
 
-        return rfind([&reg](const std::string& s)
-                    {
-                        return std::regex_match(s, reg);
-                    });
+    const std::size_t size = map->size();
+    if (size < sizeof(header))
+    {
+        throw invalid();
     }
-    catch (const std::regex_error& e)
+    std::memcpy(&header, map->data(), sizeof(header));
+
+    if (header.magic != snapshot_header::expected_magic ||
+        header.byte_order != snapshot_header::expected_order ||
+        header.version != snapshot_header::expected_version)
     {
-        std::cerr << "Error: Invalid regex pattern '" << regex << "'. "
-                  << "Details: " << e.what() << std::endl;
+        throw invalid();
+    }
 
-        return rend();
+    /* Every size is checked against what is left of the file, so that none can overflow. */
+    std::size_t left = size - sizeof(header);
+    if (header.count >= left / sizeof(std::uint64_t))
+    {
+        throw invalid();
     }
-}
+    left -= (header.count + 1) * sizeof(std::uint64_t);
+    if (header.blob_size > left)
+    {
+        throw invalid();
+    }
+    left -= header.blob_size;
 
-inline stringvec::citer stringvec::rfind_reg(const std::string& regex) const
-{
-    return const_cast<stringvec*>(this)->rfind_reg(regex);
-}
+    /* What is left must be exactly the padding and the index. */
+    const std::size_t padding = (8 - header.blob_size % 8) % 8;
+    if (header.index_slots != 0 && (!std::has_single_bit(header.index_slots) ||
+                                    header.index_slots > left / (3 * sizeof(std::uint64_t))))
+    {
+        throw invalid();
+    }
+    const std::size_t index_size = header.index_slots == 0
+                                     ? 0
+                                     : (header.index_slots * 3 + 1) * sizeof(std::uint64_t);
+    if (left != padding + index_size)
+    {
+        throw invalid();
+    }
+
+    offsets = map->data() + sizeof(header);
+    blob    = offsets + (header.count + 1) * sizeof(std::uint64_t);
+    saved   = blob + header.blob_size + padding;
 
+    if (offset(0) != 0 || offset(header.count) != header.blob_size)
+    {
+        throw invalid();
+    }
+    for (std::size_t i = 0; i < header.count; i++)
+    {
+        if (offset(i) > offset(i + 1))
+        {
+            throw invalid();
+        }
+    }
+}
 
 /** -----------------------------------------------------------------------------------------------
- * @brief Get the vector of strings.
+ * @brief Get the number of strings in the snapshot.
  */
-inline std::vector<std::string>& stringvec::get()
+inline std::size_t snapshot_file::size() const
 {
-    return vec;
+    return header.count;
 }
 
-inline const std::vector<std::string>& stringvec::get() const
+/** -----------------------------------------------------------------------------------------------
+ * @brief Get a string of the snapshot, pointing into the mapping.
+ */
+inline std::string_view snapshot_file::operator[](std::size_t i) const
 {
-    return vec;
+    const std::uint64_t first = offset(i);
+    return {blob + first, offset(i + 1) - first};
 }
 
-
 /** -----------------------------------------------------------------------------------------------
- * @brief Get an iterator to the first element of the vector.
+ * @brief Get the sort order stored in the snapshot, as the value of `stringvec::ordering`.
  */
-inline stringvec::iter stringvec::begin()
+inline std::uint8_t snapshot_file::order() const
 {
-    return vec.begin();
+    return header.order;
 }
 
-inline stringvec::citer stringvec::begin() const
+/** -----------------------------------------------------------------------------------------------
+ * @brief Get the hash index stored in the snapshot.
+ * @return The index, or `nullptr` if none was stored, or if it was built with another hash
+ *         function than the one of this build.
+ */
+inline std::shared_ptr<const flat_index> snapshot_file::index() const
 {
-    return vec.cbegin();
-}
+    if (header.index_slots == 0 || header.hash_check != flat_index::hash_check())
+    {
+        return nullptr;
+    }
 
-inline stringvec::citer stringvec::cbegin() const
-{
-    return begin();
+    return flat_index::load(saved, header.index_slots, header.count);
 }
 
 /** -----------------------------------------------------------------------------------------------
- * @brief Get an iterator to the last element of the vector.
+ * @brief Get the mapping of the file, which the strings point into.
  */
-inline stringvec::iter stringvec::end()
+inline std::shared_ptr<const mapped_file> snapshot_file::mapping() const
 {
-    return vec.end();
-}
-
-inline stringvec::citer stringvec::end() const
-{
-    return vec.cend();
+    return map;
 }
 
-inline stringvec::citer stringvec::cend() const
+inline std::uint64_t snapshot_file::offset(std::size_t i) const
 {
-    return end();
+    std::uint64_t value;
+    std::memcpy(&value, offsets + i * sizeof(std::uint64_t), sizeof(value));
+    return value;
 }
 
+}        // namespace stringvec_detail
 
 /** -----------------------------------------------------------------------------------------------
- * @brief Get the string at position `index`.
+ * @brief Save the vector to a binary snapshot, with its sort order and hash index.
+ * @param path: File to write the snapshot to.
+ *
+ * @details Loading the snapshot with `load_snapshot` is much faster than reading and processing
+ *          the original file again: the file is mapped, and only the offsets are checked.
+ *          Snapshots are meant to be loaded by the same build on the same machine; another
+ *          byte order is rejected, and an index from another standard library is dropped.
  */
-inline std::string& stringvec::operator[](std::size_t index)
+inline void stringvec::save_snapshot(const std::string& path) const
 {
-    return vec[index];
+    stringvec_detail::write_snapshot(path, vec, static_cast<std::uint8_t>(order), index.get());
 }
 
-inline const std::string& stringvec::operator[](std::size_t index) const
+/** -----------------------------------------------------------------------------------------------
+ * @brief Replace the content of the vector by a snapshot written by `save_snapshot`.
+ * @param path: Snapshot file to read.
+ *
+ * @details The sort order is restored, and so is the hash index when it was saved.
+ *          Throws `std::runtime_error` if the file is not a valid snapshot.
+ */
+inline stringvec& stringvec::load_snapshot(const std::string& path) &
 {
-    return vec[index];
-}
+    const stringvec_detail::snapshot_file snapshot{path};
 
+    vec.clear();
+    vec.reserve(snapshot.size());
+    for (std::size_t i = 0; i < snapshot.size(); i++)
+    {
+        vec.emplace_back(snapshot[i]);
+    }
 
+    order = snapshot.order() <= static_cast<std::uint8_t>(ordering::length)
+              ? static_cast<ordering>(snapshot.order())
+              : ordering::none;
+    index = snapshot.index();
+    search.reset();
 
-inline bool stringvec::operator== (const stringvec& other) const
-{
-    return vec == other.vec;
+    return *this;
 }
 
-inline bool stringvec::operator!= (const stringvec& other) const
+inline stringvec&& stringvec::load_snapshot(const std::string& path) &&
 {
-    return !(*this == other);
+    return std::move(load_snapshot(path));
 }
 
-inline std::strong_ordering stringvec::operator<=>(const stringvec& other) const
+/** -----------------------------------------------------------------------------------------------
+ * @brief Save the views to a binary snapshot, readable by both `stringvec` and `stringview_vec`.
+ * @param path: File to write the snapshot to.
+ */
+inline void stringview_vec::save_snapshot(const std::string& path) const
 {
-    return vec <=> other.vec;
+    stringvec_detail::write_snapshot(path, vec, 0, nullptr);
 }
 
+/** -----------------------------------------------------------------------------------------------
+ * @brief Replace the content of the vector by a snapshot written by `save_snapshot`.
+ * @param path: Snapshot file to map.
+ *
+ * @details The file is mapped in memory and the views point directly into it: no string is
+ *          copied or allocated. Throws `std::runtime_error` if the file is not a valid snapshot.
+ */
+inline stringview_vec& stringview_vec::load_snapshot(const std::string& path) &
+{
+    const stringvec_detail::snapshot_file snapshot{path};
+
+    clear();
+    vec.reserve(snapshot.size());
+    for (std::size_t i = 0; i < snapshot.size(); i++)
+    {
+        vec.push_back(snapshot[i]);
+    }
+    maps.push_back(snapshot.mapping());
+
+    return *this;
+}
 
+inline stringview_vec&& stringview_vec::load_snapshot(const std::string& path) &&
+{
+    return std::move(load_snapshot(path));
+}
 
 /**
  * @}
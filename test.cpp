@@ -46,6 +46,9 @@
 /** ===============================================================================================
  *  INCLUDES
  */
+#include <cstdio>
+#include <sstream>
+
 #include "stringvec.h"
 
 
@@ -65,8 +68,35 @@ constexpr err_t TEST_ERROR   = -1;
  */
 err_t comparison_test();
 err_t remove_test();
+err_t regex_cache_test();
+err_t regex_engine_test();
+err_t transform_test();
+err_t move_test();
+err_t parallel_test();
+err_t parallel_read_test();
+err_t stream_test();
+err_t arena_test();
+err_t split_test();
+err_t whitespace_test();
+err_t index_test();
+err_t set_test();
+err_t sort_test();
+err_t sorted_test();
+err_t write_test();
+err_t lazy_test();
+err_t stats_test();
+err_t async_test();
+err_t snapshot_test();
+err_t compression_test();
+err_t pattern_set_test();
+err_t search_index_test();
+err_t find_all_test();
+err_t case_test();
+err_t follow_test();
+err_t column_test();
 
 err_t integration_test();
+err_t mapped_integration_test();
 
 
 static std::pair<stringvec, stringvec> load_test(const std::string& path);
@@ -126,49 +156,1621 @@ err_t remove_test()
         return TEST_ERROR;
     }
 
+    /* Batch removals clamp to the size, and removing from an empty vector does nothing. */
+    stringvec batch = {"0", "1", "2", "3", "4", "5", "6", "7", "8", "9"};
+    batch.remove_first(2).remove_last(2).remove_range(1, 3);
+    if(batch != stringvec{"2", "5", "6", "7"})
+    {
+        return TEST_ERROR;
+    }
+
+    const std::size_t positions[] = {3, 0, 3, 42};
+    batch.remove_indices(positions);
+    if(batch != stringvec{"5", "6"} || stringvec{"a"}.remove_range(0, 10).remove_first().remove_last(3) != stringvec{})
+    {
+        return TEST_ERROR;
+    }
+
+    stringview_vec views = stringview_vec{"a", "b", "c", "d", "e"}.remove_first(2).remove_indices(positions);
+    if(views.remove_range(1, 5).to_stringvec() != stringvec{"d"})
+    {
+        return TEST_ERROR;
+    }
+
     return TEST_SUCCESS;
 }
 
-err_t integration_test()
+err_t regex_cache_test()
 {
-    const stringvec valid = {"Raspberry", "Blueberry"};
-    stringvec       sv;
+    regex_cache cache{2};
+    regex_handle berry = cache.get(".*berry");
 
-    sv.read_file("input_test.txt");
-    sv.remove_first();
-    sv.split();
-    sv.filter_remove(".*[Aa]pple.*");
-    // sv.print();
-    sv.filter_keep(".*berry");
-    // sv.print();
-    sv.write_file("output_test.txt");
+    if(cache.get(".*berry") != berry || cache.get(".*berry", std::regex::icase) == berry)
+    {
+        return TEST_ERROR;
+    }
 
-    if(sv != valid)
+    /* ".*berry" is the least recently used entry, and gets evicted. */
+    cache.get(".*apple");
+    regex_cache::statistics stats = cache.stats();
+    if(stats.hits != 1 || stats.misses != 3 || stats.evictions != 1 || stats.size != 2)
+    {
+        return TEST_ERROR;
+    }
+
+    stringvec sv = {"Raspberry", "Apple", "Blueberry"};
+    sv.filter_keep(berry);
+    if(sv != stringvec{"Raspberry", "Blueberry"} || sv.rfind_reg(berry) != sv.begin() + 1)
     {
         return TEST_ERROR;
     }
+
+    regex_cache::global().reset_stats();
+    sv.filter_remove(".*apple.*");
+    sv.filter_remove(".*apple.*");
+    if(regex_cache::global().stats().hits != 1)
+    {
+        return TEST_ERROR;
+    }
+
     return TEST_SUCCESS;
 }
 
+err_t regex_engine_test()
+{
+    const std::vector<std::string> patterns = {
+      ".*berry", "Rasp.*", ".*err.*", "Raspberry", ".*[Aa]pple.*", "^\\s+$", "(Blue|Rasp)berry",
+      "[A-Z][a-z]{2,8}", "\\w+\\.\\d*", ".*", "(a|b)*a(a|b){12}", "(\\w)\\1"};
+    const std::vector<std::string> inputs = {
+      "", "Raspberry", "Blueberry", "Raspberry\nBlueberry", "berry", " \t", "Apple pie",
+      "pineapple", "abbbbbbbbbbbbb", "ababababababab", "abc.123", "aa"};
+
+    for(const std::string& p : patterns)
+    {
+        const compiled_regex fast{p};
+        const std::regex     reference{p};
+        for(const std::string& s : inputs)
+        {
+            if(fast.match(s) != std::regex_match(s, reference))
+            {
+                return TEST_ERROR;
+            }
+        }
+    }
 
+    /* Back-references cannot be expressed by a DFA. */
+    try
+    {
+        compiled_regex{"(\\w)\\1", std::regex::ECMAScript, regex_engine::dfa};
+        return TEST_ERROR;
+    }
+    catch(const std::regex_error&)
+    {
+    }
 
-/* ------------------------------------------- */
-int main()
+    stringvec sv = {"Raspberry", "Apple", "Blueberry"};
+    sv.filter_keep(std::make_shared<const compiled_regex>("[A-Z].*berry",
+                                                          std::regex::ECMAScript,
+                                                          regex_engine::dfa));
+    if(sv != stringvec{"Raspberry", "Blueberry"})
+    {
+        return TEST_ERROR;
+    }
+
+    return TEST_SUCCESS;
+}
+
+err_t transform_test()
 {
-    if(comparison_test() == TEST_ERROR)
+    stringvec sv = {"  lorem  ", "a", "   ", "", "\tipsum dolor\n", "an already trimmed string"};
+    const char* untouched = sv[5].data();
+
+    sv.trim();
+    if(sv != stringvec{"lorem", "a", "", "", "ipsum dolor", "an already trimmed string"})
     {
-        std::cout << "FAIL" << std::endl;
         return TEST_ERROR;
     }
 
-    if(remove_test() == TEST_ERROR)
+    /* Clean strings must keep their buffer. */
+    if(sv[5].data() != untouched)
     {
-        std::cout << "FAIL" << std::endl;
         return TEST_ERROR;
     }
 
+    sv.transform_inplace([](std::string& s)
+                         {
+                             for(char& c : s)
+                             {
+                                 c = static_cast<char>(std::toupper(static_cast<unsigned char>(c)));
+                             }
+                         });
+    sv.transform([](std::string s)
+                 {
+                     return s + "!";
+                 });
+    if(sv != stringvec{"LOREM!", "A!", "!", "!", "IPSUM DOLOR!", "AN ALREADY TRIMMED STRING!"})
+    {
+        return TEST_ERROR;
+    }
 
-    if(integration_test() == TEST_ERROR)
+    return TEST_SUCCESS;
+}
+
+err_t move_test()
+{
+    stringvec   sv     = {"a string that is too long for small string optimization", "b"};
+    const char* buffer = sv[0].data();
+
+    stringvec moved = std::move(sv);
+    if(moved[0].data() != buffer)
+    {
+        return TEST_ERROR;
+    }
+
+    std::vector<std::string> strings = {"Apple Raspberry", "Blueberry pie"};
+
+    stringvec chained = stringvec{std::move(strings)}.split().filter_keep(".*berry").trim();
+    if(chained != stringvec{"Raspberry", "Blueberry"})
+    {
+        return TEST_ERROR;
+    }
+
+    stringview_vec view = stringview_vec{"c", "a", "b"}.sort_alphabetically().remove_last();
+    if(view != stringview_vec{"a", "b"})
+    {
+        return TEST_ERROR;
+    }
+
+    return TEST_SUCCESS;
+}
+
+err_t parallel_test()
+{
+    thread_pool                                pool{4};
+    const stringvec_execution::parallel_policy policy{&pool, 16};
+
+    stringvec input;
+    for (std::size_t i = 0; i < 1000; i++)
+    {
+        input.get().push_back("  item" + std::to_string((i * 7919) % 1000) + (i % 3 == 0 ? "berry " : " "));
+    }
+
+    const auto berry = [](const std::string& s)
+                       {
+                           return s.find("berry") != std::string::npos;
+                       };
+
+    stringvec parallel   = stringvec{input}.trim(policy).filter_keep(policy, berry).sort_alphabetically(policy);
+    stringvec sequential = stringvec{input}.trim().filter_keep(berry).sort_alphabetically();
+    if(parallel != sequential)
+    {
+        return TEST_ERROR;
+    }
+
+    /* The filters keep the original order. */
+    stringvec filtered = stringvec{input}.filter_remove(policy, ".*berry ");
+    if(filtered != stringvec{input}.filter_remove(".*berry "))
+    {
+        return TEST_ERROR;
+    }
+
+    if(input.find(policy, berry) != input.find(berry) || input.rfind(pool, berry) != input.rfind(berry))
+    {
+        return TEST_ERROR;
+    }
+
+    if(input.find(policy, "missing") != input.end() || input.find_reg(stringvec_execution::par, ".*item7.*") != input.find_reg(".*item7.*"))
+    {
+        return TEST_ERROR;
+    }
+
+    /* Exceptions thrown from a chunk are rethrown on the calling thread. */
+    try
+    {
+        input.transform_inplace(policy, [](std::string& s)
+                                        {
+                                            if(s.find("item999") != std::string::npos)
+                                            {
+                                                throw std::runtime_error("chunk failure");
+                                            }
+                                        });
+        return TEST_ERROR;
+    }
+    catch (const std::runtime_error&)
+    {
+    }
+
+    return TEST_SUCCESS;
+}
+
+err_t parallel_read_test()
+{
+    const std::string path = "parallel_read_test.txt";
+    {
+        std::ofstream output(path, std::ios::binary);
+        for (std::size_t i = 0; i < 200000; i++)
+        {
+            output << std::string(i % 37, 'a' + i % 26) << (i % 11 == 0 ? "\n\n" : "\n");
+        }
+        output << "no trailing newline";
+    }
+
+    thread_pool pool{4};
+
+    stringvec sequential;
+    sequential.read_file(path);
+    const stringvec      parallel = stringvec{}.read_file(pool, path);
+    const stringview_vec views    = stringview_vec{}.read_file(stringvec_execution::parallel_policy{&pool}, path);
+
+    std::remove(path.c_str());
+
+    if(parallel != sequential || views.to_stringvec() != sequential)
+    {
+        return TEST_ERROR;
+    }
+
+    return TEST_SUCCESS;
+}
+
+err_t stream_test()
+{
+    stringvec in_memory;
+    in_memory.read_file("input_test.txt");
+    in_memory.remove_first().split().filter_remove(".*[Aa]pple.*").filter_keep(".*berry");
+
+    /* Small chunks cut the file in the middle of lines. */
+    for (std::size_t chunk_size : {std::size_t{1}, std::size_t{7}, std::size_t{64}, stream_pipeline::default_chunk_size})
+    {
+        const stream_pipeline pipeline = stream_pipeline{chunk_size}.remove_first()
+                                                                    .split()
+                                                                    .filter_remove(".*[Aa]pple.*")
+                                                                    .filter_keep(".*berry");
+
+        std::ifstream     input("input_test.txt", std::ios::binary);
+        std::stringstream output;
+        pipeline.run(input, output, ";");
+
+        if(output.str() != "Raspberry;Blueberry")
+        {
+            return TEST_ERROR;
+        }
+
+        stringvec collected;
+        std::ifstream again("input_test.txt", std::ios::binary);
+        pipeline.run(again, [&collected](stringvec& sv)
+                            {
+                                collected.get().insert(collected.end(), sv.begin(), sv.end());
+                            });
+        if(collected != in_memory)
+        {
+            return TEST_ERROR;
+        }
+    }
+
+    /* Removing several lines spans chunks, and the lazy pipeline removes the same strings. */
+    const stringvec lines      = stringvec{}.read_file("input_test.txt");
+    const stringvec headerless = stringvec{lines}.remove_first(3);
+    stringvec       streamed;
+    std::ifstream   input("input_test.txt", std::ios::binary);
+    stream_pipeline{4}.remove_first(3).run(input, [&streamed](stringvec& sv)
+                                                  {
+                                                      streamed.get().insert(streamed.end(), sv.begin(), sv.end());
+                                                  });
+    if(streamed != headerless || lines.pipeline().remove_first(3).collect() != headerless ||
+       headerless != stringvec{"Pineapples", "Raspberry Appleberry", "Pear", "Watermelon", "Blueberry"})
+    {
+        return TEST_ERROR;
+    }
+
+    return TEST_SUCCESS;
+}
+
+err_t arena_test()
+{
+    string_arena arena{64};
+
+    const std::string_view a = arena.store("first string");
+    const std::string_view b = arena.store("second");
+    if(a != "first string" || b != "second" || b.data() != a.data() + a.size())
+    {
+        return TEST_ERROR;
+    }
+
+    /* Strings longer than a block get a block of their own. */
+    const std::string      large(200, 'x');
+    const std::string_view c = arena.store(large);
+    if(c != large || arena.size() != a.size() + b.size() + large.size())
+    {
+        return TEST_ERROR;
+    }
+
+    /* Resetting keeps the blocks, so the next string reuses the first one. */
+    const std::size_t capacity = arena.capacity();
+    arena.reset();
+    if(arena.store("reused").data() != a.data() || arena.capacity() != capacity)
+    {
+        return TEST_ERROR;
+    }
+
+    stringview_vec view = stringvec{"Apple", "Banana"};
+    view.transform([](std::string_view s)
+                   {
+                       return std::string{s} + " pie";
+                   });
+    if(view != stringview_vec{"Apple pie", "Banana pie"})
+    {
+        return TEST_ERROR;
+    }
+
+    /* Copies sharing an arena store their strings separately, and can be transformed concurrently. */
+    stringview_vec first  = view;
+    stringview_vec second = view;
+    std::thread    other{[&second]
+                         {
+                             second.transform([](std::string_view s)
+                                              {
+                                                  return std::string{s} + " tart";
+                                              });
+                         }};
+    first.transform([](std::string_view s)
+                    {
+                        return std::string{s} + " crumble";
+                    });
+    other.join();
+    if(first != stringview_vec{"Apple pie crumble", "Banana pie crumble"} ||
+       second != stringview_vec{"Apple pie tart", "Banana pie tart"} || view != stringview_vec{"Apple pie", "Banana pie"})
+    {
+        return TEST_ERROR;
+    }
+
+    view.clear();
+    if(view != stringview_vec{})
+    {
+        return TEST_ERROR;
+    }
+
+    return TEST_SUCCESS;
+}
+
+err_t split_test()
+{
+    const stringvec csv = {"id,name;;city", "no delimiter at all in this rather long line", "", "a,b,c,d,e,f,g,h,i,j,k,l,m,n,o,p,q,r"};
+
+    stringvec split = stringvec{csv}.split(",");
+    if(split.get().size() != 22 || split[0] != "id" || split[1] != "name;;city" || split[2] != csv[1])
+    {
+        return TEST_ERROR;
+    }
+
+    const stringvec expected = {"id", "name", "", "city", csv[1], "", "a", "b", "c", "d", "e", "f", "g", "h", "i", "j",
+                                "k", "l", "m", "n", "o", "p", "q", "r"};
+    if(stringvec{csv}.split_any(",;") != expected ||
+       stringview_vec{csv}.split_any(",;").to_stringvec() != expected)
+    {
+        return TEST_ERROR;
+    }
+
+    /* More delimiters than the SIMD search handles at once. */
+    if(stringvec{csv}.split_any(",;!?#$%&*+") != expected)
+    {
+        return TEST_ERROR;
+    }
+
+    if(stringvec{csv}.split("") != csv || stringvec{csv}.split("|") != csv)
+    {
+        return TEST_ERROR;
+    }
+
+    return TEST_SUCCESS;
+}
+
+err_t whitespace_test()
+{
+    /* Compare the vectorized trim against a scalar one, around the SIMD block boundaries. */
+    constexpr std::string_view alphabet = " \t\n\v\f\rx";
+    std::uint32_t              seed     = 12345;
+    for (std::size_t i = 0; i < 20000; i++)
+    {
+        std::string s(i % 80, ' ');
+        for (char& c : s)
+        {
+            seed = seed * 1664525 + 1013904223;
+            c    = alphabet[(seed >> 16) % ((seed >> 8) % 4 == 0 ? alphabet.size() : alphabet.size() - 1)];
+        }
+
+        const std::size_t start = s.find_first_not_of(alphabet.substr(0, 6));
+        const std::string expected = start == std::string::npos ?
+                                     "" :
+                                     s.substr(start, s.find_last_not_of(alphabet.substr(0, 6)) - start + 1);
+
+        stringvec sv = {s};
+        if(sv.trim()[0] != expected || stringview_vec{s}.trim()[0] != expected)
+        {
+            return TEST_ERROR;
+        }
+    }
+
+    stringvec sv = {"", " text ", " \t\r\n\f\v", "                                   ", "x"};
+    if(stringvec{sv}.filter_empty() != stringvec{" text ", "x"} ||
+       stringvec{sv}.filter_empty(true) != stringvec{" text ", " \t\r\n\f\v", "                                   ", "x"} ||
+       stringview_vec{sv}.filter_empty() != stringview_vec{" text ", "x"})
+    {
+        return TEST_ERROR;
+    }
+
+    return TEST_SUCCESS;
+}
+
+err_t index_test()
+{
+    stringvec sv;
+    for (std::size_t i = 0; i < 1000; i++)
+    {
+        sv.get().push_back("key" + std::to_string(i % 300));
+    }
+
+    sv.build_index();
+    if(!sv.has_index() || sv.find("key42") != sv.begin() + 42 || sv.rfind("key42") != sv.begin() + 942)
+    {
+        return TEST_ERROR;
+    }
+
+    if(!sv.contains("key299") || sv.contains("key300") || sv.find("missing") != sv.end())
+    {
+        return TEST_ERROR;
+    }
+
+    /* Modifying methods discard the index, and searches go back to linear scans. */
+    sv.remove_first();
+    if(sv.has_index() || sv.find("key42") != sv.begin() + 41)
+    {
+        return TEST_ERROR;
+    }
+
+    sv.build_index().filter_remove([](const std::string& s)
+                                   {
+                                       return s == "key42";
+                                   });
+    if(sv.has_index() || sv.contains("key42"))
+    {
+        return TEST_ERROR;
+    }
+
+    const stringvec copy = stringvec{sv}.build_index();
+    if(!copy.has_index() || copy.find("key1") - copy.begin() != sv.find("key1") - sv.begin())
+    {
+        return TEST_ERROR;
+    }
+
+    return TEST_SUCCESS;
+}
+
+err_t set_test()
+{
+    if(stringvec{"b", "a", "b", "c", "a"}.unique() != stringvec{"b", "a", "c"} ||
+       stringvec{"b", "a", "b", "c", "a"}.unique(true) != stringvec{"a", "b", "c"})
+    {
+        return TEST_ERROR;
+    }
+
+    const stringvec yesterday = {"a", "b", "c", "b"};
+    const stringvec today     = {"c", "d", "a", "d", "e"};
+    if(stringvec{yesterday}.merge_union(today) != stringvec{"a", "b", "c", "d", "e"} ||
+       stringvec{yesterday}.intersect(today) != stringvec{"a", "c"} ||
+       stringvec{today}.difference(yesterday) != stringvec{"d", "e"})
+    {
+        return TEST_ERROR;
+    }
+
+    /* The parallel versions give the same results, in the same order. */
+    stringvec large;
+    stringvec other;
+    for (std::size_t i = 0; i < 20000; i++)
+    {
+        large.get().push_back(std::to_string((i * 7919) % 5000));
+        other.get().push_back(std::to_string((i * 104729) % 7000 + 2500));
+    }
+
+    thread_pool                                pool{4};
+    const stringvec_execution::parallel_policy policy{&pool, 64};
+    if(stringvec{large}.unique(policy) != stringvec{large}.unique() ||
+       stringvec{large}.unique(policy, true) != stringvec{large}.unique(true) ||
+       stringvec{large}.merge_union(policy, other) != stringvec{large}.merge_union(other) ||
+       stringvec{large}.intersect(policy, other) != stringvec{large}.intersect(other) ||
+       stringvec{large}.difference(policy, other) != stringvec{large}.difference(other))
+    {
+        return TEST_ERROR;
+    }
+
+    if(stringvec{large}.unique().get().size() != 5000 || stringvec{large}.intersect(other).get().size() != 2500)
+    {
+        return TEST_ERROR;
+    }
+
+    return TEST_SUCCESS;
+}
+
+err_t sort_test()
+{
+    /* Shared prefixes, embedded nulls and bytes above 0x7F exercise the prefix keys. */
+    std::vector<std::string> strings;
+    std::uint32_t            seed = 777;
+    for (std::size_t i = 0; i < 5000; i++)
+    {
+        seed = seed * 1664525 + 1013904223;
+        std::string s = (seed >> 28) % 2 == 0 ? "a shared prefix longer than a key " : "";
+        for (std::size_t len = (seed >> 16) % 20; len > 0; len--)
+        {
+            seed = seed * 1664525 + 1013904223;
+            constexpr std::string_view alphabet{"ab\0\xFFz", 5};
+            s.push_back(alphabet[(seed >> 24) % alphabet.size()]);
+        }
+        strings.push_back(std::move(s));
+    }
+
+    std::vector<std::string> alphabetical = strings;
+    std::sort(alphabetical.begin(), alphabetical.end());
+    std::vector<std::string> by_length = strings;
+    std::stable_sort(by_length.begin(), by_length.end(), [](const std::string& a, const std::string& b)
+                                                         {
+                                                             return a.size() < b.size();
+                                                         });
+
+    thread_pool                                pool{4};
+    const stringvec_execution::parallel_policy policy{&pool, 64};
+    if(stringvec{strings}.sort_alphabetically() != stringvec{alphabetical} ||
+       stringvec{strings}.sort_alphabetically(policy) != stringvec{alphabetical} ||
+       stringview_vec{stringvec{strings}}.sort_alphabetically().to_stringvec() != stringvec{alphabetical})
+    {
+        return TEST_ERROR;
+    }
+
+    if(stringvec{strings}.sort_length() != stringvec{by_length} ||
+       stringvec{strings}.sort_length(policy) != stringvec{by_length} ||
+       stringview_vec{stringvec{strings}}.sort_length().to_stringvec() != stringvec{by_length})
+    {
+        return TEST_ERROR;
+    }
+
+    /* Lengths too large for a counting sort fall back to a stable comparison sort. */
+    const stringvec long_strings = {std::string(100000, 'x'), "b", std::string(70000, 'y'), "a"};
+    if(stringvec{long_strings}.sort_length() != stringvec{"b", "a", long_strings[2], long_strings[0]})
+    {
+        return TEST_ERROR;
+    }
+
+    /* Long duplicates and long shared prefixes are refined 8 bytes at a time, without recursing. */
+    const std::string        line(1 << 20, 'q');
+    std::vector<std::string> long_prefixes = {line, line + "b", line, line.substr(0, 700001) + "a", line + "a", line};
+    std::vector<std::string> long_sorted   = long_prefixes;
+    std::sort(long_sorted.begin(), long_sorted.end());
+    if(stringvec{long_prefixes}.sort_alphabetically() != stringvec{long_sorted} ||
+       stringvec{long_prefixes}.sort_alphabetically(policy) != stringvec{long_sorted} ||
+       stringvec{line, line}.sort_alphabetically() != stringvec{line, line})
+    {
+        return TEST_ERROR;
+    }
+
+    return TEST_SUCCESS;
+}
+
+err_t sorted_test()
+{
+    stringvec sv = {"pear", "fig", "apple", "kiwi", "fig"};
+    if(sv.sort_order() != stringvec::ordering::none)
+    {
+        return TEST_ERROR;
+    }
+
+    /* Binary searches must find the first and the last of equal strings. */
+    sv.sort_alphabetically();
+    if(sv.sort_order() != stringvec::ordering::alphabetical ||
+       sv.find("fig") - sv.begin() != 1 || sv.rfind("fig") - sv.begin() != 2 ||
+       sv.find("grape") != sv.end() || sv.rfind("zebra") != sv.end())
+    {
+        return TEST_ERROR;
+    }
+
+    sv.insert_sorted("banana").insert_sorted("zucchini");
+    if(sv != stringvec{"apple", "banana", "fig", "fig", "kiwi", "pear", "zucchini"})
+    {
+        return TEST_ERROR;
+    }
+
+    /* Removing elements keeps the ordering, modifying them does not. */
+    sv.filter_remove("fig");
+    if(sv.sort_order() != stringvec::ordering::alphabetical || sv.find("kiwi") - sv.begin() != 2)
+    {
+        return TEST_ERROR;
+    }
+    sv.get()[0] = "mango";
+    if(sv.sort_order() != stringvec::ordering::none || sv.find("mango") != sv.begin())
+    {
+        return TEST_ERROR;
+    }
+
+    stringvec by_length = {"ccc", "a", "bb", "dd", "e"};
+    by_length.sort_length();
+    if(by_length.find("dd") - by_length.begin() != 3 || by_length.rfind("e") - by_length.begin() != 1 ||
+       by_length.find("zz") != by_length.end())
+    {
+        return TEST_ERROR;
+    }
+
+    by_length.insert_sorted("ff").merge(stringvec{"gggg", "h"});
+    if(by_length != stringvec{"a", "e", "h", "bb", "dd", "ff", "ccc", "gggg"})
+    {
+        return TEST_ERROR;
+    }
+
+    /* An unsorted vector is sorted alphabetically before merging. */
+    stringvec merged = stringvec{"d", "b"}.merge(stringvec{"c", "a", "b"});
+    if(merged != stringvec{"a", "b", "b", "c", "d"} || merged.sort_order() != stringvec::ordering::alphabetical)
+    {
+        return TEST_ERROR;
+    }
+    merged.merge(merged);
+    if(merged.get().size() != 10 || !std::is_sorted(merged.begin(), merged.end()))
+    {
+        return TEST_ERROR;
+    }
+
+    return TEST_SUCCESS;
+}
+
+err_t write_test()
+{
+    /* Strings larger than the buffer, empty strings and a two-byte separator. */
+    std::vector<std::string> strings;
+    for (std::size_t i = 0; i < 20000; i++)
+    {
+        strings.push_back(std::string(i % 13 == 0 ? 9000 : i % 7, 'a' + i % 26));
+    }
+    const stringvec sv{strings};
+
+    std::ostringstream expected;
+    sv.print(expected, "\r\n", false);
+
+    const std::string path    = "write_test.txt";
+    auto              read_it = [&path]()
+                                {
+                                    std::ifstream input(path, std::ios::binary);
+                                    return std::string{std::istreambuf_iterator<char>(input), {}};
+                                };
+
+    for (const write_options options : {write_options{},
+                                        write_options{.buffer_size = 4096},
+                                        write_options{.buffer_size = 10000, .direct = true, .sync = true}})
+    {
+        sv.write_file(path, "\r\n", options);
+        if(read_it() != expected.str())
+        {
+            std::remove(path.c_str());
+            return TEST_ERROR;
+        }
+    }
+
+    stringview_vec{sv}.write_file(path, "\r\n", write_options{.direct = true});
+    const bool views_match = read_it() == expected.str();
+
+    /* A NUL character writes no separator, a NUL string writes the byte, an empty vector nothing. */
+    stringvec{"a", "b"}.write_file(path, '\0');
+    bool nul_match = read_it() == "ab";
+    stringview_vec{"a", "b"}.write_file(path, '\0');
+    nul_match = nul_match && read_it() == "ab";
+    stringvec{"a", "b"}.write_file(path, std::string_view{"\0", 1});
+    nul_match = nul_match && read_it() == std::string{"a\0b", 3};
+    stringvec{}.write_file(path);
+    const bool empty_match = read_it().empty();
+    std::remove(path.c_str());
+
+    if(!views_match || !nul_match || !empty_match)
+    {
+        return TEST_ERROR;
+    }
+
+    try
+    {
+        sv.write_file("missing_directory/write_test.txt");
+        return TEST_ERROR;
+    }
+    catch (const std::runtime_error&)
+    {
+    }
+
+    return TEST_SUCCESS;
+}
+
+err_t lazy_test()
+{
+    stringvec input;
+    input.read_file("input_test.txt");
+
+    /* The fused pipeline must give the same strings as the eager methods. */
+    const stringvec eager = stringvec{input}.split().filter_remove(".*[Aa]pple.*").filter_keep(".*berry");
+    const auto      lazy  = input.pipeline().split().filter_remove(".*[Aa]pple.*").filter_keep(".*berry");
+    if(lazy.collect() != eager || lazy.collect() != eager)
+    {
+        return TEST_ERROR;
+    }
+
+    const stringview_vec views{input};
+    if(views.pipeline().split().filter_remove(".*[Aa]pple.*").filter_keep(".*berry").collect() != eager)
+    {
+        return TEST_ERROR;
+    }
+
+    lazy.write_to("lazy_test.txt");
+    const stringvec written = stringvec{}.read_file("lazy_test.txt");
+    std::remove("lazy_test.txt");
+    if(written != eager)
+    {
+        return TEST_ERROR;
+    }
+
+    /* Predicates taking a std::string, a stateful one restarting on every run, and transforms. */
+    const stringvec words   = {"  one ", "two,three", "", " ", "four"};
+    auto            skipped = words.pipeline().filter_remove([count = 0](const std::string&) mutable
+                                                             {
+                                                                 return count++ == 0;
+                                                             });
+    if(skipped.collect() != stringvec{"two,three", "", " ", "four"} ||
+       skipped.collect() != stringvec{"two,three", "", " ", "four"})
+    {
+        return TEST_ERROR;
+    }
+
+    const stringvec shaped = words.pipeline()
+                                  .trim()
+                                  .filter_empty()
+                                  .split_any(",")
+                                  .transform([](std::string_view s)
+                                             {
+                                                 return std::string{s} + "!";
+                                             })
+                                  .filter_keep([](const std::string& s)
+                                               {
+                                                   return s.size() > 4;
+                                               })
+                                  .collect();
+    if(shaped != stringvec{"three!", "four!"})
+    {
+        return TEST_ERROR;
+    }
+
+    /* An invalid regex leaves the strings unchanged, as the eager methods do. */
+    if(words.pipeline().filter_remove("[").filter_keep("(").collect() != words)
+    {
+        return TEST_ERROR;
+    }
+
+    return TEST_SUCCESS;
+}
+
+err_t stats_test()
+{
+    using op = stringvec_stats::operation;
+
+    stringvec::reset_stats();
+    stringvec sv = {"a b", "c", "", "d e f"};
+    sv.split().filter_empty().filter_keep("[a-e]");
+
+    const stringvec_stats::snapshot stats = stringvec::stats();
+#if STRINGVEC_STATS
+    /* Nested calls, such as the predicate overloads behind the regex ones, are not counted. */
+    if(stats[op::split].calls != 1 || stats[op::split].elements_in != 4 || stats[op::split].elements_out != 7 ||
+       stats[op::filter_empty].elements_out != 6 || stats[op::filter_keep].calls != 1 ||
+       stats[op::filter_keep].elements_out != 5 || stats[op::filter_remove].calls != 0 ||
+       stats.regex_compilations != 1)
+    {
+        return TEST_ERROR;
+    }
+
+    if(stats.to_json().find("\"split\":{\"calls\":1,") == std::string::npos ||
+       stats.to_prometheus().find("stringvec_calls_total{operation=\"split\"} 1\n") == std::string::npos)
+    {
+        return TEST_ERROR;
+    }
+#else
+    if(stats[op::split].calls != 0 || stats.to_json() != "{\"regex_compilations\":0,\"operations\":{}}")
+    {
+        return TEST_ERROR;
+    }
+#endif
+
+    return TEST_SUCCESS;
+}
+
+err_t async_test()
+{
+    /* Lines cut by the 4 MiB chunks, empty lines, carriage returns and no trailing newline. */
+    const std::string big = "async_big_test.txt";
+    {
+        std::ofstream output(big, std::ios::binary);
+        for (std::size_t i = 0; i < 300000; i++)
+        {
+            output << std::string(i % 61, 'a' + i % 26) << (i % 13 == 0 ? "\r\n" : "\n");
+        }
+        output << "no trailing newline";
+    }
+    const std::string small = "async_small_test.txt";
+    const std::string empty = "async_empty_test.txt";
+    stringvec{"one", "", "three"}.write_file(small);
+    stringvec{}.write_file(empty);
+
+    bool matched = true;
+    for (const std::string& path : {big, small, empty, std::string{"input_test.txt"}})
+    {
+        matched = matched && stringvec::read_file_async(path).get() == stringvec{}.read_file(path);
+    }
+
+    const std::vector<stringvec> batch = stringvec::read_files_async({small, big, empty, small}).get();
+    matched = matched && batch.size() == 4 && batch[1] == stringvec{}.read_file(big) &&
+              batch[0] == stringvec{"one", "", "three"} && batch[3] == batch[0] && batch[2] == stringvec{};
+
+    /* Writing overlaps filling one buffer with writing the other. */
+    const stringvec lines = batch[1];
+    lines.write_file_async("async_write_test.txt", "\r\n", write_options{.buffer_size = 8192}).get();
+    std::ostringstream expected;
+    lines.print(expected, "\r\n", false);
+    std::ifstream     written_input("async_write_test.txt", std::ios::binary);
+    const std::string written{std::istreambuf_iterator<char>(written_input), {}};
+    matched = matched && written == expected.str();
+
+    stringvec{lines}.write_file_async("async_write_test.txt").get();
+    matched = matched && stringvec{}.read_file("async_write_test.txt") == lines;
+
+    for (const std::string& path : {big, small, empty, std::string{"async_write_test.txt"}})
+    {
+        std::remove(path.c_str());
+    }
+    if(!matched)
+    {
+        return TEST_ERROR;
+    }
+
+    try
+    {
+        stringvec::read_file_async("missing_file.txt").get();
+        return TEST_ERROR;
+    }
+    catch (const std::runtime_error&)
+    {
+    }
+
+    return TEST_SUCCESS;
+}
+
+err_t snapshot_test()
+{
+    /* Empty strings, embedded '\0' and a blob size that needs padding before the index. */
+    stringvec sv = {"kiwi", "", std::string{"nul\0byte", 8}, "apple", "kiwi", "banana"};
+    sv.build_index();
+    sv.save_snapshot("snapshot_test.bin");
+
+    stringvec loaded = stringvec{}.load_snapshot("snapshot_test.bin");
+    bool matched = loaded == sv && loaded.has_index() && loaded.find("kiwi") == loaded.begin() &&
+                   loaded.rfind("kiwi") - loaded.begin() == 4 && !loaded.contains("mango");
+
+    stringview_vec views = stringview_vec{}.load_snapshot("snapshot_test.bin");
+    matched = matched && views.get().size() == sv.get().size() && views[2] == std::string_view{"nul\0byte", 8};
+
+    /* The sort order is kept, and views save snapshots readable by `stringvec`. */
+    sv.sort_alphabetically();
+    sv.save_snapshot("snapshot_test.bin");
+    loaded.load_snapshot("snapshot_test.bin");
+    matched = matched && loaded == sv && loaded.sort_order() == stringvec::ordering::alphabetical &&
+              !loaded.has_index();
+
+    views.save_snapshot("snapshot_test.bin");
+    matched = matched && stringvec{}.load_snapshot("snapshot_test.bin") == stringvec{"kiwi", "", std::string{"nul\0byte", 8}, "apple", "kiwi", "banana"};
+
+    stringvec{}.save_snapshot("snapshot_test.bin");
+    matched = matched && stringview_vec{}.load_snapshot("snapshot_test.bin").get().empty();
+
+    /* Truncated and foreign files are rejected. */
+    sv.save_snapshot("snapshot_test.bin");
+    std::ifstream     input("snapshot_test.bin", std::ios::binary);
+    const std::string bytes{std::istreambuf_iterator<char>(input), {}};
+    input.close();
+    for (const std::string& corrupted : {bytes.substr(0, bytes.size() - 1), bytes.substr(0, 40), std::string{"kiwi\nbanana\n"}})
+    {
+        std::ofstream(std::string{"snapshot_test.bin"}, std::ios::binary) << corrupted;
+        try
+        {
+            stringvec{}.load_snapshot("snapshot_test.bin");
+            matched = false;
+        }
+        catch (const std::runtime_error&)
+        {
+        }
+    }
+
+    std::remove("snapshot_test.bin");
+    if(!matched)
+    {
+        return TEST_ERROR;
+    }
+
+    return TEST_SUCCESS;
+}
+
+err_t compression_test()
+{
+    /* Lines cut by the decompression blocks, empty lines and no trailing newline. */
+    stringvec lines;
+    for (std::size_t i = 0; i < 200000; i++)
+    {
+        lines.get().push_back(std::string(i % 37, 'a' + i % 26) + std::to_string(i));
+        if (i % 1000 == 0)
+        {
+            lines.get().emplace_back();
+        }
+    }
+
+    std::vector<std::pair<std::string, compression>> codecs;
+#ifdef STRINGVEC_USE_ZLIB
+    codecs.emplace_back("compression_test.gz", compression::gzip);
+#endif
+#ifdef STRINGVEC_USE_ZSTD
+    codecs.emplace_back("compression_test.zst", compression::zstd);
+#endif
+#ifdef STRINGVEC_USE_LZ4
+    codecs.emplace_back("compression_test.lz4", compression::lz4);
+#endif
+
+    std::ostringstream plain;
+    lines.print(plain, "\n", false);
+
+    bool matched = true;
+    for (const auto& [path, codec] : codecs)
+    {
+        /* The codec comes from the extension when writing, from the content when reading. */
+        lines.write_file(path);
+        std::ifstream     input(path, std::ios::binary);
+        const std::string bytes{std::istreambuf_iterator<char>(input), {}};
+        input.close();
+        matched = matched && bytes.size() < plain.str().size() / 2 && stringvec{}.read_file(path) == lines &&
+                  stringvec{}.read_file(stringvec_execution::par, path) == lines &&
+                  std::ranges::equal(stringview_vec{}.read_file(path).get(), lines.get()) &&
+                  stringvec::read_file_async(path).get() == lines;
+
+        /* Plain and compressed files read together, each with its own codec. */
+        lines.write_file("compression_test.txt", "\n", write_options{.codec = compression::none});
+        const std::vector<stringvec> mixed = stringvec::read_files_async({path, "compression_test.txt", path}).get();
+        matched = matched && mixed.size() == 3 && mixed[0] == lines && mixed[1] == lines && mixed[2] == lines;
+        std::remove("compression_test.txt");
+
+        /* Lazy pipelines pick the codec the same way. */
+        lines.pipeline().write_to(path);
+        std::ifstream     piped_input(path, std::ios::binary);
+        const std::string piped{std::istreambuf_iterator<char>(piped_input), {}};
+        piped_input.close();
+        matched = matched && piped.size() < plain.str().size() / 2 && stringvec{}.read_file(path) == lines;
+        lines.pipeline().write_to("compression_test.bin", "\n", write_options{.codec = codec});
+        matched = matched && stringvec{}.read_file("compression_test.bin") == lines;
+
+        lines.write_file_async("compression_test.bin", "\n", write_options{.codec = codec, .level = 1}).get();
+        matched = matched && stringvec{}.read_file("compression_test.bin") == lines;
+
+        /* Concatenated streams are read one after the other. */
+        stringvec{"first", "stream"}.write_file(path, "\n", write_options{.codec = codec});
+        std::ifstream     first_input(path, std::ios::binary);
+        const std::string first{std::istreambuf_iterator<char>(first_input), {}};
+        first_input.close();
+        stringvec{}.write_file(path);
+        std::ifstream     empty_input(path, std::ios::binary);
+        const std::string empty{std::istreambuf_iterator<char>(empty_input), {}};
+        empty_input.close();
+        std::ofstream(path, std::ios::binary) << first << empty << first;
+        matched = matched && stringvec{}.read_file(path) == stringvec{"first", "streamfirst", "stream"};
+
+        /* Truncated files are rejected. */
+        std::ofstream(path, std::ios::binary) << bytes.substr(0, bytes.size() / 2);
+        try
+        {
+            stringvec{}.read_file(path);
+            matched = false;
+        }
+        catch (const std::runtime_error&)
+        {
+        }
+        std::remove(path.c_str());
+    }
+    std::remove("compression_test.bin");
+
+    /* Without a codec, the extension is ignored; requesting the codec explicitly throws. */
+#ifndef STRINGVEC_USE_ZLIB
+    stringvec{"plain"}.write_file("compression_test.gz");
+    matched = matched && stringvec{}.read_file("compression_test.gz") == stringvec{"plain"};
+    std::remove("compression_test.gz");
+    try
+    {
+        stringvec{"plain"}.write_file("compression_test.bin", "\n", write_options{.codec = compression::gzip});
+        matched = false;
+    }
+    catch (const std::runtime_error&)
+    {
+    }
+#endif
+    stringvec{"plain"}.write_file("compression_test.txt", "\n", write_options{.codec = compression::none});
+    matched = matched && stringvec{}.read_file("compression_test.txt") == stringvec{"plain"};
+    std::remove("compression_test.txt");
+
+    if(!matched)
+    {
+        return TEST_ERROR;
+    }
+
+    return TEST_SUCCESS;
+}
+
+err_t pattern_set_test()
+{
+    const std::vector<std::string> substrings = {"she", "he", "hers", "his", ""};
+    const std::vector<std::string> regexes    = {".*apple.*", "[0-9]+", "Rasp.*", "(a|b)\\1"};
+
+    /* Overlapping substrings, found through the failure links; the empty one matches anything. */
+    const pattern_set literals = pattern_set::literals(std::span{substrings}.first(4));
+    bool matched = literals.size() == 4 && literals.match("ushers") && literals.which("ushers") == 0 &&
+                   literals.which("ahis") == 3 && literals.which("hershe") == 0 && !literals.match("hi") &&
+                   !literals.match("") && pattern_set::literals(substrings).which("xyz") == 4;
+
+    /* Literal, merged and back-reference regexes, numbered after the substrings. */
+    const pattern_set both{std::span{substrings}.first(2), regexes};
+    matched = matched && both.size() == 6 && both.which("pineapple") == 2 && both.which("123") == 3 &&
+              both.which("Raspberry") == 4 && both.which("aa") == 5 && both.which("ab") == pattern_set::npos &&
+              both.which("the apple") == 1 && both.match("42") && !both.match("apple\n") && !both.match("12a");
+
+    stringvec sv = {"Raspberry", "pineapple", "12", "Blueberry", "Strawberry", "apple\r", "bb"};
+    stringvec removed = stringvec{sv}.filter_remove_any(regexes);
+    stringvec kept    = stringvec{sv}.filter_keep_any(regexes);
+    matched = matched && removed == stringvec{"Blueberry", "Strawberry", "apple\r"} &&
+              kept == stringvec{"Raspberry", "pineapple", "12", "bb"} &&
+              stringvec{sv}.filter_keep_any(stringvec_execution::par, both) == kept;
+
+    const auto [found, pattern] = sv.find_any(pattern_set::literals(std::vector<std::string>{"berry", "apple"}));
+    const auto [missing, none]  = std::as_const(sv).find_any(pattern_set::literals(std::vector<std::string>{"kiwi"}));
+    matched = matched && found == sv.begin() && pattern == 0 && missing == sv.end() && none == pattern_set::npos;
+
+    stringview_vec views{sv};
+    views.filter_remove_any(pattern_set::literals(std::vector<std::string>{"berry"}));
+    matched = matched && views.get().size() == 4 && views.find_any(both).second == 2;
+
+    /* An invalid regex leaves the vector unchanged, as with `filter_remove`. */
+    matched = matched && stringvec{sv}.filter_remove_any(std::vector<std::string>{"a", "("}) == sv;
+
+    if(!matched)
+    {
+        return TEST_ERROR;
+    }
+
+    return TEST_SUCCESS;
+}
+
+err_t search_index_test()
+{
+    stringvec sv;
+    for (std::size_t i = 0; i < 1000; i++)
+    {
+        sv.get().push_back("id" + std::to_string(i) + (i % 3 == 0 ? " error" : " ok"));
+    }
+
+    const auto naive = [&sv](const std::string_view s, bool prefix)
+                       {
+                           std::vector<std::size_t> positions;
+                           for (std::size_t i = 0; i < std::as_const(sv).get().size(); i++)
+                           {
+                               const std::string_view x = sv[i];
+                               if (prefix ? x.starts_with(s) : x.find(s) != std::string_view::npos)
+                               {
+                                   positions.push_back(i);
+                               }
+                           }
+                           return positions;
+                       };
+    const auto agrees = [&]()
+                        {
+                            for (const std::string_view s : {"error", "id1", "99", "d9 ", "ok", "", "zzz"})
+                            {
+                                if (sv.find_all_containing(s) != naive(s, false) ||
+                                    sv.find_all_with_prefix(s) != naive(s, true))
+                                {
+                                    return false;
+                                }
+                            }
+                            return true;
+                        };
+
+    bool matched = agrees() && sv.find_all_containing("id99 ") == std::vector<std::size_t>{99};
+    sv.build_search_index();
+    matched = matched && sv.has_search_index() && agrees() && sv.find_all_with_prefix("id99") ==
+                                                              std::vector<std::size_t>{99, 990, 991, 992, 993, 994, 995, 996, 997, 998, 999};
+
+    /* Appended lines, first scanned then indexed, and erased ranges keep the index up to date. */
+    const std::string path = "search_index_test.txt";
+    {
+        std::ofstream output(path);
+        for (std::size_t i = 0; i < 5000; i++)
+        {
+            output << "line" << i << (i % 7 == 0 ? " error\n" : "\n");
+        }
+    }
+    sv.read_file(path);
+    matched = matched && sv.has_search_index() && agrees();
+    sv.remove_first(300).remove_last(10).remove_range(2000, 2500).remove_nth(5);
+    matched = matched && sv.has_search_index() && agrees();
+    sv.read_file(path);
+    std::remove(path.c_str());
+    matched = matched && sv.has_search_index() && agrees();
+
+    /* Other modifying methods discard it; prefix queries then use the sort order. */
+    sv.sort_alphabetically();
+    matched = matched && !sv.has_search_index() && agrees();
+    sv.build_search_index().drop_search_index();
+    matched = matched && !sv.has_search_index();
+
+    if(!matched)
+    {
+        return TEST_ERROR;
+    }
+
+    return TEST_SUCCESS;
+}
+
+err_t find_all_test()
+{
+    stringvec sv;
+    for (std::size_t i = 0; i < 10000; i++)
+    {
+        sv.get().push_back(i % 4 == 0 ? "error " + std::to_string(i) : "ok");
+    }
+
+    const std::vector<std::size_t> errors = sv.find_all_reg("error [0-9]+");
+    bool matched = errors.size() == 2500 && errors[1] == 4 && errors.back() == 9996 &&
+                   sv.count_reg("error [0-9]+") == 2500 && sv.count_if([](const std::string& s)
+                                                                       {
+                                                                           return s == "ok";
+                                                                       }) == 7500;
+
+    /* Parallel passes, on several chunks, give the same positions in the same order. */
+    const stringvec_execution::parallel_policy small{nullptr, 64};
+    matched = matched && sv.find_all_reg(small, "error [0-9]+") == errors &&
+              sv.count_reg(small, "error [0-9]+") == 2500 && sv.find_all("ok").size() == 7500 &&
+              sv.find_all(small, [](const std::string& s)
+                                 {
+                                     return s.ends_with('7');
+                                 }) == std::vector<std::size_t>{};
+
+    const auto [matching, others] = sv.partition_by(small, "error .*");
+    matched = matched && matching == errors && others.size() == 7500 && others.front() == 1;
+
+    /* Exact matches through the hash index, then the sort order. */
+    sv.get().insert(sv.get().begin() + 3, "error 4");
+    sv.build_index();
+    matched = matched && sv.find_all("error 4") == std::vector<std::size_t>{3, 5};
+    sv.sort_alphabetically();
+    matched = matched && sv.find_all("error 4").size() == 2 && sv.find_all("missing").empty();
+
+    /* An invalid regex matches nothing. */
+    matched = matched && sv.find_all_reg("(").empty() && sv.count_reg("(") == 0 &&
+              sv.partition_by("(").second.size() == 10001;
+
+    const stringvec      letters = {"a1", "b", "a2"};
+    const stringview_vec views{letters};
+    matched = matched && views.find_all_reg("a.") == std::vector<std::size_t>{0, 2} && views.count_reg("b") == 1 &&
+              views.partition_by("a.").second == std::vector<std::size_t>{1} && views.find_all("b").size() == 1;
+
+    if(!matched)
+    {
+        return TEST_ERROR;
+    }
+
+    return TEST_SUCCESS;
+}
+
+err_t case_test()
+{
+    const std::string mixed = "Hello, World! 0123456789 [AZ@az`{] long enough for a vector block";
+
+    stringvec sv = {mixed, "\xC3\x89T\xC3\x89", ""};
+    bool matched = stringvec{sv}.to_lower()[0] == "hello, world! 0123456789 [az@az`{] long enough for a vector block" &&
+                   stringvec{sv}.to_upper()[0] == "HELLO, WORLD! 0123456789 [AZ@AZ`{] LONG ENOUGH FOR A VECTOR BLOCK" &&
+                   stringvec{sv}.to_lower()[1] == "\xC3\x89t\xC3\x89";
+
+    /* Latin-1, Greek with a final sigma, Cyrillic, the Kelvin sign, and U+023A growing to 3 bytes. */
+    stringvec folded = stringvec{"\xC3\x89t\xC3\xA9 \xCE\xA3\xCE\x8A\xCE\xA3\xCE\xA5\xCE\xA6\xCE\x9F\xCE\xA3",
+                                 "\xD0\x9C\xD0\x9E\xD0\xA1\xD0\x9A\xD0\x92\xD0\x90 \xE2\x84\xAA",
+                                 "A\xC8\xBA\xC8\xBA\xC8\xBA" "B"}.casefold_utf8();
+    matched = matched && folded[0] == "\xC3\xA9t\xC3\xA9 \xCF\x83\xCE\xAF\xCF\x83\xCF\x85\xCF\x86\xCE\xBF\xCF\x83" &&
+              folded[1] == "\xD0\xBC\xD0\xBE\xD1\x81\xD0\xBA\xD0\xB2\xD0\xB0 k" &&
+              folded[2] == "a\xE2\xB1\xA5\xE2\xB1\xA5\xE2\xB1\xA5" "b";
+
+    /* Invalid sequences are left in place, and reported by `validate_utf8`, counted on its own. */
+    stringvec::reset_stats();
+    matched = matched && sv.validate_utf8() && folded.validate_utf8() &&
+              !stringvec{"ok", "\xC0\xAF"}.validate_utf8() && !stringvec{"\xED\xA0\x80"}.validate_utf8() &&
+              !stringvec{"\xF4\x90\x80\x80"}.validate_utf8() && !stringvec{"\xE2\x82"}.validate_utf8() &&
+              stringvec{"\xFF" "AB"}.casefold_utf8()[0] == "\xFF" "ab";
+#if STRINGVEC_STATS
+    matched = matched && stringvec::stats()[stringvec_stats::operation::validate_utf8].calls == 6 &&
+              stringvec::stats()[stringvec_stats::operation::find].calls == 0;
+#endif
+
+    /* Case-insensitive searches fold both sides. */
+    stringvec words = {"Strasse", "\xC3\x89" "COLE", "\xCE\xA3\xCE\x8A\xCE\xA3\xCE\xA5\xCE\xA6\xCE\x9F\xCE\xA3", "other"};
+    matched = matched && words.find_icase("STRASSE") == words.begin() &&
+              words.find_icase("\xCF\x83\xCE\xAF\xCF\x83\xCF\x85\xCF\x86\xCE\xBF\xCF\x82") == words.begin() + 2 &&
+              words.find_icase("\xC3\xA9" "col") == words.end() &&
+              stringvec{words}.filter_keep_icase("\xC3\xA9" "col") == stringvec{"\xC3\x89" "COLE"} &&
+              stringvec{words}.filter_remove_icase("S").get().size() == 3;
+
+    const stringview_vec views{words};
+    matched = matched && views.find_icase("OTHER") == views.begin() + 3 && views.validate_utf8() &&
+              stringview_vec{views}.filter_keep_icase("ass").get().size() == 1;
+
+    if(!matched)
+    {
+        return TEST_ERROR;
+    }
+
+    return TEST_SUCCESS;
+}
+
+err_t follow_test()
+{
+    const std::string path    = "follow_test.log";
+    const std::string rotated = "follow_test.log.1";
+    const auto        append  = [&path](const std::string& text)
+                                {
+                                    std::ofstream output(path, std::ios::binary | std::ios::app);
+                                    output << text;
+                                };
+    std::remove(path.c_str());
+    std::remove(rotated.c_str());
+    stringvec::reset_stats();
+
+    /* The file is waited for, then only complete lines are read, once. */
+    stringvec     errors;
+    file_follower follower = errors.follow(path, stream_pipeline{}.filter_keep("ERROR.*").remove_first());
+    bool matched = follower.poll() == 0;
+
+    append("ERROR skipped\nINFO a\nERROR one\nERROR tw");
+    matched = matched && follower.poll() == 1 && errors == stringvec{"ERROR one"} && follower.poll() == 0;
+    append("o\nINFO b\n");
+    matched = matched && follower.poll() == 1 && errors == stringvec{"ERROR one", "ERROR two"} &&
+              follower.offset() == 48;
+
+    /* Truncated: read again from the start. */
+    {
+        std::ofstream output(path, std::ios::binary | std::ios::trunc);
+        output << "ERROR three\n";
+    }
+    matched = matched && follower.poll() == 1 && errors.get().back() == "ERROR three";
+
+    /* Rotated: the old file is drained, including its last partial line, then the new one is read. */
+    append("ERROR four");
+    std::rename(path.c_str(), rotated.c_str());
+    append("ERROR five\n");
+    matched = matched && follower.poll() == 2 &&
+              errors == stringvec{"ERROR one", "ERROR two", "ERROR three", "ERROR four", "ERROR five"};
+
+    /* Waiting returns on a change, or after the timeout. */
+    stringvec     all;
+    file_follower lines = all.build_search_index().follow(path);
+    matched = matched && lines.wait(std::chrono::milliseconds{10}) == 1 && lines.wait(std::chrono::milliseconds{10}) == 0;
+    std::thread writer{[&append]
+                       {
+                           std::this_thread::sleep_for(std::chrono::milliseconds{20});
+                           append("late line\n");
+                       }};
+    std::size_t delivered = 0;
+    for (int i = 0; i < 50 && delivered == 0; i++)
+    {
+        delivered = lines.wait(std::chrono::milliseconds{100});
+    }
+    writer.join();
+    matched = matched && delivered == 1 && all.has_search_index() && all.find_all_containing("late") == std::vector<std::size_t>{1};
+#if STRINGVEC_STATS
+    matched = matched && stringvec::stats()[stringvec_stats::operation::append].calls == 7;
+#endif
+
+    std::remove(path.c_str());
+    std::remove(rotated.c_str());
+
+    if(!matched)
+    {
+        return TEST_ERROR;
+    }
+
+    return TEST_SUCCESS;
+}
+
+err_t column_test()
+{
+    const stringvec lines = {"apple,3,red", "kiwi,1,green,ripe", "banana,2,yellow", "fig,,purple", "cherry"};
+
+    /* Short rows read as empty fields, and the table outlives its source. */
+    column_table table = stringvec{lines}.split_columns(",");
+    bool matched = table.rows() == 5 && table.columns() == 4 && table.field(1, 3) == "ripe" &&
+                   table.field(0, 3).empty() && table.field(4, 1).empty() && table.field(4, 9).empty() &&
+                   table.column(2)[2] == "yellow" && table.to_stringvec(0) == stringvec{"apple", "kiwi", "banana", "fig", "cherry"};
+
+    bool thrown = false;
+    try
+    {
+        table.column(4);
+    }
+    catch (const std::out_of_range&)
+    {
+        thrown = true;
+    }
+    matched = matched && thrown;
+
+    /* Filters and sorts move whole rows, looking at one column. */
+    matched = matched && column_table{table}.filter_keep(1, "[0-9]+").sort_by(1).join_rows(",") ==
+                             stringvec{"kiwi,1,green,ripe", "banana,2,yellow,", "apple,3,red,"} &&
+              column_table{table}.filter_remove(2, ".*e.*").to_stringvec(0) == stringvec{"cherry"} &&
+              column_table{table}.filter_keep(3, [](std::string_view s) { return s.empty(); }).rows() == 4 &&
+              column_table{table}.filter_keep(7, "x").rows() == 0 &&
+              column_table{table}.sort_by(0, [](std::string_view a, std::string_view b) { return a.size() < b.size(); })
+                  .to_stringvec(0) == stringvec{"fig", "kiwi", "apple", "banana", "cherry"};
+
+    /* Projection keeps, reorders and repeats columns. */
+    matched = matched && column_table{table}.select({2, 0, 0, 5}).join_rows("|")[0] == "red|apple|apple|" &&
+              column_table{table}.select({}).filter_keep(0, "").rows() == 5;
+
+    /* Views of a view vector are shared, not copied. */
+    const stringview_vec views{lines};
+    const column_table   shared = views.split_columns(",");
+    matched = matched && shared == table && shared.field(0, 0).data() == views[0].data() &&
+              stringvec{"a b", " "}.split_columns(" ").columns() == 2 && column_table{}.rows() == 0;
+
+    if(!matched)
+    {
+        return TEST_ERROR;
+    }
+
+    return TEST_SUCCESS;
+}
+
+err_t integration_test()
+{
+    const stringvec valid = {"Raspberry", "Blueberry"};
+    stringvec       sv;
+
+    sv.read_file("input_test.txt");
+    sv.remove_first();
+    sv.split();
+    sv.filter_remove(".*[Aa]pple.*");
+    // sv.print();
+    sv.filter_keep(".*berry");
+    // sv.print();
+    sv.write_file("output_test.txt");
+
+    if(sv != valid)
+    {
+        return TEST_ERROR;
+    }
+    return TEST_SUCCESS;
+}
+
+err_t mapped_integration_test()
+{
+    const stringvec valid = {"RASPBERRY", "Blueberry"};
+    stringview_vec  sv;
+
+    sv.read_file("input_test.txt");
+    const char* first = sv.get().front().data();
+    const char* last  = sv.get().back().data() + sv.get().back().size();
+    auto is_mapped    = [first, last](const std::string_view s)
+                        {
+                            return s.data() >= first && s.data() < last;
+                        };
+
+    sv.remove_first();
+    sv.split();
+    sv.filter_remove(".*[Aa]pple.*");
+    sv.filter_keep(".*berry");
+    sv.transform([](const std::string_view s)
+                 {
+                     return s == "Raspberry" ? std::string{"RASPBERRY"} : std::string{s};
+                 });
+
+    /* Untouched elements must still point into the mapping. */
+    if(is_mapped(sv[0]) || !is_mapped(sv[1]))
+    {
+        return TEST_ERROR;
+    }
+
+    if(sv.to_stringvec() != valid)
+    {
+        return TEST_ERROR;
+    }
+    return TEST_SUCCESS;
+}
+
+
+
+/* ------------------------------------------- */
+int main()
+{
+    if(comparison_test() == TEST_ERROR)
+    {
+        std::cout << "FAIL" << std::endl;
+        return TEST_ERROR;
+    }
+
+    if(remove_test() == TEST_ERROR)
+    {
+        std::cout << "FAIL" << std::endl;
+        return TEST_ERROR;
+    }
+
+    if(regex_cache_test() == TEST_ERROR)
+    {
+        std::cout << "FAIL" << std::endl;
+        return TEST_ERROR;
+    }
+
+    if(regex_engine_test() == TEST_ERROR)
+    {
+        std::cout << "FAIL" << std::endl;
+        return TEST_ERROR;
+    }
+
+    if(transform_test() == TEST_ERROR)
+    {
+        std::cout << "FAIL" << std::endl;
+        return TEST_ERROR;
+    }
+
+    if(move_test() == TEST_ERROR)
+    {
+        std::cout << "FAIL" << std::endl;
+        return TEST_ERROR;
+    }
+
+    if(parallel_test() == TEST_ERROR)
+    {
+        std::cout << "FAIL" << std::endl;
+        return TEST_ERROR;
+    }
+
+    if(parallel_read_test() == TEST_ERROR)
+    {
+        std::cout << "FAIL" << std::endl;
+        return TEST_ERROR;
+    }
+
+    if(stream_test() == TEST_ERROR)
+    {
+        std::cout << "FAIL" << std::endl;
+        return TEST_ERROR;
+    }
+
+    if(arena_test() == TEST_ERROR)
+    {
+        std::cout << "FAIL" << std::endl;
+        return TEST_ERROR;
+    }
+
+    if(split_test() == TEST_ERROR)
+    {
+        std::cout << "FAIL" << std::endl;
+        return TEST_ERROR;
+    }
+
+    if(whitespace_test() == TEST_ERROR)
+    {
+        std::cout << "FAIL" << std::endl;
+        return TEST_ERROR;
+    }
+
+    if(index_test() == TEST_ERROR)
+    {
+        std::cout << "FAIL" << std::endl;
+        return TEST_ERROR;
+    }
+
+    if(set_test() == TEST_ERROR)
+    {
+        std::cout << "FAIL" << std::endl;
+        return TEST_ERROR;
+    }
+
+    if(sort_test() == TEST_ERROR)
+    {
+        std::cout << "FAIL" << std::endl;
+        return TEST_ERROR;
+    }
+
+    if(sorted_test() == TEST_ERROR)
+    {
+        std::cout << "FAIL" << std::endl;
+        return TEST_ERROR;
+    }
+
+    if(write_test() == TEST_ERROR)
+    {
+        std::cout << "FAIL" << std::endl;
+        return TEST_ERROR;
+    }
+
+    if(lazy_test() == TEST_ERROR)
+    {
+        std::cout << "FAIL" << std::endl;
+        return TEST_ERROR;
+    }
+
+    if(stats_test() == TEST_ERROR)
+    {
+        std::cout << "FAIL" << std::endl;
+        return TEST_ERROR;
+    }
+
+    if(async_test() == TEST_ERROR)
+    {
+        std::cout << "FAIL" << std::endl;
+        return TEST_ERROR;
+    }
+
+    if(snapshot_test() == TEST_ERROR)
+    {
+        std::cout << "FAIL" << std::endl;
+        return TEST_ERROR;
+    }
+
+    if(compression_test() == TEST_ERROR)
+    {
+        std::cout << "FAIL" << std::endl;
+        return TEST_ERROR;
+    }
+
+    if(pattern_set_test() == TEST_ERROR)
+    {
+        std::cout << "FAIL" << std::endl;
+        return TEST_ERROR;
+    }
+
+    if(search_index_test() == TEST_ERROR)
+    {
+        std::cout << "FAIL" << std::endl;
+        return TEST_ERROR;
+    }
+
+    if(find_all_test() == TEST_ERROR)
+    {
+        std::cout << "FAIL" << std::endl;
+        return TEST_ERROR;
+    }
+
+    if(case_test() == TEST_ERROR)
+    {
+        std::cout << "FAIL" << std::endl;
+        return TEST_ERROR;
+    }
+
+    if(follow_test() == TEST_ERROR)
+    {
+        std::cout << "FAIL" << std::endl;
+        return TEST_ERROR;
+    }
+
+    if(column_test() == TEST_ERROR)
+    {
+        std::cout << "FAIL" << std::endl;
+        return TEST_ERROR;
+    }
+
+
+    if(integration_test() == TEST_ERROR)
+    {
+        std::cout << "FAIL" << std::endl;
+        return TEST_ERROR;
+    }
+
+    if(mapped_integration_test() == TEST_ERROR)
     {
         std::cout << "FAIL" << std::endl;
         return TEST_ERROR;
@@ -190,7 +1792,7 @@ static std::pair<stringvec, stringvec> load_test(const std::string& path)
     input.read_file(path);
     answer.read_file(path + "-answer");
 
-    return {input, answer};
+    return {std::move(input), std::move(answer)};
 }
 
 